@@ -13,7 +13,9 @@ setlocal EnableDelayedExpansion
 ::                  injector        Build just the injector (UiForge.exe) and FTXUI
 ::                  core            Build just the core DLL and its dependencies
 ::                  testd3d11       Build the D3D11 test window
+::                  tests           Build and run the CPU-side tests in src\test (no graphics needed)
 ::                  ftxui           Build just the FTXUI static library
+::                  ufpak           Build the .ufpak script archive packer (needs LuaJIT built by core)
 ::                  cleanup         Remove build artifacts (no build)
 ::                  create-package  Zip a already-built UiForge into releases\ (no build)
 ::
@@ -36,6 +38,8 @@ set OBJ_DIR_INJECTOR=%BIN_DIR%\injector
 set OBJ_DIR_BINDINGS=%BIN_DIR%\bindings
 set OBJ_DIR_CORE=%BIN_DIR%\core
 set OBJ_DIR_FTXUI=%BIN_DIR%\ftxui
+set OBJ_DIR_TOOLS=%BIN_DIR%\tools
+set OBJ_DIR_TESTS=%BIN_DIR%\tests
 set OBJ_DIR_EXTERNALS=%BIN_DIR%\externals
 set EXTERNALS_DIR=%CWD%externals
 
@@ -69,6 +73,7 @@ set LINK_D3D12=d3d12.lib
 set LINK_IMGUI_WIN32=user32.lib gdi32.lib imm32.lib
 set LINK_WIC=ole32.lib windowscodecs.lib
 set LINK_AUDIO=winmm.lib
+set LINK_COMPRESSION=cabinet.lib
 set LINK_GRAPHICS=%LINK_D3D11% %LINK_D3D12% %LINK_IMGUI_WIN32% %LINK_WIC% %LINK_AUDIO%
 
 @REM Custom ImGui config: routes IM_ASSERT to a logged exception instead of aborting the
@@ -152,14 +157,18 @@ set BUILD_ALL=false
 set BUILD_INJECTOR=false
 set BUILD_CORE=false
 set BUILD_TESTD3D11=false
+set BUILD_TESTS=false
 set BUILD_FTXUI=false
+set BUILD_UFPAK=false
 set BUILD_FAILED=false
 
 if /I "%~1"=="" set BUILD_ALL=true
 if /I "%~1"=="injector" set BUILD_INJECTOR=true
 if /I "%~1"=="core" set BUILD_CORE=true
 if /I "%~1"=="testd3d11" set BUILD_TESTD3D11=true
+if /I "%~1"=="tests" set BUILD_TESTS=true
 if /I "%~1"=="ftxui" set BUILD_FTXUI=true
+if /I "%~1"=="ufpak" set BUILD_UFPAK=true
 
 @REM Build FTXUI static library
 if "%BUILD_ALL%"=="true" set BUILD_FTXUI=true
@@ -296,7 +305,7 @@ if "%BUILD_CORE%"=="true" (
         /Fo"%OBJ_DIR_CORE%\\" /Fe:"%BIN_DIR%\uiforge_core.dll" ^
         %SRC_DIR%\core\*.cpp ^
         "%OBJ_DIR_EXTERNALS%\imgui\*.obj" "%OBJ_DIR_EXTERNALS%\minhook\*.obj" "%OBJ_DIR_EXTERNALS%\kiero\*.obj" "%OBJ_DIR_EXTERNALS%\directxtk\*.obj" ^
-        /link %LINK_GRAPHICS% "%LUAJIT_LIB%"
+        /link %LINK_GRAPHICS% %LINK_COMPRESSION% "%LUAJIT_LIB%"
     @REM /nologo      : Suppresses the compiler version info in output.
     @REM /bigobj      : Enables support for larger object files.
     @REM /EHsc        : Enables standard C++ exception handling.
@@ -310,6 +319,23 @@ if "%BUILD_CORE%"=="true" (
     if errorlevel 1 goto error
 )
 
+@REM Build the .ufpak packer. It shares the archive reader with the core for its --benchmark option.
+if "%BUILD_ALL%"=="true" set BUILD_UFPAK=true
+if "%BUILD_UFPAK%"=="true" (
+    echo Building ufpak packer
+    if not exist "%LUAJIT_LIB%" (
+        echo ERROR: "%LUAJIT_LIB%" was not found. Build the core first.
+        goto error
+    )
+    if not exist %OBJ_DIR_TOOLS% mkdir %OBJ_DIR_TOOLS%
+    cl /nologo /EHsc %RUNTIME% %CSTD% ^
+        /I"%PROJ_INCLUDE_DIR%" /I"%PLOG_INCLUDE_DIR%" /I"%LUAJIT_SRC_DIR%" ^
+        /Fo"%OBJ_DIR_TOOLS%\\" /Fe:"%BIN_DIR%\ufpak_packer.exe" ^
+        "%SRC_DIR%\tools\ufpak_packer.cpp" "%SRC_DIR%\core\package_archive.cpp" "%SRC_DIR%\core\mapped_file.cpp" ^
+        /link %LINK_COMPRESSION% "%LUAJIT_LIB%"
+    if errorlevel 1 goto error
+)
+
 @REM Build D3D11 Test Window
 if "%BUILD_TESTD3D11%"=="true" (
     echo Building D3D11 Test Window
@@ -330,6 +356,33 @@ if "%BUILD_TESTD3D11%"=="true" (
     if errorlevel 1 goto error
 )
 
+@REM Build and run the CPU-side tests. Each one compiles only the core sources it covers.
+if "%BUILD_TESTS%"=="true" (
+    echo Building Tests
+    if not exist %OBJ_DIR_TESTS% mkdir %OBJ_DIR_TESTS%
+    cl /nologo /EHsc /O2 %RUNTIME% %CSTD% /I"%PROJ_INCLUDE_DIR%" /Fo"%OBJ_DIR_TESTS%\\" /Fe:"%BIN_DIR%\test_pixel_convert.exe" ^
+        "%SRC_DIR%\test\test_pixel_convert.cpp" "%SRC_DIR%\core\pixel_convert.cpp"
+    if errorlevel 1 goto error
+    cl /nologo /EHsc /O2 %RUNTIME% %CSTD% /I"%PROJ_INCLUDE_DIR%" /Fo"%OBJ_DIR_TESTS%\\" /Fe:"%BIN_DIR%\test_bc_encoder.exe" ^
+        "%SRC_DIR%\test\test_bc_encoder.cpp" "%SRC_DIR%\core\bc_encoder.cpp"
+    if errorlevel 1 goto error
+    cl /nologo /EHsc /O2 %RUNTIME% %CSTD% /I"%PROJ_INCLUDE_DIR%" /Fo"%OBJ_DIR_TESTS%\\" /Fe:"%BIN_DIR%\test_handle_table.exe" ^
+        "%SRC_DIR%\test\test_handle_table.cpp"
+    if errorlevel 1 goto error
+    cl /nologo /EHsc /O2 %RUNTIME% %CSTD% /I"%PROJ_INCLUDE_DIR%" /Fo"%OBJ_DIR_TESTS%\\" /Fe:"%BIN_DIR%\test_sdf_generator.exe" ^
+        "%SRC_DIR%\test\test_sdf_generator.cpp" "%SRC_DIR%\core\sdf_generator.cpp"
+    if errorlevel 1 goto error
+
+    echo Running Tests
+    "%BIN_DIR%\test_pixel_convert.exe" --benchmark
+    if errorlevel 1 goto error
+    "%BIN_DIR%\test_bc_encoder.exe"
+    if errorlevel 1 goto error
+    "%BIN_DIR%\test_handle_table.exe" --benchmark
+    if errorlevel 1 goto error
+    "%BIN_DIR%\test_sdf_generator.exe"
+    if errorlevel 1 goto error
+)
 
 goto cleanup
 
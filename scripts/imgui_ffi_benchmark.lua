@@ -0,0 +1,94 @@
+-- imgui_ffi_benchmark.lua
+-- Times the same widget-heavy workload through the sol2 ImGui bindings (the
+-- global ImGui) and through the FFI fast path (require("imgui_ffi")), and shows
+-- the average cost per frame of each. Enable it, let it run for a few seconds,
+-- and compare. Both passes draw into clipped child windows, so ImGui itself does
+-- little work and the numbers are mostly binding overhead.
+
+local ffi = require("ffi")
+local ImGuiFfi = require("imgui_ffi")
+
+-- QueryPerformanceCounter, since os.clock only ticks in milliseconds on Windows.
+-- Another script may have declared these already.
+pcall(ffi.cdef, [[
+    int QueryPerformanceCounter(int64_t* count);
+    int QueryPerformanceFrequency(int64_t* frequency);
+]])
+
+bench = bench or {
+    items           = 200,      -- Widget rows per pass
+    frames          = 0,
+    sol_us          = 0,
+    ffi_us          = 0,
+    counter         = ffi.new("int64_t[1]"),
+    ticks_per_us    = 0,
+}
+
+if bench.ticks_per_us == 0 then
+    ffi.C.QueryPerformanceFrequency(bench.counter)
+    bench.ticks_per_us = tonumber(bench.counter[0]) / 1e6
+end
+
+local function NowUs()
+    ffi.C.QueryPerformanceCounter(bench.counter)
+    return tonumber(bench.counter[0]) / bench.ticks_per_us
+end
+
+-- The workload only uses calls both bindings provide, with the same arguments.
+local function Workload(Gui, Vec2, items)
+    local draw_list = Gui.GetWindowDrawList()
+    for i = 1, items do
+        Gui.PushID(i)
+        Gui.Text("Row")
+        Gui.SameLine()
+        Gui.Button("Press", 60, 0)
+        Gui.SameLine()
+        local x, y = Gui.GetCursorScreenPos()
+        draw_list:AddRectFilled(Vec2.new(x, y), Vec2.new(x + 12, y + 12), 0xFF3080FF)
+        draw_list:AddLine(Vec2.new(x, y), Vec2.new(x + 12, y + 12), 0xFFFFFFFF)
+        Gui.Dummy(12, 12)
+        Gui.PopID()
+    end
+end
+
+local function TimePass(name, Gui, Vec2)
+    ImGui.BeginChild(name, 0, 80)
+    local start = NowUs()
+    Workload(Gui, Vec2, bench.items)
+    local elapsed = NowUs() - start
+    ImGui.EndChild()
+    return elapsed
+end
+
+if ImGui.Begin("ImGui Bindings Benchmark") then
+    ImGui.Text(string.format("%d rows of Text, SameLine, Button, GetCursorScreenPos, AddRectFilled, AddLine, Dummy", bench.items))
+    local items, changed = ImGui.SliderInt("Rows", bench.items, 10, 2000)
+    if changed then
+        bench.items = items
+        bench.frames, bench.sol_us, bench.ffi_us = 0, 0, 0
+    end
+    if ImGui.Button("Reset") then
+        bench.frames, bench.sol_us, bench.ffi_us = 0, 0, 0
+    end
+
+    -- Alternate which binding goes first so neither always pays for a cold cache.
+    if bench.frames % 2 == 0 then
+        bench.sol_us = bench.sol_us + TimePass("sol2", ImGui, ImVec2)
+        bench.ffi_us = bench.ffi_us + TimePass("ffi", ImGuiFfi, ImGuiFfi.ImVec2)
+    else
+        bench.ffi_us = bench.ffi_us + TimePass("ffi", ImGuiFfi, ImGuiFfi.ImVec2)
+        bench.sol_us = bench.sol_us + TimePass("sol2", ImGui, ImVec2)
+    end
+    bench.frames = bench.frames + 1
+
+    local sol_avg = bench.sol_us / bench.frames
+    local ffi_avg = bench.ffi_us / bench.frames
+    ImGui.Separator()
+    ImGui.Text(string.format("Frames measured: %d", bench.frames))
+    ImGui.Text(string.format("sol2 bindings: %8.1f us/frame", sol_avg))
+    ImGui.Text(string.format("FFI bindings:  %8.1f us/frame", ffi_avg))
+    if ffi_avg > 0 then
+        ImGui.Text(string.format("Speedup:       %8.2fx", sol_avg / ffi_avg))
+    end
+end
+ImGui.End()
@@ -40,19 +40,27 @@ end
 --- Load an image into a texture handle usable with ImGui.Image.
 --- Relative paths resolve against the calling script package's resources folder
 --- first (when the script is packaged), then the shared resources directory.
+--- compression block-compresses the image to save video memory ("bc1" for opaque images,
+--- "bc3" or "bc7" with alpha). The first load encodes the image and keeps the result in the
+--- texture cache. Width and height must be multiples of 4, otherwise it loads uncompressed.
+--- max_width and max_height give the largest size the image is drawn at; bigger images are
+--- shrunk to fit (keeping their aspect ratio) so the full resolution never sits in video memory.
 --- @param path string absolute path, or path relative to the resources directories
+--- @param options table|nil { compression = "none"|"bc1"|"bc3"|"bc7", max_width = integer, max_height = integer, filter = "lanczos"|"box", mipmaps = boolean }
 --- @return userdata|nil texture A texture handle, or nil on failure.
-function UiForge.LoadTexture(path)
+function UiForge.LoadTexture(path, options)
     return nil
 end
 
---- Create a texture from raw 32 bit RGBA pixel bytes (row major, no row padding).
+--- Create a texture from raw pixel bytes.
 --- Pass the pixels as a Lua string, for example ffi.string(buf, len).
---- @param rgba_pixels string the pixel bytes, must be width * height * 4 bytes
+--- Without options the bytes are tightly packed 32 bit RGBA (row major, no row padding).
+--- @param pixels string the pixel bytes
 --- @param width integer image width in pixels
 --- @param height integer image height in pixels
+--- @param options table|nil { format = "rgba"|"bgra"|"rgb"|"gray", row_pitch = bytes per row, premultiplied = boolean }
 --- @return userdata|nil texture A texture handle usable with ImGui.Image, or nil on failure.
-function UiForge.CreateTextureFromMemory(rgba_pixels, width, height)
+function UiForge.CreateTextureFromMemory(pixels, width, height, options)
     return nil
 end
 
@@ -0,0 +1,8 @@
+-- Declares what this package needs before its script first runs. The fonts below are loaded
+-- and rasterized during UiForge's initialization, so the LoadFont calls in uiforge_example.lua
+-- get fonts that are already in the atlas.
+return {
+    fonts = {
+        { path = "C:\\Windows\\Fonts\\times.ttf", sizes = { 20, 36 } },
+    },
+}
@@ -35,11 +35,11 @@ state = state or {
     button_clicked      = false,
     checkbox_checked    = false,
     radio_buttons       = 0,
-    input_demo_text     = "Type here...",
+    input_demo_text     = UiForge.TextBuffer(256, "Type here..."),
     input_demo_label    = "Label will update on Enter",
     slider_float        = 0.5,
     slider_int          = 5,
-    combo_items         = {"Item 01", "Item 02", "Item 03"},
+    combo_items         = UiForge.StringList({"Item 01", "Item 02", "Item 03"}),
     combo_index         = 0,
     color4              = { 1, .5, .25, 1},
     progress_percent    = 0,
@@ -67,6 +67,11 @@ state = state or {
     sound_volume        = 1.0,
     sound_loop          = false,
 
+    -- Virtual table
+    virtual_rows        = nil,
+    virtual_selected    = false,
+    virtual_filter      = UiForge.TextBuffer(64),
+
     -- Bouncing balls
     balls               = {},
     ball_count          = 10,
@@ -123,11 +128,20 @@ local function UpdateBalls(delta_time, area)
     end
 end
 
+-- All balls go to the draw list in one UiForge.DrawBatch call instead of one
+-- AddCircleFilled call (and one ImVec2) per ball.
 local function RenderBalls(origin)
-    local draw_list = ImGui.GetWindowDrawList()
-    for _, ball in ipairs(state.balls) do
-        draw_list:AddCircleFilled(ImVec2.new(origin.x + ball.position.x, origin.y + ball.position.y), ball.radius, ball.color)
+    local positions, radii, colors = {}, {}, {}
+    for i, ball in ipairs(state.balls) do
+        positions[i * 2 - 1] = ball.position.x
+        positions[i * 2] = ball.position.y
+        radii[i] = ball.radius
+        colors[i] = ball.color
     end
+    UiForge.DrawBatch({
+        origin = origin,
+        circles = { positions = positions, radii = radii, colors = colors },
+    })
 end
 
 -- ===============================
@@ -266,7 +280,7 @@ if ImGui.Begin("Hello, UiForge!", true, ImGuiWindowFlags.MenuBar) then
             state.radio_buttons = (state.radio_buttons == 2) and 0 or 2   -- Makes the button toggleable on and off by clicking it again
         end
 
-        -- Combo Box
+        -- Combo Box (the items are a UiForge.StringList, so they are not converted every frame)
         state.combo_index = ImGui.Combo("Combo Box", state.combo_index, state.combo_items, #state.combo_items)
 
         -- Input Text (press Enter to "submit")
@@ -274,10 +288,12 @@ if ImGui.Begin("Hello, UiForge!", true, ImGuiWindowFlags.MenuBar) then
         ImGui.Text("Input box demo")
         ImGui.TextDisabled("Hit Enter to change label")
         local enter_returns_true_flag = (ImGuiInputTextFlags and ImGuiInputTextFlags.EnterReturnsTrue) or 0
-        local new_text, enter_pressed = ImGui.InputText("Input Box", state.input_demo_text, enter_returns_true_flag)
-        state.input_demo_text = new_text
+        -- The text lives in a UiForge.TextBuffer that the widget edits in place; it is only
+        -- read back as a Lua string when Enter is pressed.
+        local _, enter_pressed = ImGui.InputText("Input Box", state.input_demo_text, enter_returns_true_flag)
         if enter_pressed then
-            state.input_demo_label = (state.input_demo_text ~= "" and state.input_demo_text) or "(empty)"
+            local text = state.input_demo_text:Get()
+            state.input_demo_label = (text ~= "" and text) or "(empty)"
         end
         ImGui.Text("Label: " .. state.input_demo_label)
         ImGui.TreePop()
@@ -532,6 +548,32 @@ if ImGui.Begin("Hello, UiForge!", true, ImGuiWindowFlags.MenuBar) then
         ImGui.TreePop()
     end
 
+    if ImGui.TreeNode("Virtual Table") then
+        -- The rows are filled once; only the visible ones are drawn each frame.
+        if not state.virtual_rows then
+            state.virtual_rows = UiForge.DataTable({
+                { name = "ID", type = "number" },
+                "Name",
+                { name = "Value", type = "number" },
+            })
+            for i = 1, 10000 do
+                state.virtual_rows:Append(i, string.format("Row %05d", i), math.random(0, 1000))
+            end
+        end
+
+        -- Click a header to sort; sorting and filtering happen off the render thread.
+        local _, filter_changed = ImGui.InputTextWithHint("##VirtualFilter", "Filter", state.virtual_filter)
+        if filter_changed then
+            state.virtual_rows:SetFilter(state.virtual_filter:Get())
+        end
+        ImGui.Text(string.format("%d of %d rows", state.virtual_rows:VisibleCount(), #state.virtual_rows))
+        local clicked = UiForge.VirtualTable("VirtualRows", state.virtual_rows, { height = 200, selected = state.virtual_selected })
+        if clicked then
+            state.virtual_selected = clicked
+        end
+        ImGui.TreePop()
+    end
+
     if ImGui.TreeNode("Bouncing Balls") then
         ImGui.Text("The ball count lives in this script's Settings callback,")
         ImGui.Text("and the simulation is captured by the Save/Load callbacks (profiles).")
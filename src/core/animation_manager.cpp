@@ -0,0 +1,835 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wincodec.h>
+
+#include <imgui.h>
+#include <plog/Log.h>
+
+#include "core\animation_manager.h"
+#include "core\graphics_api.h"
+#include "core\texture_loader.h"
+
+namespace
+{
+    // Largest sprite sheet built from animation frames, in either direction. Every D3D11 feature
+    // level UiForge runs on supports at least this much.
+    constexpr int MAX_SHEET_SIZE = 8192;
+
+    // Browsers treat GIF delays below 20 ms as "unspecified" and play them at 100 ms; so do we,
+    // since that is what the files were authored against.
+    constexpr double MIN_FRAME_DELAY        = 0.02;
+    constexpr double DEFAULT_FRAME_DELAY    = 0.1;
+
+    // Longest step playback takes in one frame, so a stall (or a long time hidden) does not
+    // skip through a streamed animation.
+    constexpr double MAX_PLAYBACK_STEP = 0.25;
+
+    // Streamed frames are written in turn into this many dynamic textures, as many as there can
+    // be frames in flight, so a frame is never overwritten while the GPU may still be reading it.
+    constexpr int FRAME_TEXTURE_RING_SIZE = 3;
+
+    // Decodes the frames of a multi-frame WIC image in order, composited onto a full-size canvas
+    // the way a GIF is meant to be shown. Not thread safe; each worker owns one.
+    class FrameDecoder
+    {
+        public:
+            ~FrameDecoder()
+            {
+                if (decoder)     decoder->Release();
+                if (wic_factory) wic_factory->Release();
+            }
+
+            bool Open(const std::filesystem::path& file_path)
+            {
+                HRESULT result = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic_factory));
+                if (FAILED(result)) { PLOG_ERROR << "Failed to create WIC imaging factory. HRESULT: " << result; return false; }
+
+                result = wic_factory->CreateDecoderFromFilename(file_path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
+                if (FAILED(result)) { PLOG_ERROR << "Failed to open animation " << file_path.string() << ". HRESULT: " << result; return false; }
+
+                UINT count = 0;
+                result = decoder->GetFrameCount(&count);
+                if (FAILED(result) || count == 0) { PLOG_ERROR << "Animation has no frames: " << file_path.string(); return false; }
+                frame_count = (int)count;
+
+                // GIFs describe the canvas in the logical screen descriptor; other containers
+                // just use the first frame's size.
+                IWICMetadataQueryReader* reader = nullptr;
+                if (SUCCEEDED(decoder->GetMetadataQueryReader(&reader)))
+                {
+                    canvas_width  = ReadMetadataInt(reader, L"/logscrdesc/Width", 0);
+                    canvas_height = ReadMetadataInt(reader, L"/logscrdesc/Height", 0);
+                    reader->Release();
+                }
+                if (canvas_width <= 0 || canvas_height <= 0)
+                {
+                    IWICBitmapFrameDecode* frame = nullptr;
+                    UINT width = 0;
+                    UINT height = 0;
+                    if (FAILED(decoder->GetFrame(0, &frame)) || FAILED(frame->GetSize(&width, &height)) || !width || !height)
+                    {
+                        if (frame) frame->Release();
+                        PLOG_ERROR << "Failed to read the size of animation " << file_path.string();
+                        return false;
+                    }
+                    frame->Release();
+                    canvas_width  = (int)width;
+                    canvas_height = (int)height;
+                }
+
+                Rewind();
+                return true;
+            }
+
+            // Reads every frame's delay from metadata, without decoding any pixels.
+            std::vector<double> ReadDelays()
+            {
+                std::vector<double> delays(frame_count, DEFAULT_FRAME_DELAY);
+                for (int i = 0; i < frame_count; ++i)
+                {
+                    IWICBitmapFrameDecode* frame = nullptr;
+                    IWICMetadataQueryReader* reader = nullptr;
+                    if (SUCCEEDED(decoder->GetFrame((UINT)i, &frame)) && SUCCEEDED(frame->GetMetadataQueryReader(&reader)))
+                    {
+                        const double delay = ReadMetadataInt(reader, L"/grctlext/Delay", 0) / 100.0;
+                        delays[i] = delay < MIN_FRAME_DELAY ? DEFAULT_FRAME_DELAY : delay;
+                    }
+                    if (reader) reader->Release();
+                    if (frame)  frame->Release();
+                }
+                return delays;
+            }
+
+            void Rewind()
+            {
+                canvas.assign((size_t)canvas_width * canvas_height * 4, 0);
+                next_frame = 0;
+                previous_disposal = 0;
+            }
+
+            // Composites the next frame and copies the canvas into out_rgba, which must hold
+            // width * height * 4 bytes with the given row pitch.
+            bool DecodeNext(uint8_t* out_rgba, size_t out_pitch)
+            {
+                if (next_frame >= frame_count)
+                {
+                    return false;
+                }
+
+                // Dispose of the previous frame as it asked: 2 clears its rectangle to
+                // transparent, 3 puts back what was under it.
+                if (previous_disposal == 2)
+                {
+                    FillRect(previous_rect, 0);
+                }
+                else if (previous_disposal == 3 && !saved_canvas.empty())
+                {
+                    canvas = saved_canvas;
+                }
+
+                IWICBitmapFrameDecode* frame = nullptr;
+                IWICMetadataQueryReader* reader = nullptr;
+                IWICFormatConverter* converter = nullptr;
+                bool decoded = false;
+
+                do
+                {
+                    HRESULT result = decoder->GetFrame((UINT)next_frame, &frame);
+                    if (FAILED(result)) { PLOG_ERROR << "Failed to get animation frame " << next_frame << ". HRESULT: " << result; break; }
+
+                    UINT frame_width = 0;
+                    UINT frame_height = 0;
+                    frame->GetSize(&frame_width, &frame_height);
+
+                    FrameRect rect = { 0, 0, (int)frame_width, (int)frame_height };
+                    int disposal = 0;
+                    if (SUCCEEDED(frame->GetMetadataQueryReader(&reader)))
+                    {
+                        rect.left = ReadMetadataInt(reader, L"/imgdesc/Left", 0);
+                        rect.top  = ReadMetadataInt(reader, L"/imgdesc/Top", 0);
+                        disposal  = ReadMetadataInt(reader, L"/grctlext/Disposal", 0);
+                    }
+
+                    if (disposal == 3)
+                    {
+                        saved_canvas = canvas;
+                    }
+
+                    result = wic_factory->CreateFormatConverter(&converter);
+                    if (FAILED(result)) { PLOG_ERROR << "Failed to create WIC format converter. HRESULT: " << result; break; }
+
+                    result = converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+                    if (FAILED(result)) { PLOG_ERROR << "Failed to convert animation frame to 32bpp RGBA. HRESULT: " << result; break; }
+
+                    frame_pixels.resize((size_t)frame_width * frame_height * 4);
+                    result = converter->CopyPixels(nullptr, frame_width * 4, (UINT)frame_pixels.size(), frame_pixels.data());
+                    if (FAILED(result)) { PLOG_ERROR << "Failed to copy animation frame pixels. HRESULT: " << result; break; }
+
+                    BlendFrame(rect);
+                    previous_rect     = rect;
+                    previous_disposal = disposal;
+                    decoded = true;
+                } while (false);
+
+                if (converter) converter->Release();
+                if (reader)    reader->Release();
+                if (frame)     frame->Release();
+
+                if (!decoded)
+                {
+                    return false;
+                }
+
+                const size_t row_bytes = (size_t)canvas_width * 4;
+                for (int y = 0; y < canvas_height; ++y)
+                {
+                    memcpy(out_rgba + (size_t)y * out_pitch, canvas.data() + (size_t)y * row_bytes, row_bytes);
+                }
+
+                next_frame++;
+                return true;
+            }
+
+            int GetWidth() const        { return canvas_width; }
+            int GetHeight() const       { return canvas_height; }
+            int GetFrameCount() const   { return frame_count; }
+
+        private:
+            struct FrameRect
+            {
+                int left;
+                int top;
+                int width;
+                int height;
+            };
+
+            static int ReadMetadataInt(IWICMetadataQueryReader* reader, const wchar_t* name, int fallback)
+            {
+                PROPVARIANT value;
+                PropVariantInit(&value);
+                int result = fallback;
+                if (SUCCEEDED(reader->GetMetadataByName(name, &value)))
+                {
+                    switch (value.vt)
+                    {
+                        case VT_UI1:    result = value.bVal;        break;
+                        case VT_UI2:    result = value.uiVal;       break;
+                        case VT_UI4:    result = (int)value.ulVal;  break;
+                        case VT_I4:     result = value.lVal;        break;
+                        default:                                    break;
+                    }
+                }
+                PropVariantClear(&value);
+                return result;
+            }
+
+            // Clips a frame rectangle to the canvas.
+            bool ClipRect(FrameRect& rect) const
+            {
+                const int right  = std::min(rect.left + rect.width, canvas_width);
+                const int bottom = std::min(rect.top + rect.height, canvas_height);
+                rect.left   = std::max(0, rect.left);
+                rect.top    = std::max(0, rect.top);
+                rect.width  = right - rect.left;
+                rect.height = bottom - rect.top;
+                return rect.width > 0 && rect.height > 0;
+            }
+
+            void FillRect(FrameRect rect, uint8_t value)
+            {
+                if (!ClipRect(rect))
+                {
+                    return;
+                }
+                for (int y = rect.top; y < rect.top + rect.height; ++y)
+                {
+                    memset(canvas.data() + ((size_t)y * canvas_width + rect.left) * 4, value, (size_t)rect.width * 4);
+                }
+            }
+
+            // GIF transparency is all or nothing, so a frame's transparent pixels leave the canvas
+            // as it was and every other pixel replaces it.
+            void BlendFrame(const FrameRect& frame_rect)
+            {
+                FrameRect rect = frame_rect;
+                if (!ClipRect(rect))
+                {
+                    return;
+                }
+
+                const int skip_x = rect.left - frame_rect.left;
+                const int skip_y = rect.top - frame_rect.top;
+                for (int y = 0; y < rect.height; ++y)
+                {
+                    const uint32_t* source = (const uint32_t*)frame_pixels.data() + (size_t)(y + skip_y) * frame_rect.width + skip_x;
+                    uint32_t* destination  = (uint32_t*)canvas.data() + (size_t)(rect.top + y) * canvas_width + rect.left;
+                    for (int x = 0; x < rect.width; ++x)
+                    {
+                        if (source[x] >> 24)
+                        {
+                            destination[x] = source[x];
+                        }
+                    }
+                }
+            }
+
+            IWICImagingFactory* wic_factory = nullptr;
+            IWICBitmapDecoder* decoder      = nullptr;
+            int canvas_width                = 0;
+            int canvas_height               = 0;
+            int frame_count                 = 0;
+            int next_frame                  = 0;
+            int previous_disposal           = 0;
+            FrameRect previous_rect         = {};
+            std::vector<uint8_t> canvas;
+            std::vector<uint8_t> saved_canvas;
+            std::vector<uint8_t> frame_pixels;
+    };
+
+    struct StreamedFrame
+    {
+        long long sequence;     // loop * frame_count + frame index
+        std::vector<uint8_t> rgba;
+    };
+
+    struct Animation
+    {
+        std::filesystem::path file_path;
+        AnimationLoadOptions options;
+
+        // Written by the worker under mutex until ready is set, read-only afterwards.
+        std::mutex mutex;
+        std::condition_variable queue_changed;
+        bool ready      = false;
+        bool failed     = false;
+        bool streaming  = false;
+        int frame_width = 0;
+        int frame_height = 0;
+        int frame_count = 0;
+        std::vector<double> frame_starts;   // Start time of each frame within one loop
+        double duration = 0.0;
+
+        // Sprite sheet: every frame in one texture, sheet_columns frames per row. Animated images
+        // hand their sheet over in sheet_pixels; sprite sheet files are loaded from disk instead.
+        bool sheet_from_file = false;
+        std::vector<uint8_t> sheet_pixels;
+        int sheet_width     = 0;
+        int sheet_height    = 0;
+        int sheet_columns   = 1;
+        void* sheet_texture = nullptr;
+
+        // Streaming: decoded frames ahead of playback, bounded by the memory budget.
+        std::deque<StreamedFrame> queue;
+        size_t queued_bytes         = 0;
+        long long restart_request   = -1;   // Set by Restart, consumed by the worker
+        std::array<void*, FRAME_TEXTURE_RING_SIZE> frame_textures = {};
+        int frame_texture_index     = -1;   // Ring slot holding the frame on screen
+        long long shown_sequence    = -1;
+
+        // Playback, render thread only.
+        double playback_time    = 0.0;
+        double last_draw_time   = -1.0;
+        int last_draw_frame     = -1;
+
+        std::atomic<bool> stop { false };
+        std::thread worker;
+    };
+
+    HandleTable<std::unique_ptr<Animation>> animations;
+
+    Animation* FindAnimation(ResourceHandle animation_id)
+    {
+        std::unique_ptr<Animation>* animation = animations.Find(animation_id);
+        return animation ? animation->get() : nullptr;
+    }
+
+    void MarkFailed(Animation* animation)
+    {
+        std::lock_guard<std::mutex> lock(animation->mutex);
+        animation->failed = true;
+    }
+
+    // Worker body for sprite sheet files: only the image size is needed to lay out the frames.
+    void ReadSpriteSheet(Animation* animation, FrameDecoder& decoder)
+    {
+        const AnimationLoadOptions& options = animation->options;
+        const int columns = decoder.GetWidth() / options.frame_width;
+        const int rows    = decoder.GetHeight() / options.frame_height;
+        int frame_count   = columns * rows;
+        if (options.frame_count > 0)
+        {
+            frame_count = std::min(frame_count, options.frame_count);
+        }
+        if (frame_count <= 0)
+        {
+            PLOG_ERROR << "Sprite sheet " << animation->file_path.string() << " (" << decoder.GetWidth() << "x" << decoder.GetHeight()
+                       << ") is smaller than one " << options.frame_width << "x" << options.frame_height << " frame.";
+            MarkFailed(animation);
+            return;
+        }
+
+        const double delay = options.fps > 0.0 ? 1.0 / options.fps : DEFAULT_FRAME_DELAY;
+        std::lock_guard<std::mutex> lock(animation->mutex);
+        animation->frame_width      = options.frame_width;
+        animation->frame_height     = options.frame_height;
+        animation->frame_count      = frame_count;
+        animation->frame_starts.resize(frame_count);
+        for (int i = 0; i < frame_count; ++i)
+        {
+            animation->frame_starts[i] = i * delay;
+        }
+        animation->duration         = frame_count * delay;
+        animation->sheet_from_file  = true;
+        animation->sheet_width      = decoder.GetWidth();
+        animation->sheet_height     = decoder.GetHeight();
+        animation->sheet_columns    = columns;
+        animation->ready            = true;
+    }
+
+    // Worker body for animated images that fit the budget: decodes every frame into a sheet.
+    bool BuildSheet(Animation* animation, FrameDecoder& decoder, int columns)
+    {
+        const int width         = decoder.GetWidth();
+        const int height        = decoder.GetHeight();
+        const int frame_count   = decoder.GetFrameCount();
+        const int rows          = (frame_count + columns - 1) / columns;
+        const int sheet_width   = columns * width;
+        const int sheet_height  = rows * height;
+
+        std::vector<uint8_t> sheet((size_t)sheet_width * sheet_height * 4, 0);
+        for (int i = 0; i < frame_count; ++i)
+        {
+            if (animation->stop)
+            {
+                return true;
+            }
+
+            uint8_t* cell = sheet.data() + ((size_t)(i / columns) * height * sheet_width + (size_t)(i % columns) * width) * 4;
+            if (!decoder.DecodeNext(cell, (size_t)sheet_width * 4))
+            {
+                return false;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(animation->mutex);
+        animation->sheet_pixels  = std::move(sheet);
+        animation->sheet_width   = sheet_width;
+        animation->sheet_height  = sheet_height;
+        animation->sheet_columns = columns;
+        animation->ready         = true;
+
+        PLOG_DEBUG << "Animation " << animation->file_path.string() << ": " << frame_count << " frames of " << width << "x" << height
+                   << " packed into a " << sheet_width << "x" << sheet_height << " sheet";
+        return true;
+    }
+
+    // Worker body for animated images too large to keep whole: decodes frames ahead of playback,
+    // looping forever, blocking whenever the queue holds the budget's worth of frames.
+    bool StreamFrames(Animation* animation, FrameDecoder& decoder)
+    {
+        const int frame_count       = decoder.GetFrameCount();
+        const size_t frame_bytes    = (size_t)decoder.GetWidth() * decoder.GetHeight() * 4;
+
+        // At least two frames are always allowed in flight, whatever the budget says, so
+        // playback always has the next frame to move to.
+        const size_t budget = std::max(animation->options.memory_budget_bytes, frame_bytes * 2);
+
+        {
+            std::lock_guard<std::mutex> lock(animation->mutex);
+            animation->streaming = true;
+            animation->ready     = true;
+        }
+        PLOG_DEBUG << "Animation " << animation->file_path.string() << ": streaming " << frame_count << " frames of "
+                   << decoder.GetWidth() << "x" << decoder.GetHeight() << " within " << budget << " bytes";
+
+        long long sequence = 0;
+        while (!animation->stop)
+        {
+            {
+                std::unique_lock<std::mutex> lock(animation->mutex);
+                animation->queue_changed.wait(lock, [&]
+                {
+                    return animation->stop || animation->restart_request >= 0 || animation->queued_bytes + frame_bytes <= budget;
+                });
+                if (animation->stop)
+                {
+                    break;
+                }
+                if (animation->restart_request >= 0)
+                {
+                    sequence = animation->restart_request;
+                    animation->restart_request = -1;
+                }
+            }
+
+            // Frames composite onto the previous one, so every loop decodes from the start.
+            if (sequence % frame_count == 0)
+            {
+                decoder.Rewind();
+            }
+
+            std::vector<uint8_t> rgba(frame_bytes);
+            if (!decoder.DecodeNext(rgba.data(), (size_t)decoder.GetWidth() * 4))
+            {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(animation->mutex);
+            if (animation->restart_request >= 0)
+            {
+                continue;   // Decoded for a playback position that no longer exists
+            }
+            animation->queue.push_back(StreamedFrame{ sequence, std::move(rgba) });
+            animation->queued_bytes += frame_bytes;
+            sequence++;
+        }
+        return true;
+    }
+
+    void DecodeAnimation(Animation* animation)
+    {
+        const HRESULT co_init = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        const bool co_initialized = SUCCEEDED(co_init);    // RPC_E_CHANGED_MODE means COM was already up in another mode; keep going.
+
+        do
+        {
+            FrameDecoder decoder;
+            if (!decoder.Open(animation->file_path))
+            {
+                MarkFailed(animation);
+                break;
+            }
+
+            if (animation->options.frame_width > 0 && animation->options.frame_height > 0)
+            {
+                ReadSpriteSheet(animation, decoder);
+                break;
+            }
+
+            const int width         = decoder.GetWidth();
+            const int height        = decoder.GetHeight();
+            const int frame_count   = decoder.GetFrameCount();
+
+            std::vector<double> frame_starts(frame_count);
+            double duration = 0.0;
+            const std::vector<double> delays = decoder.ReadDelays();
+            for (int i = 0; i < frame_count; ++i)
+            {
+                frame_starts[i] = duration;
+                duration += delays[i];
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(animation->mutex);
+                animation->frame_width  = width;
+                animation->frame_height = height;
+                animation->frame_count  = frame_count;
+                animation->frame_starts = std::move(frame_starts);
+                animation->duration     = duration;
+            }
+
+            // A sheet is used when every frame fits the budget and the frames fit a sheet: as
+            // square a grid as the size limit allows, since that wastes least of the last row.
+            int columns = std::max(1, (int)std::ceil(std::sqrt((double)frame_count * height / width)));
+            columns = std::min(columns, std::min(frame_count, MAX_SHEET_SIZE / width));
+            const int rows = columns > 0 ? (frame_count + columns - 1) / columns : 0;
+            const bool use_sheet = columns > 0 && (long long)rows * height <= MAX_SHEET_SIZE
+                                && (size_t)width * height * 4 * frame_count <= animation->options.memory_budget_bytes;
+
+            const bool succeeded = use_sheet ? BuildSheet(animation, decoder, columns) : StreamFrames(animation, decoder);
+            if (!succeeded)
+            {
+                MarkFailed(animation);
+            }
+        } while (false);
+
+        if (co_initialized) CoUninitialize();
+    }
+
+    // Index of the frame showing at a time within one loop.
+    int FrameAt(const Animation& animation, double loop_time)
+    {
+        auto next = std::upper_bound(animation.frame_starts.begin(), animation.frame_starts.end(), loop_time);
+        return std::max(0, (int)(next - animation.frame_starts.begin()) - 1);
+    }
+}
+
+ResourceHandle AnimationManager::Load(const std::filesystem::path& file_path, const AnimationLoadOptions& options, uint32_t owner)
+{
+    std::error_code ec;
+    if (!std::filesystem::exists(file_path, ec))
+    {
+        PLOG_WARNING << "LoadAnimation could not find \"" << file_path.string() << "\".";
+        return 0;
+    }
+
+    auto animation = std::make_unique<Animation>();
+    animation->file_path = file_path;
+    animation->options   = options;
+
+    Animation* raw_animation = animation.get();
+    const ResourceHandle animation_id = animations.Insert(std::move(animation), owner);
+    if (animation_id == 0)
+    {
+        PLOG_ERROR << "Out of animation handles.";
+        return 0;
+    }
+
+    try
+    {
+        raw_animation->worker = std::thread(DecodeAnimation, raw_animation);
+    }
+    catch (const std::system_error& err)
+    {
+        PLOG_ERROR << "Failed to start animation worker: " << err.what();
+        animations.Remove(animation_id);
+        return 0;
+    }
+
+    return animation_id;
+}
+
+bool AnimationManager::Draw(ResourceHandle animation_id, float width, float height, bool loop)
+{
+    Animation* animation = FindAnimation(animation_id);
+    if (!animation)
+    {
+        return false;
+    }
+
+    bool ready = false;
+    {
+        std::lock_guard<std::mutex> lock(animation->mutex);
+        ready = animation->ready && !animation->failed;
+    }
+
+    if (!ready)
+    {
+        // Keep the layout stable while the worker is still reading the file.
+        ImGui::Dummy(ImVec2(width, height));
+        return false;
+    }
+
+    // Everything the worker filled in before setting ready is read-only from here on.
+    const ImVec2 size(width > 0.0f ? width : (float)animation->frame_width, height > 0.0f ? height : (float)animation->frame_height);
+
+    // Advance once per ImGui frame, however many times the animation is drawn in it.
+    const int frame_number = ImGui::GetFrameCount();
+    if (frame_number != animation->last_draw_frame)
+    {
+        const double now = ImGui::GetTime();
+        if (animation->last_draw_time >= 0.0)
+        {
+            animation->playback_time += std::min(now - animation->last_draw_time, MAX_PLAYBACK_STEP);
+        }
+        animation->last_draw_time  = now;
+        animation->last_draw_frame = frame_number;
+    }
+
+    const double duration = std::max(animation->duration, 1e-3);
+    if (!loop && animation->playback_time >= duration)
+    {
+        animation->playback_time = duration - 1e-6;
+    }
+    const long long loop_index = (long long)(animation->playback_time / duration);
+    const int frame_index = FrameAt(*animation, animation->playback_time - loop_index * duration);
+
+    if (!animation->streaming)
+    {
+        if (!animation->sheet_texture)
+        {
+            if (animation->sheet_from_file)
+            {
+                animation->sheet_texture = TextureLoader::LoadFromFile(animation->file_path, TextureLoadOptions());
+            }
+            else if (IGraphicsApi::CreateTextureFromMemory)
+            {
+                animation->sheet_texture = IGraphicsApi::CreateTextureFromMemory(animation->sheet_pixels.data(), animation->sheet_width,
+                                                                                 animation->sheet_height, PixelLayout());
+                std::vector<uint8_t>().swap(animation->sheet_pixels);
+            }
+
+            if (!animation->sheet_texture)
+            {
+                MarkFailed(animation);
+                ImGui::Dummy(size);
+                return false;
+            }
+        }
+
+        const float u_step = (float)animation->frame_width / animation->sheet_width;
+        const float v_step = (float)animation->frame_height / animation->sheet_height;
+        const ImVec2 uv0((frame_index % animation->sheet_columns) * u_step, (frame_index / animation->sheet_columns) * v_step);
+        ImGui::Image(ImTextureRef(animation->sheet_texture), size, uv0, ImVec2(uv0.x + u_step, uv0.y + v_step));
+        return true;
+    }
+
+    // Streaming: take the newest queued frame that is due, dropping any that were skipped.
+    const long long target_sequence = loop_index * animation->frame_count + frame_index;
+    StreamedFrame due_frame = { -1, {} };
+    {
+        std::lock_guard<std::mutex> lock(animation->mutex);
+        while (!animation->queue.empty() && animation->queue.front().sequence <= target_sequence)
+        {
+            animation->queued_bytes -= animation->queue.front().rgba.size();
+            due_frame = std::move(animation->queue.front());
+            animation->queue.pop_front();
+        }
+    }
+    animation->queue_changed.notify_one();
+
+    if (due_frame.sequence >= 0 && IGraphicsApi::CreateDynamicTexture && IGraphicsApi::UpdateTexture)
+    {
+        // The ring is created once, on the first frame; every later frame is copied into the
+        // next texture in place, so playback never creates textures or waits on an upload.
+        if (!animation->frame_textures[0])
+        {
+            for (void*& texture : animation->frame_textures)
+            {
+                texture = IGraphicsApi::CreateDynamicTexture(animation->frame_width, animation->frame_height, PixelFormat::RGBA8);
+                if (!texture)
+                {
+                    MarkFailed(animation);
+                    ImGui::Dummy(size);
+                    return false;
+                }
+            }
+        }
+
+        const int next_index = (animation->frame_texture_index + 1) % FRAME_TEXTURE_RING_SIZE;
+        if (IGraphicsApi::UpdateTexture(animation->frame_textures[next_index], 0, 0, animation->frame_width, animation->frame_height,
+                                        due_frame.rgba.data(), (size_t)animation->frame_width * 4))
+        {
+            animation->frame_texture_index = next_index;
+            animation->shown_sequence      = due_frame.sequence;
+        }
+    }
+
+    if (animation->frame_texture_index < 0)
+    {
+        ImGui::Dummy(size);
+        return false;
+    }
+
+    ImGui::Image(ImTextureRef(animation->frame_textures[animation->frame_texture_index]), size);
+    return true;
+}
+
+void AnimationManager::Restart(ResourceHandle animation_id)
+{
+    Animation* animation = FindAnimation(animation_id);
+    if (!animation)
+    {
+        return;
+    }
+
+    animation->playback_time = 0.0;
+    std::lock_guard<std::mutex> lock(animation->mutex);
+    if (animation->streaming)
+    {
+        animation->queue.clear();
+        animation->queued_bytes    = 0;
+        animation->restart_request = 0;
+        animation->queue_changed.notify_one();
+    }
+}
+
+AnimationInfo AnimationManager::GetInfo(ResourceHandle animation_id)
+{
+    AnimationInfo info;
+    Animation* animation = FindAnimation(animation_id);
+    if (!animation)
+    {
+        info.failed = true;
+        return info;
+    }
+
+    std::lock_guard<std::mutex> lock(animation->mutex);
+    info.ready       = animation->ready && !animation->failed;
+    info.failed      = animation->failed;
+    info.streaming   = animation->streaming;
+    info.width       = animation->frame_width;
+    info.height      = animation->frame_height;
+    info.frame_count = animation->frame_count;
+    info.duration    = animation->duration;
+    return info;
+}
+
+void AnimationManager::Release(ResourceHandle animation_id)
+{
+    Animation* animation = FindAnimation(animation_id);
+    if (!animation)
+    {
+        return;
+    }
+
+    animation->stop = true;
+    {
+        std::lock_guard<std::mutex> lock(animation->mutex);
+        animation->queue_changed.notify_all();
+    }
+    if (animation->worker.joinable())
+    {
+        animation->worker.join();
+    }
+
+    IGraphicsApi::QueueTextureRelease(animation->sheet_texture);
+    for (void* texture : animation->frame_textures)
+    {
+        IGraphicsApi::QueueTextureRelease(texture);
+    }
+    animations.Remove(animation_id);
+}
+
+void AnimationManager::ReleaseAll()
+{
+    for (ResourceHandle animation_id : animations.Handles())
+    {
+        Release(animation_id);
+    }
+}
+
+void AnimationManager::ReleaseOwnedBy(uint32_t owner)
+{
+    for (ResourceHandle animation_id : animations.HandlesOwnedBy(owner))
+    {
+        Release(animation_id);
+    }
+}
+
+bool AnimationManager::Keep(ResourceHandle animation_id)
+{
+    return animations.SetOwner(animation_id, 0);
+}
+
+ResourceUsage AnimationManager::GetUsage(uint32_t owner)
+{
+    ResourceUsage usage;
+    animations.ForEach([&](ResourceHandle, std::unique_ptr<Animation>& animation, uint32_t animation_owner)
+    {
+        if (animation_owner == owner)
+        {
+            usage.count++;
+            usage.bytes += IGraphicsApi::GetTextureBytes(animation->sheet_texture);
+            for (void* texture : animation->frame_textures)
+            {
+                usage.bytes += IGraphicsApi::GetTextureBytes(texture);
+            }
+        }
+    });
+    return usage;
+}
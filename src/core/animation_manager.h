@@ -0,0 +1,121 @@
+/**
+ * @file animation_manager.h
+ * @brief Animated images for forgescripts: GIFs and sprite sheets, drawn with one call per frame.
+ *
+ * GIF (and other multi-frame WIC containers) are decoded on a worker thread, frame by frame,
+ * honouring frame offsets, per-frame delays and disposal. Short animations are packed into a
+ * single sprite-sheet texture, so playback is only a change of texture coordinates. Animations
+ * whose decoded frames would not fit the memory budget are streamed instead: the worker keeps a
+ * bounded queue of decoded frames ahead of playback and the current frame is copied into a small
+ * ring of dynamic textures when it comes due.
+ *
+ * A plain image can also be played as a sprite sheet by giving the size of one frame, in which
+ * case it is loaded through TextureLoader like any other texture.
+ *
+ * Playback time only advances while an animation is being drawn, so an animation in a hidden
+ * window resumes where it left off instead of jumping ahead.
+ */
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+#include "core\handle_table.h"
+
+/**
+ * @brief Options for AnimationManager::Load.
+ */
+struct AnimationLoadOptions
+{
+    // Sprite sheets only: the size of one frame, in pixels. Frames are read left to right, top
+    // to bottom. Leave at 0 to load the file as an animated image.
+    int     frame_width         = 0;
+    int     frame_height        = 0;
+    int     frame_count         = 0;                    // 0 for every full cell in the sheet
+    double  fps                 = 10.0;                 // Sprite sheets only
+
+    size_t  memory_budget_bytes = 64 * 1024 * 1024;     // Decoded frames kept in memory at once
+};
+
+/**
+ * @brief What is known about a loaded animation.
+ */
+struct AnimationInfo
+{
+    bool    ready       = false;    // False while the worker is still reading the file
+    bool    failed      = false;
+    bool    streaming   = false;    // Frames are streamed rather than kept in one texture
+    int     width       = 0;        // Size of one frame
+    int     height      = 0;
+    int     frame_count = 0;
+    double  duration    = 0.0;      // Seconds for one loop
+};
+
+class AnimationManager
+{
+    public:
+        /**
+         * @brief Starts loading an animation.
+         *
+         * Animated images are read on a worker thread, so the animation is not ready the moment
+         * this returns; Draw reserves its space until it is.
+         *
+         * @param file_path Full path to the image.
+         * @param options Load options.
+         * @param owner Owner tag recorded with the handle (see ReleaseOwnedBy).
+         * @return A positive animation handle, or 0 on failure (logged).
+         */
+        static ResourceHandle Load(const std::filesystem::path& file_path, const AnimationLoadOptions& options, uint32_t owner = 0);
+
+        /**
+         * @brief Draws the current frame as an ImGui image and advances playback.
+         *
+         * Must be called between ImGui::NewFrame and ImGui::Render. Playback advances once per
+         * ImGui frame no matter how often the animation is drawn.
+         *
+         * @param animation_id Handle returned by Load().
+         * @param width Drawn width, or 0 for the frame width.
+         * @param height Drawn height, or 0 for the frame height.
+         * @param loop False to stop on the last frame.
+         * @return True when a frame was drawn; false while loading or for a bad handle.
+         */
+        static bool Draw(ResourceHandle animation_id, float width, float height, bool loop);
+
+        /**
+         * @brief Restarts playback from the first frame.
+         */
+        static void Restart(ResourceHandle animation_id);
+
+        /**
+         * @brief Describes an animation. A bad handle reports failed.
+         */
+        static AnimationInfo GetInfo(ResourceHandle animation_id);
+
+        /**
+         * @brief Stops an animation's worker and releases its textures. The handle becomes invalid.
+         */
+        static void Release(ResourceHandle animation_id);
+
+        /**
+         * @brief Releases every animation loaded with the given owner tag.
+         */
+        static void ReleaseOwnedBy(uint32_t owner);
+
+        /**
+         * @brief Hands an animation over to the core (owner 0) so ReleaseOwnedBy leaves it alone.
+         *
+         * @return True when the handle was valid.
+         */
+        static bool Keep(ResourceHandle animation_id);
+
+        /**
+         * @brief Counts the animations loaded with an owner tag and the GPU memory of their
+         * textures. Frames a streaming animation has decoded ahead are not included.
+         */
+        static ResourceUsage GetUsage(uint32_t owner);
+
+        /**
+         * @brief Releases every animation. Called during core cleanup.
+         */
+        static void ReleaseAll();
+};
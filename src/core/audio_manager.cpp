@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <string>
 #include <unordered_map>
 
@@ -13,13 +14,15 @@ namespace
     struct SoundRecord
     {
         std::wstring alias;
-        std::wstring file_path;
+        std::wstring index_key;     // Key in sounds_by_path
+        size_t file_bytes;
     };
 
-    // Loaded sounds by handle, plus a path index so repeat loads reuse the alias.
-    std::unordered_map<int, SoundRecord> sounds;
-    std::unordered_map<std::wstring, int> sounds_by_path;
-    int next_sound_id = 1;
+    // Loaded sounds by handle, plus an index by owner and path so repeat loads reuse the alias.
+    // Each owner gets its own alias, so one script releasing a sound never pulls it from another.
+    HandleTable<SoundRecord> sounds;
+    std::unordered_map<std::wstring, ResourceHandle> sounds_by_path;
+    int next_alias_number = 1;
 
     // Sends one MCI command, logging the translated error on failure.
     bool SendMciCommand(const std::wstring& command, std::wstring* out_result = nullptr)
@@ -41,10 +44,9 @@ namespace
         return true;
     }
 
-    const SoundRecord* FindSound(int sound_id)
+    const SoundRecord* FindSound(ResourceHandle sound_id)
     {
-        auto record = sounds.find(sound_id);
-        return (record == sounds.end()) ? nullptr : &record->second;
+        return sounds.Find(sound_id);
     }
 
     // MCI volume range is 0-1000.
@@ -56,9 +58,10 @@ namespace
     }
 }
 
-int AudioManager::Load(const std::wstring& file_path)
+ResourceHandle AudioManager::Load(const std::wstring& file_path, uint32_t owner)
 {
-    auto existing = sounds_by_path.find(file_path);
+    const std::wstring index_key = std::to_wstring(owner) + L"|" + file_path;
+    auto existing = sounds_by_path.find(index_key);
     if (existing != sounds_by_path.end())
     {
         return existing->second;
@@ -66,8 +69,7 @@ int AudioManager::Load(const std::wstring& file_path)
 
     // The alias carries a UiForge prefix so it can never collide with MCI aliases
     // the host application might be using.
-    const int sound_id = next_sound_id;
-    const std::wstring alias = L"uiforge_snd_" + std::to_wstring(sound_id);
+    const std::wstring alias = L"uiforge_snd_" + std::to_wstring(next_alias_number);
 
     // mpegvideo decodes both mp3 and wav and, unlike waveaudio, supports setaudio volume.
     if (!SendMciCommand(L"open \"" + file_path + L"\" type mpegvideo alias " + alias))
@@ -75,14 +77,25 @@ int AudioManager::Load(const std::wstring& file_path)
         return 0;
     }
 
-    next_sound_id++;
-    sounds[sound_id] = SoundRecord{ alias, file_path };
-    sounds_by_path[file_path] = sound_id;
+    // MCI streams from the file, so its size is the closest estimate of what a sound holds.
+    std::error_code ec;
+    const uintmax_t file_bytes = std::filesystem::file_size(file_path, ec);
+
+    const ResourceHandle sound_id = sounds.Insert(SoundRecord{ alias, index_key, ec ? 0 : (size_t)file_bytes }, owner);
+    if (sound_id == 0)
+    {
+        PLOG_ERROR << "Out of sound handles.";
+        SendMciCommand(L"close " + alias);
+        return 0;
+    }
+
+    next_alias_number++;
+    sounds_by_path[index_key] = sound_id;
     PLOG_DEBUG << "Loaded sound " << sound_id << ": " << file_path;
     return sound_id;
 }
 
-bool AudioManager::Play(int sound_id, double volume, bool loop)
+bool AudioManager::Play(ResourceHandle sound_id, double volume, bool loop)
 {
     const SoundRecord* sound = FindSound(sound_id);
     if (!sound)
@@ -97,7 +110,7 @@ bool AudioManager::Play(int sound_id, double volume, bool loop)
     return SendMciCommand(L"play " + sound->alias + (loop ? L" repeat" : L""));
 }
 
-bool AudioManager::Stop(int sound_id)
+bool AudioManager::Stop(ResourceHandle sound_id)
 {
     const SoundRecord* sound = FindSound(sound_id);
     if (!sound)
@@ -107,7 +120,7 @@ bool AudioManager::Stop(int sound_id)
     return SendMciCommand(L"stop " + sound->alias);
 }
 
-bool AudioManager::IsPlaying(int sound_id)
+bool AudioManager::IsPlaying(ResourceHandle sound_id)
 {
     const SoundRecord* sound = FindSound(sound_id);
     if (!sound)
@@ -123,7 +136,7 @@ bool AudioManager::IsPlaying(int sound_id)
     return mode == L"playing";
 }
 
-bool AudioManager::SetVolume(int sound_id, double volume)
+bool AudioManager::SetVolume(ResourceHandle sound_id, double volume)
 {
     const SoundRecord* sound = FindSound(sound_id);
     if (!sound)
@@ -133,25 +146,51 @@ bool AudioManager::SetVolume(int sound_id, double volume)
     return SendMciCommand(L"setaudio " + sound->alias + L" volume to " + std::to_wstring(ToMciVolume(volume)));
 }
 
-void AudioManager::Release(int sound_id)
+void AudioManager::Release(ResourceHandle sound_id)
 {
-    auto record = sounds.find(sound_id);
-    if (record == sounds.end())
+    SoundRecord sound;
+    if (!sounds.Remove(sound_id, &sound))
     {
         return;
     }
 
-    SendMciCommand(L"close " + record->second.alias);
-    sounds_by_path.erase(record->second.file_path);
-    sounds.erase(record);
+    SendMciCommand(L"close " + sound.alias);
+    sounds_by_path.erase(sound.index_key);
+}
+
+void AudioManager::ReleaseOwnedBy(uint32_t owner)
+{
+    for (ResourceHandle sound_id : sounds.HandlesOwnedBy(owner))
+    {
+        Release(sound_id);
+    }
+}
+
+bool AudioManager::Keep(ResourceHandle sound_id)
+{
+    return sounds.SetOwner(sound_id, 0);
+}
+
+ResourceUsage AudioManager::GetUsage(uint32_t owner)
+{
+    ResourceUsage usage;
+    sounds.ForEach([&](ResourceHandle, SoundRecord& sound, uint32_t sound_owner)
+    {
+        if (sound_owner == owner)
+        {
+            usage.count++;
+            usage.bytes += sound.file_bytes;
+        }
+    });
+    return usage;
 }
 
 void AudioManager::ReleaseAll()
 {
-    for (const auto& [sound_id, sound] : sounds)
+    sounds.ForEach([](ResourceHandle, SoundRecord& sound, uint32_t)
     {
         SendMciCommand(L"close " + sound.alias);
-    }
-    sounds.clear();
+    });
+    sounds.Clear();
     sounds_by_path.clear();
 }
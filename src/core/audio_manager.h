@@ -10,6 +10,8 @@
 
 #include <string>
 
+#include "core\handle_table.h"
+
 class AudioManager
 {
     public:
@@ -17,12 +19,13 @@ class AudioManager
          * @brief Opens a sound file and returns a handle for playback.
          *
          * Loads through the MCI mpegvideo device so mp3 and wav both support volume
-         * control. Repeat loads of the same file return the same handle.
+         * control. Repeat loads of the same file by the same owner return the same handle.
          *
          * @param file_path Full path to the sound file.
-         * @return A positive sound handle, or 0 on failure (logged).
+         * @param owner Owner tag recorded with the handle (see ReleaseOwnedBy).
+         * @return A sound handle, or 0 on failure (logged).
          */
-        static int Load(const std::wstring& file_path);
+        static ResourceHandle Load(const std::wstring& file_path, uint32_t owner = 0);
 
         /**
          * @brief Plays a loaded sound from the beginning.
@@ -32,7 +35,7 @@ class AudioManager
          * @param loop True to repeat until stopped.
          * @return True when playback started.
          */
-        static bool Play(int sound_id, double volume, bool loop);
+        static bool Play(ResourceHandle sound_id, double volume, bool loop);
 
         /**
          * @brief Stops a playing sound. No-op when the sound isn't playing.
@@ -40,7 +43,7 @@ class AudioManager
          * @param sound_id Handle returned by Load().
          * @return True when the stop command succeeded.
          */
-        static bool Stop(int sound_id);
+        static bool Stop(ResourceHandle sound_id);
 
         /**
          * @brief Reports whether a sound is currently playing.
@@ -48,7 +51,7 @@ class AudioManager
          * @param sound_id Handle returned by Load().
          * @return True while the sound is playing.
          */
-        static bool IsPlaying(int sound_id);
+        static bool IsPlaying(ResourceHandle sound_id);
 
         /**
          * @brief Sets the volume of a loaded sound, affecting current and future playback.
@@ -57,14 +60,33 @@ class AudioManager
          * @param volume Volume from 0.0 to 1.0.
          * @return True when the volume was applied.
          */
-        static bool SetVolume(int sound_id, double volume);
+        static bool SetVolume(ResourceHandle sound_id, double volume);
 
         /**
-         * @brief Closes a sound and frees its MCI alias. The handle becomes invalid.
+         * @brief Closes a sound and frees its MCI alias. The handle becomes stale and is rejected
+         * by every other call, even after its slot is reused.
          *
          * @param sound_id Handle returned by Load().
          */
-        static void Release(int sound_id);
+        static void Release(ResourceHandle sound_id);
+
+        /**
+         * @brief Closes every sound loaded with the given owner tag.
+         */
+        static void ReleaseOwnedBy(uint32_t owner);
+
+        /**
+         * @brief Hands a sound over to the core (owner 0) so ReleaseOwnedBy leaves it alone.
+         *
+         * @return True when the handle was valid.
+         */
+        static bool Keep(ResourceHandle sound_id);
+
+        /**
+         * @brief Counts the sounds loaded with an owner tag. Bytes are the sizes of their files,
+         * since MCI streams from disk.
+         */
+        static ResourceUsage GetUsage(uint32_t owner);
 
         /**
          * @brief Closes every loaded sound. Called during core cleanup.
@@ -0,0 +1,864 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "core\bc_encoder.h"
+
+namespace
+{
+    struct Block
+    {
+        uint8_t rgba[16][4];
+    };
+
+    // BC7 4-bit index interpolation weights, out of 64.
+    const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    void LoadBlock(const uint8_t* image, size_t row_pitch, int width, int height, int block_x, int block_y, Block& block)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            const int source_y = std::min(block_y * 4 + y, height - 1);
+            for (int x = 0; x < 4; ++x)
+            {
+                const int source_x = std::min(block_x * 4 + x, width - 1);
+                std::memcpy(block.rgba[y * 4 + x], image + (size_t)source_y * row_pitch + (size_t)source_x * 4, 4);
+            }
+        }
+    }
+
+    // Finds the mean and the direction of greatest variance of a point cloud with 3 or 4
+    // channels, by power iteration on the covariance matrix.
+    void ComputePrincipalAxis(const float points[][4], int count, int channels, float mean[4], float axis[4])
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            mean[c] = 0.0f;
+            axis[c] = 0.0f;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            for (int c = 0; c < channels; ++c)
+            {
+                mean[c] += points[i][c];
+            }
+        }
+        for (int c = 0; c < channels; ++c)
+        {
+            mean[c] /= (float)count;
+        }
+
+        float covariance[4][4] = {};
+        for (int i = 0; i < count; ++i)
+        {
+            float delta[4] = {};
+            for (int c = 0; c < channels; ++c)
+            {
+                delta[c] = points[i][c] - mean[c];
+            }
+            for (int row = 0; row < channels; ++row)
+            {
+                for (int col = 0; col < channels; ++col)
+                {
+                    covariance[row][col] += delta[row] * delta[col];
+                }
+            }
+        }
+
+        // Start from the row of the most varied channel; it can't be orthogonal to the answer.
+        int start = 0;
+        for (int c = 1; c < channels; ++c)
+        {
+            if (covariance[c][c] > covariance[start][start])
+            {
+                start = c;
+            }
+        }
+
+        float vector[4] = {};
+        for (int c = 0; c < channels; ++c)
+        {
+            vector[c] = covariance[start][c];
+        }
+
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[4] = {};
+            float largest = 0.0f;
+            for (int row = 0; row < channels; ++row)
+            {
+                for (int col = 0; col < channels; ++col)
+                {
+                    next[row] += covariance[row][col] * vector[col];
+                }
+                largest = std::max(largest, std::fabs(next[row]));
+            }
+
+            if (largest <= 0.0f)
+            {
+                break;
+            }
+            for (int c = 0; c < channels; ++c)
+            {
+                vector[c] = next[c] / largest;
+            }
+        }
+
+        float length = 0.0f;
+        for (int c = 0; c < channels; ++c)
+        {
+            length += vector[c] * vector[c];
+        }
+        length = std::sqrt(length);
+
+        // A flat block has no axis; any direction works since every point sits on the mean.
+        for (int c = 0; c < channels; ++c)
+        {
+            axis[c] = length > 1e-6f ? vector[c] / length : 1.0f / std::sqrt((float)channels);
+        }
+    }
+
+    // Solves for the two endpoints that best reproduce the points, given each point's blend
+    // weight toward the second endpoint. Returns false when the system is degenerate (for
+    // example every point uses the same palette entry).
+    bool RefitEndpoints(const float points[][4], const float weights[], int count, int channels, float out_a[4], float out_b[4])
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[4] = {}, bx[4] = {};
+        for (int i = 0; i < count; ++i)
+        {
+            const float w = weights[i];
+            const float v = 1.0f - w;
+            aa += v * v;
+            ab += v * w;
+            bb += w * w;
+            for (int c = 0; c < channels; ++c)
+            {
+                ax[c] += v * points[i][c];
+                bx[c] += w * points[i][c];
+            }
+        }
+
+        const float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) < 1e-6f)
+        {
+            return false;
+        }
+
+        const float inverse = 1.0f / determinant;
+        for (int c = 0; c < channels; ++c)
+        {
+            out_a[c] = std::min(255.0f, std::max(0.0f, (ax[c] * bb - bx[c] * ab) * inverse));
+            out_b[c] = std::min(255.0f, std::max(0.0f, (bx[c] * aa - ax[c] * ab) * inverse));
+        }
+        return true;
+    }
+
+    // BC1 colour blocks.
+
+    uint16_t PackRgb565(const float rgb[3])
+    {
+        const int red   = std::min(31, std::max(0, (int)(rgb[0] * 31.0f / 255.0f + 0.5f)));
+        const int green = std::min(63, std::max(0, (int)(rgb[1] * 63.0f / 255.0f + 0.5f)));
+        const int blue  = std::min(31, std::max(0, (int)(rgb[2] * 31.0f / 255.0f + 0.5f)));
+        return (uint16_t)((red << 11) | (green << 5) | blue);
+    }
+
+    void UnpackRgb565(uint16_t colour, int out[4])
+    {
+        const int red   = (colour >> 11) & 31;
+        const int green = (colour >> 5) & 63;
+        const int blue  = colour & 31;
+        out[0] = (red << 3) | (red >> 2);
+        out[1] = (green << 2) | (green >> 4);
+        out[2] = (blue << 3) | (blue >> 2);
+        out[3] = 255;
+    }
+
+    // Builds the palette exactly as a decoder would. BC1 switches to three colours plus
+    // transparent when c0 <= c1; the colour half of a BC3 block always uses four colours.
+    int BuildColourPalette(uint16_t c0, uint16_t c1, bool always_four_colours, int palette[4][4])
+    {
+        UnpackRgb565(c0, palette[0]);
+        UnpackRgb565(c1, palette[1]);
+
+        if (c0 > c1 || always_four_colours)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            palette[2][3] = 255;
+            palette[3][3] = 255;
+            return 4;
+        }
+
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+        return 3;
+    }
+
+    void EncodeColourBlock(const Block& block, bool allow_transparent, uint8_t out[8])
+    {
+        bool transparent[16] = {};
+        float points[16][4] = {};
+        int point_count = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            transparent[i] = allow_transparent && block.rgba[i][3] < 128;
+            if (!transparent[i])
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    points[point_count][c] = block.rgba[i][c];
+                }
+                ++point_count;
+            }
+        }
+
+        const bool three_colour_mode = allow_transparent && point_count < 16;
+        if (point_count == 0)
+        {
+            // Fully transparent: equal endpoints select three colour mode, index 3 everywhere.
+            std::memset(out, 0, 4);
+            std::memset(out + 4, 0xFF, 4);
+            return;
+        }
+
+        // Candidate endpoints span the colours along their principal axis, pulled in slightly
+        // because the extremes are rarely the best quantized choice.
+        float mean[4], axis[4];
+        ComputePrincipalAxis(points, point_count, 3, mean, axis);
+
+        float min_t = std::numeric_limits<float>::max();
+        float max_t = -std::numeric_limits<float>::max();
+        for (int i = 0; i < point_count; ++i)
+        {
+            float t = 0.0f;
+            for (int c = 0; c < 3; ++c)
+            {
+                t += (points[i][c] - mean[c]) * axis[c];
+            }
+            min_t = std::min(min_t, t);
+            max_t = std::max(max_t, t);
+        }
+        const float inset = (max_t - min_t) / 32.0f;
+        min_t += inset;
+        max_t -= inset;
+
+        float endpoint_a[4] = {}, endpoint_b[4] = {};
+        for (int c = 0; c < 3; ++c)
+        {
+            endpoint_a[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * min_t));
+            endpoint_b[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * max_t));
+        }
+
+        uint16_t best_c0 = 0, best_c1 = 0;
+        uint32_t best_indices = 0;
+        int best_error = std::numeric_limits<int>::max();
+
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            uint16_t c0 = PackRgb565(endpoint_a);
+            uint16_t c1 = PackRgb565(endpoint_b);
+            if ((three_colour_mode && c0 > c1) || (!three_colour_mode && c0 < c1))
+            {
+                std::swap(c0, c1);
+            }
+
+            int palette[4][4];
+            const int usable_entries = BuildColourPalette(c0, c1, !allow_transparent, palette);
+
+            uint32_t indices = 0;
+            int error = 0;
+            float weights[16];
+            float fitted_points[16][4];
+            int fitted_count = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                int best_index = 3;
+                if (!transparent[i])
+                {
+                    int best_distance = std::numeric_limits<int>::max();
+                    for (int entry = 0; entry < usable_entries; ++entry)
+                    {
+                        int distance = 0;
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            const int delta = palette[entry][c] - block.rgba[i][c];
+                            distance += delta * delta;
+                        }
+                        if (distance < best_distance)
+                        {
+                            best_distance = distance;
+                            best_index = entry;
+                        }
+                    }
+                    error += best_distance;
+
+                    // Blend weight of c1 for each palette entry, for the refit below.
+                    static const float FOUR_COLOUR_WEIGHTS[4]  = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+                    static const float THREE_COLOUR_WEIGHTS[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+                    weights[fitted_count] = usable_entries == 4 ? FOUR_COLOUR_WEIGHTS[best_index] : THREE_COLOUR_WEIGHTS[best_index];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        fitted_points[fitted_count][c] = block.rgba[i][c];
+                    }
+                    ++fitted_count;
+                }
+                indices |= (uint32_t)best_index << (2 * i);
+            }
+
+            if (error < best_error)
+            {
+                best_error   = error;
+                best_c0      = c0;
+                best_c1      = c1;
+                best_indices = indices;
+            }
+
+            if (best_error == 0 || pass == 2)
+            {
+                break;
+            }
+
+            // Refit against the endpoints as they were actually ordered into c0 and c1.
+            float refit_a[4] = {}, refit_b[4] = {};
+            if (!RefitEndpoints(fitted_points, weights, fitted_count, 3, refit_a, refit_b))
+            {
+                break;
+            }
+            std::memcpy(endpoint_a, refit_a, sizeof(refit_a));
+            std::memcpy(endpoint_b, refit_b, sizeof(refit_b));
+        }
+
+        out[0] = (uint8_t)(best_c0 & 0xFF);
+        out[1] = (uint8_t)(best_c0 >> 8);
+        out[2] = (uint8_t)(best_c1 & 0xFF);
+        out[3] = (uint8_t)(best_c1 >> 8);
+        std::memcpy(out + 4, &best_indices, 4);
+    }
+
+    // BC3 alpha blocks.
+
+    void BuildAlphaPalette(int alpha0, int alpha1, int palette[8])
+    {
+        palette[0] = alpha0;
+        palette[1] = alpha1;
+        if (alpha0 > alpha1)
+        {
+            for (int i = 1; i < 7; ++i)
+            {
+                palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+            }
+        }
+        else
+        {
+            for (int i = 1; i < 5; ++i)
+            {
+                palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    void EncodeAlphaBlock(const Block& block, uint8_t out[8])
+    {
+        int lowest = 255, highest = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            lowest  = std::min(lowest, (int)block.rgba[i][3]);
+            highest = std::max(highest, (int)block.rgba[i][3]);
+        }
+
+        out[0] = (uint8_t)highest;
+        out[1] = (uint8_t)lowest;
+
+        int palette[8];
+        BuildAlphaPalette(highest, lowest, palette);
+
+        uint64_t bits = 0;
+        if (highest != lowest)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                int best_index = 0;
+                int best_distance = std::numeric_limits<int>::max();
+                for (int entry = 0; entry < 8; ++entry)
+                {
+                    const int distance = std::abs(palette[entry] - block.rgba[i][3]);
+                    if (distance < best_distance)
+                    {
+                        best_distance = distance;
+                        best_index = entry;
+                    }
+                }
+                bits |= (uint64_t)best_index << (3 * i);
+            }
+        }
+
+        for (int i = 0; i < 6; ++i)
+        {
+            out[2 + i] = (uint8_t)(bits >> (8 * i));
+        }
+    }
+
+    // BC7 mode 6 blocks.
+
+    struct BitWriter
+    {
+        uint8_t* out;
+        int      position = 0;
+
+        void Write(uint32_t value, int bit_count)
+        {
+            for (int i = 0; i < bit_count; ++i, ++position)
+            {
+                if ((value >> i) & 1)
+                {
+                    out[position >> 3] |= (uint8_t)(1 << (position & 7));
+                }
+            }
+        }
+    };
+
+    struct BitReader
+    {
+        const uint8_t* in;
+        int            position = 0;
+
+        uint32_t Read(int bit_count)
+        {
+            uint32_t value = 0;
+            for (int i = 0; i < bit_count; ++i, ++position)
+            {
+                value |= (uint32_t)((in[position >> 3] >> (position & 7)) & 1) << i;
+            }
+            return value;
+        }
+    };
+
+    // Maps a blend weight out of 64 to the closest BC7 4-bit index.
+    struct Bc7IndexTable
+    {
+        uint8_t nearest[65];
+
+        Bc7IndexTable()
+        {
+            for (int weight = 0; weight <= 64; ++weight)
+            {
+                int best = 0;
+                for (int index = 1; index < 16; ++index)
+                {
+                    if (std::abs(BC7_WEIGHTS[index] - weight) < std::abs(BC7_WEIGHTS[best] - weight))
+                    {
+                        best = index;
+                    }
+                }
+                nearest[weight] = (uint8_t)best;
+            }
+        }
+    };
+
+    const Bc7IndexTable& GetBc7IndexTable()
+    {
+        static const Bc7IndexTable table;
+        return table;
+    }
+
+    int InterpolateBc7(int e0, int e1, int index)
+    {
+        return ((64 - BC7_WEIGHTS[index]) * e0 + BC7_WEIGHTS[index] * e1 + 32) >> 6;
+    }
+
+    // Picks an index per pixel for the given expanded 8-bit endpoints and returns the squared
+    // error. The palette lies on the segment between the endpoints, so projecting onto it and
+    // checking the neighbouring steps finds the best entry without a full search.
+    int AssignBc7Indices(const Block& block, const int e0[4], const int e1[4], uint8_t indices[16])
+    {
+        int direction[4];
+        int length_squared = 0;
+        for (int c = 0; c < 4; ++c)
+        {
+            direction[c] = e1[c] - e0[c];
+            length_squared += direction[c] * direction[c];
+        }
+
+        const Bc7IndexTable& table = GetBc7IndexTable();
+        int total_error = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            int guess = 0;
+            if (length_squared > 0)
+            {
+                int dot = 0;
+                for (int c = 0; c < 4; ++c)
+                {
+                    dot += (block.rgba[i][c] - e0[c]) * direction[c];
+                }
+                const int weight = std::min(64, std::max(0, (dot * 64 + length_squared / 2) / length_squared));
+                guess = table.nearest[weight];
+            }
+
+            int best_index = guess;
+            int best_error = std::numeric_limits<int>::max();
+            for (int index = std::max(0, guess - 1); index <= std::min(15, guess + 1); ++index)
+            {
+                int error = 0;
+                for (int c = 0; c < 4; ++c)
+                {
+                    const int delta = InterpolateBc7(e0[c], e1[c], index) - block.rgba[i][c];
+                    error += delta * delta;
+                }
+                if (error < best_error)
+                {
+                    best_error = error;
+                    best_index = index;
+                }
+            }
+
+            indices[i] = (uint8_t)best_index;
+            total_error += best_error;
+        }
+
+        return total_error;
+    }
+
+    // Quantizes an endpoint to 7 bits per channel for a given p-bit (the shared low bit).
+    void QuantizeBc7Endpoint(const float value[4], int p_bit, int quantized[4], int expanded[4])
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            quantized[c] = std::min(127, std::max(0, (int)std::lround((value[c] - p_bit) / 2.0f)));
+            expanded[c]  = (quantized[c] << 1) | p_bit;
+        }
+    }
+
+    void EncodeBc7Block(const Block& block, uint8_t out[16])
+    {
+        float points[16][4];
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                points[i][c] = block.rgba[i][c];
+            }
+        }
+
+        float mean[4], axis[4];
+        ComputePrincipalAxis(points, 16, 4, mean, axis);
+
+        float min_t = std::numeric_limits<float>::max();
+        float max_t = -std::numeric_limits<float>::max();
+        for (int i = 0; i < 16; ++i)
+        {
+            float t = 0.0f;
+            for (int c = 0; c < 4; ++c)
+            {
+                t += (points[i][c] - mean[c]) * axis[c];
+            }
+            min_t = std::min(min_t, t);
+            max_t = std::max(max_t, t);
+        }
+
+        float endpoint_a[4], endpoint_b[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            endpoint_a[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * min_t));
+            endpoint_b[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * max_t));
+        }
+
+        int best_error = std::numeric_limits<int>::max();
+        int best_quantized[2][4] = {};
+        int best_p_bits[2] = {};
+        uint8_t best_indices[16] = {};
+
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            // Every p-bit pairing is tried; which one wins depends on where the endpoints fall.
+            for (int p0 = 0; p0 < 2; ++p0)
+            {
+                for (int p1 = 0; p1 < 2; ++p1)
+                {
+                    int quantized[2][4], expanded[2][4];
+                    QuantizeBc7Endpoint(endpoint_a, p0, quantized[0], expanded[0]);
+                    QuantizeBc7Endpoint(endpoint_b, p1, quantized[1], expanded[1]);
+
+                    uint8_t indices[16];
+                    const int error = AssignBc7Indices(block, expanded[0], expanded[1], indices);
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        std::memcpy(best_quantized, quantized, sizeof(quantized));
+                        best_p_bits[0] = p0;
+                        best_p_bits[1] = p1;
+                        std::memcpy(best_indices, indices, sizeof(indices));
+                    }
+                }
+            }
+
+            if (best_error == 0 || pass == 2)
+            {
+                break;
+            }
+
+            float weights[16];
+            for (int i = 0; i < 16; ++i)
+            {
+                weights[i] = BC7_WEIGHTS[best_indices[i]] / 64.0f;
+            }
+            if (!RefitEndpoints(points, weights, 16, 4, endpoint_a, endpoint_b))
+            {
+                break;
+            }
+        }
+
+        // The first index is stored with an implied zero top bit, so swap the endpoints when
+        // it would need one.
+        if (best_indices[0] >= 8)
+        {
+            std::swap(best_quantized[0], best_quantized[1]);
+            std::swap(best_p_bits[0], best_p_bits[1]);
+            for (int i = 0; i < 16; ++i)
+            {
+                best_indices[i] = (uint8_t)(15 - best_indices[i]);
+            }
+        }
+
+        std::memset(out, 0, 16);
+        BitWriter writer = { out };
+        writer.Write(1 << 6, 7);
+        for (int c = 0; c < 4; ++c)
+        {
+            writer.Write(best_quantized[0][c], 7);
+            writer.Write(best_quantized[1][c], 7);
+        }
+        writer.Write(best_p_bits[0], 1);
+        writer.Write(best_p_bits[1], 1);
+        writer.Write(best_indices[0], 3);
+        for (int i = 1; i < 16; ++i)
+        {
+            writer.Write(best_indices[i], 4);
+        }
+    }
+
+    void DecodeBc7Block(const uint8_t in[16], uint8_t pixels[16][4])
+    {
+        if ((in[0] & 0x7F) != 0x40)
+        {
+            std::memset(pixels, 0, 64);
+            return;
+        }
+
+        BitReader reader = { in, 7 };
+        int quantized[2][4];
+        for (int c = 0; c < 4; ++c)
+        {
+            quantized[0][c] = (int)reader.Read(7);
+            quantized[1][c] = (int)reader.Read(7);
+        }
+        const int p0 = (int)reader.Read(1);
+        const int p1 = (int)reader.Read(1);
+
+        int e0[4], e1[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            e0[c] = (quantized[0][c] << 1) | p0;
+            e1[c] = (quantized[1][c] << 1) | p1;
+        }
+
+        for (int i = 0; i < 16; ++i)
+        {
+            const int index = (int)reader.Read(i == 0 ? 3 : 4);
+            for (int c = 0; c < 4; ++c)
+            {
+                pixels[i][c] = (uint8_t)InterpolateBc7(e0[c], e1[c], index);
+            }
+        }
+    }
+
+    void DecodeColourBlock(const uint8_t in[8], bool always_four_colours, uint8_t pixels[16][4])
+    {
+        const uint16_t c0 = (uint16_t)(in[0] | (in[1] << 8));
+        const uint16_t c1 = (uint16_t)(in[2] | (in[3] << 8));
+        int palette[4][4];
+        BuildColourPalette(c0, c1, always_four_colours, palette);
+
+        uint32_t indices = 0;
+        std::memcpy(&indices, in + 4, 4);
+        for (int i = 0; i < 16; ++i)
+        {
+            const int index = (indices >> (2 * i)) & 3;
+            for (int c = 0; c < 4; ++c)
+            {
+                pixels[i][c] = (uint8_t)palette[index][c];
+            }
+        }
+    }
+
+    void DecodeAlphaBlock(const uint8_t in[8], uint8_t pixels[16][4])
+    {
+        int palette[8];
+        BuildAlphaPalette(in[0], in[1], palette);
+
+        uint64_t bits = 0;
+        for (int i = 0; i < 6; ++i)
+        {
+            bits |= (uint64_t)in[2 + i] << (8 * i);
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            pixels[i][3] = (uint8_t)palette[(bits >> (3 * i)) & 7];
+        }
+    }
+
+    void EncodeBlock(const Block& block, TextureFormat format, uint8_t* out)
+    {
+        switch (format)
+        {
+            case TextureFormat::BC1:
+                EncodeColourBlock(block, true, out);
+                break;
+            case TextureFormat::BC3:
+                EncodeAlphaBlock(block, out);
+                EncodeColourBlock(block, false, out + 8);
+                break;
+            case TextureFormat::BC7:
+                EncodeBc7Block(block, out);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+std::vector<uint8_t> BcEncoder::Encode(const uint8_t* rgba, int width, int height, size_t row_pitch, TextureFormat format, unsigned thread_count)
+{
+    if (!rgba || width <= 0 || height <= 0 || row_pitch < (size_t)width * 4 || !TextureFormats::IsBlockCompressed(format))
+    {
+        return {};
+    }
+
+    const int blocks_x        = (width + 3) / 4;
+    const int blocks_y        = (height + 3) / 4;
+    const size_t block_size   = TextureFormats::BytesPerBlock(format);
+    const size_t output_pitch = TextureFormats::RowPitch(format, width);
+    std::vector<uint8_t> output(output_pitch * blocks_y);
+
+    // Rows of blocks are handed out one at a time so uneven rows (flat sky versus detailed
+    // terrain) still balance across threads.
+    std::atomic<int> next_row{ 0 };
+    auto encode_rows = [&]()
+    {
+        Block block;
+        for (int block_y = next_row++; block_y < blocks_y; block_y = next_row++)
+        {
+            uint8_t* out_row = output.data() + (size_t)block_y * output_pitch;
+            for (int block_x = 0; block_x < blocks_x; ++block_x)
+            {
+                LoadBlock(rgba, row_pitch, width, height, block_x, block_y, block);
+                EncodeBlock(block, format, out_row + (size_t)block_x * block_size);
+            }
+        }
+    };
+
+    unsigned workers = thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min<unsigned>(workers, (unsigned)blocks_y);
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workers; ++i)
+    {
+        threads.emplace_back(encode_rows);
+    }
+    encode_rows();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    return output;
+}
+
+std::vector<uint8_t> BcEncoder::Decode(const uint8_t* blocks, int width, int height, TextureFormat format)
+{
+    if (!blocks || width <= 0 || height <= 0 || !TextureFormats::IsBlockCompressed(format))
+    {
+        return {};
+    }
+
+    const int blocks_x       = (width + 3) / 4;
+    const int blocks_y       = (height + 3) / 4;
+    const size_t block_size  = TextureFormats::BytesPerBlock(format);
+    std::vector<uint8_t> output((size_t)width * height * 4);
+
+    for (int block_y = 0; block_y < blocks_y; ++block_y)
+    {
+        for (int block_x = 0; block_x < blocks_x; ++block_x)
+        {
+            const uint8_t* in = blocks + ((size_t)block_y * blocks_x + block_x) * block_size;
+            uint8_t pixels[16][4];
+            switch (format)
+            {
+                case TextureFormat::BC1:
+                    DecodeColourBlock(in, false, pixels);
+                    break;
+                case TextureFormat::BC3:
+                    DecodeColourBlock(in + 8, true, pixels);
+                    DecodeAlphaBlock(in, pixels);
+                    break;
+                default:
+                    DecodeBc7Block(in, pixels);
+                    break;
+            }
+
+            for (int y = 0; y < 4 && block_y * 4 + y < height; ++y)
+            {
+                for (int x = 0; x < 4 && block_x * 4 + x < width; ++x)
+                {
+                    std::memcpy(output.data() + ((size_t)(block_y * 4 + y) * width + (block_x * 4 + x)) * 4, pixels[y * 4 + x], 4);
+                }
+            }
+        }
+    }
+
+    return output;
+}
+
+double BcEncoder::ComputePsnr(const uint8_t* a, size_t a_pitch, const uint8_t* b, size_t b_pitch, int width, int height)
+{
+    if (!a || !b || width <= 0 || height <= 0)
+    {
+        return 0.0;
+    }
+
+    uint64_t squared_error = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* row_a = a + (size_t)y * a_pitch;
+        const uint8_t* row_b = b + (size_t)y * b_pitch;
+        for (int i = 0; i < width * 4; ++i)
+        {
+            const int delta = (int)row_a[i] - (int)row_b[i];
+            squared_error += (uint64_t)(delta * delta);
+        }
+    }
+
+    if (squared_error == 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    const double mean_squared_error = (double)squared_error / ((double)width * height * 4);
+    return 10.0 * std::log10(255.0 * 255.0 / mean_squared_error);
+}
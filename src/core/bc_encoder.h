@@ -0,0 +1,54 @@
+/**
+ * @file bc_encoder.h
+ * @brief CPU block compression of RGBA8 images into BC1, BC3 and BC7.
+ *
+ * BC1 and BC3 use a principal-axis endpoint fit with a least squares refinement, which is fast
+ * enough to run at load time. BC7 uses mode 6 only (one subset, RGBA endpoints with p-bits and
+ * 16 interpolation steps), searched over every p-bit combination with two refinement passes;
+ * it is noticeably slower and meant to be cached.
+ *
+ * The encoder has no platform dependencies so it can be built and checked on its own. Decode
+ * and ComputePsnr exist so the quality of an encode can be measured against its source.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core\texture_image.h"
+
+namespace BcEncoder
+{
+    /**
+     * @brief Compresses an RGBA8 image into 4x4 blocks.
+     *
+     * Any size is accepted; edge blocks of images that are not a multiple of 4 repeat the last
+     * row and column. Rows of blocks are spread over worker threads.
+     *
+     * @param rgba Pointer to the first row of straight-alpha RGBA8 pixels.
+     * @param width Image width in pixels.
+     * @param height Image height in pixels.
+     * @param row_pitch Bytes from one source row to the next.
+     * @param format BC1, BC3 or BC7.
+     * @param thread_count Worker threads to use, 0 for one per hardware thread.
+     * @return The blocks, row-major, TextureFormats::LevelSize(format, width, height) bytes.
+     * Empty when the arguments are invalid.
+     */
+    std::vector<uint8_t> Encode(const uint8_t* rgba, int width, int height, size_t row_pitch, TextureFormat format, unsigned thread_count = 0);
+
+    /**
+     * @brief Decompresses blocks produced by Encode back into tightly packed RGBA8.
+     *
+     * BC7 decoding only understands mode 6, the only mode Encode writes. Blocks in any other
+     * mode decode as transparent black.
+     */
+    std::vector<uint8_t> Decode(const uint8_t* blocks, int width, int height, TextureFormat format);
+
+    /**
+     * @brief Computes the peak signal-to-noise ratio between two RGBA8 images, over all four channels.
+     *
+     * @return PSNR in dB, or infinity when the images are identical.
+     */
+    double ComputePsnr(const uint8_t* a, size_t a_pitch, const uint8_t* b, size_t b_pitch, int width, int height);
+}
@@ -52,13 +52,17 @@
 #include <algorithm>
 #include <atomic>
 #include <cctype>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <unknwn.h>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <sol_ImGui.h>
 #include <kiero.h>
@@ -69,11 +73,26 @@
 #include <sol/sol.hpp>
 
 #include "core\util.h"
+#include "core\animation_manager.h"
 #include "core\audio_manager.h"
+#include "core\data_table.h"
+#include "core\draw_batch.h"
 #include "core\graphics_api.h"
+#include "core\imgui_ffi.h"
+#include "core\font_manager.h"
 #include "core\forgescript_manager.h"
+#include "core\package_archive.h"
+#include "core\package_manifest.h"
+#include "core\particle_system.h"
+#include "core\resource_preloader.h"
+#include "core\resource_vfs.h"
+#include "core\sdf_font.h"
 #include "core\serpent.h"
+#include "core\string_list.h"
+#include "core\text_buffer.h"
+#include "core\texture_loader.h"
 #include "core\ui_manager.h"
+#include "core\virtual_widgets.h"
 
 // ╔═══════════════════════════════════════════════════════════════════════════╗
 // ║                             Forward Declarations                          ║
@@ -85,6 +104,8 @@ void OnGraphicsApiInvoke(void* params);
 void LoadConfiguration();
 void LogConfigValues();
 void InitializeLua();
+void StartPackagePreload(ForgeScript* script);
+void PreloadPackageFonts();
 void InitializeUiForgeLuaBindings(sol::state_view lua);
 void InitializeUiForgeLuaGlobalVariables(sol::table uiforge_table);
 void InitializeGraphicsApiLuaBindings(sol::table uiforge_table, sol::state_view lua);
@@ -125,6 +146,10 @@ plog::Severity logging_level;
 // Graphics API selection ("auto", "d3d11", or "d3d12")
 std::string graphics_api_name = "auto";
 
+// Texture cache (see TextureLoader)
+std::string texture_cache_dir;
+unsigned int texture_cache_max_mb = 256;
+
 // Script reloading
 int reload_on_save = 0;
 int reload_on_save_poll_ms = 2500;
@@ -137,10 +162,6 @@ std::string uiforge_modules_dir;
 std::string uiforge_resources_dir;
 std::string uiforge_profiles_dir;
 
-// Fonts loaded through UiForge.LoadFont, keyed by "<resolved path>|<size>" so repeat
-// loads (multiple mods, per-frame settings callbacks) reuse the same ImFont.
-static std::unordered_map<std::string, ImFont*> loaded_fonts;
-
 // For cleanup
 std::atomic<HMODULE> core_module_handle(NULL);  // I actually don't think this needs to be atomic?
 std::atomic<bool> needs_cleanup(false);
@@ -221,6 +242,8 @@ DWORD WINAPI CoreMain(LPVOID unused_param)
         PLOG_INFO << "Logging initialized";
 
         LogConfigValues();  // Logging config values here because I have to wait until logging is initialized before I can!
+
+        TextureLoader::ConfigureCache(texture_cache_dir, (uint64_t)texture_cache_max_mb * 1024 * 1024);
     }
     catch(const std::exception& err)
     {
@@ -375,12 +398,20 @@ void OnGraphicsApiInvoke(void* params)
                 throw std::runtime_error("Failed to initialize Graphics API ImGui Implementation.");
             }
             imgui_impl_initialized = true;
+            PLOG_DEBUG << "Pixel conversion kernels: " << PixelConvert::GetSimdLevelName();
+
+            PLOG_DEBUG << "Preloading package fonts";
+            PreloadPackageFonts();
 
             if (!settings_icon_file.empty())
             {
                 PLOG_DEBUG << "Loading Settings Icon Texture";
                 const std::filesystem::path icon_path = std::filesystem::path(uiforge_resources_dir) / settings_icon_file;
-                settings_icon = graphics_api->CreateTextureFromFile(icon_path.wstring());
+                // The icon is always drawn at its configured size, so nothing larger is kept resident.
+                TextureLoadOptions icon_options;
+                icon_options.max_width  = (int)settings_icon_size_x;
+                icon_options.max_height = (int)settings_icon_size_y;
+                settings_icon = TextureLoader::LoadFromFile(icon_path, icon_options);
             }
 
             PLOG_DEBUG << "Done with graphics initialization";
@@ -480,6 +511,7 @@ void LoadConfiguration()
     uiforge_modules_dir = std::string(uiforge_scripts_dir + "\\" + GET_CONFIG_VAL(config_parent_dir, std::string, "FORGE_MODULES_DIR"));
 
     uiforge_resources_dir = std::string(uiforge_scripts_dir + "\\" + GET_CONFIG_VAL(config_parent_dir, std::string, "FORGE_RESOURCES_DIR"));
+    ResourceVfs::SetSharedDirectory(uiforge_resources_dir);
 
     uiforge_profiles_dir = std::string(uiforge_scripts_dir + "\\profiles");
 
@@ -501,6 +533,25 @@ void LoadConfiguration()
 
     logging_level  = static_cast<plog::Severity>(GET_CONFIG_VAL(config_parent_dir, unsigned int, "LOGGING_LEVEL"));
 
+    // Optional keys, so configs from older releases keep working.
+    try
+    {
+        texture_cache_dir = config_parent_dir + "\\" + GET_CONFIG_VAL(config_parent_dir, std::string, "TEXTURE_CACHE_DIR");
+    }
+    catch(const std::exception&)
+    {
+        texture_cache_dir = config_parent_dir + "\\cache\\textures";
+    }
+
+    try
+    {
+        texture_cache_max_mb = GET_CONFIG_VAL(config_parent_dir, unsigned int, "TEXTURE_CACHE_MAX_MB");
+    }
+    catch(const std::exception&)
+    {
+        texture_cache_max_mb = 256;
+    }
+
     try
     {
         graphics_api_name = GET_CONFIG_VAL(config_parent_dir, std::string, "GRAPHICS_API");
@@ -529,12 +580,57 @@ void LogConfigValues()
     PLOG_DEBUG << "Settings icon file: " << settings_icon_file;
     PLOG_DEBUG << "Settings icon size x: " << settings_icon_size_x;
     PLOG_DEBUG << "Settings icon size y: " << settings_icon_size_y;
+    PLOG_DEBUG << "Texture cache directory: " << texture_cache_dir;
+    PLOG_DEBUG << "Texture cache max MB: " << texture_cache_max_mb;
     PLOG_DEBUG << "Max log size: " << max_log_size;
     PLOG_DEBUG << "Max log files: " << max_log_files;
     PLOG_DEBUG << "Log file name: " << log_file_name;
     PLOG_DEBUG << "Logging level: " << static_cast<int>(logging_level);
 }
 
+/**
+ * @brief Registers the sol2 ImGui bindings on the first lookup of a global they define.
+ *
+ * sol_ImGui::Init creates every ImGui function, enum table and usertype at once, which is most
+ * of the cost of InitializeLua and of the baseline Lua heap. Every global it defines starts with
+ * "Im" (ImGui, ImGuiWindowFlags, ImVec2, ...), so until it has run the globals table carries this
+ * __index: a miss on such a name runs Init and then looks the name up again. The metatable is
+ * removed before Init runs, so later global misses (and a failed Init) cost nothing extra.
+ */
+static int LazyImGuiBindingsIndex(lua_State* L)
+{
+    // [globals, key]
+    if (lua_type(L, 2) != LUA_TSTRING || std::strncmp(lua_tostring(L, 2), "Im", 2) != 0)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushnil(L);
+    lua_setmetatable(L, LUA_GLOBALSINDEX);
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const int heap_kb_before = lua_gc(L, LUA_GCCOUNT, 0);
+    try
+    {
+        sol::state_view lua(L);
+        sol_ImGui::Init(lua);
+        StringList::InstallWidgetOverloads(L);
+        TextBuffer::InstallWidgetOverloads(L);
+    }
+    catch (const std::exception& err)
+    {
+        PLOG_ERROR << "Failed to register the ImGui Lua bindings: " << err.what();
+    }
+    const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+    PLOG_INFO << "ImGui Lua bindings registered on first use of " << lua_tostring(L, 2) << " in " << elapsed_us / 1000.0
+              << " ms (+" << lua_gc(L, LUA_GCCOUNT, 0) - heap_kb_before << " KB Lua heap)";
+
+    lua_pushvalue(L, 2);
+    lua_rawget(L, LUA_GLOBALSINDEX);
+    return 1;
+}
+
 /**
  * @brief Initializes the Lua state and sets up Lua bindings.
  *
@@ -546,6 +642,8 @@ void LogConfigValues()
  */
 void InitializeLua()
 {
+    const auto start_time = std::chrono::steady_clock::now();
+
     // Lua state
     uif_lua_state = lua_open();
     if(!uif_lua_state)
@@ -568,6 +666,14 @@ void InitializeLua()
     script_manager->SetProfilesDirectory(uiforge_profiles_dir);
     script_manager->SetModulesDirectory(uiforge_modules_dir);
 
+    // Start decoding what the packages declare now, so it overlaps the wait for the first frame.
+    // Packages found later by a script refresh start as they are added.
+    for (unsigned i = 0; i < script_manager->GetScriptCount(); ++i)
+    {
+        StartPackagePreload(script_manager->GetScript(i));
+    }
+    script_manager->SetPackageAddedCallback(StartPackagePreload);
+
     // Need the sol::state_view to initialize the sol bindings
     sol::state_view uif_sol_state_view(uif_lua_state);
 
@@ -579,48 +685,191 @@ void InitializeLua()
     // Initialize UiForge specific Lua bindings
     InitializeUiForgeLuaBindings(uif_sol_state_view);
 
-    // Initialize ImGui Lua bindings
-    sol_ImGui::Init(uif_sol_state_view);
+    // The ImGui Lua bindings are registered the first time a script looks one of them up.
+    lua_newtable(uif_lua_state);
+    lua_pushcfunction(uif_lua_state, LazyImGuiBindingsIndex);
+    lua_setfield(uif_lua_state, -2, "__index");
+    lua_setmetatable(uif_lua_state, LUA_GLOBALSINDEX);
+
+    // Opt-in FFI fast path for the hottest ImGui calls: require("imgui_ffi"). See imgui_ffi.h.
+    ImGuiFfi::Install(uif_lua_state);
+
+    const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+    PLOG_INFO << "Lua initialized in " << elapsed_us / 1000.0 << " ms (" << lua_gc(uif_lua_state, LUA_GCCOUNT, 0) << " KB Lua heap)";
 
     // Auto-apply the preferred profile for this process, if one is configured.
     script_manager->ApplyPreferredProfile();
 }
 
 
+// Manifests of the packages discovered so far, by package directory. Each is read once.
+static std::unordered_map<std::string, PackageManifest> package_manifests;
+
+/**
+ * @brief Reads a script package's manifest.lua and queues the textures and sounds it declares
+ * on ResourcePreloader's workers. Does nothing for loose scripts and packages already seen.
+ */
+void StartPackagePreload(ForgeScript* script)
+{
+    if (!script || script->GetPackageDirectory().empty() || package_manifests.count(script->GetPackageDirectory()))
+    {
+        return;
+    }
+
+    PackageManifest& manifest = package_manifests[script->GetPackageDirectory()];
+    if (PackageManifest::Read(uif_lua_state, script->GetPackageDirectory(), script->GetPackageResourcesDir(), manifest))
+    {
+        ResourcePreloader::Start(script->GetPackageDirectory(), manifest);
+    }
+}
+
+/**
+ * @brief Loads the fonts every script package declares in its manifest.lua.
+ *
+ * Called once ImGui is initialized and before the first frame, so the fonts are in the atlas
+ * before any script runs. Their glyphs are rasterized at the start of that first frame (see
+ * FontManager::BakePending()). Fonts of packages discovered after this load on first use.
+ */
+void PreloadPackageFonts()
+{
+    for (const auto& [package_dir, manifest] : package_manifests)
+    {
+        for (const ManifestFont& font : manifest.fonts)
+        {
+            FontManager::Preload(font.path, font.sizes, font.glyph_ranges);
+        }
+    }
+}
+
+
 /**
  * @brief Resolves a script-supplied resource path to a full filesystem path.
  *
  * Relative paths are resolved against the currently executing packaged script's own
  * resources folder first (when it exists there), then fall back to the shared
- * resources directory. Absolute paths are returned unchanged.
+ * resources directory. Absolute paths are returned unchanged. Lookups are answered
+ * from ResourceVfs's in-memory index rather than by probing the disk.
  *
  * @param path The path as provided by the Lua script.
  * @return The resolved filesystem path.
  */
 static std::filesystem::path ResolveResourcePath(const std::string& path)
 {
-    std::filesystem::path resource_path(path);
-    if (!resource_path.is_relative())
+    ForgeScript* current_script = script_manager ? script_manager->GetCurrentlyExecutingScript() : nullptr;
+    return ResourceVfs::Resolve(path, current_script ? current_script->GetPackageResourcesDir() : std::string());
+}
+
+// Like ResolveResourcePath, for loaders that can only open real files (MCI, WIC decoders,
+// the SDF font mapper). Files inside a mounted .ufpak archive are extracted to the temp cache
+// and that copy's path is returned; an empty path means the archived file is missing.
+static std::filesystem::path ResolveResourceFile(const std::string& path)
+{
+    return PackageArchive::ExtractToCache(ResolveResourcePath(path));
+}
+
+// Owner tag for resources created by the running script, or 0 (the core) outside of one.
+// Whatever a script still owns is released when it is disabled or reloaded.
+static uint32_t CurrentResourceOwner()
+{
+    ForgeScript* current_script = script_manager ? script_manager->GetCurrentlyExecutingScript() : nullptr;
+    return current_script ? current_script->GetResourceOwner() : 0;
+}
+
+// Finds a module the way the package.path patterns do ("<root>\\?.lua" and "<root>\\?\\?.lua"),
+// first in the script's own package modules folder (loose or archived), then in the shared
+// modules folder of every mounted archive. Returns "" when it is in none of them.
+static std::string FindPackageModule(ForgeScript* script, const std::string& module_name)
+{
+    std::string relative = module_name;
+    std::replace(relative.begin(), relative.end(), '.', '\\');
+
+    std::vector<std::filesystem::path> module_roots;
+    if (script && !script->GetPackageModulesDir().empty())
     {
-        return resource_path;
+        module_roots.emplace_back(script->GetPackageModulesDir());
+    }
+    const std::filesystem::path modules_dir_name = std::filesystem::path(uiforge_modules_dir).filename();
+    for (const std::filesystem::path& archive_path : PackageArchive::GetMountedPaths())
+    {
+        module_roots.push_back(archive_path / modules_dir_name);
     }
 
-    if (script_manager)
+    for (const std::filesystem::path& root : module_roots)
     {
-        ForgeScript* current_script = script_manager->GetCurrentlyExecutingScript();
-        if (current_script && !current_script->GetPackageResourcesDir().empty())
+        for (const std::filesystem::path& candidate : { root / (relative + ".lua"), root / relative / (relative + ".lua") })
         {
-            const std::filesystem::path local_path =
-                std::filesystem::path(current_script->GetPackageResourcesDir()) / resource_path;
             std::error_code ec;
-            if (std::filesystem::exists(local_path, ec))
+            if (PackageArchive::ContainsFile(candidate) || std::filesystem::is_regular_file(candidate, ec))
             {
-                return local_path;
+                return candidate.string();
             }
         }
     }
+    return std::string();
+}
+
+/**
+ * @brief package.loaders searcher for modules private to the running script's package and for
+ * modules inside mounted .ufpak archives.
+ *
+ * Consults the currently executing script directly, so package.path never has to change per
+ * script. Where a module was found (or that it was not) is cached on the script (see
+ * ForgeScript::CacheModulePath), so a module that has to be loaded again for the same script
+ * does not probe the filesystem. Reloads do re-probe: ForgeScript::ApplyReload clears the cache,
+ * since files may have been added, and so do module file changes seen by the file watcher and a
+ * cached file that has gone away. Archived entries are loaded straight from the archive mapping,
+ * precompiled bytecode included. Modules it does not find fall through to the package.path
+ * searcher.
+ *
+ * @return 1: the loaded chunk, or a message saying where the module was not found.
+ */
+static int PackageModuleSearcher(lua_State* L)
+{
+    const std::string module_name = luaL_checkstring(L, 1);
+    ForgeScript* current_script = script_manager ? script_manager->GetCurrentlyExecutingScript() : nullptr;
+
+    std::string module_path;
+    if (!current_script || !current_script->FindCachedModulePath(module_name, module_path))
+    {
+        module_path = FindPackageModule(current_script, module_name);
+        if (current_script)
+        {
+            current_script->CacheModulePath(module_name, module_path);
+        }
+    }
 
-    return std::filesystem::path(uiforge_resources_dir) / resource_path;
+    if (module_path.empty())
+    {
+        lua_pushfstring(L, "\n\tno module '%s' in the script's package or in mounted archives", module_name.c_str());
+        return 1;
+    }
+
+    ArchiveFile module_file;
+    int load_result = LUA_OK;
+    if (PackageArchive::ReadFile(module_path, module_file))
+    {
+        const std::string chunk_name = "@" + module_path;
+        load_result = luaL_loadbuffer(L, module_file.data, module_file.size, chunk_name.c_str());
+    }
+    else
+    {
+        load_result = luaL_loadfile(L, module_path.c_str());
+    }
+
+    if (load_result == LUA_ERRFILE && current_script)
+    {
+        // The file went away since it was cached; look again next time.
+        lua_pop(L, 1);
+        current_script->ClearModulePathCache();
+        lua_pushfstring(L, "\n\tno file '%s' (removed)", module_path.c_str());
+        return 1;
+    }
+    if (load_result != LUA_OK)
+    {
+        return luaL_error(L, "error loading module '%s' from file '%s':\n\t%s",
+                          module_name.c_str(), module_path.c_str(), lua_tostring(L, -1));
+    }
+    return 1;
 }
 
 /**
@@ -666,124 +915,175 @@ void InitializeUiForgeLuaBindings(sol::state_view lua)
     //   - scripts\modules\subdir\module\init.lua
     lua["package"]["path"] = lua["package"]["path"].get<std::string>() + ";" + uiforge_modules_dir + "\\?.lua;" + uiforge_modules_dir + "\\?\\?.lua";
 
+    // Package-local modules and modules inside mounted .ufpak archives are found by their own
+    // searcher, right after package.preload's and ahead of the package.path searcher, so they
+    // take precedence over the shared modules directory.
+    lua_State* L = lua.lua_state();
+    lua_getglobal(L, "package");
+    lua_getfield(L, -1, "loaders");
+    for (int i = (int)lua_objlen(L, -1); i >= 2; --i)
+    {
+        lua_rawgeti(L, -1, i);
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_pushcfunction(L, PackageModuleSearcher);
+    lua_rawseti(L, -2, 2);
+    lua_pop(L, 2);
+
     // Initialize Graphics API bindings
     InitializeGraphicsApiLuaBindings(uiforge_table, lua);
 
-    uiforge_table["LoadTexture"] = [](const std::string& path) -> void*
+    // Loads an image file into a texture. The optional options table supports:
+    //   compression   "none" (default), "bc1", "bc3" or "bc7"
+    //   max_width     largest width the image is drawn at; larger images are shrunk to fit
+    //   max_height    largest height the image is drawn at
+    //   filter        "lanczos" (default) or "box", used when shrinking
+    //   mipmaps       true to build a full mip chain
+    // The processed texture is cached on disk, so later loads skip decoding, resizing and
+    // encoding. See TextureLoader. A texture the package's manifest.lua declares with the same
+    // options was already prepared in the background and is only uploaded here.
+    uiforge_table["LoadTexture"] = [](const std::string& path, sol::optional<sol::table> options) -> void*
     {
-        if (!IGraphicsApi::CreateTextureFromFile)
+        TextureLoadOptions load_options;
+        if (options)
         {
-            return nullptr;
+            PackageManifest::ReadTextureOptions(*options, "LoadTexture", load_options);
         }
 
-        return IGraphicsApi::CreateTextureFromFile(ResolveResourcePath(path).wstring());
+        const std::filesystem::path texture_path = ResolveResourcePath(path);
+        void* texture = nullptr;
+        if (std::unique_ptr<PreparedTexture> prepared = ResourcePreloader::TakeTexture(texture_path, load_options))
+        {
+            texture = TextureLoader::Upload(*prepared);
+        }
+        if (!texture)
+        {
+            texture = TextureLoader::LoadFromFile(texture_path, load_options);
+        }
+        return IGraphicsApi::RegisterScriptTexture(texture, CurrentResourceOwner());
+    };
+
+    // Reports whether a resource the package's manifest.lua declares has finished preloading,
+    // so a script can wait for it instead of stalling a frame in LoadTexture/LoadSound. Paths
+    // resolve like LoadTexture. Resources no manifest declares are always ready.
+    uiforge_table["IsResourceReady"] = [](const std::string& path) -> bool
+    {
+        return ResourcePreloader::IsReady(ResolveResourcePath(path));
+    };
+
+    // Returns how many of the running package's declared textures and sounds have finished
+    // preloading, and how many it declares: finished, total. Both are 0 outside a package or
+    // for a package without a manifest.
+    uiforge_table["GetPreloadProgress"] = []() -> std::tuple<size_t, size_t>
+    {
+        ForgeScript* current_script = script_manager ? script_manager->GetCurrentlyExecutingScript() : nullptr;
+        if (!current_script || current_script->GetPackageDirectory().empty())
+        {
+            return { 0, 0 };
+        }
+
+        const PreloadProgress progress = ResourcePreloader::GetProgress(current_script->GetPackageDirectory());
+        return { progress.finished, progress.total };
     };
 
     // Loads a TTF/OTF font for use with ImGui.PushFont. Relative paths resolve the same
     // way as LoadTexture (package resources folder first, then shared resources). Size is
     // in pixels; pass nothing (or 0) to use ImGui's default size and size it at PushFont
-    // time. On any failure the default font is returned so PushFont is always safe.
+    // time. On any failure the default font is returned so PushFont is always safe. Fonts a
+    // package declares in its manifest.lua are already loaded and rasterized by then.
     lua.new_usertype<ImFont>("ImFont", sol::no_constructor);
     uiforge_table["LoadFont"] = [](const std::string& path, sol::optional<float> size_px) -> ImFont*
     {
-        if (!ImGui::GetCurrentContext())
-        {
-            PLOG_WARNING << "LoadFont called before ImGui was initialized: " << path;
-            return nullptr;
-        }
-
-        ImGuiIO& io = ImGui::GetIO();
-        ImFont* fallback = io.FontDefault ? io.FontDefault
-                         : (io.Fonts->Fonts.empty() ? nullptr : io.Fonts->Fonts[0]);
-
-        const float size = (size_px && *size_px > 0.0f) ? *size_px : 0.0f;
-        const std::filesystem::path font_path = ResolveResourcePath(path);
-        const std::string cache_key = font_path.string() + "|" + std::to_string(size);
+        return FontManager::Load(ResolveResourcePath(path), size_px ? *size_px : 0.0f, CurrentResourceOwner());
+    };
 
-        auto cached = loaded_fonts.find(cache_key);
-        if (cached != loaded_fonts.end())
+    // Creates a texture from raw pixel bytes. Accepts the pixels as a Lua string so FFI buffers
+    // can be passed via ffi.string(buf, len). Without options the bytes are tightly packed 32-bit
+    // RGBA with straight alpha. The options table describes anything else:
+    //   format        "rgba" (default), "bgra", "rgb" or "gray"
+    //   row_pitch     bytes from one row to the next, default tightly packed
+    //   premultiplied true when the colour channels are already multiplied by alpha
+    // Conversion happens while the pixels are copied for upload. Returns a texture handle usable
+    // with ImGui.Image, or nil on failure. Release with UiForge.ReleaseTexture when no longer needed.
+    uiforge_table["CreateTextureFromMemory"] = [](const std::string& pixels, int width, int height, sol::optional<sol::table> options) -> void*
+    {
+        if (!IGraphicsApi::CreateTextureFromMemory)
         {
-            return cached->second;
+            return nullptr;
         }
 
-        // If we fails to find the font we just cache the default imgui font,
-        // so a script asking for a missing font every frame will only warn
-        // us once in the log  instead of retrying and flooding the log with
-        // a ton of the same error/warning logs.
-        std::error_code ec;
-        if (!std::filesystem::exists(font_path, ec))
+        PixelLayout layout;
+        if (options)
         {
-            PLOG_WARNING << "LoadFont could not find \"" << font_path.string() << "\". Falling back to the default font.";
-            loaded_fonts[cache_key] = fallback;
-            return fallback;
+            const std::string format_name = options->get_or<std::string>("format", "rgba");
+            if (!PixelConvert::ParseFormat(format_name, layout.format))
+            {
+                PLOG_WARNING << "CreateTextureFromMemory: unknown pixel format \"" << format_name
+                             << "\" (expected rgba, bgra, rgb or gray).";
+                return nullptr;
+            }
+            // Read signed so a negative pitch is rejected rather than wrapped to a huge one.
+            const int64_t row_pitch = options->get_or<int64_t>("row_pitch", 0);
+            const size_t row_bytes  = PixelConvert::BytesPerPixel(layout.format) * (size_t)std::max(width, 0);
+            if (row_pitch < 0 || (row_pitch > 0 && (uint64_t)row_pitch < row_bytes))
+            {
+                PLOG_WARNING << "CreateTextureFromMemory: row_pitch " << row_pitch << " is smaller than one row of "
+                             << width << " " << format_name << " pixels (" << row_bytes << " bytes).";
+                return nullptr;
+            }
+            layout.row_pitch     = (size_t)row_pitch;
+            layout.premultiplied = options->get_or("premultiplied", false);
         }
 
-        // NoLoadError keeps a bad file from tripping ImGui's assert path.
-        ImFontConfig font_config;
-        font_config.Flags |= ImFontFlags_NoLoadError;
-        ImFont* font = io.Fonts->AddFontFromFileTTF(font_path.string().c_str(), size, &font_config);
-        if (!font)
-        {
-            PLOG_WARNING << "LoadFont failed to load \"" << font_path.string() << "\". Falling back to the default font.";
-            loaded_fonts[cache_key] = fallback;
-            return fallback;
-        }
-
-        PLOG_DEBUG << "Loaded font \"" << font_path.string() << "\" at size " << size;
-        loaded_fonts[cache_key] = font;
-        return font;
-    };
-
-    // Creates a texture from raw 32-bit RGBA pixel bytes (row-major, no row padding).
-    // Accepts the pixels as a Lua string so FFI buffers can be passed via ffi.string(buf, len).
-    // Alpha is standard 0-255. Returns a texture handle usable with ImGui.Image, or nil on failure.
-    // Release with UiForge.ReleaseTexture when no longer needed.
-    uiforge_table["CreateTextureFromMemory"] = [](const std::string& rgba_pixels, int width, int height) -> void*
-    {
-        if (!IGraphicsApi::CreateTextureFromMemory)
+        const size_t required_size = PixelConvert::RequiredSourceSize(layout, width, height);
+        if (required_size == 0)
         {
+            PLOG_WARNING << "CreateTextureFromMemory: invalid size " << width << "x" << height << " with row pitch "
+                         << PixelConvert::SourceRowPitch(layout, width) << ".";
             return nullptr;
         }
-
-        if (width <= 0 || height <= 0
-            || rgba_pixels.size() != static_cast<size_t>(width) * static_cast<size_t>(height) * 4)
+        if (pixels.size() < required_size)
         {
-            PLOG_WARNING << "CreateTextureFromMemory: pixel buffer size " << rgba_pixels.size()
-                         << " does not match " << width << "x" << height << " RGBA (expected "
-                         << static_cast<size_t>(width) * static_cast<size_t>(height) * 4 << " bytes).";
+            PLOG_WARNING << "CreateTextureFromMemory: pixel buffer size " << pixels.size()
+                         << " is too small for " << width << "x" << height << " with row pitch "
+                         << PixelConvert::SourceRowPitch(layout, width) << " (expected at least "
+                         << required_size << " bytes).";
             return nullptr;
         }
 
-        return IGraphicsApi::CreateTextureFromMemory(rgba_pixels.data(), width, height);
+        return IGraphicsApi::RegisterScriptTexture(IGraphicsApi::CreateTextureFromMemory(pixels.data(), width, height, layout), CurrentResourceOwner());
     };
 
-    // Queued rather than freed outright. A script can release a texture at any point in a frame,
-    // including one it has already drawn with, and the handle stays in ImGui's draw list until the
-    // backend renders it.
+    // The handle is invalidated at once, so anything still drawing with it (including earlier in
+    // this frame) draws nothing. The texture itself is queued rather than freed outright, since
+    // frames already submitted may still be using it.
     uiforge_table["ReleaseTexture"] = [](void* texture)
     {
         if (!texture)
         {
             return;
         }
-        IGraphicsApi::QueueTextureRelease(texture);
+        IGraphicsApi::ReleaseScriptTexture(texture);
     };
 
     // Loads a sound file (mp3 or wav) for playback. Relative paths resolve the same way
     // as LoadTexture/LoadFont. Returns a sound handle, or nil when the file is missing
     // or cannot be opened. Repeat loads of the same file return the same handle.
-    uiforge_table["LoadSound"] = [](const std::string& path) -> sol::optional<int>
+    uiforge_table["LoadSound"] = [](const std::string& path) -> sol::optional<ResourceHandle>
     {
-        const std::filesystem::path sound_path = ResolveResourcePath(path);
+        // A declared sound may still be extracting or warming on a preload worker.
+        const std::filesystem::path resolved_path = ResolveResourcePath(path);
+        ResourcePreloader::WaitFor(resolved_path);
+        const std::filesystem::path sound_path = PackageArchive::ExtractToCache(resolved_path);
 
         std::error_code ec;
-        if (!std::filesystem::exists(sound_path, ec))
+        if (sound_path.empty() || !std::filesystem::exists(sound_path, ec))
         {
-            PLOG_WARNING << "LoadSound could not find \"" << sound_path.string() << "\".";
+            PLOG_WARNING << "LoadSound could not find \"" << resolved_path.string() << "\".";
             return sol::nullopt;
         }
 
-        const int sound_id = AudioManager::Load(sound_path.wstring());
+        const ResourceHandle sound_id = AudioManager::Load(sound_path.wstring(), CurrentResourceOwner());
         if (sound_id == 0)
         {
             return sol::nullopt;
@@ -794,7 +1094,7 @@ void InitializeUiForgeLuaBindings(sol::state_view lua)
     // Plays a loaded sound from the beginning. Options table supports volume (0.0 to 1.0,
     // default 1.0) and loop (default false). All sound functions are nil-safe no-ops when
     // given a nil handle, so a failed LoadSound never breaks a script.
-    uiforge_table["PlaySound"] = [](sol::optional<int> sound_id, sol::optional<sol::table> options) -> bool
+    uiforge_table["PlaySound"] = [](sol::optional<ResourceHandle> sound_id, sol::optional<sol::table> options) -> bool
     {
         if (!sound_id)
         {
@@ -811,22 +1111,22 @@ void InitializeUiForgeLuaBindings(sol::state_view lua)
         return AudioManager::Play(*sound_id, volume, loop);
     };
 
-    uiforge_table["StopSound"] = [](sol::optional<int> sound_id) -> bool
+    uiforge_table["StopSound"] = [](sol::optional<ResourceHandle> sound_id) -> bool
     {
         return sound_id ? AudioManager::Stop(*sound_id) : false;
     };
 
-    uiforge_table["IsSoundPlaying"] = [](sol::optional<int> sound_id) -> bool
+    uiforge_table["IsSoundPlaying"] = [](sol::optional<ResourceHandle> sound_id) -> bool
     {
         return sound_id ? AudioManager::IsPlaying(*sound_id) : false;
     };
 
-    uiforge_table["SetSoundVolume"] = [](sol::optional<int> sound_id, double volume) -> bool
+    uiforge_table["SetSoundVolume"] = [](sol::optional<ResourceHandle> sound_id, double volume) -> bool
     {
         return sound_id ? AudioManager::SetVolume(*sound_id, volume) : false;
     };
 
-    uiforge_table["ReleaseSound"] = [](sol::optional<int> sound_id)
+    uiforge_table["ReleaseSound"] = [](sol::optional<ResourceHandle> sound_id)
     {
         if (sound_id)
         {
@@ -834,6 +1134,346 @@ void InitializeUiForgeLuaBindings(sol::state_view lua)
         }
     };
 
+    // Loads an animated image (GIF) or a sprite sheet for playback with DrawAnimation. Relative
+    // paths resolve like LoadTexture. The options table supports:
+    //   frame_width, frame_height   size of one frame; makes the image a sprite sheet
+    //   frame_count                 frames in the sheet, default every full cell
+    //   fps                         sprite sheet playback rate, default 10
+    //   memory_budget_mb            decoded frames kept in memory at once, default 64
+    // Frames are decoded on a worker thread. Returns an animation handle, or nil when the file
+    // is missing. Like sounds, all animation functions are nil-safe.
+    uiforge_table["LoadAnimation"] = [](const std::string& path, sol::optional<sol::table> options) -> sol::optional<ResourceHandle>
+    {
+        AnimationLoadOptions load_options;
+        if (options)
+        {
+            load_options.frame_width    = options->get_or("frame_width", 0);
+            load_options.frame_height   = options->get_or("frame_height", 0);
+            load_options.frame_count    = options->get_or("frame_count", 0);
+            load_options.fps            = options->get_or("fps", 10.0);
+
+            const double budget_mb = options->get_or("memory_budget_mb", 64.0);
+            if (budget_mb > 0.0)
+            {
+                load_options.memory_budget_bytes = (size_t)(budget_mb * 1024.0 * 1024.0);
+            }
+        }
+
+        const ResourceHandle animation_id = AnimationManager::Load(ResolveResourceFile(path), load_options, CurrentResourceOwner());
+        if (animation_id == 0)
+        {
+            return sol::nullopt;
+        }
+        return animation_id;
+    };
+
+    // Draws the current frame of an animation as an image, sized width x height (default the
+    // frame size). Options table supports loop (default true). Timing is kept natively, so this
+    // is the only call a script makes per frame.
+    uiforge_table["DrawAnimation"] = [](sol::optional<ResourceHandle> animation_id, sol::optional<float> width, sol::optional<float> height,
+                                        sol::optional<sol::table> options) -> bool
+    {
+        if (!animation_id)
+        {
+            return false;
+        }
+
+        const bool loop = options ? options->get_or("loop", true) : true;
+        return AnimationManager::Draw(*animation_id, width.value_or(0.0f), height.value_or(0.0f), loop);
+    };
+
+    uiforge_table["RestartAnimation"] = [](sol::optional<ResourceHandle> animation_id)
+    {
+        if (animation_id)
+        {
+            AnimationManager::Restart(*animation_id);
+        }
+    };
+
+    // Returns { ready, failed, streaming, width, height, frame_count, duration }.
+    uiforge_table["GetAnimationInfo"] = [](sol::optional<ResourceHandle> animation_id, sol::this_state state) -> sol::table
+    {
+        const AnimationInfo info = animation_id ? AnimationManager::GetInfo(*animation_id) : AnimationManager::GetInfo(0);
+
+        sol::state_view lua(state);
+        sol::table info_table = lua.create_table();
+        info_table["ready"]         = info.ready;
+        info_table["failed"]        = info.failed;
+        info_table["streaming"]     = info.streaming;
+        info_table["width"]         = info.width;
+        info_table["height"]        = info.height;
+        info_table["frame_count"]   = info.frame_count;
+        info_table["duration"]      = info.duration;
+        return info_table;
+    };
+
+    uiforge_table["ReleaseAnimation"] = [](sol::optional<ResourceHandle> animation_id)
+    {
+        if (animation_id)
+        {
+            AnimationManager::Release(*animation_id);
+        }
+    };
+
+    // Loads a TTF/OTF font as a signed-distance-field font: one atlas serves every size, so
+    // drawing at a new size never rasterizes or uploads anything. Relative paths resolve like
+    // LoadFont. Returns a font handle, or nil when the file cannot be read as a font.
+    uiforge_table["LoadSdfFont"] = [](const std::string& path) -> sol::optional<ResourceHandle>
+    {
+        const ResourceHandle font_id = SdfFontManager::Load(ResolveResourceFile(path), CurrentResourceOwner());
+        if (font_id == 0)
+        {
+            return sol::nullopt;
+        }
+        return font_id;
+    };
+
+    // Draws text with an SDF font at the cursor, size pixels tall. color is an optional
+    // { r, g, b, a } table in 0-1, defaulting to the style's text colour.
+    uiforge_table["SdfText"] = [](sol::optional<ResourceHandle> font_id, const std::string& text, float size,
+                                  sol::optional<sol::table> color) -> bool
+    {
+        if (!font_id)
+        {
+            return false;
+        }
+
+        ImU32 text_color = ImGui::GetColorU32(ImGuiCol_Text);
+        if (color)
+        {
+            text_color = ImGui::GetColorU32(ImVec4(color->get_or(1, 1.0f), color->get_or(2, 1.0f),
+                                                   color->get_or(3, 1.0f), color->get_or(4, 1.0f)));
+        }
+        return SdfFontManager::Text(*font_id, text, size, text_color);
+    };
+
+    // Returns the width and height text would take when drawn with SdfText.
+    uiforge_table["CalcSdfTextSize"] = [](sol::optional<ResourceHandle> font_id, const std::string& text, float size) -> std::tuple<float, float>
+    {
+        const ImVec2 text_size = font_id ? SdfFontManager::CalcTextSize(*font_id, text, size) : ImVec2(0.0f, 0.0f);
+        return std::make_tuple(text_size.x, text_size.y);
+    };
+
+    uiforge_table["ReleaseSdfFont"] = [](sol::optional<ResourceHandle> font_id)
+    {
+        if (font_id)
+        {
+            SdfFontManager::Release(*font_id);
+        }
+    };
+
+    // Draws arrays of circles, rectangles and lines in one call, checking FFI arrays first.
+    DrawBatch::Install(L);
+
+    // Copies an array of strings once into an immutable native list that ImGui.Combo and
+    // ImGui.ListBox accept in place of a table, without converting it on every call.
+    uiforge_table["StringList"] = StringList::LuaCreate;
+
+    // Creates a native text buffer that ImGui.InputText and friends edit in place, so a text
+    // field no longer makes a new Lua string every frame. buffer:Get() returns the text.
+    uiforge_table["TextBuffer"] = TextBuffer::LuaCreate;
+
+    // Row storage for long tables: columns of text that scripts append rows to, drawn by
+    // VirtualTable without calling back into Lua.
+    uiforge_table["DataTable"] = DataTable::LuaCreate;
+
+    // Lists and tables that run an ImGuiListClipper natively and only touch their visible rows,
+    // either by calling a Lua function per visible row or by drawing a StringList or DataTable.
+    uiforge_table["VirtualList"] = VirtualWidgets::LuaVirtualList;
+    uiforge_table["VirtualTable"] = VirtualWidgets::LuaVirtualTable;
+
+    // Creates a native particle system. Options table supports:
+    //   max_particles               capacity, default 10000
+    //   width, height               particles bounce inside (0, 0)-(width, height); default unbounded
+    //   gravity_x, gravity_y        pixels per second squared
+    //   drag                        fraction of velocity lost per second
+    //   bounce                      fraction of speed kept on an edge hit, default 1
+    //   segments                    circle segments, default picked from the radius
+    //   seed                        random seed from 0 to 2^32 - 1, default per system
+    // Returns a particle system handle, or nil when the options are out of range. Like the other
+    // handle functions, the particle functions are nil-safe.
+    uiforge_table["ParticleSystem"] = [](sol::optional<sol::table> options) -> sol::optional<ResourceHandle>
+    {
+        ParticleSystemOptions system_options;
+        if (options)
+        {
+            const double max_particles  = options->get_or("max_particles", 10000.0);
+            system_options.max_particles = max_particles > 0.0 ? (size_t)max_particles : 0;
+            system_options.width        = options->get_or("width", 0.0f);
+            system_options.height       = options->get_or("height", 0.0f);
+            system_options.gravity_x    = options->get_or("gravity_x", 0.0f);
+            system_options.gravity_y    = options->get_or("gravity_y", 0.0f);
+            system_options.drag         = options->get_or("drag", 0.0f);
+            system_options.bounce       = options->get_or("bounce", 1.0f);
+            system_options.segments     = options->get_or("segments", 0);
+
+            // Written so NaN fails too; a cast from outside the uint32_t range is undefined.
+            const double seed = options->get_or("seed", 0.0);
+            if (!(seed >= 0.0 && seed <= (double)UINT32_MAX))
+            {
+                PLOG_ERROR << "Particle system seed must be between 0 and " << UINT32_MAX << ", got " << seed;
+                return sol::nullopt;
+            }
+            system_options.seed         = (uint32_t)seed;
+        }
+
+        const ResourceHandle system_id = ParticleSystemManager::Create(system_options, CurrentResourceOwner());
+        if (system_id == 0)
+        {
+            return sol::nullopt;
+        }
+        return system_id;
+    };
+
+    // Adds or replaces the named emitter, or removes it when options is nil. Options table
+    // supports x, y, rate (per second), burst (spawned once), angle and spread (radians), color,
+    // fade, and speed, lifetime and radius, each either a number or a { min, max } range.
+    uiforge_table["SetParticleEmitter"] = [](sol::optional<ResourceHandle> system_id, const std::string& name, sol::optional<sol::table> options) -> bool
+    {
+        if (!system_id)
+        {
+            return false;
+        }
+        if (!options)
+        {
+            return ParticleSystemManager::SetEmitter(*system_id, name, nullptr);
+        }
+
+        // A number sets both ends of a range; a { min, max } table sets each.
+        auto read_range = [&](const char* key, float& min, float& max)
+        {
+            sol::object value = (*options)[key];
+            if (value.is<float>())
+            {
+                min = max = value.as<float>();
+            }
+            else if (value.is<sol::table>())
+            {
+                sol::table range = value.as<sol::table>();
+                min = range.get_or(1, min);
+                max = range.get_or(2, min);
+            }
+        };
+
+        ParticleEmitterOptions emitter;
+        emitter.x       = options->get_or("x", 0.0f);
+        emitter.y       = options->get_or("y", 0.0f);
+        emitter.rate    = options->get_or("rate", 0.0f);
+        emitter.burst   = options->get_or("burst", 0);
+        emitter.angle   = options->get_or("angle", emitter.angle);
+        emitter.spread  = options->get_or("spread", emitter.spread);
+        emitter.color   = (ImU32)(int64_t)options->get_or("color", (double)IM_COL32_WHITE);
+        emitter.fade    = options->get_or("fade", false);
+        read_range("speed", emitter.speed_min, emitter.speed_max);
+        read_range("lifetime", emitter.lifetime_min, emitter.lifetime_max);
+        read_range("radius", emitter.radius_min, emitter.radius_max);
+        return ParticleSystemManager::SetEmitter(*system_id, name, &emitter);
+    };
+
+    // Spawns from every emitter and advances the simulation by delta_time seconds (default
+    // ImGui's frame time).
+    uiforge_table["UpdateParticles"] = [](sol::optional<ResourceHandle> system_id, sol::optional<float> delta_time)
+    {
+        if (system_id)
+        {
+            ParticleSystemManager::Update(*system_id, delta_time.value_or(ImGui::GetIO().DeltaTime));
+        }
+    };
+
+    // Draws the live particles into the current window's draw list, offset by x, y (default the
+    // cursor's screen position).
+    uiforge_table["DrawParticles"] = [](sol::optional<ResourceHandle> system_id, sol::optional<float> x, sol::optional<float> y)
+    {
+        if (system_id)
+        {
+            const ImVec2 cursor = ImGui::GetCursorScreenPos();
+            ParticleSystemManager::Draw(*system_id, ImGui::GetWindowDrawList(), ImVec2(x.value_or(cursor.x), y.value_or(cursor.y)));
+        }
+    };
+
+    uiforge_table["ClearParticles"] = [](sol::optional<ResourceHandle> system_id)
+    {
+        if (system_id)
+        {
+            ParticleSystemManager::Clear(*system_id);
+        }
+    };
+
+    // Returns { alive, capacity, spawned, expired, bounces, center_x, center_y, update_us }.
+    uiforge_table["GetParticleStats"] = [](sol::optional<ResourceHandle> system_id, sol::this_state state) -> sol::table
+    {
+        const ParticleSystemStats stats = system_id ? ParticleSystemManager::GetStats(*system_id) : ParticleSystemStats();
+
+        sol::state_view lua(state);
+        sol::table stats_table = lua.create_table();
+        stats_table["alive"]        = stats.alive;
+        stats_table["capacity"]     = stats.capacity;
+        stats_table["spawned"]      = stats.spawned;
+        stats_table["expired"]      = stats.expired;
+        stats_table["bounces"]      = stats.bounces;
+        stats_table["center_x"]     = stats.center_x;
+        stats_table["center_y"]     = stats.center_y;
+        stats_table["update_us"]    = stats.update_us;
+        return stats_table;
+    };
+
+    uiforge_table["ReleaseParticleSystem"] = [](sol::optional<ResourceHandle> system_id)
+    {
+        if (system_id)
+        {
+            ParticleSystemManager::Release(*system_id);
+        }
+    };
+
+    // Returns the resource path lookup counters:
+    //   { lookups, package_hits, shared_hits, misses, disk_probes, index_builds, indexed_files,
+    //     total_lookup_us }
+    uiforge_table["GetResourceLookupStats"] = [](sol::this_state state) -> sol::table
+    {
+        const ResourceVfsStats stats = ResourceVfs::GetStats();
+
+        sol::state_view lua(state);
+        sol::table stats_table = lua.create_table();
+        stats_table["lookups"]          = stats.lookups;
+        stats_table["package_hits"]     = stats.package_hits;
+        stats_table["shared_hits"]      = stats.shared_hits;
+        stats_table["misses"]           = stats.misses;
+        stats_table["disk_probes"]      = stats.disk_probes;
+        stats_table["index_builds"]     = stats.index_builds;
+        stats_table["indexed_files"]    = stats.indexed_files;
+        stats_table["total_lookup_us"]  = stats.total_lookup_us;
+        return stats_table;
+    };
+
+    // Resources a script creates are released when it is disabled or reloaded. Keep hands one
+    // over to the core instead, for resources cached somewhere that outlives the script (a
+    // shared module, say); kept resources are released explicitly or on eject. Each returns
+    // whether the handle was valid.
+    uiforge_table["KeepTexture"] = [](void* texture) -> bool
+    {
+        return texture ? IGraphicsApi::KeepScriptTexture(texture) : false;
+    };
+
+    uiforge_table["KeepSound"] = [](sol::optional<ResourceHandle> sound_id) -> bool
+    {
+        return sound_id ? AudioManager::Keep(*sound_id) : false;
+    };
+
+    uiforge_table["KeepAnimation"] = [](sol::optional<ResourceHandle> animation_id) -> bool
+    {
+        return animation_id ? AnimationManager::Keep(*animation_id) : false;
+    };
+
+    uiforge_table["KeepSdfFont"] = [](sol::optional<ResourceHandle> font_id) -> bool
+    {
+        return font_id ? SdfFontManager::Keep(*font_id) : false;
+    };
+
+    uiforge_table["KeepParticleSystem"] = [](sol::optional<ResourceHandle> system_id) -> bool
+    {
+        return system_id ? ParticleSystemManager::Keep(*system_id) : false;
+    };
+
     // ForgeScriptManager Bindings
     sol::table callback_type_table = lua.create_table();
     callback_type_table["Settings"] = static_cast<int>(ForgeScriptCallbackType::Settings);
@@ -937,7 +1577,13 @@ void InitializeGraphicsApiLuaBindings(sol::table uiforge_table, sol::state_view
     PLOG_DEBUG << "[+] Initializing graphics api Lua bindings";
     sol::usertype<IGraphicsApi> graphics_api_type = lua.new_usertype<IGraphicsApi>( "IGraphicsApi",
         sol::no_constructor,
-        "CreateTextureFromFile", IGraphicsApi::CreateTextureFromFile
+        "CreateTextureFromFile", [](const std::string& file_path) -> void*
+        {
+            // Goes through the loader so the texture cache applies here too. Lua strings are
+            // UTF-8; a plain path() would read them in the ANSI code page.
+            return IGraphicsApi::RegisterScriptTexture(TextureLoader::LoadFromFile(std::filesystem::u8path(file_path), TextureLoadOptions()),
+                                                       CurrentResourceOwner());
+        }
     );
 
     uiforge_table["IGraphicsApi"] = graphics_api_type;
@@ -978,14 +1624,27 @@ void CleanupUiForge()
             uif_lua_state = nullptr;
         }
 
-        // Font pointers are owned by the ImGui context and die with it below.
-        loaded_fonts.clear();
-
         PLOG_INFO << "Releasing sounds...";
         AudioManager::ReleaseAll();
 
+        PLOG_INFO << "Releasing animations...";
+        AnimationManager::ReleaseAll();
+
+        PLOG_INFO << "Releasing SDF fonts...";
+        SdfFontManager::ReleaseAll();
+
+        PLOG_INFO << "Releasing particle systems...";
+        ParticleSystemManager::ReleaseAll();
+
+        // Workers may be reading archived files and writing texture cache blobs.
+        ResourcePreloader::Shutdown();
+
+        ResourceVfs::Shutdown();
+
         // Kiero is already shut down so no further frames will be presented, which means anything
-        // the scripts queued on their way out has to be freed here instead of aging out.
+        // the scripts queued on their way out, or never released at all, has to be freed here
+        // instead of aging out.
+        IGraphicsApi::ReleaseAllScriptTextures();
         IGraphicsApi::DrainTextureReleases(true);
 
         if (settings_icon && IGraphicsApi::ReleaseTexture)
@@ -1008,6 +1667,13 @@ void CleanupUiForge()
             ui_manager = nullptr;
         }
 
+        // Font pointers are owned by the ImGui context, which reads straight from the mapped
+        // font files, so the files are only unmapped once it is gone.
+        FontManager::ReleaseAll();
+
+        // Archived fonts and scripts point straight into the archive mappings, so they go last.
+        PackageArchive::UnmountAll();
+
         if(graphics_api)
         {
             PLOG_INFO << "Cleaning up graphics api...";
@@ -0,0 +1,818 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <plog/Log.h>
+
+#include "core\data_table.h"
+#include "core\lua_helpers.h"
+
+namespace
+{
+    constexpr double EMPTY_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+    // Text sorts and filters ignore ASCII case.
+    char Fold(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+
+    int CompareFolded(std::string_view a, std::string_view b)
+    {
+        const size_t length = std::min(a.size(), b.size());
+        for (size_t i = 0; i < length; ++i)
+        {
+            const unsigned char fa = (unsigned char)Fold(a[i]);
+            const unsigned char fb = (unsigned char)Fold(b[i]);
+            if (fa != fb)
+            {
+                return fa < fb ? -1 : 1;
+            }
+        }
+        return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+    }
+
+    // folded_prefix is already folded.
+    bool StartsWithFolded(std::string_view cell, std::string_view folded_prefix)
+    {
+        if (cell.size() < folded_prefix.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < folded_prefix.size(); ++i)
+        {
+            if (Fold(cell[i]) != folded_prefix[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // folded_needle is already folded and not empty.
+    bool ContainsFolded(std::string_view cell, std::string_view folded_needle)
+    {
+        if (cell.size() < folded_needle.size())
+        {
+            return false;
+        }
+        const char first = folded_needle[0];
+        const size_t last_start = cell.size() - folded_needle.size();
+        for (size_t start = 0; start <= last_start; ++start)
+        {
+            if (Fold(cell[start]) == first && StartsWithFolded(cell.substr(start), folded_needle))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // NaN (a cell that is not a number) sorts after every number.
+    int CompareNumbers(double a, double b)
+    {
+        const bool a_nan = std::isnan(a);
+        const bool b_nan = std::isnan(b);
+        if (a_nan || b_nan)
+        {
+            return a_nan == b_nan ? 0 : (a_nan ? 1 : -1);
+        }
+        return a == b ? 0 : (a < b ? -1 : 1);
+    }
+}
+
+// A view being built on the worker thread. Everything it reads is either copied into it or
+// shared and never written again (see DataTable::Writable), so the thread needs no locks; the
+// render thread only looks at done until then.
+struct DataTable::ViewJob
+{
+    struct ColumnOrder
+    {
+        int                             column;
+        std::shared_ptr<const RowList>  cached;     // The column's permutation when the job started
+        std::shared_ptr<const RowList>  order;      // Result, covering every row
+    };
+
+    std::thread         thread;
+    std::atomic<bool>   done { false };
+
+    ViewRequest         request;
+    size_t              rows = 0;
+    uint64_t            generation = 0;
+    std::vector<std::shared_ptr<const ColumnData>>  data;   // nullptr for columns the job does not read
+    std::vector<ColumnType>                         types;
+    std::vector<ColumnOrder>                        orders;
+
+    std::shared_ptr<const RowList>  view;
+
+    ~ViewJob()
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    static std::string_view CellText(const ColumnData& cells, uint32_t row)
+    {
+        const uint32_t begin = cells.offsets[row];
+        const uint32_t end = row + 1 < cells.offsets.size() ? cells.offsets[row + 1] : (uint32_t)cells.text.size();
+        return std::string_view(cells.text.data() + begin, end - begin - 1);
+    }
+
+    // Strict ordering of two rows of a column: by value, then (for text) by exact bytes, then
+    // by row, so equal cells keep their row order and merging stays deterministic.
+    bool RowLess(int column, uint32_t a, uint32_t b) const
+    {
+        const ColumnData& cells = *data[column];
+        int order = 0;
+        if (types[column] == ColumnType::Number)
+        {
+            order = CompareNumbers(cells.numbers[a], cells.numbers[b]);
+        }
+        else
+        {
+            const std::string_view text_a = CellText(cells, a);
+            const std::string_view text_b = CellText(cells, b);
+            order = CompareFolded(text_a, text_b);
+            if (order == 0)
+            {
+                order = text_a.compare(text_b);
+            }
+        }
+        return order != 0 ? order < 0 : a < b;
+    }
+
+    // Extends a column's cached permutation to every row: only the appended rows are sorted,
+    // then merged into the rows that already were.
+    std::shared_ptr<const RowList> ExtendOrder(const ColumnOrder& column_order) const
+    {
+        if (column_order.cached && column_order.cached->size() == rows)
+        {
+            return column_order.cached;
+        }
+
+        auto order = std::make_shared<RowList>();
+        order->reserve(rows);
+        if (column_order.cached)
+        {
+            order->assign(column_order.cached->begin(), column_order.cached->end());
+        }
+        const size_t sorted = order->size();
+        for (size_t row = sorted; row < rows; ++row)
+        {
+            order->push_back((uint32_t)row);
+        }
+
+        const auto less = [this, column = column_order.column](uint32_t a, uint32_t b) { return RowLess(column, a, b); };
+        std::sort(order->begin() + sorted, order->end(), less);
+        std::inplace_merge(order->begin(), order->begin() + sorted, order->end(), less);
+        return order;
+    }
+
+    const RowList* FindOrder(int column) const
+    {
+        for (const ColumnOrder& column_order : orders)
+        {
+            if (column_order.column == column)
+            {
+                return column_order.order.get();
+            }
+        }
+        return nullptr;
+    }
+
+    bool RowMatches(uint32_t row, std::string_view needle) const
+    {
+        const size_t first = request.filter_column >= 0 ? (size_t)request.filter_column : 0;
+        const size_t last = request.filter_column >= 0 ? first + 1 : data.size();
+        for (size_t column = first; column < last; ++column)
+        {
+            const std::string_view cell = CellText(*data[column], row);
+            if (request.prefix ? StartsWithFolded(cell, needle) : ContainsFolded(cell, needle))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Run()
+    {
+        for (ColumnOrder& column_order : orders)
+        {
+            column_order.order = ExtendOrder(column_order);
+        }
+
+        const RowList* sort_order = request.sort_column >= 0 ? FindOrder(request.sort_column) : nullptr;
+        if (request.filter.empty())
+        {
+            view = orders.front().order;
+            return;
+        }
+
+        std::string needle(request.filter);
+        std::transform(needle.begin(), needle.end(), needle.begin(), Fold);
+
+        std::vector<uint8_t> matches(rows, 0);
+        const bool indexed = request.prefix && request.filter_column >= 0 && types[request.filter_column] == ColumnType::Text;
+        if (const RowList* index = indexed ? FindOrder(request.filter_column) : nullptr)
+        {
+            // The rows starting with the prefix are one run of the column's permutation.
+            const ColumnData& cells = *data[request.filter_column];
+            const auto first = std::partition_point(index->begin(), index->end(), [&](uint32_t row)
+            {
+                return CompareFolded(CellText(cells, row), needle) < 0;
+            });
+            const auto last = std::partition_point(first, index->end(), [&](uint32_t row)
+            {
+                return StartsWithFolded(CellText(cells, row), needle);
+            });
+
+            if (request.sort_column == request.filter_column)
+            {
+                view = std::make_shared<RowList>(first, last);
+                return;
+            }
+            for (auto it = first; it != last; ++it)
+            {
+                matches[*it] = 1;
+            }
+        }
+        else
+        {
+            for (size_t row = 0; row < rows; ++row)
+            {
+                matches[row] = RowMatches((uint32_t)row, needle) ? 1 : 0;
+            }
+        }
+
+        auto filtered = std::make_shared<RowList>();
+        if (sort_order)
+        {
+            for (uint32_t row : *sort_order)
+            {
+                if (matches[row])
+                {
+                    filtered->push_back(row);
+                }
+            }
+        }
+        else
+        {
+            for (size_t row = 0; row < rows; ++row)
+            {
+                if (matches[row])
+                {
+                    filtered->push_back((uint32_t)row);
+                }
+            }
+        }
+        view = std::move(filtered);
+    }
+};
+
+namespace
+{
+    // Reads a cell for a column of the given type. Strings are kept as they are, numbers are
+    // formatted the way tostring does, booleans become "true"/"false" and nil an empty cell. A
+    // number column also keeps the value (numeric strings are converted), or NaN.
+    DataTable::Cell ReadCell(lua_State* L, int index, DataTable::ColumnType type)
+    {
+        DataTable::Cell cell;
+        cell.number = EMPTY_NUMBER;
+        switch (lua_type(L, index))
+        {
+            case LUA_TNIL:
+                break;
+            case LUA_TBOOLEAN:
+                cell.text = lua_toboolean(L, index) ? "true" : "false";
+                break;
+            case LUA_TNUMBER:
+            case LUA_TSTRING:
+            {
+                if (type == DataTable::ColumnType::Number && lua_isnumber(L, index))
+                {
+                    cell.number = (double)lua_tonumber(L, index);
+                }
+                size_t length = 0;
+                const char* text = lua_tolstring(L, index, &length);
+                cell.text = std::string_view(text, length);
+                break;
+            }
+            default:
+                luaL_error(L, "DataTable: a cell cannot hold a %s", luaL_typename(L, index));
+                break;
+        }
+        return cell;
+    }
+
+    DataTable* CheckTable(lua_State* L)
+    {
+        DataTable* table = DataTable::Test(L, 1);
+        if (!table)
+        {
+            luaL_typerror(L, 1, DataTable::METATABLE_NAME);
+        }
+        return table;
+    }
+
+    // Reads an optional 1-based column argument as 0-based, or -1 when it is nil.
+    int OptColumn(lua_State* L, int index, const DataTable* table)
+    {
+        if (lua_isnoneornil(L, index))
+        {
+            return -1;
+        }
+        const lua_Integer column = luaL_checkinteger(L, index);
+        luaL_argcheck(L, column >= 1 && (size_t)column <= table->ColumnCount(), index, "column out of range");
+        return (int)column - 1;
+    }
+
+    // table:Append(value, ...) or table:Append(row), where row is an array in column order or
+    // a table keyed by column name
+    int TableAppend(lua_State* L)
+    {
+        DataTable* table = CheckTable(L);
+        const size_t column_count = table->ColumnCount();
+        std::vector<DataTable::Cell> cells(column_count);
+
+        if (lua_gettop(L) == 2 && lua_istable(L, 2))
+        {
+            // The values stay on the stack until Append has copied them.
+            luaL_checkstack(L, (int)column_count, "DataTable: too many columns");
+            for (size_t column = 0; column < column_count; ++column)
+            {
+                lua_rawgeti(L, 2, (int)column + 1);
+                if (lua_isnil(L, -1))
+                {
+                    lua_pop(L, 1);
+                    lua_getfield(L, 2, table->ColumnName(column).c_str());
+                }
+                cells[column] = ReadCell(L, -1, table->GetColumnType(column));
+            }
+        }
+        else
+        {
+            const size_t given = std::min(column_count, (size_t)(lua_gettop(L) - 1));
+            for (size_t column = 0; column < given; ++column)
+            {
+                cells[column] = ReadCell(L, (int)column + 2, table->GetColumnType(column));
+            }
+            for (size_t column = given; column < column_count; ++column)
+            {
+                cells[column].number = EMPTY_NUMBER;
+            }
+        }
+
+        table->Append(cells.data(), cells.size());
+        return 0;
+    }
+
+    int TableClear(lua_State* L)
+    {
+        CheckTable(L)->Clear();
+        return 0;
+    }
+
+    int TableRowCount(lua_State* L)
+    {
+        lua_pushinteger(L, (lua_Integer)CheckTable(L)->RowCount());
+        return 1;
+    }
+
+    int TableColumnCount(lua_State* L)
+    {
+        lua_pushinteger(L, (lua_Integer)CheckTable(L)->ColumnCount());
+        return 1;
+    }
+
+    // table:ColumnName(column) -> name, or nil when column is out of range
+    int TableColumnName(lua_State* L)
+    {
+        const DataTable* table = CheckTable(L);
+        const lua_Integer column = luaL_checkinteger(L, 2);
+        if (column < 1 || (size_t)column > table->ColumnCount())
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+        lua_pushstring(L, table->ColumnName((size_t)column - 1).c_str());
+        return 1;
+    }
+
+    // table:ColumnType(column) -> "text" or "number", or nil when column is out of range
+    int TableColumnType(lua_State* L)
+    {
+        const DataTable* table = CheckTable(L);
+        const lua_Integer column = luaL_checkinteger(L, 2);
+        if (column < 1 || (size_t)column > table->ColumnCount())
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+        lua_pushstring(L, table->GetColumnType((size_t)column - 1) == DataTable::ColumnType::Number ? "number" : "text");
+        return 1;
+    }
+
+    // table:Get(row, column) -> the cell, or nil when either is out of range. Number columns
+    // return their value, or the cell's text when it is not a number.
+    int TableGet(lua_State* L)
+    {
+        const DataTable* table = CheckTable(L);
+        const lua_Integer row = luaL_checkinteger(L, 2);
+        const lua_Integer column = luaL_checkinteger(L, 3);
+        if (row < 1 || (size_t)row > table->RowCount() || column < 1 || (size_t)column > table->ColumnCount())
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+
+        if (table->GetColumnType((size_t)column - 1) == DataTable::ColumnType::Number)
+        {
+            const double number = table->GetNumber((size_t)row - 1, (size_t)column - 1);
+            if (!std::isnan(number))
+            {
+                lua_pushnumber(L, number);
+                return 1;
+            }
+        }
+        lua_pushstring(L, table->GetText((size_t)row - 1, (size_t)column - 1));
+        return 1;
+    }
+
+    // table:Sort([column[, descending]]); no column restores row order
+    int TableSort(lua_State* L)
+    {
+        DataTable* table = CheckTable(L);
+        table->SetSort(OptColumn(L, 2, table), lua_toboolean(L, 3) != 0);
+        return 0;
+    }
+
+    // table:GetSort() -> column, descending; or nil when the table is in row order
+    int TableGetSort(lua_State* L)
+    {
+        const DataTable* table = CheckTable(L);
+        if (table->SortColumn() < 0)
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+        lua_pushinteger(L, table->SortColumn() + 1);
+        lua_pushboolean(L, table->SortDescending());
+        return 2;
+    }
+
+    // table:SetFilter([text[, options]]), options = { column = n, prefix = bool }; no text (or
+    // an empty one) removes the filter
+    int TableSetFilter(lua_State* L)
+    {
+        DataTable* table = CheckTable(L);
+        size_t length = 0;
+        const char* text = luaL_optlstring(L, 2, "", &length);
+
+        int column = -1;
+        bool prefix = false;
+        if (lua_istable(L, 3))
+        {
+            lua_getfield(L, 3, "column");
+            column = OptColumn(L, -1, table);
+            lua_getfield(L, 3, "prefix");
+            prefix = lua_toboolean(L, -1) != 0;
+            lua_pop(L, 2);
+        }
+
+        table->SetFilter(std::string_view(text, length), column, prefix);
+        return 0;
+    }
+
+    // table:VisibleCount() -> rows in the sorted and filtered view
+    int TableVisibleCount(lua_State* L)
+    {
+        DataTable* table = CheckTable(L);
+        table->UpdateView();
+        lua_pushinteger(L, (lua_Integer)table->VisibleCount());
+        return 1;
+    }
+
+    // table:VisibleRow(position) -> the row shown at a position of the view, or nil when
+    // position is out of range
+    int TableVisibleRow(lua_State* L)
+    {
+        DataTable* table = CheckTable(L);
+        const lua_Integer position = luaL_checkinteger(L, 2);
+        table->UpdateView();
+        if (position < 1 || (size_t)position > table->VisibleCount())
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+        lua_pushinteger(L, (lua_Integer)table->VisibleRow((size_t)position - 1) + 1);
+        return 1;
+    }
+
+    int TableIsUpdating(lua_State* L)
+    {
+        lua_pushboolean(L, CheckTable(L)->IsUpdating());
+        return 1;
+    }
+
+    int TableGc(lua_State* L)
+    {
+        if (DataTable* table = DataTable::Test(L, 1))
+        {
+            table->~DataTable();
+        }
+        return 0;
+    }
+
+    // Pushes the shared metatable, creating it on first use.
+    void PushMetatable(lua_State* L)
+    {
+        if (luaL_newmetatable(L, DataTable::METATABLE_NAME) == 0)
+        {
+            return;
+        }
+
+        lua_pushcfunction(L, TableGc);
+        lua_setfield(L, -2, "__gc");
+        lua_pushcfunction(L, TableRowCount);
+        lua_setfield(L, -2, "__len");
+
+        lua_newtable(L);
+        lua_pushcfunction(L, TableAppend);
+        lua_setfield(L, -2, "Append");
+        lua_pushcfunction(L, TableClear);
+        lua_setfield(L, -2, "Clear");
+        lua_pushcfunction(L, TableRowCount);
+        lua_setfield(L, -2, "RowCount");
+        lua_pushcfunction(L, TableColumnCount);
+        lua_setfield(L, -2, "ColumnCount");
+        lua_pushcfunction(L, TableColumnName);
+        lua_setfield(L, -2, "ColumnName");
+        lua_pushcfunction(L, TableColumnType);
+        lua_setfield(L, -2, "ColumnType");
+        lua_pushcfunction(L, TableGet);
+        lua_setfield(L, -2, "Get");
+        lua_pushcfunction(L, TableSort);
+        lua_setfield(L, -2, "Sort");
+        lua_pushcfunction(L, TableGetSort);
+        lua_setfield(L, -2, "GetSort");
+        lua_pushcfunction(L, TableSetFilter);
+        lua_setfield(L, -2, "SetFilter");
+        lua_pushcfunction(L, TableVisibleCount);
+        lua_setfield(L, -2, "VisibleCount");
+        lua_pushcfunction(L, TableVisibleRow);
+        lua_setfield(L, -2, "VisibleRow");
+        lua_pushcfunction(L, TableIsUpdating);
+        lua_setfield(L, -2, "IsUpdating");
+        lua_setfield(L, -2, "__index");
+    }
+}
+
+DataTable::~DataTable() = default;
+
+DataTable::ColumnData& DataTable::Writable(Column& column)
+{
+    // A view job may still be reading these cells; the table moves on with its own copy.
+    if (column.data.use_count() > 1)
+    {
+        column.data = std::make_shared<ColumnData>(*column.data);
+    }
+    return *column.data;
+}
+
+void DataTable::Append(const Cell* cells, size_t count)
+{
+    for (size_t column = 0; column < columns.size(); ++column)
+    {
+        Column& target = columns[column];
+        ColumnData& data = Writable(target);
+        const std::string_view cell = column < count ? cells[column].text : std::string_view();
+        data.offsets.push_back((uint32_t)data.text.size());
+        data.text.insert(data.text.end(), cell.begin(), cell.end());
+        data.text.push_back('\0');
+        if (target.type == ColumnType::Number)
+        {
+            data.numbers.push_back(column < count ? cells[column].number : EMPTY_NUMBER);
+        }
+    }
+    rows++;
+}
+
+void DataTable::Clear()
+{
+    for (Column& column : columns)
+    {
+        if (column.data.use_count() > 1)
+        {
+            column.data = std::make_shared<ColumnData>();
+        }
+        else
+        {
+            column.data->text.clear();
+            column.data->offsets.clear();
+            column.data->numbers.clear();
+        }
+        column.order.reset();
+    }
+    rows = 0;
+    generation++;
+    view.reset();
+    view_rows = 0;
+}
+
+void DataTable::SetSort(int column, bool descending)
+{
+    request.sort_column = column >= 0 && (size_t)column < columns.size() ? column : -1;
+    request.descending = request.sort_column >= 0 && descending;
+}
+
+void DataTable::SetFilter(std::string_view text, int column, bool prefix)
+{
+    request.filter.assign(text.data(), text.size());
+    request.filter_column = column >= 0 && (size_t)column < columns.size() ? column : -1;
+    request.prefix = prefix;
+}
+
+void DataTable::UpdateView()
+{
+    if (job && job->done)
+    {
+        FinishJob();
+    }
+
+    if (request.sort_column < 0 && request.filter.empty())
+    {
+        view.reset();
+        view_descending = false;
+        return;
+    }
+
+    if (view && view_request == request && view_rows == rows)
+    {
+        view_descending = request.descending;
+        return;
+    }
+
+    // Sorting alone, by a column whose cached permutation covers every row, only swaps the view.
+    if (request.filter.empty())
+    {
+        const Column& column = columns[request.sort_column];
+        if (column.order && column.order->size() == rows)
+        {
+            view            = column.order;
+            view_request    = request;
+            view_rows       = rows;
+            view_descending = request.descending;
+            return;
+        }
+    }
+
+    // One job at a time; a request made while it runs is picked up once it finishes.
+    if (!job)
+    {
+        StartJob();
+    }
+}
+
+void DataTable::StartJob()
+{
+    auto new_job = std::make_unique<ViewJob>();
+    new_job->request    = request;
+    new_job->rows       = rows;
+    new_job->generation = generation;
+    new_job->data.resize(columns.size());
+    new_job->types.resize(columns.size());
+
+    const auto use_column = [&](int column, bool ordered)
+    {
+        new_job->data[column]  = columns[column].data;
+        new_job->types[column] = columns[column].type;
+        const bool listed = std::any_of(new_job->orders.begin(), new_job->orders.end(),
+                                        [column](const ViewJob::ColumnOrder& column_order) { return column_order.column == column; });
+        if (ordered && !listed)
+        {
+            new_job->orders.push_back({ column, columns[column].order, nullptr });
+        }
+    };
+
+    if (request.sort_column >= 0)
+    {
+        use_column(request.sort_column, true);
+    }
+    if (!request.filter.empty())
+    {
+        if (request.filter_column >= 0)
+        {
+            // A prefix filter on a text column searches that column's permutation.
+            const bool indexed = request.prefix && columns[request.filter_column].type == ColumnType::Text;
+            use_column(request.filter_column, indexed);
+        }
+        else
+        {
+            for (size_t column = 0; column < columns.size(); ++column)
+            {
+                use_column((int)column, false);
+            }
+        }
+    }
+
+    ViewJob* raw_job = new_job.get();
+    try
+    {
+        new_job->thread = std::thread([raw_job]
+        {
+            raw_job->Run();
+            raw_job->done = true;
+        });
+    }
+    catch (const std::system_error& err)
+    {
+        PLOG_ERROR << "Failed to start DataTable view worker, building the view inline: " << err.what();
+        raw_job->Run();
+        raw_job->done = true;
+    }
+    job = std::move(new_job);
+}
+
+void DataTable::FinishJob()
+{
+    std::unique_ptr<ViewJob> finished = std::move(job);
+    if (finished->thread.joinable())
+    {
+        finished->thread.join();
+    }
+    if (finished->generation != generation)
+    {
+        return;
+    }
+
+    for (const ViewJob::ColumnOrder& column_order : finished->orders)
+    {
+        std::shared_ptr<const RowList>& cached = columns[column_order.column].order;
+        if (!cached || cached->size() < column_order.order->size())
+        {
+            cached = column_order.order;
+        }
+    }
+
+    view            = finished->view;
+    view_request    = finished->request;
+    view_rows       = finished->rows;
+    view_descending = finished->request.descending;
+}
+
+DataTable* DataTable::Test(lua_State* L, int index)
+{
+    return static_cast<DataTable*>(LuaHelpers::TestUserdata(L, index, METATABLE_NAME));
+}
+
+int DataTable::LuaCreate(lua_State* L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    const size_t column_count = lua_objlen(L, 1);
+    luaL_argcheck(L, column_count > 0, 1, "a DataTable needs at least one column");
+
+    DataTable* table = new (lua_newuserdata(L, sizeof(DataTable))) DataTable();
+    PushMetatable(L);
+    lua_setmetatable(L, -2);
+
+    table->columns.resize(column_count);
+    for (size_t column = 0; column < column_count; ++column)
+    {
+        Column& target = table->columns[column];
+        lua_rawgeti(L, 1, (int)column + 1);
+        if (lua_istable(L, -1))
+        {
+            lua_getfield(L, -1, "name");
+            const char* name = lua_tostring(L, -1);
+            target.name = name ? name : "";
+            lua_getfield(L, -2, "type");
+            const char* type = lua_tostring(L, -1);
+            if (type && strcmp(type, "number") == 0)
+            {
+                target.type = ColumnType::Number;
+            }
+            else if (type && strcmp(type, "text") != 0)
+            {
+                return luaL_error(L, "DataTable: column %d has unknown type \"%s\"", (int)column + 1, type);
+            }
+            lua_pop(L, 2);
+        }
+        else
+        {
+            const char* name = lua_tostring(L, -1);
+            target.name = name ? name : "";
+        }
+        lua_pop(L, 1);
+    }
+    return 1;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file data_table.h
+ * @brief Native columnar row storage that scripts append to and virtualized tables draw from.
+ *
+ * A script that keeps tens of thousands of rows (an inventory, a log) in Lua tables pays for
+ * every row it walks each frame. UiForge.DataTable(columns) keeps the rows natively instead,
+ * one column at a time: each column's cells are converted to text once, when the row is
+ * appended, and packed into one buffer. UiForge.VirtualTable draws straight from it, touching
+ * only the rows that are on screen, so neither Lua nor the row count is involved per frame.
+ *
+ * A table can also be sorted by a column and filtered by text. Sorting and filtering never
+ * reorder the rows themselves; they produce a view, a list of row numbers in display order,
+ * which is built on a worker thread and swapped in once it is ready. Each column caches the
+ * permutation that sorts it, extended by a merge when rows are appended, so sorting by a column
+ * again (or reversing it) only swaps which permutation the view uses. Until a new view is ready,
+ * the previous one keeps being drawn.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <lua.hpp>
+
+class DataTable
+{
+    public:
+        /** @brief Registry name of the userdata metatable. */
+        static constexpr const char* METATABLE_NAME = "UiForge.DataTable";
+
+        /** @brief Text columns sort case-insensitively; number columns sort by value. */
+        enum class ColumnType
+        {
+            Text,
+            Number,
+        };
+
+        /**
+         * @brief One appended cell. number is only read for number columns, where a cell that
+         * is not a number holds NaN (and sorts after every number).
+         */
+        struct Cell
+        {
+            std::string_view    text;
+            double              number = 0.0;
+        };
+
+        DataTable() = default;
+        ~DataTable();
+
+        DataTable(const DataTable&) = delete;
+        DataTable& operator=(const DataTable&) = delete;
+
+        size_t RowCount() const { return rows; }
+        size_t ColumnCount() const { return columns.size(); }
+        const std::string& ColumnName(size_t column) const { return columns[column].name; }
+        ColumnType GetColumnType(size_t column) const { return columns[column].type; }
+
+        /** @brief Returns a cell's text. row and column are 0-based here, unlike in Lua. */
+        const char* GetText(size_t row, size_t column) const
+        {
+            const ColumnData& cells = *columns[column].data;
+            return cells.text.data() + cells.offsets[row];
+        }
+
+        /** @brief Returns a number column's value. row and column are 0-based. */
+        double GetNumber(size_t row, size_t column) const { return columns[column].data->numbers[row]; }
+
+        /**
+         * @brief Appends one row. cells holds one entry per column; missing trailing cells are
+         * left empty.
+         */
+        void Append(const Cell* cells, size_t count);
+
+        /** @brief Removes every row and drops the view. Columns and the sort and filter are kept. */
+        void Clear();
+
+        /** @brief Sorts the view by a 0-based column, or restores row order when column < 0. */
+        void SetSort(int column, bool descending);
+        int SortColumn() const { return request.sort_column; }
+        bool SortDescending() const { return request.descending; }
+
+        /**
+         * @brief Filters the view to rows whose cell contains text (case-insensitively), in one
+         * 0-based column or in any column when column < 0. With prefix set the cell must start
+         * with text instead; on a single text column that is a binary search of its permutation.
+         * An empty text removes the filter.
+         */
+        void SetFilter(std::string_view text, int column, bool prefix);
+
+        /**
+         * @brief Collects a finished view and starts building a new one when the sort, the
+         * filter or the rows changed. Cheap when nothing did; call it once per frame before
+         * reading the view.
+         */
+        void UpdateView();
+
+        /** @brief Rows in the current view. */
+        size_t VisibleCount() const
+        {
+            if (!view)
+            {
+                return rows;
+            }
+            return view->size();
+        }
+
+        /** @brief Returns the 0-based row shown at a 0-based position of the current view. */
+        size_t VisibleRow(size_t position) const
+        {
+            if (!view)
+            {
+                return position;
+            }
+            return (*view)[view_descending ? view->size() - 1 - position : position];
+        }
+
+        /** @brief True while a view is being built on the worker thread. */
+        bool IsUpdating() const { return job != nullptr; }
+
+        /**
+         * @brief Returns the DataTable at a stack index, or nullptr when the value is anything
+         * else. Never raises.
+         */
+        static DataTable* Test(lua_State* L, int index);
+
+        /**
+         * @brief UiForge.DataTable(columns). Creates an empty table. Each entry of columns is a
+         * name, or a table { name = ..., type = "text" | "number" }.
+         */
+        static int LuaCreate(lua_State* L);
+
+    private:
+        // A column's cells. Shared with view jobs, which read it on the worker thread, so it is
+        // copied before being written while a job still holds it.
+        struct ColumnData
+        {
+            std::vector<char>       text;       // Every cell, each followed by a NUL
+            std::vector<uint32_t>   offsets;    // Start of each row's cell in text
+            std::vector<double>     numbers;    // Number columns only, one per row
+        };
+
+        using RowList = std::vector<uint32_t>;
+
+        struct Column
+        {
+            std::string                     name;
+            ColumnType                      type = ColumnType::Text;
+            std::shared_ptr<ColumnData>     data = std::make_shared<ColumnData>();
+            std::shared_ptr<const RowList>  order;  // Ascending permutation of the first order->size() rows
+        };
+
+        // What the view should show. descending is applied when the view is read, so views that
+        // differ only in direction are the same view and it is left out of the comparison.
+        struct ViewRequest
+        {
+            int             sort_column = -1;
+            bool            descending  = false;
+            std::string     filter;
+            int             filter_column = -1;
+            bool            prefix      = false;
+
+            bool operator==(const ViewRequest& other) const
+            {
+                return sort_column == other.sort_column && filter == other.filter
+                    && filter_column == other.filter_column && prefix == other.prefix;
+            }
+        };
+
+        struct ViewJob;
+
+        ColumnData& Writable(Column& column);
+        void StartJob();
+        void FinishJob();
+
+        std::vector<Column>             columns;
+        size_t                          rows = 0;
+        uint64_t                        generation = 0;     // Bumped by Clear, so stale jobs are dropped
+
+        ViewRequest                     request;
+        std::shared_ptr<const RowList>  view;               // Ascending rows; nullptr shows every row in order
+        bool                            view_descending = false;
+        ViewRequest                     view_request;       // What view was built for
+        size_t                          view_rows = 0;      // RowCount when view was built
+        std::unique_ptr<ViewJob>        job;
+};
@@ -0,0 +1,729 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <emmintrin.h>
+#include <xmmintrin.h>
+
+#include <plog/Log.h>
+
+#include "core\draw_batch.h"
+
+namespace
+{
+    // Keeps each reservation well inside 16-bit indices; the draw list moves its vertex offset
+    // between reservations when it has to.
+    constexpr size_t MAX_VERTICES_PER_RESERVE = 32768;
+    constexpr int MIN_CIRCLE_SEGMENTS = 3;
+    constexpr int MAX_CIRCLE_SEGMENTS = 512;
+    constexpr float PI = 3.14159265358979323846f;
+    constexpr int LUA_TYPE_CDATA = 10;     // LuaJIT's type for FFI cdata; lua.h does not name it
+
+    ImU32 Transparent(ImU32 color)
+    {
+        return color & ~IM_COL32_A_MASK;
+    }
+
+    // A fill or stroke as parallel bands around a shape's edge. Each ring sits at the edge plus an
+    // offset and is either the shape's colour or transparent (the anti-aliased fringe), matching
+    // what ImDrawList::PathFillConvex and PathStroke emit.
+    struct RingProfile
+    {
+        float   offsets[4]  = {};
+        bool    opaque[4]   = {};
+        int     count       = 0;
+        bool    fill_inner  = false;    // The innermost ring is also filled as a convex polygon
+    };
+
+    RingProfile FillProfile(const ImDrawList* draw_list)
+    {
+        if (draw_list->Flags & ImDrawListFlags_AntiAliasedFill)
+        {
+            const float fringe = draw_list->_FringeScale;
+            return { { -0.5f * fringe, 0.5f * fringe }, { true, false }, 2, true };
+        }
+        return { { 0.0f }, { true }, 1, true };
+    }
+
+    RingProfile StrokeProfile(const ImDrawList* draw_list, float thickness)
+    {
+        if (!(draw_list->Flags & ImDrawListFlags_AntiAliasedLines))
+        {
+            return { { -0.5f * thickness, 0.5f * thickness }, { true, true }, 2, false };
+        }
+
+        const float fringe = draw_list->_FringeScale;
+        if (thickness <= fringe)
+        {
+            return { { -fringe, 0.0f, fringe }, { false, true, false }, 3, false };
+        }
+        const float half_inner = (thickness - fringe) * 0.5f;
+        return { { -half_inner - fringe, -half_inner, half_inner, half_inner + fringe }, { false, true, true, false }, 4, false };
+    }
+
+    // The segment count ImGui picks for a circle of this radius (style.CircleTessellationMaxError).
+    int AutoSegmentCount(float radius)
+    {
+        if (radius <= 0.0f)
+        {
+            return MIN_CIRCLE_SEGMENTS;
+        }
+        const float max_error = ImGui::GetStyle().CircleTessellationMaxError;
+        const int segments = (int)std::ceil(PI / std::acos(1.0f - std::min(max_error, radius) / radius));
+        return std::clamp((segments + 1) & ~1, 4, MAX_CIRCLE_SEGMENTS);
+    }
+
+    // Reserves room for count shapes in chunks of at most MAX_VERTICES_PER_RESERVE vertices and
+    // calls write(first, n, vertices, indices, first_index) for each chunk, then commits it.
+    template <typename Writer>
+    void ReserveInChunks(ImDrawList* draw_list, size_t count, size_t vertices_per, size_t indices_per, Writer write)
+    {
+        const size_t per_chunk = std::max<size_t>(1, MAX_VERTICES_PER_RESERVE / vertices_per);
+        for (size_t first = 0; first < count; first += per_chunk)
+        {
+            const size_t n = std::min(per_chunk, count - first);
+            draw_list->PrimReserve((int)(n * indices_per), (int)(n * vertices_per));
+            write(first, n, draw_list->_VtxWritePtr, draw_list->_IdxWritePtr, (unsigned)draw_list->_VtxCurrentIdx);
+            draw_list->_VtxWritePtr += n * vertices_per;
+            draw_list->_IdxWritePtr += n * indices_per;
+            draw_list->_VtxCurrentIdx += (unsigned)(n * vertices_per);
+        }
+    }
+
+    // Triangulates points [first_index, first_index + points) as a convex polygon.
+    void WriteFanIndices(ImDrawIdx*& indices, unsigned first_index, int points)
+    {
+        for (int i = 2; i < points; ++i)
+        {
+            *indices++ = (ImDrawIdx)(first_index);
+            *indices++ = (ImDrawIdx)(first_index + i - 1);
+            *indices++ = (ImDrawIdx)(first_index + i);
+        }
+    }
+
+    // Two triangles per edge joining ring a to ring b. A closed ring also joins its last point
+    // back to its first.
+    void WriteBandIndices(ImDrawIdx*& indices, unsigned a, unsigned b, int points, bool closed)
+    {
+        const int edges = closed ? points : points - 1;
+        for (int i = 0; i < edges; ++i)
+        {
+            const int next = (i + 1) % points;
+            *indices++ = (ImDrawIdx)(a + i);
+            *indices++ = (ImDrawIdx)(a + next);
+            *indices++ = (ImDrawIdx)(b + next);
+            *indices++ = (ImDrawIdx)(a + i);
+            *indices++ = (ImDrawIdx)(b + next);
+            *indices++ = (ImDrawIdx)(b + i);
+        }
+    }
+
+    // Writes center + radius * unit[k] for every segment, four positions per iteration.
+    void WriteRing(ImDrawVert* vertices, const float* unit_x, const float* unit_y, int segments,
+                   float center_x, float center_y, float radius, ImU32 color, const ImVec2& uv)
+    {
+        const __m128 cx = _mm_set1_ps(center_x);
+        const __m128 cy = _mm_set1_ps(center_y);
+        const __m128 r  = _mm_set1_ps(radius);
+
+        int k = 0;
+        for (; k + 4 <= segments; k += 4)
+        {
+            const __m128 x = _mm_add_ps(cx, _mm_mul_ps(r, _mm_loadu_ps(unit_x + k)));
+            const __m128 y = _mm_add_ps(cy, _mm_mul_ps(r, _mm_loadu_ps(unit_y + k)));
+            const __m128 xy_low  = _mm_unpacklo_ps(x, y);     // x0 y0 x1 y1
+            const __m128 xy_high = _mm_unpackhi_ps(x, y);     // x2 y2 x3 y3
+            _mm_storel_pi((__m64*)&vertices[k].pos, xy_low);
+            _mm_storeh_pi((__m64*)&vertices[k + 1].pos, xy_low);
+            _mm_storel_pi((__m64*)&vertices[k + 2].pos, xy_high);
+            _mm_storeh_pi((__m64*)&vertices[k + 3].pos, xy_high);
+        }
+        for (; k < segments; ++k)
+        {
+            vertices[k].pos = ImVec2(center_x + radius * unit_x[k], center_y + radius * unit_y[k]);
+        }
+
+        for (k = 0; k < segments; ++k)
+        {
+            vertices[k].uv = uv;
+            vertices[k].col = color;
+        }
+    }
+
+    // Writes a rectangle the way ImDrawList::PrimRect does. min_max holds x0 y0 x1 y1.
+    void WriteRect(ImDrawVert* vertices, ImDrawIdx* indices, unsigned first_index, __m128 min_max, ImU32 color, const ImVec2& uv)
+    {
+        const __m128 crossed = _mm_shuffle_ps(min_max, min_max, _MM_SHUFFLE(3, 0, 1, 2));  // x1 y0 x0 y1
+        _mm_storel_pi((__m64*)&vertices[0].pos, min_max);
+        _mm_storel_pi((__m64*)&vertices[1].pos, crossed);
+        _mm_storeh_pi((__m64*)&vertices[2].pos, min_max);
+        _mm_storeh_pi((__m64*)&vertices[3].pos, crossed);
+        for (int k = 0; k < 4; ++k)
+        {
+            vertices[k].uv = uv;
+            vertices[k].col = color;
+        }
+
+        indices[0] = (ImDrawIdx)(first_index);
+        indices[1] = (ImDrawIdx)(first_index + 1);
+        indices[2] = (ImDrawIdx)(first_index + 2);
+        indices[3] = (ImDrawIdx)(first_index);
+        indices[4] = (ImDrawIdx)(first_index + 2);
+        indices[5] = (ImDrawIdx)(first_index + 3);
+    }
+
+    // One per-shape input of a batch section. FFI arrays are read in place (DRAW_BATCH_SOURCE
+    // has checked their element type and size), Lua tables are copied, and a number applies to
+    // every shape.
+    template <typename T>
+    struct BatchArray
+    {
+        const T*        data        = nullptr;
+        bool            is_value    = false;
+        T               value       = T();
+        bool            is_table    = false;
+        std::vector<T>  table_copy;
+    };
+
+    template <typename T>
+    T FromLuaNumber(lua_Number number)
+    {
+        return (T)number;
+    }
+
+    template <>
+    ImU32 FromLuaNumber<ImU32>(lua_Number number)
+    {
+        // Colours arrive both as 0xAABBGGRR and as bit.tobit's signed results.
+        return (ImU32)(int64_t)number;
+    }
+
+    template <typename T>
+    void ReadBatchArray(lua_State* L, int section, const char* field, BatchArray<T>& out)
+    {
+        lua_getfield(L, section, field);
+        const int type = lua_type(L, -1);
+        if (type == LUA_TNUMBER)
+        {
+            out.is_value = true;
+            out.value = FromLuaNumber<T>(lua_tonumber(L, -1));
+        }
+        else if (type == LUA_TTABLE)
+        {
+            const size_t size = lua_objlen(L, -1);
+            out.table_copy.resize(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                lua_rawgeti(L, -1, (int)i + 1);
+                out.table_copy[i] = FromLuaNumber<T>(lua_tonumber(L, -1));
+                lua_pop(L, 1);
+            }
+            out.is_table = true;
+            out.data = out.table_copy.data();
+        }
+        else if (type == LUA_TYPE_CDATA)
+        {
+            // For an array the cdata payload is the elements themselves.
+            out.data = (const T*)lua_topointer(L, -1);
+        }
+        else if (type != LUA_TNIL)
+        {
+            luaL_error(L, "DrawBatch: %s must be an FFI array, a table or a number", field);
+        }
+        lua_pop(L, 1);
+    }
+
+    // A section's shape count: its count field, or what its first array holds when that is a
+    // table. Every table the section uses must cover that many shapes.
+    template <typename T>
+    void CheckTableSize(lua_State* L, const BatchArray<T>& array, const char* field, size_t count, size_t values_per_shape)
+    {
+        if (array.is_table && array.table_copy.size() < count * values_per_shape)
+        {
+            luaL_error(L, "DrawBatch: %s holds %d values, %d needed", field, (int)array.table_copy.size(), (int)(count * values_per_shape));
+        }
+    }
+
+    size_t ReadCount(lua_State* L, int section, const char* section_name, const BatchArray<float>& shape_array, size_t values_per_shape)
+    {
+        lua_getfield(L, section, "count");
+        const bool has_count = lua_isnumber(L, -1) != 0;
+        const lua_Number count = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+
+        if (has_count)
+        {
+            return count > 0 ? (size_t)count : 0;
+        }
+        if (!shape_array.is_table)
+        {
+            luaL_error(L, "DrawBatch: %s needs a count when its arrays are not tables", section_name);
+        }
+        return shape_array.table_copy.size() / values_per_shape;
+    }
+
+    float ReadNumber(lua_State* L, int table, const char* field, float fallback)
+    {
+        lua_getfield(L, table, field);
+        const float value = lua_isnumber(L, -1) ? (float)lua_tonumber(L, -1) : fallback;
+        lua_pop(L, 1);
+        return value;
+    }
+
+    bool ReadBoolean(lua_State* L, int table, const char* field, bool fallback)
+    {
+        lua_getfield(L, table, field);
+        const bool value = lua_isnil(L, -1) ? fallback : lua_toboolean(L, -1) != 0;
+        lua_pop(L, 1);
+        return value;
+    }
+
+    // Anything with x and y fields: a table, the sol2 ImVec2 or the imgui_ffi ImVec2.
+    ImVec2 ReadPoint(lua_State* L, int table, const char* field)
+    {
+        ImVec2 point(0.0f, 0.0f);
+        lua_getfield(L, table, field);
+        if (!lua_isnil(L, -1))
+        {
+            const int point_index = lua_gettop(L);
+            point.x = ReadNumber(L, point_index, "x", 0.0f);
+            point.y = ReadNumber(L, point_index, "y", 0.0f);
+        }
+        lua_pop(L, 1);
+        return point;
+    }
+
+    // Runs once at install with the native DrawBatch and returns the UiForge.DrawBatch scripts
+    // call. The native side reads FFI arrays in place, so this is where they are checked: an
+    // array must have the element type the field expects and hold count shapes' worth of it.
+    // Pointers, which carry no length, and arrays of any other type are rejected. The batch is
+    // also copied into fresh tables, so what was checked is exactly what the native side reads.
+    const char DRAW_BATCH_SOURCE[] = R"UIFORGE_BATCH(
+local native = ...
+local ffi = require("ffi")
+
+local FLOAT = { "float" }
+local COLOR = { "uint32_t", "int32_t" }
+
+-- Per section: array fields with their element types and values per shape, then plain fields.
+local SECTIONS = {
+    circles = {
+        arrays = { positions = { FLOAT, 2 }, radii = { FLOAT, 1 }, colors = { COLOR, 1 } },
+        values = { "count", "segments", "filled", "thickness" },
+    },
+    rects = {
+        arrays = { positions = { FLOAT, 2 }, sizes = { FLOAT, 2 }, colors = { COLOR, 1 } },
+        values = { "count", "width", "height", "filled", "thickness" },
+    },
+    lines = {
+        arrays = { points = { FLOAT, 4 }, colors = { COLOR, 1 } },
+        values = { "count", "thickness" },
+    },
+}
+
+local array_types = {}
+local function IsArrayOf(value, element)
+    local types = array_types[element]
+    if not types then
+        types = { element = ffi.typeof(element), vla = ffi.typeof("$[?]", ffi.typeof(element)) }
+        array_types[element] = types
+    end
+    if ffi.istype(types.vla, value) then
+        return true
+    end
+    local size = ffi.sizeof(value)
+    local length = size and math.floor(size / ffi.sizeof(types.element)) or 0
+    return length > 0 and ffi.istype(ffi.typeof("$[$]", types.element, length), value)
+end
+
+-- Errors point at the script's DrawBatch call: CheckArray <- CopySection <- DrawBatch <- script.
+local function CheckArray(value, spec, count, section_name, field)
+    if type(value) ~= "cdata" then
+        return value
+    end
+    if type(count) ~= "number" then
+        error(string.format("DrawBatch: %s needs a count when its arrays are not tables", section_name), 4)
+    end
+
+    -- ffi.typeof results are cdata too, and pass ffi.istype for their own type.
+    local elements, per_shape = spec[1], spec[2]
+    local element
+    local is_instance = tostring(value):sub(1, 6) == "cdata<"
+    for i = 1, is_instance and #elements or 0 do
+        if IsArrayOf(value, elements[i]) then
+            element = elements[i]
+            break
+        end
+    end
+    if not element then
+        error(string.format("DrawBatch: %s.%s must be a %s array, not %s", section_name, field,
+                            table.concat(elements, " or "), tostring(ffi.typeof(value))), 4)
+    end
+
+    local needed = math.max(count, 0) * per_shape * ffi.sizeof(element)
+    if ffi.sizeof(value) < needed then
+        error(string.format("DrawBatch: %s.%s holds %d bytes, %d needed for %d shapes", section_name, field,
+                            ffi.sizeof(value), needed, count), 4)
+    end
+    return value
+end
+
+local function CopySection(section, name, layout)
+    if type(section) ~= "table" then
+        return nil
+    end
+    local copy = {}
+    for _, field in ipairs(layout.values) do
+        copy[field] = section[field]
+    end
+    for field, spec in pairs(layout.arrays) do
+        copy[field] = CheckArray(section[field], spec, copy.count, name, field)
+    end
+    return copy
+end
+
+return function(batch)
+    if type(batch) ~= "table" then
+        error("DrawBatch: batch must be a table", 2)
+    end
+    return native({
+        layer   = batch.layer,
+        origin  = batch.origin,
+        circles = CopySection(batch.circles, "circles", SECTIONS.circles),
+        rects   = CopySection(batch.rects, "rects", SECTIONS.rects),
+        lines   = CopySection(batch.lines, "lines", SECTIONS.lines),
+    })
+end
+)UIFORGE_BATCH";
+}
+
+void DrawBatch::Circles(ImDrawList* draw_list, const DrawBatchCircles& circles, const ImVec2& origin)
+{
+    if (!draw_list || !circles.positions || circles.count == 0)
+    {
+        return;
+    }
+
+    const float largest_radius = circles.radii ? *std::max_element(circles.radii, circles.radii + circles.count) : circles.radius;
+    const int segments = circles.segments > 0 ? std::clamp(circles.segments, MIN_CIRCLE_SEGMENTS, MAX_CIRCLE_SEGMENTS)
+                                              : AutoSegmentCount(largest_radius);
+
+    // Same points as ImDrawList::PathArcTo over a full turn, starting at angle 0.
+    std::vector<float> unit_x(segments);
+    std::vector<float> unit_y(segments);
+    for (int k = 0; k < segments; ++k)
+    {
+        const float angle = 2.0f * PI * (float)k / (float)segments;
+        unit_x[k] = std::cos(angle);
+        unit_y[k] = std::sin(angle);
+    }
+
+    const RingProfile profile = circles.filled ? FillProfile(draw_list) : StrokeProfile(draw_list, circles.thickness);
+    const float edge_offset = circles.filled ? 0.0f : -0.5f;  // ImGui strokes circles half a pixel inside
+    const size_t vertices_per = (size_t)segments * profile.count;
+    const size_t indices_per = (profile.fill_inner ? (size_t)(segments - 2) * 3 : 0) + (size_t)(profile.count - 1) * segments * 6;
+    const ImVec2 uv = ImGui::GetFontTexUvWhitePixel();
+
+    ReserveInChunks(draw_list, circles.count, vertices_per, indices_per,
+        [&](size_t first, size_t n, ImDrawVert* vertices, ImDrawIdx* indices, unsigned first_index)
+        {
+            for (size_t i = first; i < first + n; ++i)
+            {
+                const float center_x = origin.x + circles.positions[i * 2];
+                const float center_y = origin.y + circles.positions[i * 2 + 1];
+                const float radius = (circles.radii ? circles.radii[i] : circles.radius) + edge_offset;
+                const ImU32 color = circles.colors ? circles.colors[i] : circles.color;
+
+                for (int ring = 0; ring < profile.count; ++ring)
+                {
+                    WriteRing(vertices, unit_x.data(), unit_y.data(), segments, center_x, center_y,
+                              std::max(0.0f, radius + profile.offsets[ring]), profile.opaque[ring] ? color : Transparent(color), uv);
+                    vertices += segments;
+                }
+
+                if (profile.fill_inner)
+                {
+                    WriteFanIndices(indices, first_index, segments);
+                }
+                for (int ring = 0; ring + 1 < profile.count; ++ring)
+                {
+                    WriteBandIndices(indices, first_index + ring * segments, first_index + (ring + 1) * segments, segments, true);
+                }
+                first_index += (unsigned)vertices_per;
+            }
+        });
+}
+
+void DrawBatch::Rects(ImDrawList* draw_list, const DrawBatchRects& rects, const ImVec2& origin)
+{
+    if (!draw_list || !rects.positions || rects.count == 0)
+    {
+        return;
+    }
+
+    const ImVec2 uv = ImGui::GetFontTexUvWhitePixel();
+    const __m128 offset = _mm_setr_ps(origin.x, origin.y, origin.x, origin.y);
+    const __m128 uniform_size = _mm_setr_ps(rects.width, rects.height, 0.0f, 0.0f);
+
+    // x0 y0 x1 y1 of rectangle i.
+    auto load_min_max = [&](size_t i)
+    {
+        const __m128 min = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(rects.positions + i * 2));
+        const __m128 size = rects.sizes ? _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(rects.sizes + i * 2)) : uniform_size;
+        return _mm_add_ps(_mm_movelh_ps(min, _mm_add_ps(min, size)), offset);
+    };
+
+    if (rects.filled)
+    {
+        ReserveInChunks(draw_list, rects.count, 4, 6,
+            [&](size_t first, size_t n, ImDrawVert* vertices, ImDrawIdx* indices, unsigned first_index)
+            {
+                for (size_t i = first; i < first + n; ++i)
+                {
+                    WriteRect(vertices, indices, first_index, load_min_max(i), rects.colors ? rects.colors[i] : rects.color, uv);
+                    vertices += 4;
+                    indices += 6;
+                    first_index += 4;
+                }
+            });
+        return;
+    }
+
+    // An outline is four strips along the path ImGui strokes (half a pixel inside the rectangle),
+    // which for axis-aligned edges covers the same pixels as its anti-aliased stroke.
+    const float half = rects.thickness * 0.5f;
+    const __m128 inset = _mm_setr_ps(0.5f, 0.5f, -0.5f, -0.5f);
+    const __m128 horizontal_grow = _mm_setr_ps(-half, -half, half, half);
+    const __m128 vertical_grow = _mm_setr_ps(-half, half, half, -half);
+    ReserveInChunks(draw_list, rects.count, 16, 24,
+        [&](size_t first, size_t n, ImDrawVert* vertices, ImDrawIdx* indices, unsigned first_index)
+        {
+            for (size_t i = first; i < first + n; ++i)
+            {
+                const __m128 path = _mm_add_ps(load_min_max(i), inset);     // ax ay bx by
+                const __m128 strips[4] =
+                {
+                    _mm_add_ps(_mm_shuffle_ps(path, path, _MM_SHUFFLE(1, 2, 1, 0)), horizontal_grow),   // ax ay bx ay
+                    _mm_add_ps(_mm_shuffle_ps(path, path, _MM_SHUFFLE(3, 2, 3, 0)), horizontal_grow),   // ax by bx by
+                    _mm_add_ps(_mm_shuffle_ps(path, path, _MM_SHUFFLE(3, 0, 1, 0)), vertical_grow),     // ax ay ax by
+                    _mm_add_ps(_mm_shuffle_ps(path, path, _MM_SHUFFLE(3, 2, 1, 2)), vertical_grow),     // bx ay bx by
+                };
+                const ImU32 color = rects.colors ? rects.colors[i] : rects.color;
+                for (const __m128& strip : strips)
+                {
+                    WriteRect(vertices, indices, first_index, strip, color, uv);
+                    vertices += 4;
+                    indices += 6;
+                    first_index += 4;
+                }
+            }
+        });
+}
+
+void DrawBatch::Lines(ImDrawList* draw_list, const DrawBatchLines& lines, const ImVec2& origin)
+{
+    if (!draw_list || !lines.points || lines.count == 0)
+    {
+        return;
+    }
+
+    const ImVec2 uv = ImGui::GetFontTexUvWhitePixel();
+    const RingProfile profile = StrokeProfile(draw_list, lines.thickness);
+    const size_t vertices_per = 2 * (size_t)profile.count;
+    const size_t indices_per = 6 * (size_t)(profile.count - 1);
+
+    // ImGui draws lines through pixel centres.
+    const __m128 shift_x = _mm_set1_ps(origin.x + 0.5f);
+    const __m128 shift_y = _mm_set1_ps(origin.y + 0.5f);
+    const __m128 min_length_sq = _mm_set1_ps(1e-12f);
+
+    ReserveInChunks(draw_list, lines.count, vertices_per, indices_per,
+        [&](size_t first, size_t n, ImDrawVert* vertices, ImDrawIdx* indices, unsigned first_index)
+        {
+            // Four lines per iteration: transposed, each register holds one coordinate of all four.
+            for (size_t i = first; i < first + n; i += 4)
+            {
+                const size_t lanes = std::min<size_t>(4, first + n - i);
+                __m128 x1 = _mm_setzero_ps(), y1 = _mm_setzero_ps(), x2 = _mm_setzero_ps(), y2 = _mm_setzero_ps();
+                __m128* rows[4] = { &x1, &y1, &x2, &y2 };
+                for (size_t lane = 0; lane < lanes; ++lane)
+                {
+                    *rows[lane] = _mm_loadu_ps(lines.points + (i + lane) * 4);
+                }
+                _MM_TRANSPOSE4_PS(x1, y1, x2, y2);
+                x1 = _mm_add_ps(x1, shift_x);
+                x2 = _mm_add_ps(x2, shift_x);
+                y1 = _mm_add_ps(y1, shift_y);
+                y2 = _mm_add_ps(y2, shift_y);
+
+                const __m128 dx = _mm_sub_ps(x2, x1);
+                const __m128 dy = _mm_sub_ps(y2, y1);
+                const __m128 length_sq = _mm_max_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), min_length_sq);
+                const __m128 inverse_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_sq));
+                const __m128 normal_x = _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), dy), inverse_length);
+                const __m128 normal_y = _mm_mul_ps(dx, inverse_length);
+
+                alignas(16) float start_x[4][4], start_y[4][4], end_x[4][4], end_y[4][4];     // [ring][lane]
+                for (int ring = 0; ring < profile.count; ++ring)
+                {
+                    const __m128 offset = _mm_set1_ps(profile.offsets[ring]);
+                    const __m128 shift_normal_x = _mm_mul_ps(normal_x, offset);
+                    const __m128 shift_normal_y = _mm_mul_ps(normal_y, offset);
+                    _mm_store_ps(start_x[ring], _mm_add_ps(x1, shift_normal_x));
+                    _mm_store_ps(start_y[ring], _mm_add_ps(y1, shift_normal_y));
+                    _mm_store_ps(end_x[ring], _mm_add_ps(x2, shift_normal_x));
+                    _mm_store_ps(end_y[ring], _mm_add_ps(y2, shift_normal_y));
+                }
+
+                for (size_t lane = 0; lane < lanes; ++lane)
+                {
+                    const ImU32 color = lines.colors ? lines.colors[i + lane] : lines.color;
+                    for (int ring = 0; ring < profile.count; ++ring)
+                    {
+                        const ImU32 ring_color = profile.opaque[ring] ? color : Transparent(color);
+                        vertices[0].pos = ImVec2(start_x[ring][lane], start_y[ring][lane]);
+                        vertices[1].pos = ImVec2(end_x[ring][lane], end_y[ring][lane]);
+                        vertices[0].uv = vertices[1].uv = uv;
+                        vertices[0].col = vertices[1].col = ring_color;
+                        vertices += 2;
+                    }
+                    for (int ring = 0; ring + 1 < profile.count; ++ring)
+                    {
+                        WriteBandIndices(indices, first_index + ring * 2, first_index + (ring + 1) * 2, 2, false);
+                    }
+                    first_index += (unsigned)vertices_per;
+                }
+            }
+        });
+}
+
+bool DrawBatch::Install(lua_State* L)
+{
+    if (luaL_loadbuffer(L, DRAW_BATCH_SOURCE, sizeof(DRAW_BATCH_SOURCE) - 1, "=DrawBatch") != LUA_OK)
+    {
+        PLOG_ERROR << "Failed to load UiForge.DrawBatch: " << lua_tostring(L, -1);
+        lua_pop(L, 1);
+        return false;
+    }
+
+    lua_pushcfunction(L, LuaDraw);                                  // [chunk, native]
+    if (lua_pcall(L, 1, 1, 0) != LUA_OK)                            // [DrawBatch]
+    {
+        PLOG_ERROR << "Failed to load UiForge.DrawBatch: " << lua_tostring(L, -1);
+        lua_pop(L, 1);
+        return false;
+    }
+
+    lua_getglobal(L, "UiForge");                                    // [DrawBatch, UiForge]
+    lua_pushvalue(L, -2);                                           // [DrawBatch, UiForge, DrawBatch]
+    lua_setfield(L, -2, "DrawBatch");
+    lua_pop(L, 2);
+    return true;
+}
+
+int DrawBatch::LuaDraw(lua_State* L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    ImDrawList* draw_list = nullptr;
+    lua_getfield(L, 1, "layer");
+    const char* layer = lua_isstring(L, -1) ? lua_tostring(L, -1) : "window";
+    if (std::strcmp(layer, "window") == 0)
+    {
+        draw_list = ImGui::GetWindowDrawList();
+    }
+    else if (std::strcmp(layer, "foreground") == 0)
+    {
+        draw_list = ImGui::GetForegroundDrawList();
+    }
+    else if (std::strcmp(layer, "background") == 0)
+    {
+        draw_list = ImGui::GetBackgroundDrawList();
+    }
+    else
+    {
+        return luaL_error(L, "DrawBatch: unknown layer \"%s\" (window, foreground or background)", layer);
+    }
+    lua_pop(L, 1);
+
+    const ImVec2 origin = ReadPoint(L, 1, "origin");
+
+    lua_getfield(L, 1, "circles");
+    if (lua_istable(L, -1))
+    {
+        const int section = lua_gettop(L);
+        BatchArray<float> positions, radii;
+        BatchArray<ImU32> colors;
+        ReadBatchArray(L, section, "positions", positions);
+        ReadBatchArray(L, section, "radii", radii);
+        ReadBatchArray(L, section, "colors", colors);
+
+        DrawBatchCircles circles;
+        circles.count = ReadCount(L, section, "circles", positions, 2);
+        CheckTableSize(L, positions, "circles.positions", circles.count, 2);
+        CheckTableSize(L, radii, "circles.radii", circles.count, 1);
+        CheckTableSize(L, colors, "circles.colors", circles.count, 1);
+        circles.positions   = positions.data;
+        circles.radii       = radii.data;
+        circles.radius      = radii.is_value ? radii.value : 1.0f;
+        circles.colors      = colors.data;
+        circles.color       = colors.is_value ? colors.value : IM_COL32_WHITE;
+        circles.segments    = (int)ReadNumber(L, section, "segments", 0.0f);
+        circles.filled      = ReadBoolean(L, section, "filled", true);
+        circles.thickness   = ReadNumber(L, section, "thickness", 1.0f);
+        Circles(draw_list, circles, origin);
+    }
+    lua_pop(L, 1);
+
+    lua_getfield(L, 1, "rects");
+    if (lua_istable(L, -1))
+    {
+        const int section = lua_gettop(L);
+        BatchArray<float> positions, sizes;
+        BatchArray<ImU32> colors;
+        ReadBatchArray(L, section, "positions", positions);
+        ReadBatchArray(L, section, "sizes", sizes);
+        ReadBatchArray(L, section, "colors", colors);
+
+        DrawBatchRects rects;
+        rects.count = ReadCount(L, section, "rects", positions, 2);
+        CheckTableSize(L, positions, "rects.positions", rects.count, 2);
+        CheckTableSize(L, sizes, "rects.sizes", rects.count, 2);
+        CheckTableSize(L, colors, "rects.colors", rects.count, 1);
+        rects.positions     = positions.data;
+        rects.sizes         = sizes.data;
+        rects.width         = ReadNumber(L, section, "width", 0.0f);
+        rects.height        = ReadNumber(L, section, "height", 0.0f);
+        rects.colors        = colors.data;
+        rects.color         = colors.is_value ? colors.value : IM_COL32_WHITE;
+        rects.filled        = ReadBoolean(L, section, "filled", true);
+        rects.thickness     = ReadNumber(L, section, "thickness", 1.0f);
+        Rects(draw_list, rects, origin);
+    }
+    lua_pop(L, 1);
+
+    lua_getfield(L, 1, "lines");
+    if (lua_istable(L, -1))
+    {
+        const int section = lua_gettop(L);
+        BatchArray<float> points;
+        BatchArray<ImU32> colors;
+        ReadBatchArray(L, section, "points", points);
+        ReadBatchArray(L, section, "colors", colors);
+
+        DrawBatchLines lines;
+        lines.count = ReadCount(L, section, "lines", points, 4);
+        CheckTableSize(L, points, "lines.points", lines.count, 4);
+        CheckTableSize(L, colors, "lines.colors", lines.count, 1);
+        lines.points        = points.data;
+        lines.colors        = colors.data;
+        lines.color         = colors.is_value ? colors.value : IM_COL32_WHITE;
+        lines.thickness     = ReadNumber(L, section, "thickness", 1.0f);
+        Lines(draw_list, lines, origin);
+    }
+    lua_pop(L, 1);
+
+    return 0;
+}
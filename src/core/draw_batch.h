@@ -0,0 +1,92 @@
+/**
+ * @file draw_batch.h
+ * @brief Draws large numbers of circles, rectangles and lines into an ImDrawList in one call.
+ *
+ * A script that calls draw_list:AddCircleFilled once per shape pays the Lua/C++ crossing and
+ * the argument conversions for every shape, which dominates once there are thousands of them.
+ * UiForge.DrawBatch instead takes whole arrays (FFI arrays are read in place once their element
+ * type and size are checked, Lua tables are copied once) and writes the vertices straight into the draw list's buffers: ring
+ * and corner positions are computed four at a time with SSE, and one reservation covers as many
+ * shapes as fit in 16-bit indices.
+ *
+ * The geometry follows ImGui's own primitives, including the anti-aliased fringe when the draw
+ * list has anti-aliasing enabled, so batched and unbatched shapes look the same.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include <imgui.h>
+#include <lua.hpp>
+
+/**
+ * @brief Circles to draw. Every per-shape array has one entry per circle (two floats for a
+ * position); a null array means the matching single value applies to every circle.
+ */
+struct DrawBatchCircles
+{
+    size_t          count       = 0;
+    const float*    positions   = nullptr;  // Centers, x then y; required
+    const float*    radii       = nullptr;
+    float           radius      = 1.0f;
+    const ImU32*    colors      = nullptr;
+    ImU32           color       = IM_COL32_WHITE;
+    int             segments    = 0;        // 0 picks a count from the largest radius, as ImGui does
+    bool            filled      = true;
+    float           thickness   = 1.0f;     // Outlines only
+};
+
+/**
+ * @brief Axis-aligned rectangles to draw, laid out like DrawBatchCircles.
+ */
+struct DrawBatchRects
+{
+    size_t          count       = 0;
+    const float*    positions   = nullptr;  // Top-left corners, x then y; required
+    const float*    sizes       = nullptr;  // Width then height
+    float           width       = 0.0f;
+    float           height      = 0.0f;
+    const ImU32*    colors      = nullptr;
+    ImU32           color       = IM_COL32_WHITE;
+    bool            filled      = true;
+    float           thickness   = 1.0f;     // Outlines only
+};
+
+/**
+ * @brief Line segments to draw, laid out like DrawBatchCircles.
+ */
+struct DrawBatchLines
+{
+    size_t          count       = 0;
+    const float*    points      = nullptr;  // x1, y1, x2, y2 per line; required
+    const ImU32*    colors      = nullptr;
+    ImU32           color       = IM_COL32_WHITE;
+    float           thickness   = 1.0f;
+};
+
+class DrawBatch
+{
+    public:
+        /** @brief Draws every circle, offset by origin. */
+        static void Circles(ImDrawList* draw_list, const DrawBatchCircles& circles, const ImVec2& origin);
+
+        /** @brief Draws every rectangle, offset by origin. */
+        static void Rects(ImDrawList* draw_list, const DrawBatchRects& rects, const ImVec2& origin);
+
+        /** @brief Draws every line, offset by origin. */
+        static void Lines(ImDrawList* draw_list, const DrawBatchLines& lines, const ImVec2& origin);
+
+        /**
+         * @brief Sets UiForge.DrawBatch(batch): a Lua wrapper that checks the batch's FFI arrays
+         * and passes a copy of the batch to LuaDraw, which is not reachable otherwise.
+         *
+         * @return False (logged) when the wrapper failed to load.
+         */
+        static bool Install(lua_State* L);
+
+    private:
+        // Reads the circles, rects and lines sections of the batch table and draws them into the
+        // current window's draw list (or the one named by batch.layer). Raises a Lua error for
+        // malformed input. FFI arrays in the batch are trusted to be the checked ones.
+        static int LuaDraw(lua_State* L);
+};
@@ -0,0 +1,250 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cwctype>
+#include <string>
+#include <unordered_set>
+
+#include <Windows.h>
+
+#include <plog/Log.h>
+
+#include "core\file_watcher.h"
+
+namespace
+{
+    constexpr DWORD WATCH_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+    constexpr size_t NOTIFY_BUFFER_SIZE = 64 * 1024;
+
+    std::wstring ComparablePath(const std::filesystem::path& directory_path)
+    {
+        std::wstring comparable = directory_path.lexically_normal().wstring();
+        std::transform(comparable.begin(), comparable.end(), comparable.begin(), [](wchar_t c) { return (wchar_t)towlower(c); });
+        while (!comparable.empty() && (comparable.back() == L'\\' || comparable.back() == L'/'))
+        {
+            comparable.pop_back();
+        }
+        return comparable;
+    }
+
+    bool IsInside(const std::wstring& comparable, const std::wstring& directory)
+    {
+        return comparable.size() > directory.size() && comparable.compare(0, directory.size(), directory) == 0
+            && (comparable[directory.size()] == L'\\' || comparable[directory.size()] == L'/');
+    }
+}
+
+struct FileWatcher::WatchedDirectory
+{
+    std::filesystem::path   path;
+    HANDLE                  handle = INVALID_HANDLE_VALUE;
+    OVERLAPPED              overlapped{};
+    std::vector<DWORD>      buffer;     // DWORD-aligned, as ReadDirectoryChangesW requires
+
+    bool Listen()
+    {
+        return ReadDirectoryChangesW(handle, buffer.data(), (DWORD)(buffer.size() * sizeof(DWORD)), TRUE, WATCH_FILTER,
+            nullptr, &overlapped, nullptr) != FALSE;
+    }
+};
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+bool FileWatcher::Start(const std::vector<std::filesystem::path>& directories, unsigned debounce_ms)
+{
+    Stop();
+    this->debounce_ms = debounce_ms;
+
+    std::vector<std::wstring> roots;
+    for (const std::filesystem::path& directory : directories)
+    {
+        roots.push_back(ComparablePath(directory));
+    }
+
+    for (size_t i = 0; i < directories.size(); ++i)
+    {
+        const bool covered = std::any_of(roots.begin(), roots.end(), [&](const std::wstring& root) { return IsInside(roots[i], root); })
+            || std::find(roots.begin(), roots.begin() + i, roots[i]) != roots.begin() + i;
+        if (covered || roots[i].empty())
+        {
+            continue;
+        }
+
+        auto directory = std::make_unique<WatchedDirectory>();
+        directory->path = directories[i];
+        directory->handle = CreateFileW(directories[i].c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (directory->handle == INVALID_HANDLE_VALUE)
+        {
+            PLOG_WARNING << "Cannot watch " << directories[i].string() << " for changes (error " << GetLastError() << ")";
+            continue;
+        }
+
+        directory->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        directory->buffer.resize(NOTIFY_BUFFER_SIZE / sizeof(DWORD));
+        if (!directory->overlapped.hEvent || !directory->Listen())
+        {
+            PLOG_WARNING << "Cannot watch " << directories[i].string() << " for changes (error " << GetLastError() << ")";
+            if (directory->overlapped.hEvent)
+            {
+                CloseHandle(directory->overlapped.hEvent);
+            }
+            CloseHandle(directory->handle);
+            continue;
+        }
+
+        watched.push_back(std::move(directory));
+    }
+
+    if (watched.empty())
+    {
+        return false;
+    }
+
+    stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    running = true;
+    thread = std::thread(&FileWatcher::Run, this);
+
+    PLOG_INFO << "Watching " << watched.size() << " directories for changes";
+    return true;
+}
+
+void FileWatcher::Stop()
+{
+    running = false;
+    if (thread.joinable())
+    {
+        SetEvent(stop_event);
+        thread.join();
+    }
+    if (stop_event)
+    {
+        CloseHandle(stop_event);
+        stop_event = nullptr;
+    }
+
+    // The thread has returned, so nothing else is waiting on these.
+    for (const auto& directory : watched)
+    {
+        DWORD bytes = 0;
+        CancelIoEx(directory->handle, &directory->overlapped);
+        GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+        CloseHandle(directory->overlapped.hEvent);
+        CloseHandle(directory->handle);
+    }
+    watched.clear();
+
+    std::lock_guard<std::mutex> lock(changes_mutex);
+    changes.clear();
+}
+
+std::vector<std::filesystem::path> FileWatcher::TakeChanges()
+{
+    std::lock_guard<std::mutex> lock(changes_mutex);
+    std::vector<std::filesystem::path> taken;
+    taken.swap(changes);
+    return taken;
+}
+
+void FileWatcher::Run()
+{
+    // wait_handles[i + 1] belongs to listening[i].
+    std::vector<HANDLE> wait_handles = { stop_event };
+    std::vector<WatchedDirectory*> listening;
+    for (const auto& directory : watched)
+    {
+        wait_handles.push_back(directory->overlapped.hEvent);
+        listening.push_back(directory.get());
+    }
+
+    // Changes are gathered here until no new one has arrived for debounce_ms.
+    std::vector<std::filesystem::path> pending;
+    std::unordered_set<std::wstring> pending_keys;
+    std::chrono::steady_clock::time_point last_change{};
+
+    for (;;)
+    {
+        DWORD timeout = INFINITE;
+        if (!pending.empty())
+        {
+            const auto quiet_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - last_change).count();
+            timeout = (DWORD)std::max<long long>(0, (long long)debounce_ms - quiet_ms);
+        }
+
+        const DWORD wait_result = WaitForMultipleObjects((DWORD)wait_handles.size(), wait_handles.data(), FALSE, timeout);
+        if (wait_result == WAIT_OBJECT_0)
+        {
+            return;
+        }
+        if (wait_result == WAIT_FAILED)
+        {
+            PLOG_ERROR << "Stopped watching for changes, waiting failed (error " << GetLastError() << ")";
+            running = false;
+            return;
+        }
+
+        if (wait_result == WAIT_TIMEOUT)
+        {
+            std::lock_guard<std::mutex> lock(changes_mutex);
+            changes.insert(changes.end(), pending.begin(), pending.end());
+            pending.clear();
+            pending_keys.clear();
+            continue;
+        }
+
+        const size_t index = wait_result - WAIT_OBJECT_0 - 1;
+        WatchedDirectory& directory = *listening[index];
+        DWORD bytes = 0;
+        const bool completed = GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, FALSE) != FALSE;
+        ResetEvent(directory.overlapped.hEvent);
+        last_change = std::chrono::steady_clock::now();
+
+        auto add_pending = [&](const std::filesystem::path& changed_path)
+        {
+            if (pending_keys.insert(ComparablePath(changed_path)).second)
+            {
+                pending.push_back(changed_path);
+            }
+        };
+
+        if (!completed || bytes == 0)
+        {
+            // The buffer overflowed and the individual changes are lost.
+            add_pending(directory.path);
+        }
+        else
+        {
+            const uint8_t* record = (const uint8_t*)directory.buffer.data();
+            for (;;)
+            {
+                const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)record;
+                if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+                {
+                    add_pending(directory.path / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+                }
+                if (info->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                record += info->NextEntryOffset;
+            }
+        }
+
+        if (!directory.Listen())
+        {
+            PLOG_ERROR << "Stopped watching " << directory.path.string() << " for changes (error " << GetLastError() << ")";
+            wait_handles.erase(wait_handles.begin() + index + 1);
+            listening.erase(listening.begin() + index);
+            if (listening.empty())
+            {
+                running = false;
+                return;
+            }
+        }
+    }
+}
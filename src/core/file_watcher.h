@@ -0,0 +1,72 @@
+/**
+ * @file file_watcher.h
+ * @brief Watches directory trees for file changes on a background thread.
+ *
+ * The watcher thread waits on ReadDirectoryChangesW for every watched tree, so nothing is polled
+ * and no thread does filesystem work while files are left alone. Editors usually touch a file
+ * several times per save (truncate, write, rename over, attribute update), so changes are held
+ * until a tree has been quiet for the debounce interval and then published as one batch. The
+ * owner drains batches with TakeChanges() from its own thread.
+ */
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class FileWatcher
+{
+    public:
+        FileWatcher() = default;
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        /**
+         * @brief Starts watching directory trees, recursively, stopping any earlier watch first.
+         * Directories nested inside another watched directory are covered by it and skipped.
+         *
+         * @param directories The trees to watch.
+         * @param debounce_ms How long a tree must be quiet before its changes are published.
+         * @return False (logged) when no directory could be watched.
+         */
+        bool Start(const std::vector<std::filesystem::path>& directories, unsigned debounce_ms);
+
+        /**
+         * @brief Stops the watcher thread. Changes not yet taken are dropped.
+         */
+        void Stop();
+
+        /**
+         * @brief True while changes are being watched. Turns false by itself when waiting fails or
+         * every tree has stopped listening, so the owner can fall back to polling.
+         */
+        bool IsRunning() const { return running; }
+
+        /**
+         * @brief Returns the files created, modified or renamed into place since the last call,
+         * once each, as full paths. Never touches the filesystem.
+         *
+         * When the system drops events (too many changes at once), the watched directory itself
+         * is reported, meaning anything under it may have changed.
+         */
+        std::vector<std::filesystem::path> TakeChanges();
+
+    private:
+        struct WatchedDirectory;
+
+        void Run();
+
+        std::vector<std::unique_ptr<WatchedDirectory>> watched;
+        void* stop_event = nullptr;
+        unsigned debounce_ms = 0;
+        std::thread thread;
+        std::atomic<bool> running { false };
+
+        std::mutex changes_mutex;
+        std::vector<std::filesystem::path> changes;     // Published, waiting for TakeChanges()
+};
@@ -0,0 +1,193 @@
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <plog/Log.h>
+
+#include "core\font_manager.h"
+#include "core\mapped_file.h"
+#include "core\package_archive.h"
+
+namespace
+{
+    struct PendingBake
+    {
+        ImFont*                 font;
+        float                   size;
+        std::vector<ImWchar>    glyph_ranges;
+    };
+
+    // The bytes behind a font: a mapped loose file, or an entry of a mounted package archive.
+    struct FontFile
+    {
+        MappedFile  mapped;
+        ArchiveFile archived;
+        const void* data = nullptr;
+        size_t      size = 0;
+    };
+
+    // Fonts keyed by "<path>|<size>", and the file behind every path ImGui reads from.
+    std::unordered_map<std::string, ImFont*> fonts;
+    std::unordered_map<std::string, FontFile> font_files;
+    std::vector<PendingBake> pending_bakes;
+
+    // Which fonts each owner has asked for, for the debug counts. Fonts themselves are shared.
+    std::unordered_map<uint32_t, std::unordered_set<std::string>> font_keys_by_owner;
+
+    ImFont* GetDefaultFont()
+    {
+        ImGuiIO& io = ImGui::GetIO();
+        return io.FontDefault ? io.FontDefault : (io.Fonts->Fonts.empty() ? nullptr : io.Fonts->Fonts[0]);
+    }
+
+    const FontFile* MapFontFile(const std::filesystem::path& file_path)
+    {
+        const std::string key = file_path.string();
+        auto mapped = font_files.find(key);
+        if (mapped != font_files.end())
+        {
+            return &mapped->second;
+        }
+
+        // Archived fonts are read in place from the archive's own mapping.
+        FontFile file;
+        if (PackageArchive::ReadFile(file_path, file.archived))
+        {
+            file.data = file.archived.data;
+            file.size = file.archived.size;
+        }
+        else if (file.mapped.Open(file_path))
+        {
+            file.data = file.mapped.Data();
+            file.size = file.mapped.Size();
+        }
+        else
+        {
+            return nullptr;
+        }
+        return &(font_files[key] = std::move(file));
+    }
+}
+
+ImFont* FontManager::Load(const std::filesystem::path& file_path, float size_px, uint32_t owner)
+{
+    if (!ImGui::GetCurrentContext())
+    {
+        PLOG_WARNING << "Font requested before ImGui was initialized: " << file_path.string();
+        return nullptr;
+    }
+
+    const float size = size_px > 0.0f ? size_px : 0.0f;
+    const std::string cache_key = file_path.string() + "|" + std::to_string(size);
+    if (owner != 0)
+    {
+        font_keys_by_owner[owner].insert(cache_key);
+    }
+
+    auto cached = fonts.find(cache_key);
+    if (cached != fonts.end())
+    {
+        return cached->second;
+    }
+
+    // A failure is cached as the default font, so a script asking for a missing font every
+    // frame warns once instead of flooding the log.
+    ImFont* fallback = GetDefaultFont();
+
+    const FontFile* file = MapFontFile(file_path);
+    if (!file)
+    {
+        PLOG_WARNING << "Could not open font \"" << file_path.string() << "\". Falling back to the default font.";
+        fonts[cache_key] = fallback;
+        return fallback;
+    }
+
+    // The atlas reads straight from the mapped pages and must not try to free them.
+    // NoLoadError keeps a bad file from tripping ImGui's assert path.
+    ImFontConfig font_config;
+    font_config.FontDataOwnedByAtlas = false;
+    font_config.Flags |= ImFontFlags_NoLoadError;
+    ImFont* font = ImGui::GetIO().Fonts->AddFontFromMemoryTTF((void*)file->data, (int)file->size, size, &font_config);
+    if (!font)
+    {
+        PLOG_WARNING << "Failed to load font \"" << file_path.string() << "\". Falling back to the default font.";
+        fonts[cache_key] = fallback;
+        return fallback;
+    }
+
+    PLOG_DEBUG << "Loaded font \"" << file_path.string() << "\" at size " << size;
+    fonts[cache_key] = font;
+    return font;
+}
+
+void FontManager::Preload(const std::filesystem::path& file_path, const std::vector<float>& sizes_px,
+                          const std::vector<ImWchar>& glyph_ranges)
+{
+    for (float size : sizes_px)
+    {
+        ImFont* font = Load(file_path, size);
+        if (!font || font == GetDefaultFont())
+        {
+            continue;
+        }
+
+        // Size 0 fonts are drawn at ImGui's base size unless pushed with an explicit one.
+        const float bake_size = size > 0.0f ? size : ImGui::GetStyle().FontSizeBase;
+        pending_bakes.push_back({ font, bake_size, glyph_ranges });
+    }
+}
+
+void FontManager::BakePending()
+{
+    if (pending_bakes.empty())
+    {
+        return;
+    }
+
+    size_t glyph_count = 0;
+    for (const PendingBake& bake : pending_bakes)
+    {
+        ImFontBaked* baked = bake.font->GetFontBaked(bake.size);
+        if (!baked)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i + 1 < bake.glyph_ranges.size() && bake.glyph_ranges[i] != 0; i += 2)
+        {
+            for (unsigned int codepoint = bake.glyph_ranges[i]; codepoint <= bake.glyph_ranges[i + 1]; ++codepoint)
+            {
+                baked->FindGlyph((ImWchar)codepoint);
+                glyph_count++;
+            }
+        }
+    }
+
+    PLOG_DEBUG << "Preloaded " << glyph_count << " glyphs across " << pending_bakes.size() << " font sizes";
+    pending_bakes.clear();
+}
+
+void FontManager::ForgetOwner(uint32_t owner)
+{
+    font_keys_by_owner.erase(owner);
+}
+
+ResourceUsage FontManager::GetUsage(uint32_t owner)
+{
+    ResourceUsage usage;
+    auto keys = font_keys_by_owner.find(owner);
+    if (keys != font_keys_by_owner.end())
+    {
+        usage.count = keys->second.size();
+    }
+    return usage;
+}
+
+void FontManager::ReleaseAll()
+{
+    pending_bakes.clear();
+    font_keys_by_owner.clear();
+    fonts.clear();
+    font_files.clear();
+}
@@ -0,0 +1,77 @@
+/**
+ * @file font_manager.h
+ * @brief Fonts for forgescripts, loaded on demand or declared up front by packages.
+ *
+ * Font files are memory-mapped and handed to ImGui without a heap copy; the mapping lives as
+ * long as the ImGui context does. Each (file, size) pair gets one ImFont, so repeat loads from
+ * several scripts, or from a settings callback every frame, are a map lookup.
+ *
+ * Fonts a package declares in its manifest (see package_manifest.h) are added while the core
+ * initializes, and their glyphs are rasterized at the start of the first frame, before any
+ * script runs. Scripts asking for a preloaded font through UiForge.LoadFont get the baked
+ * ImFont back and never rasterize or re-upload the atlas mid-frame.
+ */
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include <imgui.h>
+
+#include "core\handle_table.h"
+
+class FontManager
+{
+    public:
+        /**
+         * @brief Returns the font for a file at a size, adding it to the atlas the first time.
+         *
+         * Failures (missing or unreadable files) are logged once and remembered, and the default
+         * font is returned in their place so PushFont is always safe.
+         *
+         * @param file_path Full path to a TTF/OTF file.
+         * @param size_px Size in pixels, or 0 for ImGui's default size.
+         * @param owner Owner tag the request is counted against (see GetUsage).
+         * @return The font, the default font on failure, or nullptr before ImGui is initialized.
+         */
+        static ImFont* Load(const std::filesystem::path& file_path, float size_px, uint32_t owner = 0);
+
+        /**
+         * @brief Adds a font now and queues its glyphs to be rasterized at the next frame.
+         *
+         * @param file_path Full path to a TTF/OTF file.
+         * @param sizes_px Sizes to preload; each becomes its own ImFont.
+         * @param glyph_ranges Inclusive codepoint pairs to rasterize, terminated by 0 (the same
+         * layout as ImFontConfig::GlyphRanges).
+         */
+        static void Preload(const std::filesystem::path& file_path, const std::vector<float>& sizes_px,
+                            const std::vector<ImWchar>& glyph_ranges);
+
+        /**
+         * @brief Rasterizes the glyphs queued by Preload.
+         *
+         * Must be called between ImGui::NewFrame and ImGui::Render so the atlas backend is live;
+         * the new glyph pages are uploaded with that frame. Does nothing when nothing is queued.
+         */
+        static void BakePending();
+
+        /**
+         * @brief Stops counting fonts against an owner.
+         *
+         * Fonts stay in the atlas: they are shared by every owner that asked for them, and the
+         * atlas keeps them for the life of the ImGui context.
+         */
+        static void ForgetOwner(uint32_t owner);
+
+        /**
+         * @brief Counts the distinct fonts an owner has asked for. Bytes are not reported, since
+         * the glyphs live in the shared font atlas.
+         */
+        static ResourceUsage GetUsage(uint32_t owner);
+
+        /**
+         * @brief Forgets every font and unmaps the font files. Called during core cleanup, after
+         * the ImGui context that referenced them is gone.
+         */
+        static void ReleaseAll();
+};
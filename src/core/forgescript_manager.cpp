@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <ctime>
 #include <filesystem>
@@ -11,7 +13,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include <windows.h>
 
@@ -21,6 +25,7 @@
 
 #include "core\util.h"
 #include "core\forgescript_manager.h"
+#include "core\script_resources.h"
 
 // Time stuff is hard
 static std::chrono::system_clock::time_point FileTimeToSystemClock(std::filesystem::file_time_type file_time)
@@ -43,47 +48,131 @@ static std::string FormatLocalTime(std::chrono::system_clock::time_point tp)
     return oss.str();
 }
 
+// One sized read rather than streaming the file through istreambuf_iterator a char at a time.
+static bool ReadWholeFile(const std::string& file_name, std::string& out_contents)
+{
+    std::ifstream file(file_name, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+
+    const std::streamsize size = file.tellg();
+    out_contents.resize((size_t)std::max<std::streamsize>(size, 0));
+    file.seekg(0, std::ios::beg);
+    return size <= 0 || (bool)file.read(out_contents.data(), size);
+}
+
+static int AppendChunk(lua_State*, const void* data, size_t size, void* out_bytecode)
+{
+    ((std::string*)out_bytecode)->append((const char*)data, size);
+    return 0;
+}
+
+// Dumps the function on top of the stack as LuaJIT bytecode. Debug info is kept, so errors raised
+// by the compiled chunk still name the script and line.
+static std::string DumpBytecode(lua_State* curr_lua_state)
+{
+    std::string bytecode;
+    lua_dump(curr_lua_state, AppendChunk, &bytecode);
+    return bytecode;
+}
+
 // ╔═══════════════════════════════════════════════════════════════════════════╗
 // ║                            ForgeScript Class                              ║
 // ╚═══════════════════════════════════════════════════════════════════════════╝
 
-ForgeScript::ForgeScript() : enabled(false) {}
+// Resource owner tags. 0 belongs to the core, so scripts start at 1.
+static uint32_t next_resource_owner = 1;
+
+ForgeScript::ForgeScript() : enabled(false), resource_owner(next_resource_owner++) {}
 
-ForgeScript::ForgeScript(const std::string file_name) : enabled(false), file_name(file_name)
+ForgeScript::ForgeScript(const std::string file_name) : enabled(false), file_name(file_name), resource_owner(next_resource_owner++)
 {
+    // Nothing is read here. Discovery only needs to know the script exists; its contents are
+    // loaded when it is first enabled (see Load()).
     stats = { 0 };
-    LoadFromDisk();
+}
+
+bool ForgeScript::Load(lua_State* compile_state)
+{
+    if (loaded)
+    {
+        return true;
+    }
+
+    try
+    {
+        LoadFromDisk();
+    }
+    catch (const std::exception& err)
+    {
+        PLOG_ERROR << "Error loading script: " << err.what();
+        return false;
+    }
+
+    // Compile once here so Run() only has to load bytecode each frame. A chunk that does not
+    // parse is left uncompiled, and Run() reports the syntax error as usual. Archived scripts
+    // may have been packed as bytecode already.
+    compiled_chunk.clear();
+    if (!(archived && archived_contents.bytecode))
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        lua_State* scratch_state = compile_state ? compile_state : luaL_newstate();
+        const std::string_view contents = Contents();
+        if (scratch_state && luaL_loadbuffer(scratch_state, contents.data(), contents.size(), file_name.c_str()) == LUA_OK)
+        {
+            compiled_chunk = DumpBytecode(scratch_state);
+        }
+        if (scratch_state)
+        {
+            lua_settop(scratch_state, 0);
+        }
+        if (scratch_state && !compile_state)
+        {
+            lua_close(scratch_state);
+        }
+        const auto end_time = std::chrono::steady_clock::now();
+        stats.time_to_compile = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+    }
 
     last_reload_time = std::chrono::system_clock::now();
     has_reload_time = true;
+    loaded = true;
+    return true;
+}
+
+bool ForgeScript::IsLoaded() const
+{
+    return loaded;
 }
 
 void ForgeScript::LoadFromDisk()
 {
-    std::ifstream file(file_name, std::ios::in | std::ios::binary);
-    if (!file)
+    // Archived scripts are read in place from the archive mapping; there is nothing to copy.
+    auto start_time = std::chrono::steady_clock::now();
+    archived = PackageArchive::ReadFile(file_name, archived_contents);
+    if (!archived && !ReadWholeFile(file_name, file_contents))
     {
         throw std::runtime_error("Could not open file: " + file_name);
     }
-
-    // Read the file contents into the file_contents string
-    auto start_time = std::chrono::steady_clock::now();
-    file.seekg(0, std::ios::end);
-    file_contents.clear();
-    file_contents.reserve(file.tellg());
-    file.seekg(0, std::ios::beg);
-    file_contents.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     auto end_time = std::chrono::steady_clock::now();
     stats.time_to_read_file_contents = std::chrono::duration_cast<std::chrono::microseconds>(end_time-start_time).count();
 
-    stats.script_size = file_contents.size();
+    stats.script_size = Contents().size();
 
     // hash the file contents
     start_time = std::chrono::steady_clock::now();
-    hash = std::hash<std::string>{}(file_contents);
+    hash = std::hash<std::string_view>{}(Contents());
     end_time = std::chrono::steady_clock::now();
     stats.time_to_hash_file_contents = std::chrono::duration_cast<std::chrono::microseconds>(end_time-start_time).count();
 
+    if (archived)
+    {
+        has_write_time = false;
+        return;
+    }
+
     try
     {
         observed_write_time = std::filesystem::last_write_time(file_name);
@@ -152,7 +241,8 @@ void ForgeScript::Run(lua_State* curr_lua_state)
     }
 
     auto start_time = std::chrono::steady_clock::now();
-    int load_result = luaL_loadbuffer(curr_lua_state, file_contents.c_str(), file_contents.size(), file_name.c_str());
+    const std::string_view contents = compiled_chunk.empty() ? Contents() : std::string_view(compiled_chunk);
+    int load_result = luaL_loadbuffer(curr_lua_state, contents.data(), contents.size(), file_name.c_str());
     if(load_result != LUA_OK)
     {
         
@@ -165,32 +255,23 @@ void ForgeScript::Run(lua_State* curr_lua_state)
     auto end_time = std::chrono::steady_clock::now();
     stats.total_time_loading_from_mem += std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
 
-    // This is how we run the script in its own "isolated" environment
+    // This is how we run the script in its own "isolated" environment. A script that was
+    // disabled since its last run starts over, as its old globals may hold released handles.
+    if (env_stale)
+    {
+        ResetLuaEnvironment(curr_lua_state);
+        env_stale = false;
+    }
     EnsureLuaEnvironment(curr_lua_state);
     lua_rawgeti(curr_lua_state, LUA_REGISTRYINDEX, env_ref); // push env
     lua_setfenv(curr_lua_state, -2);                         // set env
 
-    // Packaged scripts get their own modules folder prepended to package.path for the
-    // duration of this run, so their local require() calls resolve locally before the
-    // shared modules directory. The original path is restored afterwards so loose
-    // scripts and other packages are unaffected.
-    sol::state_view lua(curr_lua_state);
-    std::string saved_package_path;
-    const bool swap_package_path = !package_modules_dir.empty();
-    if (swap_package_path)
-    {
-        saved_package_path = lua["package"]["path"].get<std::string>();
-        lua["package"]["path"] = package_modules_dir + "\\?.lua;" + package_modules_dir + "\\?\\?.lua;" + saved_package_path;
-    }
-
+    // A packaged script's local require() calls resolve in its own modules folder first
+    // through the core's package module searcher, which looks at the currently executing
+    // script, so nothing about package.path changes per run.
     start_time = std::chrono::steady_clock::now();
     int call_result = lua_pcall(curr_lua_state, 0, 0,  0);
 
-    if (swap_package_path)
-    {
-        lua["package"]["path"] = saved_package_path;
-    }
-
     if(call_result != LUA_OK)
     {
         const char* lua_error = lua_tostring(curr_lua_state, -1);
@@ -203,74 +284,81 @@ void ForgeScript::Run(lua_State* curr_lua_state)
     stats.times_executed++;
 }
 
-void ForgeScript::Reload(lua_State* curr_lua_state)
+void ForgeScript::PrepareReload(lua_State* compile_state, ForgeScriptReload& out_reload)
 {
-    std::string new_contents;
-    ForgeScriptDebug new_stats = stats;
-    std::size_t new_hash = hash;
-    bool new_has_write_time = false;
-    std::filesystem::file_time_type new_write_time{};
-
+    // Runs on the reload worker: it may only use its arguments, never a ForgeScript.
     try
     {
-        // Try to open the file, if we can't then error out.
-        std::ifstream file(file_name, std::ios::in | std::ios::binary);
-        if (!file)
+        // Grab the new contents and the stats related to that for the debug window and such.
+        auto start_time = std::chrono::steady_clock::now();
+        if (out_reload.archived)
+        {
+            if (!PackageArchive::ReadFile(out_reload.file_name, out_reload.archived_contents))
+            {
+                out_reload.error = "Could not read archived script for reload: " + out_reload.file_name;
+                return;
+            }
+        }
+        else if (!ReadWholeFile(out_reload.file_name, out_reload.contents))
         {
-            PLOG_ERROR << "Could not open script file for reload: " << file_name;
+            out_reload.error = "Could not open script file for reload: " + out_reload.file_name;
             return;
         }
-
-        // Grab the new contents and the stats related to that for the debug window and such.
-        auto start_time = std::chrono::steady_clock::now();
-        file.seekg(0, std::ios::end);
-        new_contents.reserve(file.tellg());
-        file.seekg(0, std::ios::beg);
-        new_contents.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const std::string_view new_view = out_reload.archived
+            ? std::string_view(out_reload.archived_contents.data, out_reload.archived_contents.size)
+            : std::string_view(out_reload.contents);
         auto end_time = std::chrono::steady_clock::now();
-        new_stats.time_to_read_file_contents = std::chrono::duration_cast<std::chrono::microseconds>(end_time-start_time).count();
-        new_stats.script_size = new_contents.size();
+        out_reload.time_to_read_file_contents = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
 
         start_time = std::chrono::steady_clock::now();
-        new_hash = std::hash<std::string>{}(new_contents);
+        out_reload.hash = std::hash<std::string_view>{}(new_view);
         end_time = std::chrono::steady_clock::now();
-        new_stats.time_to_hash_file_contents = std::chrono::duration_cast<std::chrono::microseconds>(end_time-start_time).count();
+        out_reload.time_to_hash_file_contents = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
 
         // Get the write time of the file
-        try
+        std::error_code ec;
+        if (!out_reload.archived)
         {
-            new_write_time = std::filesystem::last_write_time(file_name);
-            new_has_write_time = true;
+            out_reload.write_time = std::filesystem::last_write_time(out_reload.file_name, ec);
+            out_reload.has_write_time = !ec;
         }
-        catch(...)
+
+        // Compile the new version, which also tells us whether it is valid.
+        start_time = std::chrono::steady_clock::now();
+        if (luaL_loadbuffer(compile_state, new_view.data(), new_view.size(), out_reload.file_name.c_str()) != LUA_OK)
         {
-            new_has_write_time = false;
+            const char* lua_error = lua_tostring(compile_state, -1);
+            out_reload.error = "Hot-reload failed for " + out_reload.file_name + ": " + (lua_error ? lua_error : "(unknown error)");
         }
+        else
+        {
+            out_reload.compiled_chunk = DumpBytecode(compile_state);
+        }
+        lua_settop(compile_state, 0);
+        end_time = std::chrono::steady_clock::now();
+        out_reload.time_to_compile = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
     }
     catch (const std::exception& err)
     {
-        PLOG_ERROR << "Exception reading script for reload (" << file_name << "): " << err.what();
-        return;
+        out_reload.error = "Exception reading script for reload (" + out_reload.file_name + "): " + err.what();
     }
+}
 
-    // Try to parse the new lua file to make sure it is valid
-    const int is_script_valid = luaL_loadbuffer(curr_lua_state, new_contents.c_str(), new_contents.size(), file_name.c_str());
-    if (is_script_valid != LUA_OK)
+void ForgeScript::ApplyReload(lua_State* curr_lua_state, ForgeScriptReload& reload)
+{
+    if (!reload.error.empty())
     {
-        const char* lua_error = lua_tostring(curr_lua_state, -1);
-        PLOG_ERROR << "Hot-reload failed for " << file_name << ": " << (lua_error ? lua_error : "(unknown error)");
-        lua_pop(curr_lua_state, 1);
+        PLOG_ERROR << reload.error;
 
         // Don't spam retries every frame for the same bad save. We'll try again when the file changes again.
-        if (new_has_write_time)
+        if (reload.has_write_time)
         {
-            observed_write_time = new_write_time;
-            loaded_write_time = new_write_time;
+            observed_write_time = reload.write_time;
+            loaded_write_time = reload.write_time;
             has_write_time = true;
         }
         return;
     }
-    lua_pop(curr_lua_state, 1); // pop the parsed chunk
 
     // We want to perform any cleanup from the script disable callback so we can cleanly close the script.
     const bool was_enabled = enabled;
@@ -279,7 +367,7 @@ void ForgeScript::Reload(lua_State* curr_lua_state)
         Disable();
     }
 
-    // Clear callbacks.
+    // Clear callbacks. Disable() already did for an enabled script.
     settings_callback = sol::protected_function();
     disable_script_callback = sol::protected_function();
     save_callback = sol::protected_function();
@@ -287,23 +375,29 @@ void ForgeScript::Reload(lua_State* curr_lua_state)
     on_eject_callback = sol::protected_function();
 
     ResetLuaEnvironment(curr_lua_state);
-
-    // Apply new version.
-    file_contents.swap(new_contents);
-    hash = new_hash;
-    stats.time_to_read_file_contents = new_stats.time_to_read_file_contents;
-    stats.time_to_hash_file_contents = new_stats.time_to_hash_file_contents;
-    stats.script_size = new_stats.script_size;
+    env_stale = false;
+
+    // Apply new version. Its modules are looked up afresh, since files may have been added.
+    ClearModulePathCache();
+    file_contents.swap(reload.contents);
+    archived_contents = std::move(reload.archived_contents);
+    compiled_chunk.swap(reload.compiled_chunk);
+    loaded = true;
+    hash = reload.hash;
+    stats.time_to_read_file_contents = reload.time_to_read_file_contents;
+    stats.time_to_hash_file_contents = reload.time_to_hash_file_contents;
+    stats.time_to_compile = reload.time_to_compile;
+    stats.script_size = Contents().size();
 
     // Reset runtime stats for the new version.
     stats.total_time_executing = 0;
     stats.total_time_loading_from_mem = 0;
     stats.times_executed = 0;
 
-    if (new_has_write_time)
+    if (reload.has_write_time)
     {
-        observed_write_time = new_write_time;
-        loaded_write_time = new_write_time;
+        observed_write_time = reload.write_time;
+        loaded_write_time = reload.write_time;
         has_write_time = true;
     }
 
@@ -385,6 +479,12 @@ void ForgeScript::RunOnEjectCallback()
 
 void ForgeScript::Enable()
 {
+    // Scripts are read on first enable; one that cannot be read stays disabled.
+    if (!Load())
+    {
+        return;
+    }
+
     enabled = true;
 }
 
@@ -399,6 +499,20 @@ void ForgeScript::Disable()
 
     enabled = false;
     RunDisableScriptCallback();
+
+    // Whatever the script didn't release (or Keep) itself is reclaimed here, after its
+    // disable callback had its chance to clean up.
+    ScriptResources::ReleaseOwnedBy(resource_owner);
+
+    // The callbacks close over the old environment; the script registers them again
+    // when it next runs. Disable() has no lua_State, so the environment itself is
+    // reset at the start of that run.
+    settings_callback = sol::protected_function();
+    disable_script_callback = sol::protected_function();
+    save_callback = sol::protected_function();
+    load_callback = sol::protected_function();
+    on_eject_callback = sol::protected_function();
+    env_stale = true;
 }
 
 bool ForgeScript::IsEnabled() const
@@ -411,6 +525,11 @@ std::string ForgeScript::GetFileName()
     return file_name;
 }
 
+uint32_t ForgeScript::GetResourceOwner() const
+{
+    return resource_owner;
+}
+
 std::filesystem::file_time_type ForgeScript::GetLastWriteTime() const
 {
     return observed_write_time;
@@ -443,6 +562,12 @@ std::string ForgeScript::GetLastReloadTimeString() const
 
 bool ForgeScript::IsOutOfDateOnDisk()
 {
+    // Archives are not rewritten while mounted.
+    if (archived)
+    {
+        return false;
+    }
+
     try
     {
         const auto current_write_time = std::filesystem::last_write_time(file_name);
@@ -465,7 +590,12 @@ bool ForgeScript::IsOutOfDateOnDisk()
 
 std::string ForgeScript::GetContents()
 {
-    return file_contents;
+    return std::string(Contents());
+}
+
+std::string_view ForgeScript::Contents() const
+{
+    return archived ? std::string_view(archived_contents.data, archived_contents.size) : std::string_view(file_contents);
 }
 
 std::size_t ForgeScript::GetHash()
@@ -473,11 +603,17 @@ std::size_t ForgeScript::GetHash()
     return hash;
 }
 
+bool ForgeScript::IsArchived() const
+{
+    return archived;
+}
+
 void ForgeScript::SetPackageDirectory(const std::string& directory_path)
 {
     package_dir = directory_path;
     package_modules_dir.clear();
     package_resources_dir.clear();
+    ClearModulePathCache();
 
     if (package_dir.empty())
     {
@@ -488,18 +624,45 @@ void ForgeScript::SetPackageDirectory(const std::string& directory_path)
     // per-frame Run() path never has to touch the filesystem.
     std::error_code ec;
     const std::filesystem::path modules_candidate = std::filesystem::path(package_dir) / "modules";
-    if (std::filesystem::is_directory(modules_candidate, ec))
+    if (PackageArchive::IsDirectory(modules_candidate) || std::filesystem::is_directory(modules_candidate, ec))
     {
         package_modules_dir = modules_candidate.string();
     }
 
     const std::filesystem::path resources_candidate = std::filesystem::path(package_dir) / "resources";
-    if (std::filesystem::is_directory(resources_candidate, ec))
+    if (PackageArchive::IsDirectory(resources_candidate) || std::filesystem::is_directory(resources_candidate, ec))
     {
         package_resources_dir = resources_candidate.string();
     }
 }
 
+bool ForgeScript::FindCachedModulePath(const std::string& module_name, std::string& out_path) const
+{
+    auto cached = module_path_cache.find(module_name);
+    if (cached == module_path_cache.end())
+    {
+        return false;
+    }
+
+    out_path = cached->second;
+    return true;
+}
+
+void ForgeScript::CacheModulePath(const std::string& module_name, const std::string& module_path)
+{
+    module_path_cache[module_name] = module_path;
+}
+
+void ForgeScript::ClearModulePathCache()
+{
+    module_path_cache.clear();
+}
+
+std::string ForgeScript::GetPackageDirectory() const
+{
+    return package_dir;
+}
+
 std::string ForgeScript::GetPackageModulesDir() const
 {
     return package_modules_dir;
@@ -516,6 +679,16 @@ ForgeScript::~ForgeScript(){}
 // ║                          ForgeScriptManager Class                         ║
 // ╚═══════════════════════════════════════════════════════════════════════════╝
 
+// Upper bound on the threads LoadScripts starts; script loads are short and mostly I/O.
+static constexpr unsigned MAX_LOAD_THREADS = 8;
+
+// Most prepared reloads ProcessPendingReloads swaps in per frame, so a reload-all is spread out.
+static constexpr unsigned MAX_RELOAD_SWAPS_PER_FRAME = 2;
+
+// How long the scripts tree must be quiet after a change before reloading, so the several writes
+// an editor makes per save cause one reload.
+static constexpr unsigned FILE_WATCH_DEBOUNCE_MS = 150;
+
 #define FIND_SCRIPT_BY_NAME(name) [&name](const std::unique_ptr<ForgeScript>& script){ return script->GetFileName() == name;}
 
 static std::string ToLowerCopy(const std::string& value)
@@ -526,18 +699,88 @@ static std::string ToLowerCopy(const std::string& value)
     return lowered;
 }
 
+// Replaces the global require. Scripts run every frame, so their top-level requires run every
+// frame too; only the first call for each requirer/name pair is reported, before the real require
+// runs. The requirer is the module being loaded when the call is nested inside another module's
+// require, and nil (meaning the running script) otherwise. Scripts are told apart by their
+// environment tables, which are replaced on reload and disable, so a restarted script reports its
+// requires again; a module's edges are forgotten whenever it is loaded afresh. A call from the
+// global environment cannot be tied to one script and is always reported. An already loaded
+// module requires nothing further, so it skips the bookkeeping pcall.
+static const char* REQUIRE_WRAPPER_SOURCE = R"(
+local original_require, record_require = ...
+local globals = _G
+local package_loaded = package.loaded
+local getfenv, getinfo = getfenv, debug.getinfo
+local loading = {}
+local reported = setmetatable({}, { __mode = "k" })
+return function(name)
+    local parent = loading[#loading]
+    if type(name) == "string" then
+        if not package_loaded[name] then
+            reported[name] = nil
+        end
+        local requirer = parent
+        if requirer == nil then
+            local caller = getinfo(2, "f")
+            requirer = caller and getfenv(caller.func) or globals
+        end
+        if requirer == globals then
+            record_require(parent, name)
+        else
+            local names = reported[requirer]
+            if names == nil then
+                names = {}
+                reported[requirer] = names
+            end
+            if not names[name] then
+                names[name] = true
+                record_require(parent, name)
+            end
+        end
+    end
+    if package_loaded[name] then
+        return original_require(name)
+    end
+    loading[#loading + 1] = name
+    local ok, result = pcall(original_require, name)
+    loading[#loading] = nil
+    if not ok then
+        error(result, 0)
+    end
+    return result
+end
+)";
+
+// Both arguments lowercased and normalized.
+static bool IsPathInside(const std::string& path, const std::string& directory)
+{
+    return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0
+        && (path[directory.size()] == '\\' || path[directory.size()] == '/');
+}
+
+static std::string ComparablePath(const std::filesystem::path& file_path)
+{
+    return ToLowerCopy(file_path.lexically_normal().string());
+}
+
+static bool IsScriptFile(const std::filesystem::path& file_path)
+{
+    std::error_code ec;
+    return PackageArchive::ContainsFile(file_path) || std::filesystem::is_regular_file(file_path, ec);
+}
+
 // A subdirectory of the scripts folder is a script package when it contains an entry
 // script directly inside it. The entry script is, in order of preference:
 // "<dir name>.lua", "main.lua", "init.lua". Returns the full path of the entry script,
-// or "" when the directory is not a package.
+// or "" when the directory is not a package. Works for packages inside mounted archives too.
 static std::string FindPackageEntryScript(const std::filesystem::path& package_dir)
 {
     const std::string dir_name = package_dir.filename().string();
     const char* fallbacks[] = { "main.lua", "init.lua" };
 
-    std::error_code ec;
     const std::filesystem::path named_entry = package_dir / (dir_name + ".lua");
-    if (std::filesystem::is_regular_file(named_entry, ec))
+    if (IsScriptFile(named_entry))
     {
         return named_entry.string();
     }
@@ -545,7 +788,7 @@ static std::string FindPackageEntryScript(const std::filesystem::path& package_d
     for (const char* fallback : fallbacks)
     {
         const std::filesystem::path candidate = package_dir / fallback;
-        if (std::filesystem::is_regular_file(candidate, ec))
+        if (IsScriptFile(candidate))
         {
             return candidate.string();
         }
@@ -570,6 +813,8 @@ ForgeScriptManager::ForgeScriptManager(std::string scripts_path, lua_State* uif_
         this->excluded_subdirs.push_back(ToLowerCopy(name));
     }
 
+    InstallRequireTracking();
+
     // Discover loose scripts and script packages. RefreshScripts holds the one true
     // discovery logic; with no scripts loaded yet it simply adds everything it finds.
     RefreshScripts();
@@ -585,6 +830,11 @@ void ForgeScriptManager::AddScript(const std::string file_name, const std::strin
             script->SetPackageDirectory(package_dir);
         }
         scripts.emplace_back(std::move(script));
+
+        if (!package_dir.empty() && package_added_callback)
+        {
+            package_added_callback(scripts.back().get());
+        }
     }
     catch(const std::exception& err)
     {
@@ -603,8 +853,13 @@ void ForgeScriptManager::RemoveScript(const std::string file_name)
 
 void ForgeScriptManager::RunScripts()
 {
-    // periodically poll for file changes and queue reloads before executing the frame.
-    if (reload_on_save_enabled)
+    // Queue reloads for whatever changed before executing the frame. The watcher has already
+    // done the waiting; polling write times is the fallback when the tree cannot be watched.
+    if (reload_on_save_enabled && file_watcher.IsRunning())
+    {
+        HandleFileChanges(file_watcher.TakeChanges());
+    }
+    else if (reload_on_save_enabled)
     {
         const auto now = std::chrono::steady_clock::now();
         const bool should_poll = !reload_on_save_has_polled ||
@@ -665,52 +920,284 @@ void ForgeScriptManager::SetReloadOnSave(bool enabled, unsigned poll_ms)
     reload_on_save_enabled = enabled;
     reload_on_save_poll_ms = poll_ms;
     reload_on_save_has_polled = false;
+
+    file_watcher.Stop();
+    if (enabled && !file_watcher.Start({ scripts_path }, FILE_WATCH_DEBOUNCE_MS))
+    {
+        PLOG_WARNING << "Cannot watch " << scripts_path << " for changes; polling script write times every " << poll_ms << " ms instead.";
+    }
+}
+
+void ForgeScriptManager::HandleFileChanges(const std::vector<std::filesystem::path>& changed_paths)
+{
+    if (changed_paths.empty())
+    {
+        return;
+    }
+
+    const std::string scripts_root = ComparablePath(scripts_path);
+    std::vector<std::string> module_roots;
+    for (const std::string& module_root : GetModuleRoots())
+    {
+        module_roots.push_back(ComparablePath(module_root));
+    }
+
+    bool refresh = false;
+    bool reload_all = false;
+    std::vector<std::string> changed_modules;
+
+    for (const std::filesystem::path& changed_path : changed_paths)
+    {
+        const std::string changed = ComparablePath(changed_path);
+        if (changed == scripts_root)
+        {
+            // The watcher lost track of individual changes; assume everything changed.
+            refresh = true;
+            reload_all = true;
+            continue;
+        }
+
+        // Scripts that were never loaded read their current contents when first enabled.
+        bool matched = false;
+        for (const auto& script : scripts)
+        {
+            if (!script->IsLoaded())
+            {
+                continue;
+            }
+
+            const std::string package_dir = script->GetPackageDirectory();
+            if (changed == ComparablePath(script->GetFileName()) || (!package_dir.empty() && IsPathInside(changed, ComparablePath(package_dir))))
+            {
+                pending_reload.emplace(script->GetFileName());
+                matched = true;
+            }
+        }
+
+        // Module files reload the scripts that depend on them (see QueueModuleReloads). A new
+        // module file may also be one a script was told does not exist.
+        if (std::any_of(module_roots.begin(), module_roots.end(), [&](const std::string& root) { return IsPathInside(changed, root); }))
+        {
+            changed_modules.push_back(changed);
+            continue;
+        }
+
+        // Something new directly in the scripts directory (a loose script, archive or package
+        // directory) or a new entry script inside a package directory.
+        const std::filesystem::path relative = std::filesystem::path(changed).lexically_relative(scripts_root);
+        const size_t depth = (size_t)std::distance(relative.begin(), relative.end());
+        const bool excluded = depth > 0 && std::find(excluded_subdirs.begin(), excluded_subdirs.end(), relative.begin()->string()) != excluded_subdirs.end();
+        if (!matched && !excluded && (depth == 1 || (depth == 2 && relative.extension() == ".lua")))
+        {
+            refresh = true;
+        }
+    }
+
+    if (refresh)
+    {
+        RefreshScripts();
+    }
+
+    if (!changed_modules.empty())
+    {
+        for (const auto& script : scripts)
+        {
+            script->ClearModulePathCache();
+        }
+        QueueModuleReloads(changed_modules);
+    }
+
+    if (reload_all)
+    {
+        for (const auto& script : scripts)
+        {
+            if (script->IsLoaded())
+            {
+                RequestReload(script->GetFileName());
+            }
+        }
+    }
+}
+
+void ForgeScriptManager::QueueModuleReloads(const std::vector<std::string>& changed_files)
+{
+    // Modules in the graph whose source is one of the changed files. Names are matched to files
+    // the way require() resolves them, without touching the filesystem.
+    std::unordered_set<std::string> affected;
+    for (const auto& [requirer, modules] : dependency_graph)
+    {
+        for (const std::string& module_name : modules)
+        {
+            for (const std::filesystem::path& candidate : GetModuleFileCandidates(module_name))
+            {
+                if (std::find(changed_files.begin(), changed_files.end(), ComparablePath(candidate)) != changed_files.end())
+                {
+                    affected.insert(module_name);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Walk up the graph: a module that requires an affected module is affected too, and every
+    // script requiring an affected module is reloaded. Nothing else is touched.
+    std::vector<std::string> frontier(affected.begin(), affected.end());
+    while (!frontier.empty())
+    {
+        const std::string module_name = frontier.back();
+        frontier.pop_back();
+
+        for (const std::string& dependent : GetModuleDependents(module_name))
+        {
+            if (GetScript(dependent))
+            {
+                if (pending_reload.emplace(dependent).second)
+                {
+                    PLOG_INFO << "Reloading " << dependent << " because module '" << module_name << "' changed";
+                }
+            }
+            else if (affected.insert(dependent).second)
+            {
+                frontier.push_back(dependent);
+            }
+        }
+    }
+
+    pending_module_purge.insert(affected.begin(), affected.end());
 }
 
 void ForgeScriptManager::RequestReload(const std::string& file_name)
 {
+    // A reload asked for by hand should pick up module edits too, so the modules the script
+    // uses are dropped along with it.
     pending_reload.emplace(file_name);
+    for (const std::string& module_name : GetModuleClosure(file_name))
+    {
+        if (IsUserModule(module_name))
+        {
+            pending_module_purge.insert(module_name);
+        }
+    }
 }
 
 void ForgeScriptManager::RequestReloadAll()
 {
     for (const auto& script : scripts)
     {
-        pending_reload.emplace(script->GetFileName());
+        RequestReload(script->GetFileName());
     }
 }
 
 void ForgeScriptManager::ProcessPendingReloads()
 {
-    if (pending_reload.empty())
+    PurgeModules(pending_module_purge);
+    pending_module_purge.clear();
+
+    // Hand new requests to the worker. A script already queued there is read when its turn
+    // comes, so it is not queued twice.
+    if (!pending_reload.empty())
     {
-        return;
-    }
+        std::lock_guard<std::mutex> lock(reload_mutex);
+        for (const auto& file_name : pending_reload)
+        {
+            // A script that was never loaded reads its current contents when it is first enabled.
+            ForgeScript* script = GetScript(file_name);
+            const bool queued = std::any_of(reload_jobs.begin(), reload_jobs.end(),
+                [&](const ForgeScriptReload& job) { return job.file_name == file_name; });
+            if (!script || !script->IsLoaded() || queued)
+            {
+                continue;
+            }
 
-    // Drop cached user modules so the reloaded scripts pick up module edits too.
-    PurgeUserModuleCache();
+            ForgeScriptReload job;
+            job.file_name = file_name;
+            job.archived = script->IsArchived();
+            reload_jobs.push_back(std::move(job));
+        }
+        pending_reload.clear();
 
-    for (const auto& file_name : pending_reload)
+        if (!reload_thread.joinable())
+        {
+            reload_thread = std::thread(&ForgeScriptManager::RunReloadWorker, this);
+        }
+        reload_jobs_changed.notify_one();
+    }
+
+    // Swap in what the worker has finished, a few scripts per frame. Each swap re-runs a
+    // script's setup, which is the part that cannot move off this thread.
+    for (unsigned swaps = 0; swaps < MAX_RELOAD_SWAPS_PER_FRAME; ++swaps)
     {
-        ForgeScript* script = GetScript(file_name);
+        ForgeScriptReload reload;
+        {
+            std::lock_guard<std::mutex> lock(reload_mutex);
+            if (prepared_reloads.empty())
+            {
+                break;
+            }
+            reload = std::move(prepared_reloads.front());
+            prepared_reloads.pop_front();
+        }
+
+        ForgeScript* script = GetScript(reload.file_name);
         if (!script)
         {
             continue;
         }
 
+        // Its requires are recorded again as the new version runs.
+        if (reload.error.empty())
+        {
+            dependency_graph.erase(reload.file_name);
+        }
+
         try
         {
-            script->Reload(uif_lua_state);
+            script->ApplyReload(uif_lua_state, reload);
         }
         catch (const std::exception& err)
         {
-            PLOG_ERROR << "Error reloading script " << file_name << ": " << err.what();
+            PLOG_ERROR << "Error reloading script " << reload.file_name << ": " << err.what();
             CoreUtils::ErrorMessageBox(err.what());
             script->Disable();
         }
     }
+}
+
+void ForgeScriptManager::RunReloadWorker()
+{
+    // One scratch state for the worker's lifetime; it only ever parses.
+    lua_State* compile_state = luaL_newstate();
+
+    std::unique_lock<std::mutex> lock(reload_mutex);
+    for (;;)
+    {
+        reload_jobs_changed.wait(lock, [this] { return reload_thread_stopping || !reload_jobs.empty(); });
+        if (reload_thread_stopping)
+        {
+            break;
+        }
+
+        ForgeScriptReload reload = std::move(reload_jobs.front());
+        reload_jobs.pop_front();
+        lock.unlock();
+
+        if (compile_state)
+        {
+            ForgeScript::PrepareReload(compile_state, reload);
+        }
+        else
+        {
+            reload.error = "Hot-reload failed for " + reload.file_name + ": could not create a Lua state to compile in";
+        }
+
+        lock.lock();
+        prepared_reloads.push_back(std::move(reload));
+    }
 
-    pending_reload.clear();
+    if (compile_state)
+    {
+        lua_close(compile_state);
+    }
 }
 
 void ForgeScriptManager::RegisterCallback(ForgeScriptCallbackType type, sol::protected_function callback)
@@ -775,22 +1262,11 @@ void ForgeScriptManager::RunSettingsCallback(ForgeScript* script)
 
     // Settings callbacks run from the UI, outside the RunScripts() loop, so the
     // currently executing script has to be set here for per-script resource
-    // resolution and callback registration to work from inside them. A packaged
-    // script's local modules folder is also given package.path priority, matching
-    // the behavior of its main chunk.
+    // resolution, package-local require() and callback registration to work from
+    // inside them.
     ForgeScript* previous = currently_executing_script;
     currently_executing_script = script;
 
-    sol::state_view lua(uif_lua_state);
-    std::string saved_package_path;
-    const std::string package_modules = script->GetPackageModulesDir();
-    const bool swap_package_path = !package_modules.empty();
-    if (swap_package_path)
-    {
-        saved_package_path = lua["package"]["path"].get<std::string>();
-        lua["package"]["path"] = package_modules + "\\?.lua;" + package_modules + "\\?\\?.lua;" + saved_package_path;
-    }
-
     // No manual ImGui state recovery here. The callback draws inside the settings
     // window's tab bar, and ErrorRecoveryTryToRecoverState force-closes any tab bar
     // open on the current window (ImGui cannot recover from inside a tab item).
@@ -801,18 +1277,10 @@ void ForgeScriptManager::RunSettingsCallback(ForgeScript* script)
     }
     catch (...)
     {
-        if (swap_package_path)
-        {
-            lua["package"]["path"] = saved_package_path;
-        }
         currently_executing_script = previous;
         throw;
     }
 
-    if (swap_package_path)
-    {
-        lua["package"]["path"] = saved_package_path;
-    }
     currently_executing_script = previous;
 }
 
@@ -854,11 +1322,111 @@ void ForgeScriptManager::SetModulesDirectory(const std::string& directory_path)
     modules_path = directory_path;
 }
 
-void ForgeScriptManager::PurgeUserModuleCache()
+void ForgeScriptManager::SetPackageAddedCallback(std::function<void(ForgeScript*)> callback)
+{
+    package_added_callback = std::move(callback);
+}
+
+void ForgeScriptManager::InstallRequireTracking()
+{
+    sol::state_view lua(uif_lua_state);
+    sol::load_result wrapper_chunk = lua.load(REQUIRE_WRAPPER_SOURCE, "=uiforge_require");
+    if (!wrapper_chunk.valid())
+    {
+        sol::error err = wrapper_chunk;
+        PLOG_ERROR << "Failed to build the require wrapper: " << err.what();
+        return;
+    }
+
+    sol::protected_function make_wrapper = wrapper_chunk;
+    auto record_require = [this](sol::object parent_module, sol::object module_name)
+    {
+        RecordRequire(parent_module, module_name);
+    };
+    auto wrapper = make_wrapper(lua["require"], sol::make_object(lua, record_require));
+    if (!wrapper.valid())
+    {
+        sol::error err = wrapper;
+        PLOG_ERROR << "Failed to build the require wrapper: " << err.what();
+        return;
+    }
+
+    lua["require"] = wrapper.get<sol::object>();
+}
+
+void ForgeScriptManager::RecordRequire(const sol::object& parent_module, const sol::object& module_name)
+{
+    if (!module_name.is<std::string>())
+    {
+        return;
+    }
+
+    // Requires made outside any script (the core's own) are not part of the graph.
+    std::string requirer;
+    if (parent_module.is<std::string>())
+    {
+        requirer = parent_module.as<std::string>();
+    }
+    else if (currently_executing_script)
+    {
+        requirer = currently_executing_script->GetFileName();
+    }
+    else
+    {
+        return;
+    }
+
+    dependency_graph[requirer].insert(module_name.as<std::string>());
+}
+
+std::set<std::string> ForgeScriptManager::GetRequiredModules(const std::string& requirer) const
+{
+    auto node = dependency_graph.find(requirer);
+    return node == dependency_graph.end() ? std::set<std::string>() : node->second;
+}
+
+std::set<std::string> ForgeScriptManager::GetModuleDependents(const std::string& module_name) const
+{
+    std::set<std::string> dependents;
+    for (const auto& [requirer, modules] : dependency_graph)
+    {
+        if (modules.count(module_name))
+        {
+            dependents.insert(requirer);
+        }
+    }
+    return dependents;
+}
+
+std::set<std::string> ForgeScriptManager::GetModuleClosure(const std::string& requirer) const
+{
+    std::set<std::string> closure;
+    std::vector<std::string> frontier = { requirer };
+    while (!frontier.empty())
+    {
+        const std::string node = frontier.back();
+        frontier.pop_back();
+
+        auto required = dependency_graph.find(node);
+        if (required == dependency_graph.end())
+        {
+            continue;
+        }
+        for (const std::string& module_name : required->second)
+        {
+            if (closure.insert(module_name).second)
+            {
+                frontier.push_back(module_name);
+            }
+        }
+    }
+    return closure;
+}
+
+std::vector<std::string> ForgeScriptManager::GetModuleRoots() const
 {
-    // User modules can live in the shared modules directory or in a packaged
-    // script's own modules folder; both are purged so hot reloads pick up edits
-    // to either kind.
+    // User modules can live in the shared modules directory or in a packaged script's own
+    // modules folder.
     std::vector<std::string> module_roots;
     if (!modules_path.empty())
     {
@@ -872,8 +1440,43 @@ void ForgeScriptManager::PurgeUserModuleCache()
             module_roots.push_back(package_modules);
         }
     }
+    return module_roots;
+}
+
+std::vector<std::filesystem::path> ForgeScriptManager::GetModuleFileCandidates(const std::string& module_name) const
+{
+    // Resolve the module name the same way require() does with our package.path patterns
+    // ("<modules>\?.lua" and "<modules>\?\?.lua"): dots become path separators.
+    std::string relative = module_name;
+    std::replace(relative.begin(), relative.end(), '.', '\\');
 
-    if (module_roots.empty())
+    std::vector<std::filesystem::path> candidates;
+    for (const std::string& root : GetModuleRoots())
+    {
+        candidates.push_back(std::filesystem::path(root) / (relative + ".lua"));
+        candidates.push_back(std::filesystem::path(root) / relative / (relative + ".lua"));
+    }
+    return candidates;
+}
+
+bool ForgeScriptManager::IsUserModule(const std::string& module_name) const
+{
+    // Only names backed by a file under one of the module roots are user modules; everything
+    // else (built-ins, embedded serpent) is kept.
+    for (const std::filesystem::path& candidate : GetModuleFileCandidates(module_name))
+    {
+        std::error_code ec;
+        if (PackageArchive::ContainsFile(candidate) || std::filesystem::exists(candidate, ec))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ForgeScriptManager::PurgeModules(const std::unordered_set<std::string>& module_names)
+{
+    if (module_names.empty())
     {
         return;
     }
@@ -886,40 +1489,12 @@ void ForgeScriptManager::PurgeUserModuleCache()
     }
     sol::table loaded = loaded_obj.as<sol::table>();
 
-    // Collect first, purge after -- removing keys while iterating a Lua table is undefined.
-    std::vector<std::string> to_purge;
-    for (const auto& entry : loaded)
-    {
-        if (!entry.first.is<std::string>())
-        {
-            continue;
-        }
-
-        // Resolve the module name the same way require() does with our package.path
-        // patterns ("<modules>\?.lua" and "<modules>\?\?.lua"): dots become path
-        // separators. Only names backed by a real file under one of the module roots
-        // are user modules; everything else (built-ins, embedded serpent) is kept.
-        std::string relative = entry.first.as<std::string>();
-        std::replace(relative.begin(), relative.end(), '.', '\\');
-
-        for (const auto& root : module_roots)
-        {
-            const std::filesystem::path direct = std::filesystem::path(root) / (relative + ".lua");
-            const std::filesystem::path nested = std::filesystem::path(root) / relative / (relative + ".lua");
-
-            std::error_code ec;
-            if (std::filesystem::exists(direct, ec) || std::filesystem::exists(nested, ec))
-            {
-                to_purge.push_back(entry.first.as<std::string>());
-                break;
-            }
-        }
-    }
-
-    for (const auto& module_name : to_purge)
+    for (const std::string& module_name : module_names)
     {
+        // The module's own requires are recorded again when it is next loaded.
         loaded[module_name] = sol::lua_nil;
-        PLOG_DEBUG << "Purged cached module '" << module_name << "' so the next require() re-reads it from disk.";
+        dependency_graph.erase(module_name);
+        PLOG_DEBUG << "Purged cached module '" << module_name << "' so the next require() re-reads it.";
     }
 }
 
@@ -1174,6 +1749,18 @@ void ForgeScriptManager::ApplyProfile(const std::string& profile_name)
     }
     sol::table profile_scripts = scripts_obj.as<sol::table>();
 
+    // Read the scripts about to be enabled together, rather than one by one as Enable() would.
+    std::vector<ForgeScript*> to_load;
+    for (const auto& script : scripts)
+    {
+        const std::string script_name = std::filesystem::path(script->GetFileName()).filename().string();
+        if (!script->IsLoaded() && profile_scripts[script_name].valid() && profile_scripts[script_name].get_type() == sol::type::table)
+        {
+            to_load.push_back(script.get());
+        }
+    }
+    LoadScripts(to_load);
+
     // Enable exactly the scripts the profile lists, disabling everything else.
     // Disable() runs each script's disable callback so the outgoing set can clean up.
     for (const auto& script : scripts)
@@ -1464,6 +2051,62 @@ void ForgeScriptManager::RunOnEjectCallbacks()
     }
 }
 
+void ForgeScriptManager::LoadScripts(const std::vector<ForgeScript*>& to_load)
+{
+    if (to_load.empty())
+    {
+        return;
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const unsigned thread_count = (unsigned)std::min<size_t>(to_load.size(),
+        std::clamp(std::thread::hardware_concurrency(), 1u, MAX_LOAD_THREADS));
+
+    // Each thread compiles in its own scratch state, since a lua_State is not thread-safe. The
+    // calling thread takes a share of the scripts too.
+    std::atomic<size_t> next_script{ 0 };
+    auto load_scripts = [&]()
+    {
+        lua_State* compile_state = luaL_newstate();
+        for (size_t i = next_script++; i < to_load.size(); i = next_script++)
+        {
+            to_load[i]->Load(compile_state);
+        }
+        if (compile_state)
+        {
+            lua_close(compile_state);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < thread_count; ++i)
+    {
+        workers.emplace_back(load_scripts);
+    }
+    load_scripts();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+    size_t serial_us = 0;
+    size_t loaded_count = 0;
+    for (const ForgeScript* script : to_load)
+    {
+        if (script->IsLoaded())
+        {
+            serial_us += script->stats.time_to_read_file_contents + script->stats.time_to_hash_file_contents + script->stats.time_to_compile;
+            loaded_count++;
+        }
+    }
+    const size_t unloaded_count = (size_t)std::count_if(scripts.begin(), scripts.end(),
+        [](const std::unique_ptr<ForgeScript>& script) { return !script->IsLoaded(); });
+
+    PLOG_INFO << "Loaded " << loaded_count << " scripts in " << elapsed_us << " us on " << thread_count << " threads ("
+              << serial_us << " us of work); " << unloaded_count << " other scripts are left unread until enabled";
+}
+
 void ForgeScriptManager::RefreshScripts()
 {
     // Scripts are identified by file name (not full path) here so a packaged script's
@@ -1477,10 +2120,44 @@ void ForgeScriptManager::RefreshScripts()
         known_names.emplace(std::filesystem::path(script->GetFileName()).filename().string());
     }
 
+    // Script package: a directory with an entry script inside it. The shared
+    // modules/resources/profiles directories are excluded from consideration.
+    auto add_package = [&](const std::filesystem::path& package_path)
+    {
+        const std::string dir_name_lower = ToLowerCopy(package_path.filename().string());
+        if (std::find(excluded_subdirs.begin(), excluded_subdirs.end(), dir_name_lower) != excluded_subdirs.end())
+        {
+            return;
+        }
+
+        const std::string entry_script = FindPackageEntryScript(package_path);
+        if (entry_script.empty()) return;
+
+        const std::string name = std::filesystem::path(entry_script).filename().string();
+        if (known_names.find(name) != known_names.end())
+        {
+            PLOG_WARNING << "Skipping script package " << package_path.string()
+                         << ": a script named " << name << " is already loaded.";
+            return;
+        }
+
+        AddScript(entry_script, package_path.string());
+        known_names.emplace(name);
+    };
+
+    std::vector<std::filesystem::path> archive_paths;
+    const auto loose_start_time = std::chrono::steady_clock::now();
+    const size_t loose_count_before = scripts.size();
     for (const auto& entry : std::filesystem::directory_iterator(scripts_path))
     {
         if (entry.is_regular_file())
         {
+            if (ToLowerCopy(entry.path().extension().string()) == ".ufpak")
+            {
+                archive_paths.push_back(entry.path());
+                continue;
+            }
+
             // Loose script: a .lua file sitting directly in the scripts directory.
             if (entry.path().extension() != ".lua") continue;
 
@@ -1492,29 +2169,52 @@ void ForgeScriptManager::RefreshScripts()
         }
         else if (entry.is_directory())
         {
-            // Script package: a subdirectory with an entry script inside it. The shared
-            // modules/resources/profiles directories are excluded from consideration.
-            const std::string dir_name = entry.path().filename().string();
-            const std::string dir_name_lower = ToLowerCopy(dir_name);
-            if (std::find(excluded_subdirs.begin(), excluded_subdirs.end(), dir_name_lower) != excluded_subdirs.end())
-            {
-                continue;
-            }
+            add_package(entry.path());
+        }
+    }
+
+    if (scripts.size() > loose_count_before)
+    {
+        const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loose_start_time).count();
+        PLOG_INFO << "Found " << (scripts.size() - loose_count_before) << " loose scripts in " << elapsed_us << " us";
+    }
 
-            const std::string entry_script = FindPackageEntryScript(entry.path());
-            if (entry_script.empty()) continue;
+    // Archives are added after the loose tree, so an unpacked copy of a package being
+    // worked on takes precedence over the archived one.
+    for (const auto& archive_path : archive_paths)
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        const PackageArchive* archive = PackageArchive::Mount(archive_path);
+        if (!archive)
+        {
+            continue;
+        }
 
-            const std::string name = std::filesystem::path(entry_script).filename().string();
-            if (known_names.find(name) != known_names.end())
+        const size_t script_count_before = scripts.size();
+        std::unordered_set<std::string> top_level_dirs;
+        for (const std::string& key : archive->ListDirectory(""))
+        {
+            const size_t separator = key.find('\\');
+            if (separator != std::string::npos)
             {
-                PLOG_WARNING << "Skipping script package " << entry.path().string()
-                             << ": a script named " << name << " is already loaded.";
+                top_level_dirs.insert(key.substr(0, separator));
                 continue;
             }
 
-            AddScript(entry_script, entry.path().string());
+            const std::string name = std::filesystem::path(key).filename().string();
+            if (std::filesystem::path(key).extension() != ".lua" || known_names.find(name) != known_names.end()) continue;
+
+            AddScript((archive_path / key).string());
             known_names.emplace(name);
         }
+        for (const std::string& dir_name : top_level_dirs)
+        {
+            add_package(archive_path / dir_name);
+        }
+
+        const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+        PLOG_INFO << "Found " << (scripts.size() - script_count_before) << " scripts in " << archive_path.filename().string()
+                  << " in " << elapsed_us << " us";
     }
 }
 
@@ -1527,6 +2227,7 @@ void ForgeScriptManager::UpdateDebugStats()
         ForgeScript* current_script = script.get();
         stats.script_size += current_script->stats.script_size;
         stats.time_to_hash_file_contents += current_script->stats.time_to_hash_file_contents;
+        stats.time_to_compile += current_script->stats.time_to_compile;
         stats.time_to_read_file_contents += current_script->stats.time_to_read_file_contents;
         stats.times_executed += current_script->stats.times_executed;
         stats.total_time_executing += current_script->stats.total_time_executing;
@@ -1534,4 +2235,15 @@ void ForgeScriptManager::UpdateDebugStats()
     }
 }
 
-ForgeScriptManager::~ForgeScriptManager(){}
+ForgeScriptManager::~ForgeScriptManager()
+{
+    if (reload_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(reload_mutex);
+            reload_thread_stopping = true;
+        }
+        reload_jobs_changed.notify_one();
+        reload_thread.join();
+    }
+}
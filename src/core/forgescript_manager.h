@@ -1,17 +1,28 @@
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <lua.hpp>
 #include <sol/sol.hpp>
 
+#include "core\file_watcher.h"
+#include "core\package_archive.h"
+
 /**
  * @brief The ForgeScriptCallbackType identifies a Lua callback that a script can register with the ForgeScriptManager.
  *
@@ -44,12 +55,34 @@ struct ForgeScriptDebug
 {
     size_t time_to_read_file_contents;
     size_t time_to_hash_file_contents;
+    size_t time_to_compile;
     size_t total_time_loading_from_mem;
     size_t total_time_executing;
     size_t times_executed;
     size_t script_size;
 };
 
+/**
+ * @brief A new version of a script, read and compiled off the render thread for a hot reload
+ * (see ForgeScript::PrepareReload and ForgeScript::ApplyReload).
+ */
+struct ForgeScriptReload
+{
+    std::string file_name;
+    bool archived = false;
+
+    std::string contents;                   // New contents (loose scripts)
+    ArchiveFile archived_contents;          // New contents (archived scripts)
+    std::string compiled_chunk;             // Bytecode of the new contents
+    std::string error;                      // Why the reload cannot be applied; "" when it can
+    std::size_t hash = 0;
+    size_t time_to_read_file_contents = 0;
+    size_t time_to_hash_file_contents = 0;
+    size_t time_to_compile = 0;
+    bool has_write_time = false;
+    std::filesystem::file_time_type write_time{};
+};
+
 // ╔═══════════════════════════════════════════════════════════════════════════╗
 // ║                            ForgeScript Class                              ║
 // ╚═══════════════════════════════════════════════════════════════════════════╝
@@ -71,13 +104,33 @@ class ForgeScript
         ForgeScript();
 
         /**
-         * @brief Constructs a ForgeScript object by reading the contents of a Lua script file.
-         * 
-         * @param file_name The name of the Lua script file to load.
-         * @throws std::runtime_error If the file cannot be opened or read.
+         * @brief Constructs a ForgeScript object for a Lua script file without reading it.
+         *
+         * The contents are read when the script is first enabled, or ahead of that by
+         * ForgeScriptManager::LoadScripts() (see Load()).
+         *
+         * @param file_name The name of the Lua script file.
          */
         ForgeScript(const std::string file_name);
 
+        /**
+         * @brief Reads, hashes and compiles the script, if that has not happened yet.
+         *
+         * Touches nothing but this script, so different scripts can be loaded on different
+         * threads at once.
+         *
+         * @param compile_state A Lua state to compile in, used only by the calling thread. When
+         * null, a temporary state is created.
+         * @return False (logged) when the file cannot be read. A script that does not compile
+         * still loads; Run() reports the error.
+         */
+        bool Load(lua_State* compile_state = nullptr);
+
+        /**
+         * @brief Reports whether the script's contents have been read (see Load()).
+         */
+        bool IsLoaded() const;
+
         /**
          * @brief Executes the Lua script using the given Lua state.
          * 
@@ -88,14 +141,28 @@ class ForgeScript
         void Run(lua_State* curr_lua_state);
 
         /**
-         * @brief Reload script contents from disk and reset its isolated Lua environment.
+         * @brief Reads and compiles a new version of a script for ApplyReload().
+         *
+         * Uses nothing but its arguments, so it runs on the reload worker thread.
+         *
+         * @param compile_state A Lua state only the calling thread uses, to compile in.
+         * @param out_reload Names the script (file_name, archived) and receives the new version,
+         * or an error when it cannot be read or does not compile.
+         */
+        static void PrepareReload(lua_State* compile_state, ForgeScriptReload& out_reload);
+
+        /**
+         * @brief Swaps in a version prepared by PrepareReload() and resets the script's isolated
+         * Lua environment. When the reload carries an error, it is logged and the current version
+         * stays.
          *
          * Preserves the enabled/disabled state of the script. If the script was enabled,
          * the disable callback is executed before reloading.
          *
          * @param curr_lua_state The Lua state used to manage registry references for the script environment.
+         * @param reload The prepared version; its contents are moved into the script.
          */
-        void Reload(lua_State* curr_lua_state);
+        void ApplyReload(lua_State* curr_lua_state, ForgeScriptReload& reload);
 
         /**
          * @brief Executes the Lua Scripts registered settings callback function.
@@ -123,11 +190,19 @@ class ForgeScript
 
         /**
          * @brief Enables the script, allowing it to be executed.
+         *
+         * Loads the script first if it has not been loaded. A script that cannot be read is
+         * logged and stays disabled.
          */
         void Enable();
 
         /**
          * @brief Disables the script, preventing it from being executed.
+         *
+         * Runs the disable callback, then releases every resource the script still owns (see
+         * script_resources.h) and drops its registered callbacks. Its Lua environment is discarded
+         * before the next run, so a re-enabled script starts with fresh globals rather than
+         * handles to resources that no longer exist. ApplyReload() goes through here too.
          */
         void Disable();
 
@@ -145,6 +220,13 @@ class ForgeScript
          */
         std::string GetFileName();
 
+        /**
+         * @brief Returns the owner tag recorded with every resource this script creates.
+         *
+         * Unique per ForgeScript for the life of the core and never 0 (the core's own tag).
+         */
+        uint32_t GetResourceOwner() const;
+
         /**
          * @brief Returns the last observed write time of the script file on disk.
          */
@@ -178,7 +260,7 @@ class ForgeScript
         /**
          * @brief Retrieves the contents of the Lua script file.
          * 
-         * @return The contents of the Lua script as a string.
+         * @return The contents of the Lua script as a string, or "" before the script is loaded.
          */
         std::string GetContents();
 
@@ -190,13 +272,21 @@ class ForgeScript
          */
         std::size_t GetHash();
 
+        /**
+         * @brief Reports whether the script was loaded from a mounted .ufpak archive.
+         *
+         * Archived scripts run straight from the archive mapping and are never out of date on
+         * disk; their modules are read from the archive by the core's package module searcher.
+         */
+        bool IsArchived() const;
+
         /**
          * @brief Marks this script as a packaged script living in its own subdirectory.
          *
          * A packaged script is a script directory dropped into the scripts folder
          * (e.g. "scripts\\my_mod\\my_mod.lua"). If the package directory contains a
-         * "modules" folder, that folder is prepended to package.path while the script
-         * runs so its local require() calls resolve locally before the shared modules
+         * "modules" folder, the core's package module searcher looks there first while the
+         * script runs, so its local require() calls resolve locally before the shared modules
          * directory. If it contains a "resources" folder, relative resource paths
          * (e.g. UiForge.LoadTexture) are resolved against it before the shared
          * resources directory.
@@ -205,6 +295,31 @@ class ForgeScript
          */
         void SetPackageDirectory(const std::string& directory_path);
 
+        /**
+         * @brief Looks up where the package module searcher found a module for this script.
+         *
+         * @param out_path Receives the module's file, or "" when the module is known not to be in
+         * the script's package or a mounted archive.
+         * @return False when the module has not been looked up for this script yet.
+         */
+        bool FindCachedModulePath(const std::string& module_name, std::string& out_path) const;
+
+        /**
+         * @brief Records where a module was found for this script ("" for not found).
+         */
+        void CacheModulePath(const std::string& module_name, const std::string& module_path);
+
+        /**
+         * @brief Forgets every cached module location, so modules are looked up again. Done on
+         * reload and whenever the file watcher sees module files change.
+         */
+        void ClearModulePathCache();
+
+        /**
+         * @brief Returns the script's package directory, or "" for a loose script.
+         */
+        std::string GetPackageDirectory() const;
+
         /**
          * @brief Returns the package's local modules directory, or "" when the script
          * is not packaged or the package has no modules folder.
@@ -271,15 +386,27 @@ class ForgeScript
          */
         void ResetLuaEnvironment(lua_State* curr_lua_state);
 
+        /**
+         * @brief Returns the loaded script: the archive entry for archived scripts, else file_contents.
+         */
+        std::string_view Contents() const;
+
         std::string file_name;                      // The name of the Lua file
-        std::string file_contents;                  // The contents of the script
-        std::size_t hash;                           // hash of the contents, for quick comparison
+        std::string file_contents;                  // The contents of the script (loose scripts)
+        ArchiveFile archived_contents;              // The contents of the script (archived scripts)
+        bool archived = false;                      // Loaded from a mounted .ufpak archive
+        std::string compiled_chunk;                 // Bytecode of the contents; "" when they do not compile
+        bool loaded = false;                        // Contents have been read (see Load())
+        std::size_t hash = 0;                       // hash of the contents, for quick comparison
 
         std::string package_dir;                    // Root directory of a packaged script ("" for loose scripts)
         std::string package_modules_dir;            // "<package_dir>\modules" when it exists, else ""
         std::string package_resources_dir;          // "<package_dir>\resources" when it exists, else ""
+        std::unordered_map<std::string, std::string> module_path_cache;    // Module name -> file, "" when not found (see FindCachedModulePath)
 
         int env_ref = LUA_NOREF;                    // Registry ref to this script's isolated environment table
+        bool env_stale = false;                     // Disabled since its last run; Run() resets the environment first
+        uint32_t resource_owner;                    // Owner tag for resources this script creates
         std::filesystem::file_time_type loaded_write_time{};     // Write time of the file when contents were last loaded
         std::filesystem::file_time_type observed_write_time{};   // Most recently observed write time on disk
         bool has_write_time = false;
@@ -331,7 +458,7 @@ class ForgeScriptManager
          * @param file_name The full path to the Lua script file to add.
          * @param package_dir Full path to the script's package directory when the script
          * is a packaged script, or "" (the default) for a loose script.
-         * @note If the script fails to load, an error is logged, and the script is not added.
+         * @note The script is not read here; see ForgeScript::Load().
          */
         void AddScript(const std::string file_name, const std::string package_dir = std::string());
 
@@ -356,15 +483,27 @@ class ForgeScriptManager
         /**
          * @brief Configure reload-on-save behavior for all managed scripts.
          *
-         * @param enabled If true, scripts are polled for file timestamp changes and reloaded automatically.
-         * @param poll_ms Minimum time between polling passes (milliseconds).
+         * When enabled, the scripts directory tree (which holds the shared modules and resources
+         * directories and every package) is watched on a background thread (see FileWatcher), and
+         * RunScripts() acts on the changes it reports: an edited script, or any file inside a
+         * script's package, reloads that script; an edited shared module reloads every loaded
+         * script; a new loose script, archive or package triggers RefreshScripts(). Only when the
+         * directory cannot be watched are enabled scripts' write times polled instead.
+         *
+         * @param enabled If true, scripts are reloaded automatically when their files change.
+         * @param poll_ms Minimum time between polling passes (milliseconds), when polling.
          */
         void SetReloadOnSave(bool enabled, uint32_t poll_ms);
 
         /**
          * @brief Request a script reload by its full file path.
          *
+         * The user modules the script requires (directly or through other modules) are purged
+         * with it, so the reload picks up module edits too.
+         *
          * @note The reload occurs outside of script execution so we don't screw something up.
+         * The file is read and compiled on a worker thread; the new version is swapped in at
+         * the start of a later RunScripts() pass (see ProcessPendingReloads()).
          */
         void RequestReload(const std::string& file_name);
 
@@ -418,13 +557,20 @@ class ForgeScriptManager
         /**
          * @brief Sets the modules directory used to detect which require()d modules are user modules.
          *
-         * When set, script reloads purge matching entries from package.loaded so edited modules
-         * are re-read from disk (see PurgeUserModuleCache()).
+         * Module files under it (and under each package's own modules folder) are matched to the
+         * module names scripts require, so editing one reloads exactly the scripts that depend on
+         * it (see QueueModuleReloads()).
          *
          * @param directory_path Full path to the Lua modules directory.
          */
         void SetModulesDirectory(const std::string& directory_path);
 
+        /**
+         * @brief Sets a function called with each script package added from now on (by
+         * RefreshScripts), so the core can start preloading what the package declares.
+         */
+        void SetPackageAddedCallback(std::function<void(ForgeScript*)> callback);
+
         /**
          * @brief Saves the current setup as a named profile.
          *
@@ -446,7 +592,8 @@ class ForgeScriptManager
          * and queues the profile's per-script states and window settings to be delivered at the
          * end of the next RunScripts() pass. The one-pass delay lets newly enabled scripts run
          * once so they can register their Load callbacks and create their windows before state
-         * and window positions are applied.
+         * and window positions are applied. Scripts it enables that were never loaded are
+         * loaded together first (see LoadScripts()).
          *
          * The profile file is parsed inside an empty sandbox environment (profiles are plain
          * data and must not be able to touch globals).
@@ -515,6 +662,17 @@ class ForgeScriptManager
          */
         void RefreshScripts();
 
+        /**
+         * @brief Returns the modules a script (by file name) or module requires directly, as
+         * recorded when they ran. Empty until the requirer has run.
+         */
+        std::set<std::string> GetRequiredModules(const std::string& requirer) const;
+
+        /**
+         * @brief Returns the scripts (by file name) and modules that directly require a module.
+         */
+        std::set<std::string> GetModuleDependents(const std::string& module_name) const;
+
         /**
          * @brief Returns the script currently being executed by the manager, or nullptr.
          *
@@ -555,11 +713,36 @@ class ForgeScriptManager
          *
          * Reload requests are queued (e.g. from the UI button or reload-on-save polling)
          * and then processed at a safe point in the normal loop (outside of script execution).
+         * New requests are passed to the reload worker, which reads and compiles each script
+         * (see RunReloadWorker()); versions it has finished are swapped in, at most
+         * MAX_RELOAD_SWAPS_PER_FRAME per call, so a large reload never lands in one frame.
          *
          * On reload failure, the error is logged and the script is disabled.
          */
         void ProcessPendingReloads();
 
+        /**
+         * @brief Body of the reload worker thread, started on the first reload: prepares
+         * queued reloads (ForgeScript::PrepareReload()) in a scratch Lua state of its own.
+         */
+        void RunReloadWorker();
+
+        /**
+         * @brief Queues reloads (and a script refresh) for a batch of changed files reported by
+         * the file watcher. Only compares paths; the filesystem is touched only when new scripts
+         * appeared and RefreshScripts() runs.
+         */
+        void HandleFileChanges(const std::vector<std::filesystem::path>& changed_paths);
+
+        /**
+         * @brief Loads scripts in parallel on a few short-lived threads, and logs how long that
+         * took against the time the same loads would take one after another.
+         *
+         * Used when a profile enables a set of scripts at once, most notably the preferred
+         * profile at startup.
+         */
+        void LoadScripts(const std::vector<ForgeScript*>& to_load);
+
         /**
          * @brief Builds the file path for a named profile, "<profiles dir>\\<name>.profile.lua".
          */
@@ -610,16 +793,59 @@ class ForgeScriptManager
         static void ApplyWindowSettings(const std::string& ini_blob);
 
         /**
-         * @brief Removes user modules from package.loaded so the next require() re-reads them from disk.
+         * @brief Replaces the global require with a wrapper that reports each new requirer ->
+         * module edge to RecordRequire() before running the original.
+         */
+        void InstallRequireTracking();
+
+        /**
+         * @brief Adds a requirer -> module edge to the dependency graph.
          *
-         * Only module names that resolve to a .lua file under the modules directory are purged;
-         * built-in libraries and embedded modules are untouched. Called before pending script
-         * reloads are applied so a hot reload picks up module edits too.
+         * @param parent_module The module whose loading made this require, or nil when it came
+         * straight from the currently executing script.
+         * @param module_name The module being required. Non-string names are ignored.
+         */
+        void RecordRequire(const sol::object& parent_module, const sol::object& module_name);
+
+        /**
+         * @brief Returns every module a script or module requires, directly or indirectly.
+         */
+        std::set<std::string> GetModuleClosure(const std::string& requirer) const;
+
+        /**
+         * @brief Returns the shared modules directory and every package's modules folder.
+         */
+        std::vector<std::string> GetModuleRoots() const;
+
+        /**
+         * @brief Returns the files a module name can resolve to under the module roots, worked out
+         * from the name alone.
+         */
+        std::vector<std::filesystem::path> GetModuleFileCandidates(const std::string& module_name) const;
+
+        /**
+         * @brief Reports whether a module name is backed by a file under one of the module roots
+         * (built-in libraries and the embedded serpent are not).
+         */
+        bool IsUserModule(const std::string& module_name) const;
+
+        /**
+         * @brief Removes modules from package.loaded, and their edges from the graph, so the next
+         * require() re-reads them.
          *
          * @note Scripts that are not being reloaded keep whatever references they already hold to
-         * the old module tables until they are reloaded themselves.
+         * the old module tables, which is why module reloads purge no more than they must.
          */
-        void PurgeUserModuleCache();
+        void PurgeModules(const std::unordered_set<std::string>& module_names);
+
+        /**
+         * @brief Handles edited module files: purges the modules they back and every module that
+         * requires one of those (transitively), and queues a reload of every script that requires
+         * any of them.
+         *
+         * @param changed_files Lowercased, normalized paths of the changed files.
+         */
+        void QueueModuleReloads(const std::vector<std::string>& changed_files);
 
         lua_State* uif_lua_state;                           // The lua state for the ForgeScripts to use when running
         std::string scripts_path;                           // The full path to the lua scripts that will be made into ForgeScript objects
@@ -635,9 +861,24 @@ class ForgeScriptManager
         ForgeScript* currently_executing_script;            // Pointer to the currently executing ForgeScript
 
         std::unordered_set<std::string> pending_reload;     // Full script paths pending reload
+        std::unordered_set<std::string> pending_module_purge;   // Module names to purge before the pending reloads
+
+        // Who requires what: script file name or module name -> names of the modules it required.
+        // Filled by the require wrapper as scripts run; a node's edges are dropped when it is
+        // reloaded or purged and recorded again when it next runs.
+        std::unordered_map<std::string, std::set<std::string>> dependency_graph;
+        std::function<void(ForgeScript*)> package_added_callback;   // See SetPackageAddedCallback
 
         bool reload_on_save_enabled = false;
         uint32_t reload_on_save_poll_ms = 2500;
         std::chrono::steady_clock::time_point reload_on_save_last_poll{};
         bool reload_on_save_has_polled = false;
+        FileWatcher file_watcher;                           // Watches the scripts tree while reload-on-save is enabled
+
+        std::thread reload_thread;                          // See RunReloadWorker
+        std::mutex reload_mutex;                            // Guards the members below
+        std::condition_variable reload_jobs_changed;
+        std::deque<ForgeScriptReload> reload_jobs;          // Waiting for the worker
+        std::deque<ForgeScriptReload> prepared_reloads;     // Ready to swap in, in completion order
+        bool reload_thread_stopping = false;
 };
@@ -1,9 +1,12 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
-#include <wincodec.h>
+#include <d3dcompiler.h>
 
 #include <WICTextureLoader.h>
 #include <backends/imgui_impl_dx11.h>
@@ -11,6 +14,7 @@
 #include <plog/Log.h>
 
 #include "core\graphics_api.h"
+#include "core\texture_loader.h"
 
 
 // ╔═══════════════════════════════════════════════════════════════════════════╗
@@ -24,8 +28,12 @@ void    (*IGraphicsApi::Render)()
 void    (*IGraphicsApi::UpdateRenderTarget)(void*)                                                  = nullptr;
 void    (*IGraphicsApi::OnGraphicsApiInvoke)(void*)                                                 = nullptr;
 void*   (*IGraphicsApi::CreateTextureFromFile)(const std::wstring& file_path)                       = nullptr;
-void*   (*IGraphicsApi::CreateTextureFromMemory)(const void* pixels, int width, int height)         = nullptr;
+void*   (*IGraphicsApi::CreateTextureFromMemory)(const void*, int, int, const PixelLayout&)         = nullptr;
+void*   (*IGraphicsApi::CreateTextureFromImage)(const TextureImage& image)                          = nullptr;
+void*   (*IGraphicsApi::CreateDynamicTexture)(int, int, PixelFormat)                                = nullptr;
+bool    (*IGraphicsApi::UpdateTexture)(void*, int, int, int, int, const void*, size_t)              = nullptr;
 void    (*IGraphicsApi::ReleaseTexture)(void* texture)                                              = nullptr;
+void    (*IGraphicsApi::SdfTextCallback)(const ImDrawList*, const ImDrawCmd*)                       = nullptr;
 void    (*IGraphicsApi::ShutdownImGuiImpl)()                                                        = nullptr;
 void*   IGraphicsApi::OriginalFunction                                                              = nullptr;
 void*   IGraphicsApi::HookedFunction                                                                = nullptr;
@@ -33,6 +41,9 @@ HWND    IGraphicsApi::target_window
 bool    IGraphicsApi::initialized                                                                   = false;
 
 std::vector<IGraphicsApi::PendingTextureRelease> IGraphicsApi::pending_texture_releases;
+HandleTable<void*> IGraphicsApi::script_textures;
+std::unordered_map<void*, size_t> IGraphicsApi::texture_memory;
+size_t IGraphicsApi::resident_texture_bytes = 0;
 
 // Long enough to cover the deepest swap chain we present into, so a handle is never freed while
 // a submitted frame that still references it could be in flight on the GPU.
@@ -72,12 +83,263 @@ void IGraphicsApi::DrainTextureReleases(bool release_all)
     pending_texture_releases.resize(kept);
 }
 
+// Script-facing texture handles have both low bits set. Real handles never do: D3D11 handles are
+// COM pointers and D3D12 handles are descriptor addresses, both at least 4-byte aligned.
+static constexpr uint64_t SCRIPT_TEXTURE_TAG = 0x3;
+
+static bool IsScriptTextureHandle(uint64_t value)
+{
+    return (value & SCRIPT_TEXTURE_TAG) == SCRIPT_TEXTURE_TAG;
+}
+
+void* IGraphicsApi::RegisterScriptTexture(void* texture, uint32_t owner)
+{
+    if (!texture)
+    {
+        return nullptr;
+    }
+
+    const ResourceHandle handle = script_textures.Insert(texture, owner);
+    if (handle == 0)
+    {
+        PLOG_ERROR << "Out of script texture handles.";
+        QueueTextureRelease(texture);
+        return nullptr;
+    }
+    return (void*)(uintptr_t)((handle << 2) | SCRIPT_TEXTURE_TAG);
+}
+
+void* IGraphicsApi::ResolveScriptTexture(void* handle)
+{
+    const uint64_t value = (uint64_t)(uintptr_t)handle;
+    if (!IsScriptTextureHandle(value))
+    {
+        return handle;
+    }
+
+    void** texture = script_textures.Find(value >> 2);
+    return texture ? *texture : nullptr;
+}
+
+void IGraphicsApi::ReleaseScriptTexture(void* handle)
+{
+    const uint64_t value = (uint64_t)(uintptr_t)handle;
+    if (!IsScriptTextureHandle(value))
+    {
+        QueueTextureRelease(handle);
+        return;
+    }
+
+    void* texture = nullptr;
+    if (script_textures.Remove(value >> 2, &texture))
+    {
+        QueueTextureRelease(texture);
+    }
+}
+
+void IGraphicsApi::ReleaseAllScriptTextures()
+{
+    script_textures.ForEach([](ResourceHandle, void*& texture, uint32_t)
+    {
+        QueueTextureRelease(texture);
+    });
+    script_textures.Clear();
+}
+
+void IGraphicsApi::ReleaseScriptTexturesOwnedBy(uint32_t owner)
+{
+    for (ResourceHandle handle : script_textures.HandlesOwnedBy(owner))
+    {
+        void* texture = nullptr;
+        if (script_textures.Remove(handle, &texture))
+        {
+            QueueTextureRelease(texture);
+        }
+    }
+}
+
+bool IGraphicsApi::KeepScriptTexture(void* handle)
+{
+    const uint64_t value = (uint64_t)(uintptr_t)handle;
+    return IsScriptTextureHandle(value) && script_textures.SetOwner(value >> 2, 0);
+}
+
+ResourceUsage IGraphicsApi::GetScriptTextureUsage(uint32_t owner)
+{
+    ResourceUsage usage;
+    script_textures.ForEach([&](ResourceHandle, void*& texture, uint32_t texture_owner)
+    {
+        if (texture_owner == owner)
+        {
+            usage.count++;
+            usage.bytes += GetTextureBytes(texture);
+        }
+    });
+    return usage;
+}
+
+void IGraphicsApi::ResolveScriptTextures(ImDrawData* draw_data)
+{
+    if (!draw_data)
+    {
+        return;
+    }
+
+    for (ImDrawList* draw_list : draw_data->CmdLists)
+    {
+        for (ImDrawCmd& command : draw_list->CmdBuffer)
+        {
+            // Commands backed by ImGui's own textures (the font atlas) carry _TexData instead.
+            if (command.UserCallback || command.TexRef._TexData || !IsScriptTextureHandle(command.TexRef._TexID))
+            {
+                continue;
+            }
+
+            void** texture = script_textures.Find(command.TexRef._TexID >> 2);
+            if (texture)
+            {
+                command.TexRef._TexID = (ImTextureID)(uintptr_t)*texture;
+            }
+            else
+            {
+                command.ElemCount = 0;
+            }
+        }
+    }
+}
+
+void IGraphicsApi::TrackTextureMemory(void* texture, size_t bytes)
+{
+    if (!texture)
+    {
+        return;
+    }
+
+    size_t& tracked = texture_memory[texture];
+    resident_texture_bytes = resident_texture_bytes - tracked + bytes;
+    tracked = bytes;
+}
+
+void IGraphicsApi::UntrackTextureMemory(void* texture)
+{
+    auto entry = texture_memory.find(texture);
+    if (entry == texture_memory.end())
+    {
+        return;
+    }
+
+    resident_texture_bytes -= entry->second;
+    texture_memory.erase(entry);
+}
+
+void IGraphicsApi::UntrackAllTextureMemory()
+{
+    texture_memory.clear();
+    resident_texture_bytes = 0;
+}
+
+size_t IGraphicsApi::GetResidentTextureBytes()
+{
+    return resident_texture_bytes;
+}
+
+size_t IGraphicsApi::GetTextureBytes(void* texture)
+{
+    auto entry = texture_memory.find(texture);
+    return (entry == texture_memory.end()) ? 0 : entry->second;
+}
+
+// Maps a TextureFormat to the DXGI format both D3D implementations create it with.
+static DXGI_FORMAT GetDxgiFormat(TextureFormat format)
+{
+    switch (format)
+    {
+        case TextureFormat::BC1:    return DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC3:    return DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC7:    return DXGI_FORMAT_BC7_UNORM;
+        default:                    return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+// Maps a dynamic texture's PixelFormat to its DXGI format, or DXGI_FORMAT_UNKNOWN when it is not
+// one CreateDynamicTexture supports.
+static DXGI_FORMAT GetDynamicDxgiFormat(PixelFormat format)
+{
+    switch (format)
+    {
+        case PixelFormat::RGBA8:    return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case PixelFormat::Gray8:    return DXGI_FORMAT_R8_UNORM;
+        default:                    return DXGI_FORMAT_UNKNOWN;
+    }
+}
+
+// Checks an UpdateTexture rectangle against the texture's size, logging the problem.
+static bool ValidateTextureUpdate(UINT texture_width, UINT texture_height, int x, int y, int width, int height,
+                                  const void* pixels, size_t row_pitch, size_t bytes_per_pixel)
+{
+    if (!pixels || x < 0 || y < 0 || width <= 0 || height <= 0
+        || (UINT)x + (UINT)width > texture_width || (UINT)y + (UINT)height > texture_height
+        || row_pitch < (size_t)width * bytes_per_pixel)
+    {
+        PLOG_WARNING << "UpdateTexture called with an invalid rectangle (" << x << ", " << y << ", " << width << "x" << height
+                     << ", row pitch " << row_pitch << ") for a " << texture_width << "x" << texture_height << " texture.";
+        return false;
+    }
+    return true;
+}
+
+// Checks the parts of a TextureImage every implementation relies on, logging the first problem.
+static bool ValidateTextureImage(const TextureImage& image)
+{
+    if (image.mips.empty() || image.mips.size() > D3D12_REQ_MIP_LEVELS)
+    {
+        PLOG_WARNING << "CreateTextureFromImage called with " << image.mips.size() << " mip levels.";
+        return false;
+    }
+
+    for (const TextureMip& mip : image.mips)
+    {
+        if (!mip.data || mip.width <= 0 || mip.height <= 0
+            || mip.row_pitch < TextureFormats::RowPitch(image.format, mip.width))
+        {
+            PLOG_WARNING << "CreateTextureFromImage called with an invalid mip level (data=" << mip.data
+                         << ", width=" << mip.width << ", height=" << mip.height << ", row pitch=" << mip.row_pitch << ").";
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // ╔═══════════════════════════════════════════════════════════════════════════╗
 // ║                           D3D11GraphicsApi Class                          ║
 // ╚═══════════════════════════════════════════════════════════════════════════╝
 ID3D11Device*           D3D11GraphicsApi::d3d11_device            = nullptr;
 ID3D11DeviceContext*    D3D11GraphicsApi::d3d11_context           = nullptr;
 ID3D11RenderTargetView* D3D11GraphicsApi::main_render_target_view = nullptr;
+ID3D11PixelShader*      D3D11GraphicsApi::sdf_text_pixel_shader   = nullptr;
+
+// Turns a distance field in the texture's red channel (the atlas is single-channel) into
+// antialiased coverage. The input signature matches the vertex shader output of ImGui's DX11 and
+// DX12 backends, so D3D11 only swaps the pixel shader and D3D12 pairs it with the same vertex shader.
+static const char* SDF_TEXT_PIXEL_SHADER = R"(
+struct PS_INPUT
+{
+    float4 pos : SV_POSITION;
+    float4 col : COLOR0;
+    float2 uv  : TEXCOORD0;
+};
+sampler sampler0;
+Texture2D texture0;
+
+float4 main(PS_INPUT input) : SV_Target
+{
+    float distance  = texture0.Sample(sampler0, input.uv).r;
+    float smoothing = max(fwidth(distance) * 0.75, 1.0 / 255.0);
+    float coverage  = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    return float4(input.col.rgb, input.col.a * coverage);
+}
+)";
 
 D3D11GraphicsApi::D3D11GraphicsApi(void(*OnGraphicsApiInvoke)(void*) = nullptr)
 {
@@ -90,6 +352,9 @@ D3D11GraphicsApi::D3D11GraphicsApi(void(*OnGraphicsApiInvoke)(void*) = nullptr)
     IGraphicsApi::HookedFunction            = D3D11GraphicsApi::HookedPresent;
     IGraphicsApi::CreateTextureFromFile     = D3D11GraphicsApi::CreateTextureFromFile;
     IGraphicsApi::CreateTextureFromMemory   = D3D11GraphicsApi::CreateTextureFromMemory;
+    IGraphicsApi::CreateTextureFromImage    = D3D11GraphicsApi::CreateTextureFromImage;
+    IGraphicsApi::CreateDynamicTexture      = D3D11GraphicsApi::CreateDynamicTexture;
+    IGraphicsApi::UpdateTexture             = D3D11GraphicsApi::UpdateTexture;
     IGraphicsApi::ReleaseTexture            = D3D11GraphicsApi::ReleaseTexture;
     IGraphicsApi::ShutdownImGuiImpl         = D3D11GraphicsApi::ShutdownImGuiImpl;
 }
@@ -119,7 +384,33 @@ void D3D11GraphicsApi::InitializeApi(void* swap_chain)
 
 bool D3D11GraphicsApi::InitializeImGui()
 {
-    return ImGui_ImplDX11_Init(d3d11_device, d3d11_context);
+    if (!ImGui_ImplDX11_Init(d3d11_device, d3d11_context))
+    {
+        return false;
+    }
+
+    ID3DBlob* shader_blob = nullptr;
+    ID3DBlob* error_blob  = nullptr;
+    HRESULT result = D3DCompile(SDF_TEXT_PIXEL_SHADER, strlen(SDF_TEXT_PIXEL_SHADER), nullptr, nullptr, nullptr,
+                                "main", "ps_4_0", 0, 0, &shader_blob, &error_blob);
+    if (SUCCEEDED(result))
+    {
+        result = d3d11_device->CreatePixelShader(shader_blob->GetBufferPointer(), shader_blob->GetBufferSize(), nullptr, &sdf_text_pixel_shader);
+    }
+
+    if (SUCCEEDED(result))
+    {
+        IGraphicsApi::SdfTextCallback = D3D11GraphicsApi::BindSdfTextShader;
+    }
+    else
+    {
+        PLOG_WARNING << "Failed to create the SDF text shader, SDF fonts will use regular fonts. HRESULT: " << result
+                     << (error_blob ? std::string(" ") + (const char*)error_blob->GetBufferPointer() : std::string());
+    }
+
+    if (shader_blob) shader_blob->Release();
+    if (error_blob)  error_blob->Release();
+    return true;
 }
 
 void D3D11GraphicsApi::NewFrame()
@@ -220,6 +511,7 @@ void D3D11GraphicsApi::Render()
     }
 
     d3d11_context->OMSetRenderTargets(1, &main_render_target_view, nullptr);
+    IGraphicsApi::ResolveScriptTextures(ImGui::GetDrawData());
     ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 
     // The frame's draw data has been consumed, so queued texture handles can age out.
@@ -254,12 +546,29 @@ void* D3D11GraphicsApi::CreateTextureFromFile(const std::wstring& file_path)
     else
     {
         PLOG_DEBUG << "Texture created: " << out_texture_view;
+
+        // WICTextureLoader picks the format itself; count it as 32 bits per texel, which is what
+        // it produces for the PNG and JPEG images scripts load.
+        ID3D11Resource* resource = nullptr;
+        ((ID3D11ShaderResourceView*)out_texture_view)->GetResource(&resource);
+        ID3D11Texture2D* texture = nullptr;
+        if (resource && SUCCEEDED(resource->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&texture)))
+        {
+            D3D11_TEXTURE2D_DESC texture_description;
+            texture->GetDesc(&texture_description);
+            TrackTextureMemory(out_texture_view, (size_t)texture_description.Width * texture_description.Height * 4);
+            texture->Release();
+        }
+        if (resource)
+        {
+            resource->Release();
+        }
     }
 
     return out_texture_view;
 }
 
-void* D3D11GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, int height)
+void* D3D11GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, int height, const PixelLayout& layout)
 {
     if (!d3d11_device)
     {
@@ -284,9 +593,22 @@ void* D3D11GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
     texture_description.Usage               = D3D11_USAGE_IMMUTABLE;
     texture_description.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
 
+    // D3D11 copies the initial data itself and honours its row pitch, so plain RGBA (padded or
+    // not) goes straight through. Anything else needs converting into a packed RGBA copy first.
+    std::vector<uint8_t> converted_pixels;
     D3D11_SUBRESOURCE_DATA initial_data = {};
-    initial_data.pSysMem     = pixels;
-    initial_data.SysMemPitch = width * 4;
+    if (PixelConvert::IsPassthrough(layout))
+    {
+        initial_data.pSysMem     = pixels;
+        initial_data.SysMemPitch = (UINT)PixelConvert::SourceRowPitch(layout, width);
+    }
+    else
+    {
+        converted_pixels.resize((size_t)width * height * 4);
+        PixelConvert::ConvertToRgba(pixels, layout, width, height, converted_pixels.data(), (size_t)width * 4);
+        initial_data.pSysMem     = converted_pixels.data();
+        initial_data.SysMemPitch = width * 4;
+    }
 
     ID3D11Texture2D* texture = nullptr;
     HRESULT result = d3d11_device->CreateTexture2D(&texture_description, &initial_data, &texture);
@@ -305,10 +627,158 @@ void* D3D11GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
         return nullptr;
     }
 
+    TrackTextureMemory(out_texture_view, (size_t)width * height * 4);
     PLOG_DEBUG << "Texture created from memory (" << width << "x" << height << "): " << out_texture_view;
     return out_texture_view;
 }
 
+void* D3D11GraphicsApi::CreateTextureFromImage(const TextureImage& image)
+{
+    if (!d3d11_device)
+    {
+        PLOG_WARNING << "CreateTextureFromImage called without an initialized device.";
+        return nullptr;
+    }
+
+    if (!ValidateTextureImage(image))
+    {
+        return nullptr;
+    }
+
+    D3D11_TEXTURE2D_DESC texture_description = {};
+    texture_description.Width               = image.mips[0].width;
+    texture_description.Height              = image.mips[0].height;
+    texture_description.MipLevels           = (UINT)image.mips.size();
+    texture_description.ArraySize           = 1;
+    texture_description.Format              = GetDxgiFormat(image.format);
+    texture_description.SampleDesc.Count    = 1;
+    texture_description.Usage               = D3D11_USAGE_IMMUTABLE;
+    texture_description.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+
+    std::vector<D3D11_SUBRESOURCE_DATA> initial_data(image.mips.size());
+    for (size_t level = 0; level < image.mips.size(); level++)
+    {
+        initial_data[level].pSysMem     = image.mips[level].data;
+        initial_data[level].SysMemPitch = (UINT)image.mips[level].row_pitch;
+    }
+
+    ID3D11Texture2D* texture = nullptr;
+    HRESULT result = d3d11_device->CreateTexture2D(&texture_description, initial_data.data(), &texture);
+    if (FAILED(result))
+    {
+        PLOG_ERROR << "Failed to create " << TextureFormats::GetName(image.format) << " texture. Returned HRESULT: " << result;
+        return nullptr;
+    }
+
+    ID3D11ShaderResourceView* out_texture_view = nullptr;
+    result = d3d11_device->CreateShaderResourceView(texture, nullptr, &out_texture_view);
+    texture->Release();
+    if (FAILED(result))
+    {
+        PLOG_ERROR << "Failed to create shader resource view for " << TextureFormats::GetName(image.format)
+                   << " texture. Returned HRESULT: " << result;
+        return nullptr;
+    }
+
+    TrackTextureMemory(out_texture_view, TextureFormats::ImageSize(image));
+    PLOG_DEBUG << "Texture created from image (" << image.mips[0].width << "x" << image.mips[0].height << " "
+               << TextureFormats::GetName(image.format) << ", " << image.mips.size() << " mips): " << out_texture_view;
+    return out_texture_view;
+}
+
+void* D3D11GraphicsApi::CreateDynamicTexture(int width, int height, PixelFormat format)
+{
+    if (!d3d11_device)
+    {
+        PLOG_WARNING << "CreateDynamicTexture called without an initialized device.";
+        return nullptr;
+    }
+
+    const DXGI_FORMAT dxgi_format = GetDynamicDxgiFormat(format);
+    if (width <= 0 || height <= 0 || dxgi_format == DXGI_FORMAT_UNKNOWN)
+    {
+        PLOG_WARNING << "CreateDynamicTexture called with invalid arguments (width=" << width << ", height=" << height
+                     << ", format=" << (int)format << ").";
+        return nullptr;
+    }
+
+    // Default usage, so UpdateSubresource can write rectangles of it; the driver orders those
+    // writes after draws already submitted from the same texture.
+    D3D11_TEXTURE2D_DESC texture_description = {};
+    texture_description.Width               = width;
+    texture_description.Height              = height;
+    texture_description.MipLevels           = 1;
+    texture_description.ArraySize           = 1;
+    texture_description.Format              = dxgi_format;
+    texture_description.SampleDesc.Count    = 1;
+    texture_description.Usage               = D3D11_USAGE_DEFAULT;
+    texture_description.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+
+    const size_t bytes_per_pixel = PixelConvert::BytesPerPixel(format);
+    std::vector<uint8_t> zeroed((size_t)width * height * bytes_per_pixel, 0);
+    D3D11_SUBRESOURCE_DATA initial_data = {};
+    initial_data.pSysMem     = zeroed.data();
+    initial_data.SysMemPitch = (UINT)(width * bytes_per_pixel);
+
+    ID3D11Texture2D* texture = nullptr;
+    HRESULT result = d3d11_device->CreateTexture2D(&texture_description, &initial_data, &texture);
+    if (FAILED(result))
+    {
+        PLOG_ERROR << "Failed to create dynamic texture. Returned HRESULT: " << result;
+        return nullptr;
+    }
+
+    ID3D11ShaderResourceView* out_texture_view = nullptr;
+    result = d3d11_device->CreateShaderResourceView(texture, nullptr, &out_texture_view);
+    texture->Release();
+    if (FAILED(result))
+    {
+        PLOG_ERROR << "Failed to create shader resource view for dynamic texture. Returned HRESULT: " << result;
+        return nullptr;
+    }
+
+    TrackTextureMemory(out_texture_view, zeroed.size());
+    PLOG_DEBUG << "Dynamic texture created (" << width << "x" << height << "): " << out_texture_view;
+    return out_texture_view;
+}
+
+bool D3D11GraphicsApi::UpdateTexture(void* texture, int x, int y, int width, int height, const void* pixels, size_t row_pitch)
+{
+    if (!d3d11_context || !texture)
+    {
+        return false;
+    }
+
+    ID3D11Resource* resource = nullptr;
+    ((ID3D11ShaderResourceView*)texture)->GetResource(&resource);
+    ID3D11Texture2D* texture_2d = nullptr;
+    const HRESULT result = resource->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&texture_2d);
+    resource->Release();
+    if (FAILED(result))
+    {
+        PLOG_WARNING << "UpdateTexture called with a view that is not a 2D texture: " << texture;
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC texture_description;
+    texture_2d->GetDesc(&texture_description);
+    const size_t bytes_per_pixel = texture_description.Format == DXGI_FORMAT_R8_UNORM ? 1 : 4;
+    bool valid = texture_description.Usage == D3D11_USAGE_DEFAULT;
+    if (!valid)
+    {
+        PLOG_WARNING << "UpdateTexture called with a texture not created by CreateDynamicTexture: " << texture;
+    }
+    valid = valid && ValidateTextureUpdate(texture_description.Width, texture_description.Height, x, y, width, height,
+                                           pixels, row_pitch, bytes_per_pixel);
+    if (valid)
+    {
+        const D3D11_BOX box = { (UINT)x, (UINT)y, 0, (UINT)(x + width), (UINT)(y + height), 1 };
+        d3d11_context->UpdateSubresource(texture_2d, 0, &box, pixels, (UINT)row_pitch, 0);
+    }
+    texture_2d->Release();
+    return valid;
+}
+
 void D3D11GraphicsApi::ReleaseTexture(void* texture)
 {
     if (!texture)
@@ -317,12 +787,25 @@ void D3D11GraphicsApi::ReleaseTexture(void* texture)
     }
 
     // D3D11 texture handles are COM shader resource views.
+    UntrackTextureMemory(texture);
     ((IUnknown*)texture)->Release();
 }
 
+void D3D11GraphicsApi::BindSdfTextShader(const ImDrawList* draw_list, const ImDrawCmd* command)
+{
+    d3d11_context->PSSetShader(sdf_text_pixel_shader, nullptr, 0);
+}
+
 void D3D11GraphicsApi::ShutdownImGuiImpl()
 {
     ImGui_ImplDX11_Shutdown();
+
+    IGraphicsApi::SdfTextCallback = nullptr;
+    if (sdf_text_pixel_shader)
+    {
+        sdf_text_pixel_shader->Release();
+        sdf_text_pixel_shader = nullptr;
+    }
 }
 
 void D3D11GraphicsApi::Cleanup(void* params)
@@ -376,11 +859,47 @@ ID3D12Fence*                         D3D12GraphicsApi::upload_fence
 UINT64                               D3D12GraphicsApi::upload_fence_value        = 0;
 HANDLE                               D3D12GraphicsApi::upload_fence_event        = nullptr;
 void*                                D3D12GraphicsApi::OriginalExecuteCommandLists = nullptr;
+std::vector<D3D12GraphicsApi::PendingTextureUpdate> D3D12GraphicsApi::pending_texture_updates;
+std::vector<uint8_t>                 D3D12GraphicsApi::pending_update_data;
+std::vector<ID3D12Resource*>         D3D12GraphicsApi::update_buffers;
+std::vector<UINT64>                  D3D12GraphicsApi::update_buffer_sizes;
+ID3D12RootSignature*                 D3D12GraphicsApi::sdf_root_signature        = nullptr;
+ID3D12PipelineState*                 D3D12GraphicsApi::sdf_pipeline_state        = nullptr;
 
 // Size of the shader-visible SRV heap shared by the ImGui backend (fonts, internal textures)
 // and user textures created via CreateTextureFromFile/CreateTextureFromMemory.
 static const UINT UIFORGE_D3D12_SRV_HEAP_CAPACITY = 256;
 
+// ImGui's DX12 backend vertex shader, for the SDF text pipeline: the backend does not expose its
+// own, and a pipeline state needs both stages.
+static const char* SDF_TEXT_VERTEX_SHADER = R"(
+cbuffer vertexBuffer : register(b0)
+{
+    float4x4 ProjectionMatrix;
+};
+struct VS_INPUT
+{
+    float2 pos : POSITION;
+    float4 col : COLOR0;
+    float2 uv  : TEXCOORD0;
+};
+struct PS_INPUT
+{
+    float4 pos : SV_POSITION;
+    float4 col : COLOR0;
+    float2 uv  : TEXCOORD0;
+};
+
+PS_INPUT main(VS_INPUT input)
+{
+    PS_INPUT output;
+    output.pos = mul(ProjectionMatrix, float4(input.pos.xy, 0.0, 1.0));
+    output.col = input.col;
+    output.uv  = input.uv;
+    return output;
+}
+)";
+
 D3D12GraphicsApi::D3D12GraphicsApi(void(*OnGraphicsApiInvoke)(void*) = nullptr)
 {
     IGraphicsApi::OnGraphicsApiInvoke       = OnGraphicsApiInvoke;
@@ -392,6 +911,9 @@ D3D12GraphicsApi::D3D12GraphicsApi(void(*OnGraphicsApiInvoke)(void*) = nullptr)
     IGraphicsApi::HookedFunction            = D3D12GraphicsApi::HookedPresent;
     IGraphicsApi::CreateTextureFromFile     = D3D12GraphicsApi::CreateTextureFromFile;
     IGraphicsApi::CreateTextureFromMemory   = D3D12GraphicsApi::CreateTextureFromMemory;
+    IGraphicsApi::CreateTextureFromImage    = D3D12GraphicsApi::CreateTextureFromImage;
+    IGraphicsApi::CreateDynamicTexture      = D3D12GraphicsApi::CreateDynamicTexture;
+    IGraphicsApi::UpdateTexture             = D3D12GraphicsApi::UpdateTexture;
     IGraphicsApi::ReleaseTexture            = D3D12GraphicsApi::ReleaseTexture;
     IGraphicsApi::ShutdownImGuiImpl         = D3D12GraphicsApi::ShutdownImGuiImpl;
 }
@@ -570,7 +1092,163 @@ bool D3D12GraphicsApi::InitializeImGui()
     init_info.SrvDescriptorAllocFn  = D3D12GraphicsApi::ImGuiSrvAlloc;
     init_info.SrvDescriptorFreeFn   = D3D12GraphicsApi::ImGuiSrvFree;
 
-    return ImGui_ImplDX12_Init(&init_info);
+    if (!ImGui_ImplDX12_Init(&init_info))
+    {
+        return false;
+    }
+
+    CreateSdfTextPipeline();
+    return true;
+}
+
+void D3D12GraphicsApi::CreateSdfTextPipeline()
+{
+    // The backend's root signature: projection constants at b0 for the vertex shader, then the
+    // texture table at t0 and a static linear sampler for the pixel shader. Keeping the same
+    // parameter indices lets the backend's per-draw SetGraphicsRootDescriptorTable(1, ...) work.
+    D3D12_DESCRIPTOR_RANGE texture_range = {};
+    texture_range.RangeType                         = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    texture_range.NumDescriptors                    = 1;
+    texture_range.BaseShaderRegister                = 0;
+    texture_range.RegisterSpace                     = 0;
+    texture_range.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_ROOT_PARAMETER parameters[2] = {};
+    parameters[0].ParameterType             = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    parameters[0].Constants.ShaderRegister  = 0;
+    parameters[0].Constants.RegisterSpace   = 0;
+    parameters[0].Constants.Num32BitValues  = 16;
+    parameters[0].ShaderVisibility          = D3D12_SHADER_VISIBILITY_VERTEX;
+    parameters[1].ParameterType                         = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    parameters[1].DescriptorTable.NumDescriptorRanges   = 1;
+    parameters[1].DescriptorTable.pDescriptorRanges     = &texture_range;
+    parameters[1].ShaderVisibility                      = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    D3D12_STATIC_SAMPLER_DESC sampler = {};
+    sampler.Filter              = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    sampler.AddressU            = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    sampler.AddressV            = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    sampler.AddressW            = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    sampler.ComparisonFunc      = D3D12_COMPARISON_FUNC_ALWAYS;
+    sampler.BorderColor         = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+    sampler.MaxLOD              = D3D12_FLOAT32_MAX;
+    sampler.ShaderRegister      = 0;
+    sampler.ShaderVisibility    = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    D3D12_ROOT_SIGNATURE_DESC root_signature_description = {};
+    root_signature_description.NumParameters        = 2;
+    root_signature_description.pParameters          = parameters;
+    root_signature_description.NumStaticSamplers    = 1;
+    root_signature_description.pStaticSamplers      = &sampler;
+    root_signature_description.Flags                = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT
+                                                    | D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS
+                                                    | D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS
+                                                    | D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
+
+    ID3DBlob* signature_blob     = nullptr;
+    ID3DBlob* vertex_shader_blob = nullptr;
+    ID3DBlob* pixel_shader_blob  = nullptr;
+    ID3DBlob* error_blob         = nullptr;
+    HRESULT result = D3D12SerializeRootSignature(&root_signature_description, D3D_ROOT_SIGNATURE_VERSION_1, &signature_blob, &error_blob);
+    if (SUCCEEDED(result))
+    {
+        result = d3d12_device->CreateRootSignature(0, signature_blob->GetBufferPointer(), signature_blob->GetBufferSize(),
+                                                   __uuidof(ID3D12RootSignature), (void**)&sdf_root_signature);
+    }
+    if (SUCCEEDED(result))
+    {
+        result = D3DCompile(SDF_TEXT_VERTEX_SHADER, strlen(SDF_TEXT_VERTEX_SHADER), nullptr, nullptr, nullptr,
+                            "main", "vs_5_0", 0, 0, &vertex_shader_blob, &error_blob);
+    }
+    if (SUCCEEDED(result))
+    {
+        result = D3DCompile(SDF_TEXT_PIXEL_SHADER, strlen(SDF_TEXT_PIXEL_SHADER), nullptr, nullptr, nullptr,
+                            "main", "ps_5_0", 0, 0, &pixel_shader_blob, &error_blob);
+    }
+
+    if (SUCCEEDED(result))
+    {
+        // Same fixed-function state as the backend's pipeline: ImDrawVert input, alpha blending,
+        // no culling, no depth.
+        const D3D12_INPUT_ELEMENT_DESC input_layout[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT,   0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,   0, 8,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR",    0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        };
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC pipeline_description = {};
+        pipeline_description.pRootSignature         = sdf_root_signature;
+        pipeline_description.VS                     = { vertex_shader_blob->GetBufferPointer(), vertex_shader_blob->GetBufferSize() };
+        pipeline_description.PS                     = { pixel_shader_blob->GetBufferPointer(), pixel_shader_blob->GetBufferSize() };
+        pipeline_description.InputLayout            = { input_layout, 3 };
+        pipeline_description.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        pipeline_description.NumRenderTargets       = 1;
+        pipeline_description.RTVFormats[0]          = rtv_format;
+        pipeline_description.SampleDesc.Count       = 1;
+        pipeline_description.SampleMask             = UINT_MAX;
+        pipeline_description.NodeMask               = 1;
+
+        D3D12_RENDER_TARGET_BLEND_DESC& blend = pipeline_description.BlendState.RenderTarget[0];
+        blend.BlendEnable           = TRUE;
+        blend.SrcBlend              = D3D12_BLEND_SRC_ALPHA;
+        blend.DestBlend             = D3D12_BLEND_INV_SRC_ALPHA;
+        blend.BlendOp               = D3D12_BLEND_OP_ADD;
+        blend.SrcBlendAlpha         = D3D12_BLEND_ONE;
+        blend.DestBlendAlpha        = D3D12_BLEND_INV_SRC_ALPHA;
+        blend.BlendOpAlpha          = D3D12_BLEND_OP_ADD;
+        blend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+        pipeline_description.RasterizerState.FillMode        = D3D12_FILL_MODE_SOLID;
+        pipeline_description.RasterizerState.CullMode        = D3D12_CULL_MODE_NONE;
+        pipeline_description.RasterizerState.DepthClipEnable = TRUE;
+
+        pipeline_description.DepthStencilState.DepthEnable   = FALSE;
+        pipeline_description.DepthStencilState.StencilEnable = FALSE;
+
+        result = d3d12_device->CreateGraphicsPipelineState(&pipeline_description, __uuidof(ID3D12PipelineState), (void**)&sdf_pipeline_state);
+    }
+
+    if (SUCCEEDED(result))
+    {
+        IGraphicsApi::SdfTextCallback = D3D12GraphicsApi::BindSdfTextShader;
+    }
+    else
+    {
+        PLOG_WARNING << "Failed to create the SDF text pipeline, SDF fonts will use regular fonts. HRESULT: " << result
+                     << (error_blob ? std::string(" ") + (const char*)error_blob->GetBufferPointer() : std::string());
+        if (sdf_root_signature)
+        {
+            sdf_root_signature->Release();
+            sdf_root_signature = nullptr;
+        }
+    }
+
+    if (signature_blob)     signature_blob->Release();
+    if (vertex_shader_blob) vertex_shader_blob->Release();
+    if (pixel_shader_blob)  pixel_shader_blob->Release();
+    if (error_blob)         error_blob->Release();
+}
+
+void D3D12GraphicsApi::BindSdfTextShader(const ImDrawList* draw_list, const ImDrawCmd* command)
+{
+    // The projection the backend set up for this draw data (ImGui_ImplDX12_SetupRenderState).
+    const ImDrawData* draw_data = ImGui::GetDrawData();
+    const float left   = draw_data->DisplayPos.x;
+    const float right  = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+    const float top    = draw_data->DisplayPos.y;
+    const float bottom = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+    const float projection[16] =
+    {
+        2.0f / (right - left),              0.0f,                               0.0f, 0.0f,
+        0.0f,                               2.0f / (top - bottom),              0.0f, 0.0f,
+        0.0f,                               0.0f,                               0.5f, 0.0f,
+        (right + left) / (left - right),    (top + bottom) / (bottom - top),    0.5f, 1.0f,
+    };
+
+    d3d12_command_list->SetGraphicsRootSignature(sdf_root_signature);
+    d3d12_command_list->SetPipelineState(sdf_pipeline_state);
+    d3d12_command_list->SetGraphicsRoot32BitConstants(0, 16, projection, 0);
 }
 
 void D3D12GraphicsApi::NewFrame()
@@ -667,6 +1345,8 @@ void D3D12GraphicsApi::Render()
     d3d12_command_list->OMSetRenderTargets(1, &rtv_handle, FALSE, nullptr);
     d3d12_command_list->SetDescriptorHeaps(1, &srv_descriptor_heap);
 
+    FlushTextureUpdates();
+    IGraphicsApi::ResolveScriptTextures(ImGui::GetDrawData());
     ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), d3d12_command_list);
 
     barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
@@ -715,21 +1395,9 @@ bool D3D12GraphicsApi::ExecuteAndWait(ID3D12CommandList* command_list)
     return upload_fence->GetCompletedValue() >= signal_value;
 }
 
-void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, int height)
+void* D3D12GraphicsApi::UploadTexture(DXGI_FORMAT format, int width, int height, UINT mip_levels,
+                                      const std::function<void(UINT level, uint8_t* destination, UINT row_pitch)>& write_level)
 {
-    if (!d3d12_device || !d3d12_command_queue)
-    {
-        PLOG_WARNING << "CreateTextureFromMemory called without an initialized device/command queue.";
-        return nullptr;
-    }
-
-    if (!pixels || width <= 0 || height <= 0)
-    {
-        PLOG_WARNING << "CreateTextureFromMemory called with invalid arguments (pixels=" << pixels
-                     << ", width=" << width << ", height=" << height << ").";
-        return nullptr;
-    }
-
     // Destination texture in GPU-local memory.
     D3D12_HEAP_PROPERTIES default_heap = {};
     default_heap.Type = D3D12_HEAP_TYPE_DEFAULT;
@@ -739,8 +1407,8 @@ void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
     texture_description.Width            = width;
     texture_description.Height           = height;
     texture_description.DepthOrArraySize = 1;
-    texture_description.MipLevels        = 1;
-    texture_description.Format           = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texture_description.MipLevels        = (UINT16)mip_levels;
+    texture_description.Format           = format;
     texture_description.SampleDesc.Count = 1;
 
     ID3D12Resource* texture = nullptr;
@@ -752,10 +1420,19 @@ void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
         return nullptr;
     }
 
-    // Upload buffer. Texture copies require rows padded to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT.
-    const UINT source_pitch  = (UINT)width * 4;
-    const UINT aligned_pitch = (source_pitch + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
-    const UINT64 upload_size = (UINT64)aligned_pitch * height;
+    // Upload buffer layout. Texture copies require rows padded to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+    // and levels placed at D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT; the device works both out.
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprints[D3D12_REQ_MIP_LEVELS] = {};
+    UINT   row_counts[D3D12_REQ_MIP_LEVELS] = {};
+    UINT64 row_sizes[D3D12_REQ_MIP_LEVELS] = {};
+    UINT64 upload_size = 0;
+    d3d12_device->GetCopyableFootprints(&texture_description, 0, mip_levels, 0, footprints, row_counts, row_sizes, &upload_size);
+
+    size_t texel_bytes = 0;
+    for (UINT level = 0; level < mip_levels; level++)
+    {
+        texel_bytes += (size_t)row_sizes[level] * row_counts[level];
+    }
 
     D3D12_HEAP_PROPERTIES upload_heap = {};
     upload_heap.Type = D3D12_HEAP_TYPE_UPLOAD;
@@ -779,7 +1456,8 @@ void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
         return nullptr;
     }
 
-    // Copy pixel rows into the (padded) upload buffer.
+    // Each level is written directly into its padded spot in the upload buffer, so callers
+    // converting pixels never need an intermediate copy.
     void* mapped = nullptr;
     result = upload_buffer->Map(0, nullptr, &mapped);
     if (FAILED(result))
@@ -789,11 +1467,13 @@ void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
         texture->Release();
         return nullptr;
     }
-    for (int row = 0; row < height; row++)
+    const auto staging_start = std::chrono::steady_clock::now();
+    for (UINT level = 0; level < mip_levels; level++)
     {
-        memcpy((uint8_t*)mapped + (SIZE_T)row * aligned_pitch, (const uint8_t*)pixels + (SIZE_T)row * source_pitch, source_pitch);
+        write_level(level, (uint8_t*)mapped + footprints[level].Offset, footprints[level].Footprint.RowPitch);
     }
     upload_buffer->Unmap(0, nullptr);
+    const auto staging_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - staging_start).count();
 
     // Record the copy on a one-shot command list and wait for it, so the upload buffer can
     // be released immediately. Texture creation is rare enough that blocking is fine.
@@ -813,21 +1493,20 @@ void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
         return nullptr;
     }
 
-    D3D12_TEXTURE_COPY_LOCATION copy_destination = {};
-    copy_destination.pResource        = texture;
-    copy_destination.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    copy_destination.SubresourceIndex = 0;
+    for (UINT level = 0; level < mip_levels; level++)
+    {
+        D3D12_TEXTURE_COPY_LOCATION copy_destination = {};
+        copy_destination.pResource        = texture;
+        copy_destination.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        copy_destination.SubresourceIndex = level;
 
-    D3D12_TEXTURE_COPY_LOCATION copy_source = {};
-    copy_source.pResource                          = upload_buffer;
-    copy_source.Type                               = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-    copy_source.PlacedFootprint.Footprint.Format   = DXGI_FORMAT_R8G8B8A8_UNORM;
-    copy_source.PlacedFootprint.Footprint.Width    = width;
-    copy_source.PlacedFootprint.Footprint.Height   = height;
-    copy_source.PlacedFootprint.Footprint.Depth    = 1;
-    copy_source.PlacedFootprint.Footprint.RowPitch = aligned_pitch;
+        D3D12_TEXTURE_COPY_LOCATION copy_source = {};
+        copy_source.pResource       = upload_buffer;
+        copy_source.Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        copy_source.PlacedFootprint = footprints[level];
 
-    upload_command_list->CopyTextureRegion(&copy_destination, 0, 0, 0, &copy_source, nullptr);
+        upload_command_list->CopyTextureRegion(&copy_destination, 0, 0, 0, &copy_source, nullptr);
+    }
 
     D3D12_RESOURCE_BARRIER barrier = {};
     barrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -859,70 +1538,273 @@ void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, i
     }
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srv_description = {};
-    srv_description.Format                  = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srv_description.Format                  = format;
     srv_description.ViewDimension           = D3D12_SRV_DIMENSION_TEXTURE2D;
     srv_description.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    srv_description.Texture2D.MipLevels     = 1;
+    srv_description.Texture2D.MipLevels     = mip_levels;
     d3d12_device->CreateShaderResourceView(texture, &srv_description, GetSrvCpuHandle(slot));
 
     const D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle = GetSrvGpuHandle(slot);
-    texture_registry[gpu_handle.ptr] = TextureRecord{ texture, slot };
+    texture_registry[gpu_handle.ptr] = TextureRecord{ texture, slot, format, (UINT)width, (UINT)height, false };
+    TrackTextureMemory((void*)gpu_handle.ptr, texel_bytes);
 
-    PLOG_DEBUG << "D3D12 texture created from memory (" << width << "x" << height << "), SRV slot " << slot;
+    PLOG_DEBUG << "D3D12 texture created (" << width << "x" << height << ", " << mip_levels << " mips), SRV slot " << slot
+               << ", staged in " << staging_us << " us";
     return (void*)gpu_handle.ptr;
 }
 
-void* D3D12GraphicsApi::CreateTextureFromFile(const std::wstring& file_path)
+void* D3D12GraphicsApi::CreateTextureFromMemory(const void* pixels, int width, int height, const PixelLayout& layout)
 {
-    // WICTextureLoader is D3D11-only, so decode the image with WIC directly and feed the
-    // RGBA pixels through the shared upload path.
-    PLOG_DEBUG << "Creating D3D12 texture from file";
+    if (!d3d12_device || !d3d12_command_queue)
+    {
+        PLOG_WARNING << "CreateTextureFromMemory called without an initialized device/command queue.";
+        return nullptr;
+    }
+
+    if (!pixels || width <= 0 || height <= 0)
+    {
+        PLOG_WARNING << "CreateTextureFromMemory called with invalid arguments (pixels=" << pixels
+                     << ", width=" << width << ", height=" << height << ").";
+        return nullptr;
+    }
+
+    return UploadTexture(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1,
+        [&](UINT level, uint8_t* destination, UINT row_pitch)
+        {
+            PixelConvert::ConvertToRgba(pixels, layout, width, height, destination, row_pitch);
+        });
+}
+
+void* D3D12GraphicsApi::CreateTextureFromImage(const TextureImage& image)
+{
+    if (!d3d12_device || !d3d12_command_queue)
+    {
+        PLOG_WARNING << "CreateTextureFromImage called without an initialized device/command queue.";
+        return nullptr;
+    }
+
+    if (!ValidateTextureImage(image))
+    {
+        return nullptr;
+    }
+
+    return UploadTexture(GetDxgiFormat(image.format), image.mips[0].width, image.mips[0].height, (UINT)image.mips.size(),
+        [&](UINT level, uint8_t* destination, UINT row_pitch)
+        {
+            const TextureMip& mip  = image.mips[level];
+            const size_t row_bytes = TextureFormats::RowPitch(image.format, mip.width);
+            const int row_count    = TextureFormats::RowCount(image.format, mip.height);
+            for (int row = 0; row < row_count; row++)
+            {
+                memcpy(destination + (size_t)row * row_pitch, (const uint8_t*)mip.data + (size_t)row * mip.row_pitch, row_bytes);
+            }
+        });
+}
+
+void* D3D12GraphicsApi::CreateDynamicTexture(int width, int height, PixelFormat format)
+{
+    if (!d3d12_device || !d3d12_command_queue)
+    {
+        PLOG_WARNING << "CreateDynamicTexture called without an initialized device/command queue.";
+        return nullptr;
+    }
+
+    const DXGI_FORMAT dxgi_format = GetDynamicDxgiFormat(format);
+    if (width <= 0 || height <= 0 || dxgi_format == DXGI_FORMAT_UNKNOWN)
+    {
+        PLOG_WARNING << "CreateDynamicTexture called with invalid arguments (width=" << width << ", height=" << height
+                     << ", format=" << (int)format << ").";
+        return nullptr;
+    }
+
+    const size_t row_bytes = (size_t)width * PixelConvert::BytesPerPixel(format);
+    void* texture = UploadTexture(dxgi_format, width, height, 1,
+        [&](UINT level, uint8_t* destination, UINT row_pitch)
+        {
+            for (int row = 0; row < height; row++)
+            {
+                memset(destination + (size_t)row * row_pitch, 0, row_bytes);
+            }
+        });
+    if (texture)
+    {
+        texture_registry[(UINT64)texture].dynamic = true;
+    }
+    return texture;
+}
+
+bool D3D12GraphicsApi::UpdateTexture(void* texture, int x, int y, int width, int height, const void* pixels, size_t row_pitch)
+{
+    auto record = texture_registry.find((UINT64)texture);
+    if (record == texture_registry.end() || !record->second.dynamic)
+    {
+        PLOG_WARNING << "UpdateTexture called with a texture not created by CreateDynamicTexture: " << texture;
+        return false;
+    }
+
+    const size_t bytes_per_pixel = record->second.format == DXGI_FORMAT_R8_UNORM ? 1 : 4;
+    if (!ValidateTextureUpdate(record->second.width, record->second.height, x, y, width, height, pixels, row_pitch, bytes_per_pixel))
+    {
+        return false;
+    }
 
-    const HRESULT co_init = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    const bool co_initialized = SUCCEEDED(co_init);    // RPC_E_CHANGED_MODE means COM was already up in another mode; keep going.
+    PendingTextureUpdate update;
+    update.texture      = (UINT64)texture;
+    update.x            = (UINT)x;
+    update.y            = (UINT)y;
+    update.width        = (UINT)width;
+    update.height       = (UINT)height;
+    update.row_bytes    = (size_t)width * bytes_per_pixel;
+    update.data_offset  = pending_update_data.size();
 
-    void* texture_handle = nullptr;
-    IWICImagingFactory* wic_factory = nullptr;
-    IWICBitmapDecoder* decoder = nullptr;
-    IWICBitmapFrameDecode* frame = nullptr;
-    IWICFormatConverter* converter = nullptr;
+    pending_update_data.resize(update.data_offset + update.row_bytes * height);
+    for (int row = 0; row < height; row++)
+    {
+        memcpy(pending_update_data.data() + update.data_offset + (size_t)row * update.row_bytes,
+               (const uint8_t*)pixels + (size_t)row * row_pitch, update.row_bytes);
+    }
+    pending_texture_updates.push_back(update);
+    return true;
+}
 
-    do
+void D3D12GraphicsApi::FlushTextureUpdates()
+{
+    if (pending_texture_updates.empty())
     {
-        HRESULT result = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic_factory));
-        if (FAILED(result)) { PLOG_ERROR << "Failed to create WIC imaging factory. HRESULT: " << result; break; }
+        return;
+    }
 
-        result = wic_factory->CreateDecoderFromFilename(file_path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
-        if (FAILED(result)) { PLOG_ERROR << "Failed to decode image file. HRESULT: " << result; break; }
+    // Lay the rectangles out as copy footprints: rows padded to the pitch alignment and each
+    // rectangle starting on the placement alignment.
+    const auto align = [](UINT64 value, UINT64 alignment) { return (value + alignment - 1) & ~(alignment - 1); };
+    std::vector<UINT64> offsets(pending_texture_updates.size());
+    UINT64 total_size = 0;
+    for (size_t idx = 0; idx < pending_texture_updates.size(); idx++)
+    {
+        const PendingTextureUpdate& update = pending_texture_updates[idx];
+        offsets[idx] = align(total_size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        total_size   = offsets[idx] + align(update.row_bytes, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT) * update.height;
+    }
 
-        result = decoder->GetFrame(0, &frame);
-        if (FAILED(result)) { PLOG_ERROR << "Failed to get image frame. HRESULT: " << result; break; }
+    // Each swap chain buffer has its own upload buffer, grown as needed. Replacing one is safe
+    // for the same reason resetting its command allocator is.
+    update_buffers.resize(buffer_count, nullptr);
+    update_buffer_sizes.resize(buffer_count, 0);
+    ID3D12Resource*& upload_buffer = update_buffers[current_buffer_index];
+    if (update_buffer_sizes[current_buffer_index] < total_size)
+    {
+        if (upload_buffer)
+        {
+            upload_buffer->Release();
+            upload_buffer = nullptr;
+        }
+        update_buffer_sizes[current_buffer_index] = 0;
+
+        D3D12_HEAP_PROPERTIES upload_heap = {};
+        upload_heap.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_RESOURCE_DESC upload_description = {};
+        upload_description.Dimension        = D3D12_RESOURCE_DIMENSION_BUFFER;
+        upload_description.Width            = align(total_size, 64 * 1024);
+        upload_description.Height           = 1;
+        upload_description.DepthOrArraySize = 1;
+        upload_description.MipLevels        = 1;
+        upload_description.SampleDesc.Count = 1;
+        upload_description.Layout           = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+        const HRESULT result = d3d12_device->CreateCommittedResource(&upload_heap, D3D12_HEAP_FLAG_NONE, &upload_description,
+            D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, __uuidof(ID3D12Resource), (void**)&upload_buffer);
+        if (FAILED(result))
+        {
+            PLOG_ERROR << "Failed to create D3D12 texture update buffer. Returned HRESULT: " << result;
+            upload_buffer = nullptr;
+            pending_texture_updates.clear();
+            pending_update_data.clear();
+            return;
+        }
+        update_buffer_sizes[current_buffer_index] = upload_description.Width;
+    }
+
+    uint8_t* mapped = nullptr;
+    if (FAILED(upload_buffer->Map(0, nullptr, (void**)&mapped)))
+    {
+        PLOG_ERROR << "Failed to map D3D12 texture update buffer.";
+        pending_texture_updates.clear();
+        pending_update_data.clear();
+        return;
+    }
 
-        result = wic_factory->CreateFormatConverter(&converter);
-        if (FAILED(result)) { PLOG_ERROR << "Failed to create WIC format converter. HRESULT: " << result; break; }
+    for (size_t idx = 0; idx < pending_texture_updates.size(); idx++)
+    {
+        const PendingTextureUpdate& update = pending_texture_updates[idx];
+        auto record = texture_registry.find(update.texture);
+        if (record == texture_registry.end())
+        {
+            continue;       // Released since the update was queued.
+        }
 
-        result = converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
-        if (FAILED(result)) { PLOG_ERROR << "Failed to convert image to 32bpp RGBA. HRESULT: " << result; break; }
+        const UINT row_pitch = (UINT)align(update.row_bytes, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+        for (UINT row = 0; row < update.height; row++)
+        {
+            memcpy(mapped + offsets[idx] + (size_t)row * row_pitch,
+                   pending_update_data.data() + update.data_offset + (size_t)row * update.row_bytes, update.row_bytes);
+        }
 
-        UINT width = 0;
-        UINT height = 0;
-        result = converter->GetSize(&width, &height);
-        if (FAILED(result) || !width || !height) { PLOG_ERROR << "Failed to get image size. HRESULT: " << result; break; }
+        // Dynamic textures rest in the pixel shader resource state between updates.
+        D3D12_RESOURCE_BARRIER barrier = {};
+        barrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Transition.pResource   = record->second.resource;
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        barrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_COPY_DEST;
+        d3d12_command_list->ResourceBarrier(1, &barrier);
+
+        D3D12_TEXTURE_COPY_LOCATION copy_destination = {};
+        copy_destination.pResource        = record->second.resource;
+        copy_destination.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        copy_destination.SubresourceIndex = 0;
+
+        D3D12_TEXTURE_COPY_LOCATION copy_source = {};
+        copy_source.pResource                           = upload_buffer;
+        copy_source.Type                                = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        copy_source.PlacedFootprint.Offset              = offsets[idx];
+        copy_source.PlacedFootprint.Footprint.Format    = record->second.format;
+        copy_source.PlacedFootprint.Footprint.Width     = update.width;
+        copy_source.PlacedFootprint.Footprint.Height    = update.height;
+        copy_source.PlacedFootprint.Footprint.Depth     = 1;
+        copy_source.PlacedFootprint.Footprint.RowPitch  = row_pitch;
+
+        d3d12_command_list->CopyTextureRegion(&copy_destination, update.x, update.y, 0, &copy_source, nullptr);
+
+        barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        barrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        d3d12_command_list->ResourceBarrier(1, &barrier);
+    }
 
-        std::vector<uint8_t> pixels((size_t)width * height * 4);
-        result = converter->CopyPixels(nullptr, width * 4, (UINT)pixels.size(), pixels.data());
-        if (FAILED(result)) { PLOG_ERROR << "Failed to copy decoded pixels. HRESULT: " << result; break; }
+    upload_buffer->Unmap(0, nullptr);
+    pending_texture_updates.clear();
+    pending_update_data.clear();
+}
 
-        texture_handle = CreateTextureFromMemory(pixels.data(), (int)width, (int)height);
-    } while (false);
+void* D3D12GraphicsApi::CreateTextureFromFile(const std::wstring& file_path)
+{
+    // WICTextureLoader is D3D11-only, so decode the image with WIC directly and feed the
+    // pixels through the shared upload path. BGRA is the native output of most WIC decoders,
+    // so asking for it usually makes the decode a plain copy; the swizzle to RGBA happens
+    // while filling the upload buffer.
+    PLOG_DEBUG << "Creating D3D12 texture from file";
 
-    if (converter)   converter->Release();
-    if (frame)       frame->Release();
-    if (decoder)     decoder->Release();
-    if (wic_factory) wic_factory->Release();
-    if (co_initialized) CoUninitialize();
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+    if (!TextureLoader::DecodeImageFile(file_path, PixelFormat::BGRA8, pixels, width, height))
+    {
+        return nullptr;
+    }
 
-    return texture_handle;
+    PixelLayout layout;
+    layout.format = PixelFormat::BGRA8;
+    return CreateTextureFromMemory(pixels.data(), width, height, layout);
 }
 
 void D3D12GraphicsApi::ReleaseTexture(void* texture)
@@ -940,6 +1822,11 @@ void D3D12GraphicsApi::ReleaseTexture(void* texture)
         return;
     }
 
+    // Its descriptor slot can be reused before the next Render, so queued updates must not outlive it.
+    pending_texture_updates.erase(std::remove_if(pending_texture_updates.begin(), pending_texture_updates.end(),
+        [texture](const PendingTextureUpdate& update) { return update.texture == (UINT64)texture; }), pending_texture_updates.end());
+
+    UntrackTextureMemory(texture);
     record->second.resource->Release();
     if (record->second.heap_index < srv_slot_used.size())
     {
@@ -951,6 +1838,18 @@ void D3D12GraphicsApi::ReleaseTexture(void* texture)
 void D3D12GraphicsApi::ShutdownImGuiImpl()
 {
     ImGui_ImplDX12_Shutdown();
+
+    IGraphicsApi::SdfTextCallback = nullptr;
+    if (sdf_pipeline_state)
+    {
+        sdf_pipeline_state->Release();
+        sdf_pipeline_state = nullptr;
+    }
+    if (sdf_root_signature)
+    {
+        sdf_root_signature->Release();
+        sdf_root_signature = nullptr;
+    }
 }
 
 void D3D12GraphicsApi::Cleanup(void* params)
@@ -962,6 +1861,19 @@ void D3D12GraphicsApi::Cleanup(void* params)
     }
     texture_registry.clear();
     srv_slot_used.clear();
+    UntrackAllTextureMemory();
+    pending_texture_updates.clear();
+    pending_update_data.clear();
+
+    for (ID3D12Resource* update_buffer : update_buffers)
+    {
+        if (update_buffer)
+        {
+            update_buffer->Release();
+        }
+    }
+    update_buffers.clear();
+    update_buffer_sizes.clear();
 
     if (current_back_buffer)
     {
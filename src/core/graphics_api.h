@@ -4,10 +4,19 @@
 #include <d3d11.h>
 #include <d3d12.h>
 #include <dxgi1_4.h>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "core\handle_table.h"
+#include "core\pixel_convert.h"
+#include "core\texture_image.h"
+
+struct ImDrawData;
+struct ImDrawList;
+struct ImDrawCmd;
+
 enum class GraphicsApiType
 {
     DirectX11,
@@ -78,17 +87,67 @@ class IGraphicsApi
         static void* (*CreateTextureFromFile)(const std::wstring& file_path);
 
         /**
-         * @brief Creates a graphics API compatible texture from raw 32-bit RGBA pixels.
+         * @brief Creates a graphics API compatible texture from raw pixels.
+         *
+         * The pixels are converted to 32-bit straight-alpha RGBA (see pixel_convert.h) as they
+         * are copied into staging memory.
+         *
+         * @param pixels Pointer to the first row of pixel data, at least
+         *               PixelConvert::RequiredSourceSize(layout, width, height) bytes.
+         * @param width Texture width in pixels.
+         * @param height Texture height in pixels.
+         * @param layout Source format, row pitch and alpha mode. A default PixelLayout is tightly packed RGBA.
+         * @return Pointer to the created texture resource, or nullptr on failure.
+         */
+        static void* (*CreateTextureFromMemory)(const void* pixels, int width, int height, const PixelLayout& layout);
+
+        /**
+         * @brief Creates a graphics API compatible texture from prepared image data.
+         *
+         * Unlike CreateTextureFromMemory the data is uploaded as is, so it must already be in the
+         * image's GPU format. This is the path for block-compressed textures and mip chains.
+         *
+         * @param image The format and mip levels to upload, largest level first.
+         * @return Pointer to the created texture resource, or nullptr on failure.
+         */
+        static void* (*CreateTextureFromImage)(const TextureImage& image);
+
+        /**
+         * @brief Creates a texture whose pixels can be rewritten in place with UpdateTexture.
+         *
+         * Other textures are immutable, so changing one means creating a replacement. A dynamic
+         * texture is for content that changes while it is drawn (a glyph atlas, video frames).
+         * It starts out zeroed.
          *
-         * @param pixels Pointer to width * height * 4 bytes of RGBA pixel data (row-major, no padding).
          * @param width Texture width in pixels.
          * @param height Texture height in pixels.
+         * @param format PixelFormat::RGBA8 for straight-alpha colour, or PixelFormat::Gray8 for a
+         *               single-channel texture, which shaders sample as red. Other formats fail.
          * @return Pointer to the created texture resource, or nullptr on failure.
          */
-        static void* (*CreateTextureFromMemory)(const void* pixels, int width, int height);
+        static void* (*CreateDynamicTexture)(int width, int height, PixelFormat format);
 
         /**
-         * @brief Releases a texture previously returned by CreateTextureFromFile or CreateTextureFromMemory.
+         * @brief Overwrites a rectangle of a texture created by CreateDynamicTexture.
+         *
+         * The pixels are copied before returning. Draws recorded earlier in the frame see the new
+         * pixels too, since the copy lands before the frame is rendered.
+         *
+         * @param texture A texture returned by CreateDynamicTexture.
+         * @param x Left edge of the rectangle in pixels.
+         * @param y Top edge of the rectangle in pixels.
+         * @param width Rectangle width in pixels.
+         * @param height Rectangle height in pixels.
+         * @param pixels First row of the rectangle, in the texture's own format (4 bytes per pixel
+         *               for RGBA8, 1 for Gray8).
+         * @param row_pitch Bytes from one source row to the next.
+         * @return True when the update was applied or queued; false for a bad texture or rectangle (logged).
+         */
+        static bool (*UpdateTexture)(void* texture, int x, int y, int width, int height, const void* pixels, size_t row_pitch);
+
+        /**
+         * @brief Releases a texture previously returned by CreateTextureFromFile, CreateTextureFromMemory,
+         * CreateTextureFromImage or CreateDynamicTexture.
          *
          * Texture handles are API specific (a COM shader resource view for D3D11, a GPU descriptor
          * handle for D3D12), so releasing must go through the active implementation rather than a
@@ -121,6 +180,92 @@ class IGraphicsApi
          */
         static void DrainTextureReleases(bool release_all = false);
 
+        /**
+         * @brief Registers a texture created for a script and returns the handle the script gets.
+         *
+         * Scripts never see raw texture handles. They get a generational handle (see
+         * handle_table.h), tagged in its low two bits so it can never be mistaken for a real
+         * handle, which are all aligned. ImGui stores it in the draw list like any texture ID and
+         * ResolveScriptTextures swaps in the real texture just before the backend renders. A
+         * handle kept past its texture's release therefore draws nothing instead of whatever
+         * texture was created next.
+         *
+         * @param texture The real texture. Null returns null.
+         * @param owner Owner tag recorded with the handle.
+         * @return The script-facing handle, or nullptr when texture is null.
+         */
+        static void* RegisterScriptTexture(void* texture, uint32_t owner = 0);
+
+        /**
+         * @brief Returns the real texture behind a script-facing handle, or nullptr when the handle
+         * is stale. Untagged values are returned unchanged.
+         */
+        static void* ResolveScriptTexture(void* handle);
+
+        /**
+         * @brief Invalidates a script-facing handle and queues its texture for release (see
+         * QueueTextureRelease). Untagged values are queued as raw textures.
+         */
+        static void ReleaseScriptTexture(void* handle);
+
+        /**
+         * @brief Invalidates every script-facing handle and queues all their textures for release.
+         * Called during core cleanup.
+         */
+        static void ReleaseAllScriptTextures();
+
+        /**
+         * @brief Releases every script-facing texture registered with the given owner tag, as
+         * ReleaseScriptTexture does. Used to reclaim what a script left behind when it is disabled
+         * or reloaded.
+         */
+        static void ReleaseScriptTexturesOwnedBy(uint32_t owner);
+
+        /**
+         * @brief Hands a script-facing texture over to the core (owner 0), so it survives its
+         * creator being disabled or reloaded and is only released explicitly or on eject.
+         *
+         * @return True when the handle was valid.
+         */
+        static bool KeepScriptTexture(void* handle);
+
+        /**
+         * @brief Counts the script-facing textures registered with an owner tag and the GPU memory
+         * they hold (see GetTextureBytes).
+         */
+        static ResourceUsage GetScriptTextureUsage(uint32_t owner);
+
+        /**
+         * @brief Replaces script-facing texture handles in a frame's draw data with the real
+         * textures. Draw commands using stale handles are emptied.
+         *
+         * Called by each implementation's Render right before handing the draw data to its backend.
+         */
+        static void ResolveScriptTextures(ImDrawData* draw_data);
+
+        /**
+         * @brief Returns the GPU memory held by live user textures, in bytes.
+         *
+         * Counts the texels of every texture created through this interface and not yet released.
+         * Driver padding and alignment are not included, so the real footprint is slightly higher.
+         */
+        static size_t GetResidentTextureBytes();
+
+        /**
+         * @brief Returns the GPU memory held by one live texture, counted the same way as
+         * GetResidentTextureBytes, or 0 for an unknown handle.
+         */
+        static size_t GetTextureBytes(void* texture);
+
+        /**
+         * @brief ImDrawList callback that switches the backend to its signed-distance-field text
+         * shader for the draw commands that follow (see sdf_font.h).
+         *
+         * Null when the active implementation has no SDF shader. Draw lists that add this callback
+         * must add ImDrawCallback_ResetRenderState after their SDF draws to switch back.
+         */
+        static void (*SdfTextCallback)(const ImDrawList* draw_list, const ImDrawCmd* command);
+
         /**
          * @brief Shuts down the ImGui implementation for the graphics API.
          */
@@ -138,6 +283,22 @@ class IGraphicsApi
         static bool  initialized;
         static HWND  target_window;
 
+    protected:
+        /**
+         * @brief Records the size of a newly created texture for GetResidentTextureBytes.
+         */
+        static void TrackTextureMemory(void* texture, size_t bytes);
+
+        /**
+         * @brief Forgets a texture recorded by TrackTextureMemory. Unknown handles are ignored.
+         */
+        static void UntrackTextureMemory(void* texture);
+
+        /**
+         * @brief Forgets every tracked texture. Used when an implementation frees all of its textures at once.
+         */
+        static void UntrackAllTextureMemory();
+
     private:
         // A texture handle awaiting release, and how many more frames it has to be held first.
         struct PendingTextureRelease
@@ -147,6 +308,9 @@ class IGraphicsApi
         };
 
         static std::vector<PendingTextureRelease> pending_texture_releases;
+        static HandleTable<void*>                 script_textures;            // Script-facing handle -> real texture
+        static std::unordered_map<void*, size_t>  texture_memory;             // Texture handle -> bytes
+        static size_t                             resident_texture_bytes;
 };
 
 /**
@@ -175,6 +339,9 @@ class D3D11GraphicsApi : public IGraphicsApi
         /**
          * @brief Initializes ImGui with the DirectX 11 implementation.
          *
+         * Also compiles the SDF text pixel shader. If that fails SDF text falls back to regular
+         * fonts, so the failure is logged rather than returned.
+         *
          * @return True if initialization is successful, otherwise false.
          */
         static bool InitializeImGui();
@@ -218,20 +385,55 @@ class D3D11GraphicsApi : public IGraphicsApi
         static void* CreateTextureFromFile(const std::wstring& file_path);
 
         /**
-         * @brief Creates a texture from raw 32-bit RGBA pixels in the DirectX 11 context.
+         * @brief Creates a texture from raw pixels in the DirectX 11 context.
+         *
+         * Tightly packed or padded RGBA is handed to the device as is. Other layouts are
+         * converted into a temporary RGBA copy first.
+         *
+         * @param pixels Pointer to the first row of pixel data.
+         * @param width Texture width in pixels.
+         * @param height Texture height in pixels.
+         * @param layout Source format, row pitch and alpha mode.
+         * @return Pointer to the created shader resource view, or nullptr on failure.
+         */
+        static void* CreateTextureFromMemory(const void* pixels, int width, int height, const PixelLayout& layout);
+
+        /**
+         * @brief Creates a texture from prepared image data (any TextureFormat, any number of mips).
+         *
+         * @param image The format and mip levels to upload.
+         * @return Pointer to the created shader resource view, or nullptr on failure.
+         */
+        static void* CreateTextureFromImage(const TextureImage& image);
+
+        /**
+         * @brief Creates a default-usage texture that UpdateTexture can write to.
          *
-         * @param pixels Pointer to width * height * 4 bytes of RGBA pixel data (row-major, no padding).
          * @param width Texture width in pixels.
          * @param height Texture height in pixels.
+         * @param format RGBA8 or Gray8 (created as R8).
          * @return Pointer to the created shader resource view, or nullptr on failure.
          */
-        static void* CreateTextureFromMemory(const void* pixels, int width, int height);
+        static void* CreateDynamicTexture(int width, int height, PixelFormat format);
+
+        /**
+         * @brief Writes a rectangle of a dynamic texture with UpdateSubresource on the immediate context.
+         */
+        static bool UpdateTexture(void* texture, int x, int y, int width, int height, const void* pixels, size_t row_pitch);
 
         /**
          * @brief Releases a D3D11 texture handle (a COM shader resource view).
          */
         static void ReleaseTexture(void* texture);
 
+        /**
+         * @brief Binds the SDF text pixel shader from inside ImGui's render loop.
+         *
+         * Only the pixel shader changes; the backend's vertex shader, sampler and blend state stay
+         * bound, and ImDrawCallback_ResetRenderState restores its own pixel shader.
+         */
+        static void BindSdfTextShader(const ImDrawList* draw_list, const ImDrawCmd* command);
+
         /**
          * @brief Shuts down the ImGui implementation for DirectX 11.
          */
@@ -262,6 +464,7 @@ class D3D11GraphicsApi : public IGraphicsApi
         static ID3D11Device*            d3d11_device;
         static ID3D11DeviceContext*     d3d11_context;
         static ID3D11RenderTargetView*  main_render_target_view;
+        static ID3D11PixelShader*       sdf_text_pixel_shader;
 };
 
 
@@ -352,7 +555,8 @@ class D3D12GraphicsApi : public IGraphicsApi
         /**
          * @brief Creates a texture from a file in the DirectX 12 context.
          *
-         * The image is decoded to 32-bit RGBA with WIC and uploaded through CreateTextureFromMemory.
+         * The image is decoded to 32-bit BGRA with WIC and uploaded through CreateTextureFromMemory,
+         * which swizzles it to RGBA while filling the upload buffer.
          *
          * @param file_path Path to the texture file.
          * @return An opaque texture handle (a GPU descriptor handle) usable with ImGui.Image, or nullptr on failure.
@@ -360,23 +564,63 @@ class D3D12GraphicsApi : public IGraphicsApi
         static void* CreateTextureFromFile(const std::wstring& file_path);
 
         /**
-         * @brief Creates a texture from raw 32-bit RGBA pixels in the DirectX 12 context.
+         * @brief Creates a texture from raw pixels in the DirectX 12 context.
+         *
+         * Converts the pixels straight into a temporary upload buffer, uploads them to a
+         * default-heap texture, waits for the copy on the captured command queue, and allocates
+         * an SRV descriptor for it.
+         *
+         * @param pixels Pointer to the first row of pixel data.
+         * @param width Texture width in pixels.
+         * @param height Texture height in pixels.
+         * @param layout Source format, row pitch and alpha mode.
+         * @return An opaque texture handle (a GPU descriptor handle) usable with ImGui.Image, or nullptr on failure.
+         */
+        static void* CreateTextureFromMemory(const void* pixels, int width, int height, const PixelLayout& layout);
+
+        /**
+         * @brief Creates a texture from prepared image data (any TextureFormat, any number of mips).
+         *
+         * @param image The format and mip levels to upload.
+         * @return An opaque texture handle (a GPU descriptor handle) usable with ImGui.Image, or nullptr on failure.
+         */
+        static void* CreateTextureFromImage(const TextureImage& image);
+
+        /**
+         * @brief Creates a default-heap texture that UpdateTexture can write to.
          *
-         * Uploads the pixels to a default-heap texture via a temporary upload buffer, waits for
-         * the copy on the captured command queue, and allocates an SRV descriptor for it.
+         * Creation waits for the upload like any other texture; updates afterwards do not.
          *
-         * @param pixels Pointer to width * height * 4 bytes of RGBA pixel data (row-major, no padding).
          * @param width Texture width in pixels.
          * @param height Texture height in pixels.
+         * @param format RGBA8 or Gray8 (created as R8).
          * @return An opaque texture handle (a GPU descriptor handle) usable with ImGui.Image, or nullptr on failure.
          */
-        static void* CreateTextureFromMemory(const void* pixels, int width, int height);
+        static void* CreateDynamicTexture(int width, int height, PixelFormat format);
+
+        /**
+         * @brief Queues a rectangle of a dynamic texture to be copied in on the next Render.
+         *
+         * The pixels are staged on the CPU; Render copies them into its frame's upload buffer and
+         * records the copy ahead of the ImGui draws on the same command list, so nothing waits
+         * on the GPU.
+         */
+        static bool UpdateTexture(void* texture, int x, int y, int width, int height, const void* pixels, size_t row_pitch);
 
         /**
          * @brief Releases a D3D12 texture handle (frees its SRV descriptor and underlying resource).
          */
         static void ReleaseTexture(void* texture);
 
+        /**
+         * @brief Switches the command list to the SDF text pipeline from inside ImGui's render loop.
+         *
+         * The pipeline uses a root signature laid out like the backend's, so the backend keeps
+         * binding each draw's texture at the same root parameter. Changing root signature drops
+         * the projection constants, so they are set again from the draw data.
+         */
+        static void BindSdfTextShader(const ImDrawList* draw_list, const ImDrawCmd* command);
+
         /**
          * @brief Shuts down the ImGui implementation for DirectX 12.
          */
@@ -420,6 +664,24 @@ class D3D12GraphicsApi : public IGraphicsApi
         {
             ID3D12Resource* resource;
             UINT            heap_index;
+            DXGI_FORMAT     format;
+            UINT            width;
+            UINT            height;
+            bool            dynamic;        // Created by CreateDynamicTexture, so UpdateTexture may write it
+        };
+
+        /**
+         * @brief A rectangle queued by UpdateTexture, waiting for Render to copy it in.
+         */
+        struct PendingTextureUpdate
+        {
+            UINT64  texture;                // GPU descriptor ptr, looked up again in Render
+            UINT    x;
+            UINT    y;
+            UINT    width;
+            UINT    height;
+            size_t  row_bytes;
+            size_t  data_offset;            // Tightly packed rows in pending_update_data
         };
 
         /**
@@ -441,6 +703,25 @@ class D3D12GraphicsApi : public IGraphicsApi
         static void ImGuiSrvAlloc(struct ImGui_ImplDX12_InitInfo* info, D3D12_CPU_DESCRIPTOR_HANDLE* out_cpu_handle, D3D12_GPU_DESCRIPTOR_HANDLE* out_gpu_handle);
         static void ImGuiSrvFree(struct ImGui_ImplDX12_InitInfo* info, D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle, D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle);
 
+        /**
+         * @brief Creates a default-heap texture, fills it through a temporary upload buffer, and
+         * allocates its SRV.
+         *
+         * The upload buffer layout comes from GetCopyableFootprints, so every level is written
+         * straight into its final padded position by write_level. That is where pixel conversion
+         * or block copies happen, without any intermediate buffer.
+         *
+         * @param format Texture format.
+         * @param width Width of the top level in pixels.
+         * @param height Height of the top level in pixels.
+         * @param mip_levels Number of levels to allocate and fill.
+         * @param write_level Called once per level with the level index, its mapped destination
+         *                    and its row pitch in the upload buffer.
+         * @return The texture handle, or nullptr on failure.
+         */
+        static void* UploadTexture(DXGI_FORMAT format, int width, int height, UINT mip_levels,
+                                   const std::function<void(UINT level, uint8_t* destination, UINT row_pitch)>& write_level);
+
         /**
          * @brief Submits a closed command list on the captured queue and blocks until the GPU finishes it.
          *
@@ -450,6 +731,21 @@ class D3D12GraphicsApi : public IGraphicsApi
          */
         static bool ExecuteAndWait(ID3D12CommandList* command_list);
 
+        /**
+         * @brief Records the copies queued by UpdateTexture on the frame's command list.
+         *
+         * Called by Render before the ImGui draws. The staged pixels go into the upload buffer
+         * of the current swap chain buffer, which is reused only once the GPU is done with it,
+         * the same guarantee the per-buffer command allocators rely on.
+         */
+        static void FlushTextureUpdates();
+
+        /**
+         * @brief Creates the SDF text root signature and pipeline state. On failure SDF text falls
+         * back to regular fonts, so the failure is logged rather than returned.
+         */
+        static void CreateSdfTextPipeline();
+
         static ID3D12Device*                        d3d12_device;
         static ID3D12CommandQueue*                  d3d12_command_queue;        // Captured from the app via HookedExecuteCommandLists
         static ID3D12GraphicsCommandList*           d3d12_command_list;
@@ -467,6 +763,12 @@ class D3D12GraphicsApi : public IGraphicsApi
         static ID3D12Fence*                         upload_fence;
         static UINT64                               upload_fence_value;
         static HANDLE                               upload_fence_event;
+        static std::vector<PendingTextureUpdate>    pending_texture_updates;
+        static std::vector<uint8_t>                 pending_update_data;
+        static std::vector<ID3D12Resource*>         update_buffers;             // One per swap chain buffer, grown on demand
+        static std::vector<UINT64>                  update_buffer_sizes;
+        static ID3D12RootSignature*                 sdf_root_signature;
+        static ID3D12PipelineState*                 sdf_pipeline_state;
 };
 
 /** 
@@ -0,0 +1,263 @@
+/**
+ * @file handle_table.h
+ * @brief Generational slot map for the resources scripts hold handles to.
+ *
+ * A handle packs a slot index with the generation the slot had when the handle was issued.
+ * Removing a resource bumps its slot's generation, so an old handle kept by a reloaded script
+ * fails validation instead of aliasing whatever resource reuses the slot. A slot whose
+ * generation runs out is retired rather than wrapped, so a slot reused every frame never hands
+ * out a generation again. Lookups are O(1): a
+ * bounds check, a generation compare and one indirection. Values are stored densely, so
+ * iterating every live resource (cleanup, debug counts) touches no empty slots.
+ *
+ * Every entry also carries an owner tag, the id of whoever created it (0 for the core), so
+ * resources can be listed or reclaimed per owner.
+ *
+ * Handles are below 2^44, which keeps them exact as Lua numbers and leaves room for callers
+ * to tag them further (see IGraphicsApi's texture handles). 0 is never a valid handle.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using ResourceHandle = uint64_t;
+
+/**
+ * @brief How many resources of one kind an owner holds, and roughly how much memory they use.
+ */
+struct ResourceUsage
+{
+    size_t count = 0;
+    size_t bytes = 0;   // Estimated; see each manager's GetUsage
+};
+
+template <typename T>
+class HandleTable
+{
+    public:
+        static constexpr int        INDEX_BITS      = 28;
+        static constexpr int        GENERATION_BITS = 16;
+        static constexpr uint32_t   MAX_SLOTS       = 1u << INDEX_BITS;
+        static constexpr uint32_t   MAX_GENERATION  = (1u << GENERATION_BITS) - 1;
+
+        /**
+         * @brief Stores a value and returns its handle, or 0 when every slot is in use.
+         */
+        ResourceHandle Insert(T value, uint32_t owner = 0)
+        {
+            uint32_t index;
+            if (!free_slots.empty())
+            {
+                index = free_slots.back();
+                free_slots.pop_back();
+            }
+            else
+            {
+                if (slots.size() >= MAX_SLOTS)
+                {
+                    return 0;
+                }
+                index = (uint32_t)slots.size();
+                slots.push_back(Slot());
+            }
+
+            Slot& slot      = slots[index];
+            slot.dense      = (uint32_t)values.size();
+            slot.live       = true;
+            values.push_back(std::move(value));
+            entries.push_back({ index, owner });
+            return MakeHandle(index, slot.generation);
+        }
+
+        /**
+         * @brief Returns the value for a handle, or nullptr when the handle is stale or invalid.
+         */
+        T* Find(ResourceHandle handle)
+        {
+            const Slot* slot = FindSlot(handle);
+            return slot ? &values[slot->dense] : nullptr;
+        }
+
+        const T* Find(ResourceHandle handle) const
+        {
+            const Slot* slot = FindSlot(handle);
+            return slot ? &values[slot->dense] : nullptr;
+        }
+
+        bool Contains(ResourceHandle handle) const
+        {
+            return FindSlot(handle) != nullptr;
+        }
+
+        /**
+         * @brief Returns the owner tag a handle was inserted with, or 0 for an invalid handle.
+         */
+        uint32_t GetOwner(ResourceHandle handle) const
+        {
+            const Slot* slot = FindSlot(handle);
+            return slot ? entries[slot->dense].owner : 0;
+        }
+
+        /**
+         * @brief Changes the owner tag of a live value.
+         *
+         * @return True when the handle was valid.
+         */
+        bool SetOwner(ResourceHandle handle, uint32_t owner)
+        {
+            const Slot* slot = FindSlot(handle);
+            if (!slot)
+            {
+                return false;
+            }
+            entries[slot->dense].owner = owner;
+            return true;
+        }
+
+        /**
+         * @brief Removes a value, optionally moving it out first. Stale handles are ignored.
+         *
+         * @return True when the handle was valid.
+         */
+        bool Remove(ResourceHandle handle, T* out_value = nullptr)
+        {
+            const Slot* found = FindSlot(handle);
+            if (!found)
+            {
+                return false;
+            }
+
+            const uint32_t index = (uint32_t)(handle & (MAX_SLOTS - 1));
+            const uint32_t dense = found->dense;
+            if (out_value)
+            {
+                *out_value = std::move(values[dense]);
+            }
+
+            // Swap the last value into the hole to keep storage dense.
+            const uint32_t last = (uint32_t)values.size() - 1;
+            if (dense != last)
+            {
+                values[dense]  = std::move(values[last]);
+                entries[dense] = entries[last];
+                slots[entries[dense].index].dense = dense;
+            }
+            values.pop_back();
+            entries.pop_back();
+
+            FreeSlot(index);
+            return true;
+        }
+
+        /**
+         * @brief Calls fn(handle, value, owner) for every live value, in storage order.
+         *
+         * fn must not insert or remove while iterating.
+         */
+        template <typename Fn>
+        void ForEach(Fn&& fn)
+        {
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                const Entry& entry = entries[i];
+                fn(MakeHandle(entry.index, slots[entry.index].generation), values[i], entry.owner);
+            }
+        }
+
+        /**
+         * @brief Returns the handles of every live value, for callers that remove as they go.
+         */
+        std::vector<ResourceHandle> Handles() const
+        {
+            std::vector<ResourceHandle> handles;
+            handles.reserve(entries.size());
+            for (const Entry& entry : entries)
+            {
+                handles.push_back(MakeHandle(entry.index, slots[entry.index].generation));
+            }
+            return handles;
+        }
+
+        /**
+         * @brief Returns the handles of every value with the given owner tag.
+         */
+        std::vector<ResourceHandle> HandlesOwnedBy(uint32_t owner) const
+        {
+            std::vector<ResourceHandle> handles;
+            for (const Entry& entry : entries)
+            {
+                if (entry.owner == owner)
+                {
+                    handles.push_back(MakeHandle(entry.index, slots[entry.index].generation));
+                }
+            }
+            return handles;
+        }
+
+        /**
+         * @brief Removes every value. Outstanding handles all become stale.
+         */
+        void Clear()
+        {
+            for (const Entry& entry : entries)
+            {
+                FreeSlot(entry.index);
+            }
+            values.clear();
+            entries.clear();
+        }
+
+        size_t Size() const { return values.size(); }
+        bool Empty() const { return values.empty(); }
+
+    private:
+        struct Slot
+        {
+            uint32_t dense      = 0;    // Position of the value in values
+            uint32_t generation = 1;    // Never 0, so no handle is ever 0
+            bool     live       = false;
+        };
+
+        struct Entry
+        {
+            uint32_t index;             // Slot that points at this value
+            uint32_t owner;
+        };
+
+        static ResourceHandle MakeHandle(uint32_t index, uint32_t generation)
+        {
+            return ((ResourceHandle)generation << INDEX_BITS) | index;
+        }
+
+        // Bumps the slot's generation and queues it for reuse. A slot that has used its last
+        // generation stays dead instead: wrapping would let a handle from 65k uses ago match again.
+        void FreeSlot(uint32_t index)
+        {
+            Slot& slot = slots[index];
+            slot.live = false;
+            if (slot.generation < MAX_GENERATION)
+            {
+                slot.generation++;
+                free_slots.push_back(index);
+            }
+        }
+
+        const Slot* FindSlot(ResourceHandle handle) const
+        {
+            const uint32_t index      = (uint32_t)(handle & (MAX_SLOTS - 1));
+            const uint32_t generation = (uint32_t)(handle >> INDEX_BITS);
+            if (index >= slots.size() || !slots[index].live || slots[index].generation != generation)
+            {
+                return nullptr;
+            }
+            return &slots[index];
+        }
+
+        std::vector<Slot>       slots;
+        std::vector<uint32_t>   free_slots;
+        std::vector<T>          values;
+        std::vector<Entry>      entries;    // Parallel to values
+};
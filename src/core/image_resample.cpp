@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cmath>
+
+#include <emmintrin.h>
+
+#include "core\image_resample.h"
+
+namespace
+{
+    constexpr double PI = 3.14159265358979323846;
+
+    // The source pixels that make up one destination pixel along one axis.
+    struct Contribution
+    {
+        int first;              // First source pixel
+        int count;              // Number of source pixels
+        size_t weight_offset;   // Index of the first weight in the shared weight array
+    };
+
+    double FilterRadius(ResampleFilter filter)
+    {
+        return filter == ResampleFilter::Box ? 0.5 : 3.0;
+    }
+
+    double FilterWeight(ResampleFilter filter, double x)
+    {
+        x = std::fabs(x);
+        if (filter == ResampleFilter::Box)
+        {
+            return x < 0.5 ? 1.0 : (x == 0.5 ? 0.5 : 0.0);
+        }
+
+        if (x < 1e-8)
+        {
+            return 1.0;
+        }
+        if (x >= 3.0)
+        {
+            return 0.0;
+        }
+        const double pi_x = PI * x;
+        return 3.0 * std::sin(pi_x) * std::sin(pi_x / 3.0) / (pi_x * pi_x);
+    }
+
+    // Precomputes normalized filter weights for every destination pixel along one axis. When
+    // shrinking, the filter is stretched to cover every source pixel, which is what keeps
+    // large reductions from aliasing.
+    void ComputeContributions(int source_size, int destination_size, ResampleFilter filter,
+                              std::vector<Contribution>& out_contributions, std::vector<float>& out_weights)
+    {
+        const double scale        = (double)source_size / destination_size;
+        const double filter_scale = std::max(1.0, scale);
+        const double radius       = FilterRadius(filter) * filter_scale;
+
+        out_contributions.resize(destination_size);
+        out_weights.clear();
+
+        for (int i = 0; i < destination_size; ++i)
+        {
+            const double center = (i + 0.5) * scale;
+            const int first     = std::max(0, (int)std::floor(center - radius));
+            const int last      = std::min(source_size, (int)std::ceil(center + radius));
+
+            Contribution& contribution  = out_contributions[i];
+            contribution.first          = first;
+            contribution.count          = 0;
+            contribution.weight_offset  = out_weights.size();
+
+            double total = 0.0;
+            for (int j = first; j < last; ++j)
+            {
+                const double weight = FilterWeight(filter, (j + 0.5 - center) / filter_scale);
+                out_weights.push_back((float)weight);
+                total += weight;
+                contribution.count++;
+            }
+
+            if (contribution.count == 0 || std::fabs(total) < 1e-8)
+            {
+                // Nothing under the filter (tiny upscales with Box); fall back to the nearest pixel.
+                out_weights.resize(contribution.weight_offset);
+                contribution.first = std::min(source_size - 1, std::max(0, (int)center));
+                contribution.count = 1;
+                out_weights.push_back(1.0f);
+                continue;
+            }
+
+            for (int j = 0; j < contribution.count; ++j)
+            {
+                out_weights[contribution.weight_offset + j] = (float)(out_weights[contribution.weight_offset + j] / total);
+            }
+        }
+    }
+
+    // Loads one RGBA8 pixel as premultiplied floats in [0, 1].
+    inline __m128 LoadPremultiplied(const uint8_t* pixel)
+    {
+        const __m128i zero      = _mm_setzero_si128();
+        const __m128i bytes     = _mm_cvtsi32_si128(*(const int*)pixel);
+        const __m128i dwords    = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+        const __m128 straight   = _mm_mul_ps(_mm_cvtepi32_ps(dwords), _mm_set1_ps(1.0f / 255.0f));
+
+        const __m128 alpha      = _mm_shuffle_ps(straight, straight, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 alpha_lane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+        return _mm_or_ps(_mm_andnot_ps(alpha_lane, _mm_mul_ps(straight, alpha)), _mm_and_ps(alpha_lane, straight));
+    }
+
+    // Stores one premultiplied float pixel as straight-alpha RGBA8. Lanczos overshoot is clamped
+    // first, including colour above alpha, which premultiplied colour can never legally be.
+    inline void StoreStraight(__m128 pixel, uint8_t* destination)
+    {
+        pixel = _mm_min_ps(_mm_max_ps(pixel, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+        const __m128 alpha      = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 alpha_lane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+        const __m128 visible    = _mm_cmpgt_ps(alpha, _mm_set1_ps(1.0f / 512.0f));
+
+        __m128 colour = _mm_div_ps(_mm_min_ps(pixel, alpha), _mm_max_ps(alpha, _mm_set1_ps(1.0f / 512.0f)));
+        colour = _mm_and_ps(colour, visible);
+        pixel  = _mm_or_ps(_mm_andnot_ps(alpha_lane, colour), _mm_and_ps(alpha_lane, pixel));
+
+        const __m128i dwords = _mm_cvtps_epi32(_mm_mul_ps(pixel, _mm_set1_ps(255.0f)));
+        const __m128i words  = _mm_packs_epi32(dwords, dwords);
+        *(int*)destination   = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    }
+}
+
+bool ImageResample::Resize(const uint8_t* source, int source_width, int source_height, size_t source_pitch,
+                           uint8_t* destination, int width, int height, size_t destination_pitch, ResampleFilter filter)
+{
+    if (!source || !destination || source_width <= 0 || source_height <= 0 || width <= 0 || height <= 0
+        || source_pitch < (size_t)source_width * 4 || destination_pitch < (size_t)width * 4)
+    {
+        return false;
+    }
+
+    std::vector<Contribution> columns;
+    std::vector<float> column_weights;
+    ComputeContributions(source_width, width, filter, columns, column_weights);
+
+    std::vector<Contribution> rows;
+    std::vector<float> row_weights;
+    ComputeContributions(source_height, height, filter, rows, row_weights);
+
+    // Horizontal pass into a (width x source_height) float image, 4 floats per pixel. Only the
+    // source rows some destination row actually reads are filtered.
+    std::vector<float> intermediate((size_t)width * source_height * 4);
+    std::vector<float> source_row((size_t)source_width * 4);
+    const int first_row = rows.front().first;
+    const int last_row  = rows.back().first + rows.back().count;
+    for (int y = first_row; y < last_row; ++y)
+    {
+        const uint8_t* row = source + (size_t)y * source_pitch;
+        for (int x = 0; x < source_width; ++x)
+        {
+            _mm_storeu_ps(source_row.data() + (size_t)x * 4, LoadPremultiplied(row + (size_t)x * 4));
+        }
+
+        float* out = intermediate.data() + (size_t)y * width * 4;
+        for (int x = 0; x < width; ++x)
+        {
+            const Contribution& contribution = columns[x];
+            const float* weights = column_weights.data() + contribution.weight_offset;
+            const float* pixels  = source_row.data() + (size_t)contribution.first * 4;
+
+            __m128 sum = _mm_setzero_ps();
+            for (int i = 0; i < contribution.count; ++i)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pixels + (size_t)i * 4), _mm_set1_ps(weights[i])));
+            }
+            _mm_storeu_ps(out + (size_t)x * 4, sum);
+        }
+    }
+
+    // Vertical pass straight into the destination.
+    for (int y = 0; y < height; ++y)
+    {
+        const Contribution& contribution = rows[y];
+        const float* weights = row_weights.data() + contribution.weight_offset;
+        uint8_t* out = destination + (size_t)y * destination_pitch;
+
+        for (int x = 0; x < width; ++x)
+        {
+            const float* column = intermediate.data() + ((size_t)contribution.first * width + x) * 4;
+            const size_t stride = (size_t)width * 4;
+
+            __m128 sum = _mm_setzero_ps();
+            for (int i = 0; i < contribution.count; ++i)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(column + (size_t)i * stride), _mm_set1_ps(weights[i])));
+            }
+            StoreStraight(sum, out + (size_t)x * 4);
+        }
+    }
+
+    return true;
+}
+
+void ImageResample::FitWithin(int width, int height, int max_width, int max_height, int& out_width, int& out_height)
+{
+    double scale = 1.0;
+    if (max_width > 0 && width > max_width)
+    {
+        scale = std::min(scale, (double)max_width / width);
+    }
+    if (max_height > 0 && height > max_height)
+    {
+        scale = std::min(scale, (double)max_height / height);
+    }
+
+    out_width  = std::max(1, (int)std::lround(width * scale));
+    out_height = std::max(1, (int)std::lround(height * scale));
+}
+
+std::vector<std::vector<uint8_t>> ImageResample::BuildMipChain(const uint8_t* rgba, int width, int height)
+{
+    std::vector<std::vector<uint8_t>> levels;
+    const uint8_t* previous = rgba;
+    while (width > 1 || height > 1)
+    {
+        const int level_width  = std::max(1, width / 2);
+        const int level_height = std::max(1, height / 2);
+
+        std::vector<uint8_t> level((size_t)level_width * level_height * 4);
+        Resize(previous, width, height, (size_t)width * 4, level.data(), level_width, level_height, (size_t)level_width * 4, ResampleFilter::Box);
+        levels.push_back(std::move(level));
+
+        previous = levels.back().data();
+        width    = level_width;
+        height   = level_height;
+    }
+    return levels;
+}
+
+bool ImageResample::ParseFilter(const std::string& name, ResampleFilter& out_filter)
+{
+    if (name == "box")                          { out_filter = ResampleFilter::Box;       return true; }
+    if (name == "lanczos" || name == "lanczos3") { out_filter = ResampleFilter::Lanczos3;  return true; }
+    return false;
+}
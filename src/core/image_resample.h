@@ -0,0 +1,67 @@
+/**
+ * @file image_resample.h
+ * @brief High-quality resizing of RGBA8 images, used to shrink textures to the size they are drawn at.
+ *
+ * Resizing is separable (a horizontal pass, then a vertical one) and done in premultiplied
+ * floating point, one pixel per SSE register, so transparent pixels never bleed their colour
+ * into the edges of opaque ones. Lanczos3 is the default for downscaling; Box is a plain average
+ * over the covered area and is what mip chains are built with.
+ *
+ * The module has no platform dependencies beyond SSE2, which every x64 CPU has.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class ResampleFilter
+{
+    Box,        // Area average; exact 2x2 averaging at half size
+    Lanczos3    // Windowed sinc with 3 lobes; sharper, slightly slower
+};
+
+namespace ImageResample
+{
+    /**
+     * @brief Resizes a straight-alpha RGBA8 image.
+     *
+     * @param source First row of the source image.
+     * @param source_width Source width in pixels.
+     * @param source_height Source height in pixels.
+     * @param source_pitch Bytes from one source row to the next.
+     * @param destination First row of the destination image.
+     * @param width Destination width in pixels.
+     * @param height Destination height in pixels.
+     * @param destination_pitch Bytes from one destination row to the next.
+     * @param filter The reconstruction filter.
+     * @return False when any argument is invalid; the destination is untouched then.
+     */
+    bool Resize(const uint8_t* source, int source_width, int source_height, size_t source_pitch,
+                uint8_t* destination, int width, int height, size_t destination_pitch, ResampleFilter filter);
+
+    /**
+     * @brief Computes the largest size with the source's aspect ratio that fits in a bounding box.
+     *
+     * Images are never enlarged. A bound of 0 leaves that direction unconstrained. The result is
+     * at least 1x1.
+     */
+    void FitWithin(int width, int height, int max_width, int max_height, int& out_width, int& out_height);
+
+    /**
+     * @brief Builds the smaller levels of a mip chain, each half the size of the previous one,
+     * down to 1x1.
+     *
+     * @param rgba Tightly packed level 0.
+     * @param width Level 0 width.
+     * @param height Level 0 height.
+     * @return The levels after level 0, largest first, each tightly packed.
+     */
+    std::vector<std::vector<uint8_t>> BuildMipChain(const uint8_t* rgba, int width, int height);
+
+    /**
+     * @brief Parses a filter name as used by the Lua API ("box", "lanczos").
+     */
+    bool ParseFilter(const std::string& name, ResampleFilter& out_filter);
+}
@@ -0,0 +1,626 @@
+#include <cstdio>
+#include <exception>
+
+#include <imgui.h>
+#include <imgui_internal.h>
+#include <plog/Log.h>
+
+#include "core\imgui_ffi.h"
+
+namespace
+{
+    // The FFI side only ever sees an opaque pointer; the distinct name keeps our cdef from
+    // colliding with a script that declares ImGui's own types.
+    using UiForgeImDrawList = ImDrawList;
+
+    // return type, name, parameters. Functions returning an ImVec2 write it to out[0], out[1]
+    // instead: passing structs by value is something the JIT will not compile. End, EndChild
+    // and PopID return nonzero when the call was refused (see FailCall).
+    #define UIFORGE_IMGUI_FFI_FUNCTIONS(X) \
+        X(bool,                 Begin,                  (const char* name, bool* open, int flags)) \
+        X(int,                  End,                    (void)) \
+        X(bool,                 BeginChild,             (const char* id, float width, float height, int child_flags, int window_flags)) \
+        X(int,                  EndChild,               (void)) \
+        X(void,                 SetNextWindowPos,       (float x, float y, int cond, float pivot_x, float pivot_y)) \
+        X(void,                 SetNextWindowSize,      (float width, float height, int cond)) \
+        X(void,                 GetWindowPos,           (float* out)) \
+        X(void,                 GetWindowSize,          (float* out)) \
+        X(void,                 GetContentRegionAvail,  (float* out)) \
+        X(void,                 Text,                   (const char* text)) \
+        X(void,                 TextColored,            (float r, float g, float b, float a, const char* text)) \
+        X(void,                 TextDisabled,           (const char* text)) \
+        X(void,                 CalcTextSize,           (const char* text, bool hide_text_after_double_hash, float wrap_width, float* out)) \
+        X(bool,                 Button,                 (const char* label, float width, float height)) \
+        X(bool,                 SmallButton,            (const char* label)) \
+        X(bool,                 InvisibleButton,        (const char* id, float width, float height, int flags)) \
+        X(bool,                 Checkbox,               (const char* label, bool* value)) \
+        X(void,                 SameLine,               (float offset_from_start_x, float spacing)) \
+        X(void,                 NewLine,                (void)) \
+        X(void,                 Spacing,                (void)) \
+        X(void,                 Separator,              (void)) \
+        X(void,                 Dummy,                  (float width, float height)) \
+        X(void,                 Indent,                 (float indent_w)) \
+        X(void,                 Unindent,               (float indent_w)) \
+        X(void,                 GetCursorScreenPos,     (float* out)) \
+        X(void,                 SetCursorScreenPos,     (float x, float y)) \
+        X(void,                 GetCursorPos,           (float* out)) \
+        X(void,                 SetCursorPos,           (float x, float y)) \
+        X(void,                 PushID,                 (const char* id)) \
+        X(void,                 PushIDInt,              (int id)) \
+        X(int,                  PopID,                  (void)) \
+        X(bool,                 IsItemHovered,          (int flags)) \
+        X(bool,                 IsItemClicked,          (int mouse_button)) \
+        X(unsigned int,         GetColorU32,            (float r, float g, float b, float a)) \
+        X(UiForgeImDrawList*,   GetWindowDrawList,      (void)) \
+        X(UiForgeImDrawList*,   GetForegroundDrawList,  (void)) \
+        X(UiForgeImDrawList*,   GetBackgroundDrawList,  (void)) \
+        X(void,                 DrawList_AddLine,       (UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, unsigned int col, float thickness)) \
+        X(void,                 DrawList_AddRect,       (UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, unsigned int col, float rounding, int flags, float thickness)) \
+        X(void,                 DrawList_AddRectFilled, (UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, unsigned int col, float rounding, int flags)) \
+        X(void,                 DrawList_AddCircle,     (UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments, float thickness)) \
+        X(void,                 DrawList_AddCircleFilled, (UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments)) \
+        X(void,                 DrawList_AddTriangle,   (UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, float x3, float y3, unsigned int col, float thickness)) \
+        X(void,                 DrawList_AddTriangleFilled, (UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, float x3, float y3, unsigned int col)) \
+        X(void,                 DrawList_AddNgon,       (UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments, float thickness)) \
+        X(void,                 DrawList_AddNgonFilled, (UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments)) \
+        X(void,                 DrawList_AddText,       (UiForgeImDrawList* draw_list, float x, float y, unsigned int col, const char* text)) \
+        X(const char*,          TakeError,              (void))
+
+    // A C++ exception must not unwind through LuaJIT's FFI frames, and IM_ASSERT throws one (see
+    // uiforge_imconfig.h). So no shim throws: a failed call stores its error here and returns,
+    // and the Lua wrapper raises it as a Lua error, as the sol2 bindings would have. Only the
+    // render thread runs scripts.
+    int  ffi_error_pending = 0;
+    char ffi_error_message[256] = "";
+
+    void SetError(const char* message)
+    {
+        std::snprintf(ffi_error_message, sizeof(ffi_error_message), "%s", message);
+        ffi_error_pending = 1;
+    }
+
+    int FailCall(const char* message)
+    {
+        SetError(message);
+        return 1;
+    }
+
+    const char* FfiTakeError()
+    {
+        ffi_error_pending = 0;
+        return ffi_error_message;
+    }
+
+    // What the API table actually points at: the shim, with any exception caught and stored.
+    template <auto Fn>
+    struct Guarded;
+
+    template <typename Ret, typename... Args, Ret (*Fn)(Args...)>
+    struct Guarded<Fn>
+    {
+        static Ret Call(Args... args) noexcept
+        {
+            try
+            {
+                return Fn(args...);
+            }
+            catch (const std::exception& err)
+            {
+                SetError(err.what());
+            }
+            catch (...)
+            {
+                SetError("unknown C++ exception in an ImGui call");
+            }
+            return Ret();
+        }
+    };
+
+    // Windows
+    bool FfiBegin(const char* name, bool* open, int flags) { return ImGui::Begin(name, open, flags); }
+    // End, EndChild and PopID check the stacks ImGui would assert on first, so the common script
+    // mistake of an unbalanced call is refused cleanly instead of asserting halfway through.
+    int FfiEnd()
+    {
+        const ImGuiContext& g = *GImGui;
+        if (g.CurrentWindowStack.Size <= 1)     // Only the implicit "Debug" window is left
+        {
+            return FailCall("End() called without a matching Begin()");
+        }
+        if (g.CurrentWindow->Flags & ImGuiWindowFlags_ChildWindow)
+        {
+            return FailCall("End() called on a child window; call EndChild()");
+        }
+        ImGui::End();
+        return 0;
+    }
+    bool FfiBeginChild(const char* id, float width, float height, int child_flags, int window_flags)
+    {
+        return ImGui::BeginChild(id, ImVec2(width, height), child_flags, window_flags);
+    }
+    int FfiEndChild()
+    {
+        const ImGuiContext& g = *GImGui;
+        const ImGuiWindowFlags flags = g.CurrentWindow ? g.CurrentWindow->Flags : 0;
+        if (g.CurrentWindowStack.Size <= 1 || !(flags & ImGuiWindowFlags_ChildWindow) || (flags & ImGuiWindowFlags_Popup))
+        {
+            return FailCall("EndChild() called without a matching BeginChild()");
+        }
+        ImGui::EndChild();
+        return 0;
+    }
+    void FfiSetNextWindowPos(float x, float y, int cond, float pivot_x, float pivot_y)
+    {
+        ImGui::SetNextWindowPos(ImVec2(x, y), cond, ImVec2(pivot_x, pivot_y));
+    }
+    void FfiSetNextWindowSize(float width, float height, int cond) { ImGui::SetNextWindowSize(ImVec2(width, height), cond); }
+
+    void WriteVec2(const ImVec2& value, float* out)
+    {
+        out[0] = value.x;
+        out[1] = value.y;
+    }
+    void FfiGetWindowPos(float* out) { WriteVec2(ImGui::GetWindowPos(), out); }
+    void FfiGetWindowSize(float* out) { WriteVec2(ImGui::GetWindowSize(), out); }
+    void FfiGetContentRegionAvail(float* out) { WriteVec2(ImGui::GetContentRegionAvail(), out); }
+
+    // Text. Script strings are never format strings.
+    void FfiText(const char* text) { ImGui::TextUnformatted(text); }
+    void FfiTextColored(float r, float g, float b, float a, const char* text) { ImGui::TextColored(ImVec4(r, g, b, a), "%s", text); }
+    void FfiTextDisabled(const char* text) { ImGui::TextDisabled("%s", text); }
+    void FfiCalcTextSize(const char* text, bool hide_text_after_double_hash, float wrap_width, float* out)
+    {
+        WriteVec2(ImGui::CalcTextSize(text, nullptr, hide_text_after_double_hash, wrap_width), out);
+    }
+
+    // Widgets
+    bool FfiButton(const char* label, float width, float height) { return ImGui::Button(label, ImVec2(width, height)); }
+    bool FfiSmallButton(const char* label) { return ImGui::SmallButton(label); }
+    bool FfiInvisibleButton(const char* id, float width, float height, int flags) { return ImGui::InvisibleButton(id, ImVec2(width, height), flags); }
+    bool FfiCheckbox(const char* label, bool* value) { return ImGui::Checkbox(label, value); }
+
+    // Layout
+    void FfiSameLine(float offset_from_start_x, float spacing) { ImGui::SameLine(offset_from_start_x, spacing); }
+    void FfiNewLine() { ImGui::NewLine(); }
+    void FfiSpacing() { ImGui::Spacing(); }
+    void FfiSeparator() { ImGui::Separator(); }
+    void FfiDummy(float width, float height) { ImGui::Dummy(ImVec2(width, height)); }
+    void FfiIndent(float indent_w) { ImGui::Indent(indent_w); }
+    void FfiUnindent(float indent_w) { ImGui::Unindent(indent_w); }
+    void FfiGetCursorScreenPos(float* out) { WriteVec2(ImGui::GetCursorScreenPos(), out); }
+    void FfiSetCursorScreenPos(float x, float y) { ImGui::SetCursorScreenPos(ImVec2(x, y)); }
+    void FfiGetCursorPos(float* out) { WriteVec2(ImGui::GetCursorPos(), out); }
+    void FfiSetCursorPos(float x, float y) { ImGui::SetCursorPos(ImVec2(x, y)); }
+
+    // IDs and queries
+    void FfiPushID(const char* id) { ImGui::PushID(id); }
+    void FfiPushIDInt(int id) { ImGui::PushID(id); }
+    int FfiPopID()
+    {
+        const ImGuiWindow* window = GImGui->CurrentWindow;
+        if (!window || window->IDStack.Size <= 1)   // The window's own ID is always at the bottom
+        {
+            return FailCall("PopID() called without a matching PushID()");
+        }
+        ImGui::PopID();
+        return 0;
+    }
+    bool FfiIsItemHovered(int flags) { return ImGui::IsItemHovered(flags); }
+    bool FfiIsItemClicked(int mouse_button) { return ImGui::IsItemClicked(mouse_button); }
+    unsigned int FfiGetColorU32(float r, float g, float b, float a) { return ImGui::GetColorU32(ImVec4(r, g, b, a)); }
+
+    // Draw lists
+    UiForgeImDrawList* FfiGetWindowDrawList() { return ImGui::GetWindowDrawList(); }
+    UiForgeImDrawList* FfiGetForegroundDrawList() { return ImGui::GetForegroundDrawList(); }
+    UiForgeImDrawList* FfiGetBackgroundDrawList() { return ImGui::GetBackgroundDrawList(); }
+    void FfiDrawList_AddLine(UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, unsigned int col, float thickness)
+    {
+        draw_list->AddLine(ImVec2(x1, y1), ImVec2(x2, y2), col, thickness);
+    }
+    void FfiDrawList_AddRect(UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, unsigned int col, float rounding, int flags, float thickness)
+    {
+        draw_list->AddRect(ImVec2(x1, y1), ImVec2(x2, y2), col, rounding, flags, thickness);
+    }
+    void FfiDrawList_AddRectFilled(UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, unsigned int col, float rounding, int flags)
+    {
+        draw_list->AddRectFilled(ImVec2(x1, y1), ImVec2(x2, y2), col, rounding, flags);
+    }
+    void FfiDrawList_AddCircle(UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments, float thickness)
+    {
+        draw_list->AddCircle(ImVec2(x, y), radius, col, segments, thickness);
+    }
+    void FfiDrawList_AddCircleFilled(UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments)
+    {
+        draw_list->AddCircleFilled(ImVec2(x, y), radius, col, segments);
+    }
+    void FfiDrawList_AddTriangle(UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, float x3, float y3, unsigned int col, float thickness)
+    {
+        draw_list->AddTriangle(ImVec2(x1, y1), ImVec2(x2, y2), ImVec2(x3, y3), col, thickness);
+    }
+    void FfiDrawList_AddTriangleFilled(UiForgeImDrawList* draw_list, float x1, float y1, float x2, float y2, float x3, float y3, unsigned int col)
+    {
+        draw_list->AddTriangleFilled(ImVec2(x1, y1), ImVec2(x2, y2), ImVec2(x3, y3), col);
+    }
+    void FfiDrawList_AddNgon(UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments, float thickness)
+    {
+        draw_list->AddNgon(ImVec2(x, y), radius, col, segments, thickness);
+    }
+    void FfiDrawList_AddNgonFilled(UiForgeImDrawList* draw_list, float x, float y, float radius, unsigned int col, int segments)
+    {
+        draw_list->AddNgonFilled(ImVec2(x, y), radius, col, segments);
+    }
+    void FfiDrawList_AddText(UiForgeImDrawList* draw_list, float x, float y, unsigned int col, const char* text)
+    {
+        draw_list->AddText(ImVec2(x, y), col, text);
+    }
+
+    // The table handed to Lua, and the C declaration of the same table for ffi.cdef.
+    struct UiForgeImGuiApi
+    {
+        #define UIFORGE_FFI_FIELD(ret, name, params) ret (*name) params;
+        UIFORGE_IMGUI_FFI_FUNCTIONS(UIFORGE_FFI_FIELD)
+        #undef UIFORGE_FFI_FIELD
+        const int* error_pending;
+    };
+
+    const UiForgeImGuiApi IMGUI_FFI_API =
+    {
+        #define UIFORGE_FFI_POINTER(ret, name, params) &Guarded<&Ffi##name>::Call,
+        UIFORGE_IMGUI_FFI_FUNCTIONS(UIFORGE_FFI_POINTER)
+        #undef UIFORGE_FFI_POINTER
+        &ffi_error_pending,
+    };
+
+    const char IMGUI_FFI_CDEF[] =
+        "typedef struct UiForgeImDrawList UiForgeImDrawList;\n"
+        "typedef struct UiForgeImVec2 { float x, y; } UiForgeImVec2;\n"
+        "typedef struct UiForgeImGuiApi {\n"
+        #define UIFORGE_FFI_DECLARATION(ret, name, params) #ret " (*" #name ")" #params ";\n"
+        UIFORGE_IMGUI_FFI_FUNCTIONS(UIFORGE_FFI_DECLARATION)
+        #undef UIFORGE_FFI_DECLARATION
+        "const int* error_pending;\n"
+        "} UiForgeImGuiApi;\n";
+
+    // Runs once at install with (cdef, api pointer) and returns the package.preload loader. The
+    // module is built on the first require, so scripts that never ask for it cost nothing. The
+    // wrappers keep the sol2 bindings' argument defaults and return shapes.
+    const char IMGUI_FFI_MODULE_SOURCE[] = R"UIFORGE_FFI(
+local cdef, api_address = ...
+local module
+
+local function Build()
+    local ffi = require("ffi")
+    local sol_imgui = ImGui
+    ffi.cdef(cdef)
+    local api = ffi.cast("const UiForgeImGuiApi*", api_address)
+
+    -- Scratch out-parameters, reused by every call.
+    local out2 = ffi.new("float[2]")
+    local out_bool = ffi.new("bool[1]")
+
+    -- The shims never throw; a call that failed (an ImGui assertion, an unbalanced End or PopID)
+    -- leaves its error pending, and CheckError raises it. Both helpers are called straight from
+    -- a wrapper, so level 3 is the script's call.
+    local error_pending, TakeError = api.error_pending, api.TakeError
+    local function CheckError()
+        if error_pending[0] ~= 0 then
+            error(ffi.string(TakeError()), 3)
+        end
+    end
+
+    -- FFI would pass nil as a NULL const char*, which ImGui dereferences.
+    local function Str(value, position, name)
+        if type(value) == "string" then
+            return value
+        end
+        if type(value) == "number" then
+            return tostring(value)
+        end
+        error(string.format("bad argument #%d to '%s' (string expected, got %s)", position, name, type(value)), 3)
+    end
+
+    -- Anything not bound here falls through to the sol2 bindings.
+    local M = setmetatable({}, { __index = sol_imgui })
+
+    -- ImVec2 with arithmetic. Functions below take anything with x and y fields, so the sol2
+    -- ImVec2 still works; this one stays on the JIT's fast path.
+    local Vec2
+    Vec2 = ffi.metatype("UiForgeImVec2", {
+        __add = function(a, b) return Vec2(a.x + b.x, a.y + b.y) end,
+        __sub = function(a, b) return Vec2(a.x - b.x, a.y - b.y) end,
+        __mul = function(a, b)
+            if type(a) == "number" then return Vec2(a * b.x, a * b.y) end
+            if type(b) == "number" then return Vec2(a.x * b, a.y * b) end
+            return Vec2(a.x * b.x, a.y * b.y)
+        end,
+        __div = function(a, b)
+            if type(b) == "number" then return Vec2(a.x / b, a.y / b) end
+            return Vec2(a.x / b.x, a.y / b.y)
+        end,
+        __unm = function(a) return Vec2(-a.x, -a.y) end,
+        __tostring = function(a) return "ImVec2(" .. a.x .. ", " .. a.y .. ")" end,
+        __index = {
+            Length = function(a) return math.sqrt(a.x * a.x + a.y * a.y) end,
+        },
+    })
+    M.ImVec2 = { new = function(x, y) return Vec2(x or 0, y or 0) end }
+
+    -- Windows
+    local Begin, End = api.Begin, api.End
+    function M.Begin(name, open, flags)
+        name = Str(name, 1, "Begin")
+        if open == nil then
+            local should_draw = Begin(name, nil, flags or 0)
+            CheckError()
+            return should_draw
+        end
+        out_bool[0] = open
+        local should_draw = Begin(name, out_bool, flags or 0)
+        CheckError()
+        return out_bool[0], should_draw
+    end
+    function M.End()
+        End()
+        CheckError()
+    end
+    local BeginChild, EndChild = api.BeginChild, api.EndChild
+    function M.BeginChild(name, width, height, child_flags, window_flags)
+        local visible = BeginChild(Str(name, 1, "BeginChild"), width or 0, height or 0, child_flags or 0, window_flags or 0)
+        CheckError()
+        return visible
+    end
+    function M.EndChild()
+        EndChild()
+        CheckError()
+    end
+    local SetNextWindowPos = api.SetNextWindowPos
+    function M.SetNextWindowPos(x, y, cond, pivot_x, pivot_y)
+        SetNextWindowPos(x, y, cond or 0, pivot_x or 0, pivot_y or 0)
+        CheckError()
+    end
+    local SetNextWindowSize = api.SetNextWindowSize
+    function M.SetNextWindowSize(width, height, cond)
+        SetNextWindowSize(width, height, cond or 0)
+        CheckError()
+    end
+
+    local function Vec2Getter(fn)
+        return function()
+            fn(out2)
+            CheckError()
+            return out2[0], out2[1]
+        end
+    end
+    -- For the shims that take no strings and return nothing.
+    local function Checked(fn)
+        return function(...)
+            fn(...)
+            CheckError()
+        end
+    end
+    M.GetWindowPos = Vec2Getter(api.GetWindowPos)
+    M.GetWindowSize = Vec2Getter(api.GetWindowSize)
+    M.GetContentRegionAvail = Vec2Getter(api.GetContentRegionAvail)
+    M.GetCursorScreenPos = Vec2Getter(api.GetCursorScreenPos)
+    M.GetCursorPos = Vec2Getter(api.GetCursorPos)
+
+    -- Text
+    local Text, TextColored, TextDisabled = api.Text, api.TextColored, api.TextDisabled
+    function M.Text(text)
+        Text(Str(text, 1, "Text"))
+        CheckError()
+    end
+    function M.TextUnformatted(text)
+        Text(Str(text, 1, "TextUnformatted"))
+        CheckError()
+    end
+    function M.TextColored(r, g, b, a, text)
+        TextColored(r, g, b, a, Str(text, 5, "TextColored"))
+        CheckError()
+    end
+    function M.TextDisabled(text)
+        TextDisabled(Str(text, 1, "TextDisabled"))
+        CheckError()
+    end
+    local CalcTextSize = api.CalcTextSize
+    function M.CalcTextSize(text, text_end, hide_text_after_double_hash, wrap_width)
+        if text_end ~= nil then
+            return sol_imgui.CalcTextSize(text, text_end, hide_text_after_double_hash, wrap_width)
+        end
+        CalcTextSize(Str(text, 1, "CalcTextSize"), hide_text_after_double_hash or false, wrap_width or -1, out2)
+        CheckError()
+        return out2[0], out2[1]
+    end
+
+    -- Widgets
+    local Button = api.Button
+    function M.Button(label, width, height)
+        local pressed = Button(Str(label, 1, "Button"), width or 0, height or 0)
+        CheckError()
+        return pressed
+    end
+    local SmallButton = api.SmallButton
+    function M.SmallButton(label)
+        local pressed = SmallButton(Str(label, 1, "SmallButton"))
+        CheckError()
+        return pressed
+    end
+    local InvisibleButton = api.InvisibleButton
+    function M.InvisibleButton(id, width, height, flags)
+        local pressed = InvisibleButton(Str(id, 1, "InvisibleButton"), width, height, flags or 0)
+        CheckError()
+        return pressed
+    end
+    local Checkbox = api.Checkbox
+    function M.Checkbox(label, value)
+        label = Str(label, 1, "Checkbox")
+        out_bool[0] = value
+        local pressed = Checkbox(label, out_bool)
+        CheckError()
+        return out_bool[0], pressed
+    end
+
+    -- Layout
+    local SameLine = api.SameLine
+    function M.SameLine(offset_from_start_x, spacing)
+        SameLine(offset_from_start_x or 0, spacing or -1)
+        CheckError()
+    end
+    M.NewLine = Checked(api.NewLine)
+    M.Spacing = Checked(api.Spacing)
+    M.Separator = Checked(api.Separator)
+    M.Dummy = Checked(api.Dummy)
+    local Indent, Unindent = api.Indent, api.Unindent
+    function M.Indent(indent_w)
+        Indent(indent_w or 0)
+        CheckError()
+    end
+    function M.Unindent(indent_w)
+        Unindent(indent_w or 0)
+        CheckError()
+    end
+    M.SetCursorScreenPos = Checked(api.SetCursorScreenPos)
+    M.SetCursorPos = Checked(api.SetCursorPos)
+
+    -- IDs and queries
+    local PushID, PushIDInt, PopID = api.PushID, api.PushIDInt, api.PopID
+    function M.PushID(id, id_end)
+        if id_end == nil then
+            if type(id) == "string" then
+                PushID(id)
+                CheckError()
+                return
+            end
+            if type(id) == "number" then
+                PushIDInt(id)
+                CheckError()
+                return
+            end
+        end
+        return sol_imgui.PushID(id, id_end)
+    end
+    function M.PopID()
+        PopID()
+        CheckError()
+    end
+    local IsItemHovered, IsItemClicked = api.IsItemHovered, api.IsItemClicked
+    function M.IsItemHovered(flags)
+        local hovered = IsItemHovered(flags or 0)
+        CheckError()
+        return hovered
+    end
+    function M.IsItemClicked(mouse_button)
+        local clicked = IsItemClicked(mouse_button or 0)
+        CheckError()
+        return clicked
+    end
+    local GetColorU32 = api.GetColorU32
+    function M.GetColorU32(r, g, b, a)
+        if g == nil then
+            return sol_imgui.GetColorU32(r)
+        end
+        if b == nil then
+            return sol_imgui.GetColorU32(r, g)
+        end
+        local color = GetColorU32(r, g, b, a or 1)
+        CheckError()
+        return color
+    end
+
+    -- Draw lists: the same methods as the sol2 ImDrawList, points given as ImVec2s.
+    local AddLine, AddRect, AddRectFilled = api.DrawList_AddLine, api.DrawList_AddRect, api.DrawList_AddRectFilled
+    local AddCircle, AddCircleFilled = api.DrawList_AddCircle, api.DrawList_AddCircleFilled
+    local AddTriangle, AddTriangleFilled = api.DrawList_AddTriangle, api.DrawList_AddTriangleFilled
+    local AddNgon, AddNgonFilled, AddText = api.DrawList_AddNgon, api.DrawList_AddNgonFilled, api.DrawList_AddText
+    ffi.metatype("UiForgeImDrawList", {
+        __index = {
+            AddLine = function(self, p1, p2, col, thickness)
+                AddLine(self, p1.x, p1.y, p2.x, p2.y, col, thickness or 1)
+                CheckError()
+            end,
+            AddRect = function(self, p_min, p_max, col, rounding, flags, thickness)
+                AddRect(self, p_min.x, p_min.y, p_max.x, p_max.y, col, rounding or 0, flags or 0, thickness or 1)
+                CheckError()
+            end,
+            AddRectFilled = function(self, p_min, p_max, col, rounding, flags)
+                AddRectFilled(self, p_min.x, p_min.y, p_max.x, p_max.y, col, rounding or 0, flags or 0)
+                CheckError()
+            end,
+            AddCircle = function(self, center, radius, col, segments, thickness)
+                AddCircle(self, center.x, center.y, radius, col, segments or 0, thickness or 1)
+                CheckError()
+            end,
+            AddCircleFilled = function(self, center, radius, col, segments)
+                AddCircleFilled(self, center.x, center.y, radius, col, segments or 0)
+                CheckError()
+            end,
+            AddTriangle = function(self, p1, p2, p3, col, thickness)
+                AddTriangle(self, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, col, thickness or 1)
+                CheckError()
+            end,
+            AddTriangleFilled = function(self, p1, p2, p3, col)
+                AddTriangleFilled(self, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, col)
+                CheckError()
+            end,
+            AddNgon = function(self, center, radius, col, segments, thickness)
+                AddNgon(self, center.x, center.y, radius, col, segments, thickness or 1)
+                CheckError()
+            end,
+            AddNgonFilled = function(self, center, radius, col, segments)
+                AddNgonFilled(self, center.x, center.y, radius, col, segments)
+                CheckError()
+            end,
+            AddText = function(self, pos, col, text)
+                AddText(self, pos.x, pos.y, col, Str(text, 3, "AddText"))
+                CheckError()
+            end,
+        },
+    })
+    local function DrawListGetter(fn)
+        return function()
+            local draw_list = fn()
+            CheckError()
+            return draw_list
+        end
+    end
+    M.GetWindowDrawList = DrawListGetter(api.GetWindowDrawList)
+    M.GetForegroundDrawList = DrawListGetter(api.GetForegroundDrawList)
+    M.GetBackgroundDrawList = DrawListGetter(api.GetBackgroundDrawList)
+
+    return M
+end
+
+return function()
+    module = module or Build()
+    return module
+end
+)UIFORGE_FFI";
+}
+
+bool ImGuiFfi::Install(lua_State* L)
+{
+    if (luaL_loadbuffer(L, IMGUI_FFI_MODULE_SOURCE, sizeof(IMGUI_FFI_MODULE_SOURCE) - 1, "=imgui_ffi") != LUA_OK)
+    {
+        PLOG_ERROR << "Failed to load the ImGui FFI bindings: " << lua_tostring(L, -1);
+        lua_pop(L, 1);
+        return false;
+    }
+
+    lua_pushstring(L, IMGUI_FFI_CDEF);                              // [chunk, cdef]
+    lua_pushlightuserdata(L, (void*)&IMGUI_FFI_API);                // [chunk, cdef, api]
+    if (lua_pcall(L, 2, 1, 0) != LUA_OK)                            // [loader]
+    {
+        PLOG_ERROR << "Failed to load the ImGui FFI bindings: " << lua_tostring(L, -1);
+        lua_pop(L, 1);
+        return false;
+    }
+
+    lua_getglobal(L, "package");                                    // [loader, package]
+    lua_getfield(L, -1, "preload");                                 // [loader, package, preload]
+    lua_pushvalue(L, -3);                                           // [loader, package, preload, loader]
+    lua_setfield(L, -2, MODULE_NAME);                               // preload[MODULE_NAME] = loader
+    lua_pop(L, 3);
+
+    PLOG_DEBUG << "ImGui FFI bindings registered as \"" << MODULE_NAME << "\"";
+    return true;
+}
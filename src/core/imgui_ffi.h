@@ -0,0 +1,40 @@
+/**
+ * @file imgui_ffi.h
+ * @brief LuaJIT FFI bindings for the ImGui calls forgescripts make most, as an opt-in fast path.
+ *
+ * The sol2 bindings (sol_ImGui::Init) marshal every argument through the Lua stack, build a
+ * std::string for every label and pack multiple returns into tuples, and the JIT cannot compile
+ * across any of it. A script that instead does
+ *
+ *     local ImGui = require("imgui_ffi")
+ *
+ * gets a table whose hottest functions (text, buttons, windows, layout, draw list primitives and
+ * an FFI ImVec2 with arithmetic) call plain C functions through LuaJIT's FFI, which the JIT turns
+ * into direct calls. Everything not covered falls through to the sol2 bindings, so the table is a
+ * drop-in replacement for the global ImGui. The choice is per script: the global is untouched.
+ *
+ * The C functions are declared once, in imgui_ffi.cpp, and that single list produces the C++
+ * function table, its initializer and the ffi.cdef text, so the two sides cannot drift apart.
+ *
+ * No C function throws, because a C++ exception cannot unwind through the FFI call. Failures
+ * (a failed IM_ASSERT, an unbalanced End or PopID) are stored instead, and the Lua wrappers
+ * check the arguments they pass and raise any stored failure as a Lua error.
+ */
+#pragma once
+
+#include <lua.hpp>
+
+class ImGuiFfi
+{
+    public:
+        /** @brief Name scripts pass to require() to get the FFI bindings. */
+        static constexpr const char* MODULE_NAME = "imgui_ffi";
+
+        /**
+         * @brief Registers the module in package.preload. The module is built on the first
+         * require, which is when it looks up the global ImGui table it falls through to.
+         *
+         * @return False (logged) when the module source failed to load.
+         */
+        static bool Install(lua_State* lua_state);
+};
@@ -0,0 +1,35 @@
+#include "core\lua_helpers.h"
+
+void* LuaHelpers::TestUserdata(lua_State* L, int index, const char* metatable_name)
+{
+    void* data = lua_touserdata(L, index);
+    if (!data || !lua_getmetatable(L, index))
+    {
+        return nullptr;
+    }
+    lua_getfield(L, LUA_REGISTRYINDEX, metatable_name);
+    const bool matches = lua_rawequal(L, -1, -2) != 0;
+    lua_pop(L, 2);
+    return matches ? data : nullptr;
+}
+
+bool LuaHelpers::WrapFunction(lua_State* L, const char* name, lua_CFunction overload)
+{
+    lua_getfield(L, -1, name);
+    if (lua_isnil(L, -1))
+    {
+        lua_pop(L, 1);
+        return false;
+    }
+    lua_pushcclosure(L, overload, 1);
+    lua_setfield(L, -2, name);
+    return true;
+}
+
+int LuaHelpers::CallOriginal(lua_State* L)
+{
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_insert(L, 1);
+    lua_call(L, lua_gettop(L) - 1, LUA_MULTRET);
+    return lua_gettop(L);
+}
@@ -0,0 +1,34 @@
+/**
+ * @file lua_helpers.h
+ * @brief Small Lua C API helpers shared by the native types scripts hold as userdata.
+ *
+ * The native list and buffer types (StringList, TextBuffer) are plain userdata with a metatable
+ * in the registry, and they plug into the sol2 ImGui bindings by wrapping individual functions:
+ * the wrapper handles its own argument types and passes every other call on unchanged.
+ */
+#pragma once
+
+#include <lua.hpp>
+
+namespace LuaHelpers
+{
+    /**
+     * @brief Returns the userdata at a stack index when its metatable is the one registered
+     * under metatable_name, otherwise nullptr. Never raises (unlike luaL_checkudata).
+     */
+    void* TestUserdata(lua_State* L, int index, const char* metatable_name);
+
+    /**
+     * @brief Replaces the function field name of the table on top of the stack with overload,
+     * which receives the original function as upvalue 1 (see CallOriginal).
+     *
+     * @return False when the table has no such field; nothing is changed then.
+     */
+    bool WrapFunction(lua_State* L, const char* name, lua_CFunction overload);
+
+    /**
+     * @brief For use inside a WrapFunction overload: calls the original function with the
+     * overload's arguments and returns its results.
+     */
+    int CallOriginal(lua_State* L);
+}
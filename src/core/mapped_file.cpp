@@ -0,0 +1,88 @@
+#include <Windows.h>
+#include <utility>
+
+#include "core\mapped_file.h"
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        file_handle     = std::exchange(other.file_handle, nullptr);
+        mapping_handle  = std::exchange(other.mapping_handle, nullptr);
+        view            = std::exchange(other.view, nullptr);
+        size            = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& file_path)
+{
+    Close();
+
+    // FILE_SHARE_DELETE lets a cache evict (delete) the file while it is still mapped here.
+    HANDLE file = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 || (unsigned long long)file_size.QuadPart > SIZE_MAX)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* mapped_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!mapped_view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle     = file;
+    mapping_handle  = mapping;
+    view            = mapped_view;
+    size            = (size_t)file_size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (view)
+    {
+        UnmapViewOfFile(view);
+        view = nullptr;
+    }
+    if (mapping_handle)
+    {
+        CloseHandle((HANDLE)mapping_handle);
+        mapping_handle = nullptr;
+    }
+    if (file_handle)
+    {
+        CloseHandle((HANDLE)file_handle);
+        file_handle = nullptr;
+    }
+    size = 0;
+}
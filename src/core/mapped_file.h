@@ -0,0 +1,47 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Mapping a file lets a loader hand its bytes straight to a consumer (for example a GPU upload)
+ * without copying them into a heap buffer first; pages are faulted in by the OS as they are read.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+class MappedFile
+{
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /**
+         * @brief Maps a file for reading, closing any file mapped before.
+         *
+         * @param file_path The file to map.
+         * @return True on success. Empty files cannot be mapped and fail.
+         */
+        bool Open(const std::filesystem::path& file_path);
+
+        /**
+         * @brief Unmaps the file. Pointers returned by Data() become invalid.
+         */
+        void Close();
+
+        bool IsOpen() const { return view != nullptr; }
+        const uint8_t* Data() const { return (const uint8_t*)view; }
+        size_t Size() const { return size; }
+
+    private:
+        void* file_handle       = nullptr;
+        void* mapping_handle    = nullptr;
+        const void* view        = nullptr;
+        size_t size             = 0;
+};
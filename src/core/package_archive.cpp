@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cwctype>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+
+#include <Windows.h>
+#include <compressapi.h>
+
+#include <plog/Log.h>
+
+#include "core\package_archive.h"
+#include "core\util.h"
+
+namespace
+{
+    std::mutex archive_mutex;
+    std::vector<std::unique_ptr<PackageArchive>> mounted_archives;
+
+    // Lowercased, normalized form of a path, for case-insensitive prefix matching.
+    std::wstring ComparablePath(const std::filesystem::path& file_path)
+    {
+        std::wstring comparable = file_path.lexically_normal().wstring();
+        std::transform(comparable.begin(), comparable.end(), comparable.begin(), [](wchar_t c) { return (wchar_t)towlower(c); });
+        while (!comparable.empty() && (comparable.back() == L'\\' || comparable.back() == L'/'))
+        {
+            comparable.pop_back();
+        }
+        return comparable;
+    }
+
+    bool DecompressEntry(const char* data, size_t stored_size, size_t size, std::vector<char>& out_buffer)
+    {
+        DECOMPRESSOR_HANDLE decompressor = nullptr;
+        if (!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &decompressor))
+        {
+            return false;
+        }
+
+        out_buffer.resize(size);
+        SIZE_T decompressed_size = 0;
+        const bool decompressed = Decompress(decompressor, data, stored_size, out_buffer.data(), size, &decompressed_size)
+            && decompressed_size == size;
+        CloseDecompressor(decompressor);
+        return decompressed;
+    }
+}
+
+bool PackageArchive::Open(const std::filesystem::path& file_path)
+{
+    path = file_path;
+    header = nullptr;
+    entries = nullptr;
+    names = nullptr;
+
+    if (!file.Open(file_path))
+    {
+        PLOG_ERROR << "Failed to map package archive: " << file_path.string();
+        return false;
+    }
+
+    const uint8_t* base = file.Data();
+    const size_t file_size = file.Size();
+    if (file_size < sizeof(Ufpak::Header))
+    {
+        PLOG_ERROR << "Package archive is truncated: " << file_path.string();
+        file.Close();
+        return false;
+    }
+
+    const Ufpak::Header* archive_header = (const Ufpak::Header*)base;
+    if (std::memcmp(archive_header->magic, Ufpak::MAGIC, sizeof(Ufpak::MAGIC)) != 0 || archive_header->version != Ufpak::VERSION)
+    {
+        PLOG_ERROR << "Not a version " << Ufpak::VERSION << " package archive: " << file_path.string();
+        file.Close();
+        return false;
+    }
+
+    const uint64_t index_size = (uint64_t)archive_header->entry_count * sizeof(Ufpak::Entry);
+    if (archive_header->index_offset > file_size || index_size > file_size - archive_header->index_offset
+        || archive_header->names_offset > file_size || archive_header->names_size > file_size - archive_header->names_offset)
+    {
+        PLOG_ERROR << "Package archive index is out of bounds: " << file_path.string();
+        file.Close();
+        return false;
+    }
+
+    // Check every entry once here, so Read and GetName can trust the offsets.
+    const Ufpak::Entry* archive_entries = (const Ufpak::Entry*)(base + archive_header->index_offset);
+    for (uint32_t i = 0; i < archive_header->entry_count; ++i)
+    {
+        const Ufpak::Entry& entry = archive_entries[i];
+        const bool compressed = (entry.flags & Ufpak::ENTRY_COMPRESSED) != 0;
+        if (entry.data_offset > file_size || entry.stored_size > file_size - entry.data_offset
+            || (uint64_t)entry.name_offset + entry.name_length > archive_header->names_size
+            || (!compressed && entry.size != entry.stored_size) || entry.size > SIZE_MAX)
+        {
+            PLOG_ERROR << "Package archive entry " << i << " is out of bounds: " << file_path.string();
+            file.Close();
+            return false;
+        }
+    }
+
+    header = archive_header;
+    entries = archive_entries;
+    names = (const char*)(base + archive_header->names_offset);
+    index_hash = CoreUtils::HashBytes(base + archive_header->index_offset, (size_t)index_size);
+    return true;
+}
+
+size_t PackageArchive::LowerBound(const std::string& key) const
+{
+    size_t low = 0;
+    size_t high = GetEntryCount();
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        const std::string_view name(names + entries[middle].name_offset, entries[middle].name_length);
+        if (name.compare(key) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+const Ufpak::Entry* PackageArchive::Find(const std::string& key) const
+{
+    const size_t index = LowerBound(key);
+    if (index >= GetEntryCount())
+    {
+        return nullptr;
+    }
+
+    const Ufpak::Entry& entry = entries[index];
+    return (std::string_view(names + entry.name_offset, entry.name_length) == key) ? &entry : nullptr;
+}
+
+bool PackageArchive::Read(const Ufpak::Entry& entry, ArchiveFile& out_file) const
+{
+    const char* data = (const char*)file.Data() + entry.data_offset;
+    out_file.bytecode = (entry.flags & Ufpak::ENTRY_BYTECODE) != 0;
+
+    if (!(entry.flags & Ufpak::ENTRY_COMPRESSED))
+    {
+        out_file.data = data;
+        out_file.size = (size_t)entry.size;
+        out_file.decompressed.reset();
+        return true;
+    }
+
+    auto buffer = std::make_shared<std::vector<char>>();
+    if (!DecompressEntry(data, (size_t)entry.stored_size, (size_t)entry.size, *buffer))
+    {
+        PLOG_ERROR << "Failed to decompress " << GetName(entry) << " from " << path.string();
+        return false;
+    }
+
+    out_file.data = buffer->data();
+    out_file.size = buffer->size();
+    out_file.decompressed = std::move(buffer);
+    return true;
+}
+
+std::string PackageArchive::GetName(const Ufpak::Entry& entry) const
+{
+    return std::string(names + entry.name_offset, entry.name_length);
+}
+
+bool PackageArchive::HasDirectory(const std::string& directory_key) const
+{
+    if (directory_key.empty())
+    {
+        return GetEntryCount() > 0;
+    }
+
+    // Names are sorted, so every entry under the directory sits right after where its prefix would.
+    const std::string prefix = directory_key + '\\';
+    const size_t index = LowerBound(prefix);
+    return index < GetEntryCount()
+        && std::string_view(names + entries[index].name_offset, entries[index].name_length).compare(0, prefix.size(), prefix) == 0;
+}
+
+std::vector<std::string> PackageArchive::ListDirectory(const std::string& directory_key) const
+{
+    const std::string prefix = directory_key.empty() ? std::string() : directory_key + '\\';
+    std::vector<std::string> listed;
+    for (size_t index = LowerBound(prefix); index < GetEntryCount(); ++index)
+    {
+        const std::string_view name(names + entries[index].name_offset, entries[index].name_length);
+        if (name.compare(0, prefix.size(), prefix) != 0)
+        {
+            break;
+        }
+        listed.emplace_back(name.substr(prefix.size()));
+    }
+    return listed;
+}
+
+const PackageArchive* PackageArchive::Mount(const std::filesystem::path& file_path)
+{
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    const std::wstring comparable = ComparablePath(file_path);
+    for (const auto& archive : mounted_archives)
+    {
+        if (ComparablePath(archive->path) == comparable)
+        {
+            return archive.get();
+        }
+    }
+
+    auto archive = std::make_unique<PackageArchive>();
+    if (!archive->Open(file_path))
+    {
+        return nullptr;
+    }
+
+    PLOG_INFO << "Mounted package archive " << file_path.string() << " (" << archive->GetEntryCount() << " entries)";
+    mounted_archives.push_back(std::move(archive));
+    return mounted_archives.back().get();
+}
+
+const PackageArchive* PackageArchive::Locate(const std::filesystem::path& file_path, std::string& out_key)
+{
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    if (mounted_archives.empty())
+    {
+        return nullptr;
+    }
+
+    const std::wstring comparable = ComparablePath(file_path);
+    for (const auto& archive : mounted_archives)
+    {
+        const std::wstring archive_path = ComparablePath(archive->path);
+        if (comparable.compare(0, archive_path.size(), archive_path) != 0)
+        {
+            continue;
+        }
+        if (comparable.size() == archive_path.size())
+        {
+            out_key.clear();
+            return archive.get();
+        }
+
+        const wchar_t separator = comparable[archive_path.size()];
+        if (separator == L'\\' || separator == L'/')
+        {
+            const std::filesystem::path inner(comparable.substr(archive_path.size() + 1));
+            return Ufpak::NormalizeKey(inner.string(), out_key) ? archive.get() : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+bool PackageArchive::ReadFile(const std::filesystem::path& file_path, ArchiveFile& out_file)
+{
+    std::string key;
+    const PackageArchive* archive = Locate(file_path, key);
+    const Ufpak::Entry* entry = archive ? archive->Find(key) : nullptr;
+    return entry && archive->Read(*entry, out_file);
+}
+
+bool PackageArchive::ContainsFile(const std::filesystem::path& file_path)
+{
+    std::string key;
+    const PackageArchive* archive = Locate(file_path, key);
+    return archive && archive->Find(key) != nullptr;
+}
+
+bool PackageArchive::IsDirectory(const std::filesystem::path& directory_path)
+{
+    std::string key;
+    const PackageArchive* archive = Locate(directory_path, key);
+    return archive && archive->HasDirectory(key);
+}
+
+std::vector<std::filesystem::path> PackageArchive::GetMountedPaths()
+{
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    std::vector<std::filesystem::path> paths;
+    for (const auto& archive : mounted_archives)
+    {
+        paths.push_back(archive->path);
+    }
+    return paths;
+}
+
+std::filesystem::path PackageArchive::ExtractToCache(const std::filesystem::path& file_path)
+{
+    std::string key;
+    const PackageArchive* archive = Locate(file_path, key);
+    if (!archive)
+    {
+        return file_path;
+    }
+
+    const Ufpak::Entry* entry = archive->Find(key);
+    if (!entry)
+    {
+        PLOG_ERROR << "File not found in package archive: " << file_path.string();
+        return {};
+    }
+
+    // One folder per archive build, so a rebuilt archive never serves stale extracted files.
+    char build_id[17];
+    snprintf(build_id, sizeof(build_id), "%016llx", (unsigned long long)archive->index_hash);
+
+    std::error_code ec;
+    const std::filesystem::path cached_path = std::filesystem::temp_directory_path(ec) / "UiForge" / "ufpak" / build_id / key;
+    if (ec)
+    {
+        PLOG_ERROR << "No temp directory to extract " << file_path.string() << " into: " << ec.message();
+        return {};
+    }
+    if (std::filesystem::is_regular_file(cached_path, ec) && std::filesystem::file_size(cached_path, ec) == entry->size)
+    {
+        return cached_path;
+    }
+
+    ArchiveFile contents;
+    if (!archive->Read(*entry, contents))
+    {
+        return {};
+    }
+
+    std::filesystem::create_directories(cached_path.parent_path(), ec);
+    std::ofstream out(cached_path, std::ios::binary | std::ios::trunc);
+    if (!out.write(contents.data, (std::streamsize)contents.size))
+    {
+        PLOG_ERROR << "Failed to extract " << file_path.string() << " to " << cached_path.string();
+        return {};
+    }
+
+    PLOG_DEBUG << "Extracted " << file_path.string() << " to " << cached_path.string();
+    return cached_path;
+}
+
+void PackageArchive::UnmountAll()
+{
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    mounted_archives.clear();
+}
@@ -0,0 +1,143 @@
+/**
+ * @file package_archive.h
+ * @brief Read-only access to .ufpak script package archives (see ufpak_format.h).
+ *
+ * An archive is memory-mapped once when it is mounted and its index is used in place, so
+ * mounting allocates nothing per entry. Reading an uncompressed entry returns a pointer into the
+ * mapping; only compressed entries are decompressed into a buffer.
+ *
+ * Mounted archives appear at their own path: "<scripts>\tools.ufpak\tools\tools.lua" names the
+ * entry "tools\tools.lua" of the archive "<scripts>\tools.ufpak". Code that takes file paths asks
+ * here first (ReadFile, IsDirectory) and falls back to the disk when the path is not inside a
+ * mounted archive. Consumers that can only open real files (MCI, WIC file decoders) go through
+ * ExtractToCache.
+ *
+ * Archives stay mounted until UnmountAll, so pointers into them remain valid for the life of the
+ * core.
+ */
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core\mapped_file.h"
+#include "core\ufpak_format.h"
+
+/**
+ * @brief The contents of one archive entry.
+ */
+struct ArchiveFile
+{
+    const char* data        = nullptr;
+    size_t      size        = 0;
+    bool        bytecode    = false;                        // LuaJIT bytecode rather than Lua source
+    std::shared_ptr<const std::vector<char>> decompressed;  // Owns data for compressed entries
+};
+
+class PackageArchive
+{
+    public:
+        /**
+         * @brief Maps an archive and validates its header and index.
+         *
+         * @return False (logged) when the file cannot be mapped or is not a valid archive.
+         */
+        bool Open(const std::filesystem::path& file_path);
+
+        const std::filesystem::path& GetPath() const { return path; }
+        size_t GetEntryCount() const { return header ? header->entry_count : 0; }
+
+        /**
+         * @brief Finds an entry by its normalized name (see Ufpak::NormalizeKey).
+         */
+        const Ufpak::Entry* Find(const std::string& key) const;
+
+        /**
+         * @brief Returns an entry's contents, decompressing it when needed.
+         *
+         * @return False (logged) when decompression fails.
+         */
+        bool Read(const Ufpak::Entry& entry, ArchiveFile& out_file) const;
+
+        /**
+         * @brief Returns an entry's normalized name.
+         */
+        std::string GetName(const Ufpak::Entry& entry) const;
+
+        /**
+         * @brief Reports whether any entry lives under a directory name ("" for the root).
+         */
+        bool HasDirectory(const std::string& directory_key) const;
+
+        /**
+         * @brief Lists the entries under a directory name, recursively, with their names relative
+         * to it. Entries are listed in name order.
+         */
+        std::vector<std::string> ListDirectory(const std::string& directory_key) const;
+
+        /**
+         * @brief Maps an archive and makes its entries visible at its path. Mounting an archive
+         * that is already mounted returns the existing one.
+         *
+         * @return The mounted archive, or nullptr when it could not be opened (logged).
+         */
+        static const PackageArchive* Mount(const std::filesystem::path& file_path);
+
+        /**
+         * @brief Returns the mounted archive a path lies inside, and the path's name within it.
+         *
+         * @param out_key Receives the normalized name; "" for the archive root.
+         * @return The archive, or nullptr when the path is not inside a mounted archive.
+         */
+        static const PackageArchive* Locate(const std::filesystem::path& file_path, std::string& out_key);
+
+        /**
+         * @brief Reads a file that lies inside a mounted archive.
+         *
+         * @return False when the path is not an entry of a mounted archive.
+         */
+        static bool ReadFile(const std::filesystem::path& file_path, ArchiveFile& out_file);
+
+        /**
+         * @brief Reports whether a path is an entry of a mounted archive.
+         */
+        static bool ContainsFile(const std::filesystem::path& file_path);
+
+        /**
+         * @brief Reports whether a path is a directory inside a mounted archive (or the archive itself).
+         */
+        static bool IsDirectory(const std::filesystem::path& directory_path);
+
+        /**
+         * @brief Returns the paths of every mounted archive, in mount order.
+         */
+        static std::vector<std::filesystem::path> GetMountedPaths();
+
+        /**
+         * @brief Returns a real file with the contents of an archived path, writing it to the temp
+         * directory the first time. Paths outside mounted archives are returned unchanged.
+         *
+         * For consumers that can only open files by name. Returns an empty path on failure (logged).
+         */
+        static std::filesystem::path ExtractToCache(const std::filesystem::path& file_path);
+
+        /**
+         * @brief Unmaps every archive. Pointers returned by Read and ReadFile become invalid.
+         * Called during core cleanup, after everything that may reference archive data is gone.
+         */
+        static void UnmountAll();
+
+    private:
+        // Index of the first entry whose name is not less than key.
+        size_t LowerBound(const std::string& key) const;
+
+        std::filesystem::path path;
+        MappedFile file;
+        const Ufpak::Header* header  = nullptr;
+        const Ufpak::Entry*  entries = nullptr;
+        const char*          names   = nullptr;
+        uint64_t             index_hash = 0;   // Identifies this build of the archive for ExtractToCache
+};
@@ -0,0 +1,187 @@
+#include <string>
+#include <string_view>
+
+#include <plog/Log.h>
+#include <sol/sol.hpp>
+
+#include "core\package_archive.h"
+#include "core\package_manifest.h"
+#include "core\resource_vfs.h"
+
+namespace
+{
+    // Basic Latin and Latin-1 Supplement, the same set as ImFontAtlas::GetGlyphRangesDefault.
+    const ImWchar DEFAULT_GLYPH_RANGES[] = { 0x0020, 0x00FF, 0 };
+
+    bool ReadFont(const sol::table& entry, const std::string& package_resources_dir, ManifestFont& out_font)
+    {
+        sol::optional<std::string> path = entry["path"];
+        if (!path || path->empty())
+        {
+            return false;
+        }
+        out_font.path = ResourceVfs::Resolve(*path, package_resources_dir);
+
+        sol::optional<sol::table> sizes = entry["sizes"];
+        if (sizes)
+        {
+            for (size_t i = 1; i <= sizes->size(); ++i)
+            {
+                sol::optional<float> size = (*sizes)[i];
+                if (size && *size > 0.0f)
+                {
+                    out_font.sizes.push_back(*size);
+                }
+            }
+        }
+        if (out_font.sizes.empty())
+        {
+            out_font.sizes.push_back(entry.get_or("size", 0.0f));
+        }
+
+        sol::optional<sol::table> glyphs = entry["glyphs"];
+        if (glyphs)
+        {
+            for (size_t i = 1; i + 1 <= glyphs->size(); i += 2)
+            {
+                const unsigned int first = (*glyphs)[i].get_or(0u);
+                const unsigned int last  = (*glyphs)[i + 1].get_or(0u);
+                if (first == 0 || last < first || last > 0xFFFF)
+                {
+                    PLOG_WARNING << "Ignoring glyph range " << first << "-" << last << " for \"" << *path << "\"";
+                    continue;
+                }
+                out_font.glyph_ranges.push_back((ImWchar)first);
+                out_font.glyph_ranges.push_back((ImWchar)last);
+            }
+        }
+        if (out_font.glyph_ranges.empty())
+        {
+            out_font.glyph_ranges.assign(DEFAULT_GLYPH_RANGES, DEFAULT_GLYPH_RANGES + 2);
+        }
+        out_font.glyph_ranges.push_back(0);
+        return true;
+    }
+
+    // Entries are either a path or a table with a path; returns the path, or nullopt.
+    sol::optional<std::string> ReadEntryPath(const sol::object& entry)
+    {
+        if (entry.is<std::string>())
+        {
+            return entry.as<std::string>();
+        }
+        if (entry.is<sol::table>())
+        {
+            return entry.as<sol::table>()["path"].get<sol::optional<std::string>>();
+        }
+        return sol::nullopt;
+    }
+}
+
+void PackageManifest::ReadTextureOptions(const sol::table& options, const std::string& context, TextureLoadOptions& out_options)
+{
+    const std::string compression = options.get_or<std::string>("compression", "none");
+    if (!TextureLoader::ParseCompression(compression, out_options.compression))
+    {
+        PLOG_WARNING << context << ": unknown compression \"" << compression
+                     << "\" (expected none, bc1, bc3 or bc7). Loading uncompressed.";
+    }
+
+    out_options.max_width      = options.get_or("max_width", 0);
+    out_options.max_height     = options.get_or("max_height", 0);
+    out_options.generate_mips  = options.get_or("mipmaps", false);
+
+    const std::string filter = options.get_or<std::string>("filter", "lanczos");
+    if (!ImageResample::ParseFilter(filter, out_options.filter))
+    {
+        PLOG_WARNING << context << ": unknown filter \"" << filter << "\" (expected lanczos or box). Using lanczos.";
+    }
+}
+
+bool PackageManifest::Read(lua_State* lua_state, const std::filesystem::path& package_dir,
+                           const std::string& package_resources_dir, PackageManifest& out_manifest)
+{
+    const std::filesystem::path manifest_path = package_dir / "manifest.lua";
+    ArchiveFile archived;
+    const bool is_archived = PackageArchive::ReadFile(manifest_path, archived);
+    std::error_code ec;
+    if (!lua_state || (!is_archived && !std::filesystem::is_regular_file(manifest_path, ec)))
+    {
+        return false;
+    }
+
+    sol::state_view lua(lua_state);
+    sol::environment sandbox(lua, sol::create);
+    sol::protected_function_result result = is_archived
+        ? lua.safe_script(std::string_view(archived.data, archived.size), sandbox, sol::script_pass_on_error, "@" + manifest_path.string())
+        : lua.safe_script_file(manifest_path.string(), sandbox, sol::script_pass_on_error);
+    if (!result.valid())
+    {
+        sol::error err = result;
+        PLOG_WARNING << "Failed to run " << manifest_path.string() << ": " << err.what();
+        return false;
+    }
+
+    sol::optional<sol::table> manifest = result.get<sol::optional<sol::table>>();
+    if (!manifest)
+    {
+        PLOG_WARNING << manifest_path.string() << " did not return a table";
+        return false;
+    }
+
+    sol::optional<sol::table> fonts = (*manifest)["fonts"];
+    if (fonts)
+    {
+        for (size_t i = 1; i <= fonts->size(); ++i)
+        {
+            sol::optional<sol::table> entry = (*fonts)[i];
+            ManifestFont font;
+            if (!entry || !ReadFont(*entry, package_resources_dir, font))
+            {
+                PLOG_WARNING << manifest_path.string() << ": fonts[" << i << "] needs a path";
+                continue;
+            }
+            out_manifest.fonts.push_back(std::move(font));
+        }
+    }
+
+    sol::optional<sol::table> textures = (*manifest)["textures"];
+    if (textures)
+    {
+        for (size_t i = 1; i <= textures->size(); ++i)
+        {
+            const sol::object entry = (*textures)[i];
+            sol::optional<std::string> path = ReadEntryPath(entry);
+            if (!path || path->empty())
+            {
+                PLOG_WARNING << manifest_path.string() << ": textures[" << i << "] needs a path";
+                continue;
+            }
+
+            ManifestTexture texture;
+            texture.path = ResourceVfs::Resolve(*path, package_resources_dir);
+            if (entry.is<sol::table>())
+            {
+                ReadTextureOptions(entry.as<sol::table>(), manifest_path.string(), texture.options);
+            }
+            out_manifest.textures.push_back(std::move(texture));
+        }
+    }
+
+    sol::optional<sol::table> sounds = (*manifest)["sounds"];
+    if (sounds)
+    {
+        for (size_t i = 1; i <= sounds->size(); ++i)
+        {
+            sol::optional<std::string> path = ReadEntryPath((*sounds)[i]);
+            if (!path || path->empty())
+            {
+                PLOG_WARNING << manifest_path.string() << ": sounds[" << i << "] needs a path";
+                continue;
+            }
+            out_manifest.sounds.push_back(ResourceVfs::Resolve(*path, package_resources_dir));
+        }
+    }
+
+    return true;
+}
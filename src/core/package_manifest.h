@@ -0,0 +1,87 @@
+/**
+ * @file package_manifest.h
+ * @brief The optional manifest.lua a script package uses to declare what it needs up front.
+ *
+ * A manifest is a Lua file in the package directory that returns a table:
+ *
+ *     return {
+ *         fonts = {
+ *             { path = "Roboto-Regular.ttf", sizes = { 14, 18 } },
+ *             { path = "NotoSans.ttf", sizes = { 16 }, glyphs = { 0x20, 0xFF, 0x400, 0x4FF } },
+ *         },
+ *         textures = {
+ *             "icons\\close.png",
+ *             { path = "background.png", compression = "bc7", max_width = 1920, max_height = 1080 },
+ *         },
+ *         sounds = { "click.wav" },
+ *     }
+ *
+ * Fonts are added to the atlas before the first frame. Textures and sounds are preloaded on
+ * worker threads (see ResourcePreloader), so a package's first LoadTexture/LoadSound calls find
+ * the work already done. A texture entry takes the same options as UiForge.LoadTexture, and only
+ * a LoadTexture call with matching options picks up the preloaded image.
+ *
+ * It runs in an empty environment, so it can compute values but cannot reach the UiForge or
+ * ImGui APIs. Relative paths resolve like UiForge.LoadTexture from inside the package: the
+ * package's resources folder first, then the shared resources directory.
+ */
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <imgui.h>
+#include <lua.hpp>
+#include <sol/sol.hpp>
+
+#include "core\texture_loader.h"
+
+/**
+ * @brief A font a package wants loaded before its scripts first run.
+ */
+struct ManifestFont
+{
+    std::filesystem::path   path;           // Resolved full path
+    std::vector<float>      sizes;          // Pixel sizes, one ImFont each
+    std::vector<ImWchar>    glyph_ranges;   // Inclusive codepoint pairs, 0 terminated
+};
+
+/**
+ * @brief A texture a package wants decoded in the background.
+ */
+struct ManifestTexture
+{
+    std::filesystem::path   path;           // Resolved full path
+    TextureLoadOptions      options;
+};
+
+struct PackageManifest
+{
+    std::vector<ManifestFont>           fonts;
+    std::vector<ManifestTexture>        textures;
+    std::vector<std::filesystem::path>  sounds;     // Resolved full paths
+
+    /**
+     * @brief Reads "<package_dir>\manifest.lua".
+     *
+     * Malformed entries are logged and skipped; the rest of the manifest still applies.
+     *
+     * @param lua_state The core Lua state, used to run the manifest.
+     * @param package_dir The package directory.
+     * @param package_resources_dir The package's resources folder, or "" for none. Relative
+     * resource paths resolve through ResourceVfs::Resolve, exactly as UiForge.LoadTexture's do.
+     * @param out_manifest Receives the declarations.
+     * @return False when the package has no manifest or it failed to run (logged).
+     */
+    static bool Read(lua_State* lua_state, const std::filesystem::path& package_dir,
+                     const std::string& package_resources_dir, PackageManifest& out_manifest);
+
+    /**
+     * @brief Reads the options table UiForge.LoadTexture takes (compression, max_width,
+     * max_height, filter, mipmaps). Unknown values are logged and left at their defaults.
+     *
+     * @param context Names the caller in warnings, e.g. "LoadTexture".
+     */
+    static void ReadTextureOptions(const sol::table& options, const std::string& context, TextureLoadOptions& out_options);
+};
@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <emmintrin.h>
+#include <xmmintrin.h>
+
+#include <plog/Log.h>
+
+#include "core\draw_batch.h"
+#include "core\particle_system.h"
+
+namespace
+{
+    // Longest step one update simulates, so a stall (or a long time hidden) does not fling
+    // particles through the edges in a single jump.
+    constexpr float MAX_UPDATE_STEP = 0.25f;
+
+    // Largest system a script can create, at about 44 MB (see BYTES_PER_PARTICLE).
+    constexpr size_t MAX_PARTICLES = 1000000;
+
+    // Remaining life of a particle that never expires. Finite, so it stays finite as updates
+    // subtract from it.
+    constexpr float IMMORTAL_LIFE = FLT_MAX;
+
+    // Per-particle bytes across the structure of arrays, plus the draw scratch buffers.
+    constexpr size_t BYTES_PER_PARTICLE = 7 * sizeof(float) + sizeof(ImU32) + 2 * sizeof(float) + sizeof(ImU32);
+
+    struct Emitter
+    {
+        std::string             name;
+        ParticleEmitterOptions  options;
+        float                   pending     = 0.0f;     // Fractional particles owed by rate
+    };
+
+    struct ParticleSystem
+    {
+        ParticleSystemOptions   options;
+        std::vector<Emitter>    emitters;
+
+        // One array per attribute, each padded to a multiple of four so the update can always
+        // load whole vectors. Slots past alive hold stale values that are never drawn.
+        std::vector<float>      x, y, velocity_x, velocity_y, life, inverse_lifetime, radius;
+        std::vector<ImU32>      color;
+        size_t                  alive = 0;
+
+        // Rebuilt for every draw: interleaved positions and faded colours for DrawBatch.
+        std::vector<float>      draw_positions;
+        std::vector<ImU32>      draw_colors;
+
+        uint32_t                random_state = 1;
+        ParticleSystemStats     stats;
+    };
+
+    HandleTable<std::unique_ptr<ParticleSystem>> systems;
+
+    ParticleSystem* FindSystem(ResourceHandle system_id)
+    {
+        std::unique_ptr<ParticleSystem>* system = systems.Find(system_id);
+        return system ? system->get() : nullptr;
+    }
+
+    // xorshift32: cheap, and good enough to scatter particles.
+    float Random01(ParticleSystem& system)
+    {
+        uint32_t state = system.random_state;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        system.random_state = state;
+        return (float)(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float RandomRange(ParticleSystem& system, float min, float max)
+    {
+        return min + (max - min) * Random01(system);
+    }
+
+    void Spawn(ParticleSystem& system, const ParticleEmitterOptions& emitter, size_t count)
+    {
+        count = std::min(count, system.options.max_particles - system.alive);
+        for (size_t n = 0; n < count; ++n)
+        {
+            const size_t i = system.alive++;
+            const float angle = emitter.angle + (Random01(system) - 0.5f) * emitter.spread;
+            const float speed = RandomRange(system, emitter.speed_min, emitter.speed_max);
+            const float lifetime = RandomRange(system, emitter.lifetime_min, emitter.lifetime_max);
+
+            system.x[i]                 = emitter.x;
+            system.y[i]                 = emitter.y;
+            system.velocity_x[i]        = std::cos(angle) * speed;
+            system.velocity_y[i]        = std::sin(angle) * speed;
+            system.life[i]              = lifetime > 0.0f ? lifetime : IMMORTAL_LIFE;
+            system.inverse_lifetime[i]  = (emitter.fade && lifetime > 0.0f) ? 1.0f / lifetime : 0.0f;
+            system.radius[i]            = RandomRange(system, emitter.radius_min, emitter.radius_max);
+            system.color[i]             = emitter.color;
+        }
+        system.stats.spawned += count;
+    }
+
+    // Picks a or b per lane: mask ? a : b.
+    __m128 Select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    int CountBits(int bits)
+    {
+        return (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+    }
+
+    // Clamps one axis to [radius, extent - radius] and reflects the velocity of every particle
+    // that crossed an edge. Returns the lanes that did.
+    int Collide(__m128& position, __m128& velocity, __m128 radius, __m128 extent, __m128 bounce)
+    {
+        const __m128 sign_bit = _mm_set1_ps(-0.0f);
+        const __m128 speed = _mm_mul_ps(_mm_andnot_ps(sign_bit, velocity), bounce);
+
+        const __m128 low = radius;
+        const __m128 high = _mm_max_ps(low, _mm_sub_ps(extent, radius));
+        const __m128 below = _mm_cmplt_ps(position, low);
+        const __m128 above = _mm_cmpgt_ps(position, high);
+
+        position = Select(below, low, Select(above, high, position));
+        velocity = Select(below, speed, Select(above, _mm_or_ps(speed, sign_bit), velocity));
+        return _mm_movemask_ps(_mm_or_ps(below, above));
+    }
+
+    // Advances particles [0, alive) by one step, four at a time.
+    void Integrate(ParticleSystem& system, float delta_time)
+    {
+        const ParticleSystemOptions& options = system.options;
+        const bool bounded = options.width > 0.0f && options.height > 0.0f;
+
+        const __m128 dt         = _mm_set1_ps(delta_time);
+        const __m128 damping    = _mm_set1_ps(std::max(0.0f, 1.0f - options.drag * delta_time));
+        const __m128 gravity_x  = _mm_set1_ps(options.gravity_x * delta_time);
+        const __m128 gravity_y  = _mm_set1_ps(options.gravity_y * delta_time);
+        const __m128 width      = _mm_set1_ps(options.width);
+        const __m128 height     = _mm_set1_ps(options.height);
+        const __m128 bounce     = _mm_set1_ps(options.bounce);
+        const __m128 lane_index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+        __m128 sum_x = _mm_setzero_ps();
+        __m128 sum_y = _mm_setzero_ps();
+        size_t bounces = 0;
+
+        for (size_t i = 0; i < system.alive; i += 4)
+        {
+            __m128 x  = _mm_loadu_ps(&system.x[i]);
+            __m128 y  = _mm_loadu_ps(&system.y[i]);
+            __m128 vx = _mm_loadu_ps(&system.velocity_x[i]);
+            __m128 vy = _mm_loadu_ps(&system.velocity_y[i]);
+
+            vx = _mm_add_ps(_mm_mul_ps(vx, damping), gravity_x);
+            vy = _mm_add_ps(_mm_mul_ps(vy, damping), gravity_y);
+            x  = _mm_add_ps(x, _mm_mul_ps(vx, dt));
+            y  = _mm_add_ps(y, _mm_mul_ps(vy, dt));
+
+            // The last block may run past alive; its extra lanes are stale and must not count.
+            const __m128 valid = _mm_cmplt_ps(lane_index, _mm_set1_ps((float)(system.alive - i)));
+            if (bounded)
+            {
+                const __m128 radius = _mm_loadu_ps(&system.radius[i]);
+                const int hits = Collide(x, vx, radius, width, bounce) | Collide(y, vy, radius, height, bounce);
+                bounces += CountBits(hits & _mm_movemask_ps(valid));
+            }
+
+            _mm_storeu_ps(&system.x[i], x);
+            _mm_storeu_ps(&system.y[i], y);
+            _mm_storeu_ps(&system.velocity_x[i], vx);
+            _mm_storeu_ps(&system.velocity_y[i], vy);
+            _mm_storeu_ps(&system.life[i], _mm_sub_ps(_mm_loadu_ps(&system.life[i]), dt));
+
+            sum_x = _mm_add_ps(sum_x, _mm_and_ps(valid, x));
+            sum_y = _mm_add_ps(sum_y, _mm_and_ps(valid, y));
+        }
+
+        alignas(16) float lanes_x[4], lanes_y[4];
+        _mm_store_ps(lanes_x, sum_x);
+        _mm_store_ps(lanes_y, sum_y);
+        const float count = (float)std::max<size_t>(1, system.alive);
+        system.stats.center_x = (lanes_x[0] + lanes_x[1] + lanes_x[2] + lanes_x[3]) / count;
+        system.stats.center_y = (lanes_y[0] + lanes_y[1] + lanes_y[2] + lanes_y[3]) / count;
+        system.stats.bounces = bounces;
+    }
+
+    // Moves the last live particle into every expired slot. Draw order is not kept, which no
+    // effect relies on.
+    void RemoveExpired(ParticleSystem& system)
+    {
+        size_t i = 0;
+        while (i < system.alive)
+        {
+            if (system.life[i] > 0.0f)
+            {
+                ++i;
+                continue;
+            }
+
+            const size_t last = --system.alive;
+            system.x[i]                 = system.x[last];
+            system.y[i]                 = system.y[last];
+            system.velocity_x[i]        = system.velocity_x[last];
+            system.velocity_y[i]        = system.velocity_y[last];
+            system.life[i]              = system.life[last];
+            system.inverse_lifetime[i]  = system.inverse_lifetime[last];
+            system.radius[i]            = system.radius[last];
+            system.color[i]             = system.color[last];
+            system.stats.expired++;
+        }
+    }
+}
+
+ResourceHandle ParticleSystemManager::Create(const ParticleSystemOptions& options, uint32_t owner)
+{
+    if (options.max_particles == 0 || options.max_particles > MAX_PARTICLES)
+    {
+        PLOG_ERROR << "Particle system size must be between 1 and " << MAX_PARTICLES << ", got " << options.max_particles;
+        return 0;
+    }
+
+    auto system = std::make_unique<ParticleSystem>();
+    system->options = options;
+
+    const size_t padded = (options.max_particles + 3) & ~(size_t)3;
+    for (std::vector<float>* array : { &system->x, &system->y, &system->velocity_x, &system->velocity_y,
+                                       &system->life, &system->inverse_lifetime, &system->radius })
+    {
+        array->assign(padded, 0.0f);
+    }
+    system->color.assign(padded, 0);
+    system->stats.capacity = options.max_particles;
+
+    ParticleSystem* created = system.get();
+    const ResourceHandle system_id = systems.Insert(std::move(system), owner);
+    if (system_id == 0)
+    {
+        PLOG_ERROR << "Too many particle systems";
+        return 0;
+    }
+
+    // xorshift must not start at 0.
+    created->random_state = options.seed != 0 ? options.seed : (uint32_t)(system_id * 2654435761u) | 1u;
+    return system_id;
+}
+
+bool ParticleSystemManager::SetEmitter(ResourceHandle system_id, const std::string& name, const ParticleEmitterOptions* options)
+{
+    ParticleSystem* system = FindSystem(system_id);
+    if (!system)
+    {
+        return false;
+    }
+
+    auto emitter = std::find_if(system->emitters.begin(), system->emitters.end(), [&](const Emitter& e) { return e.name == name; });
+    if (!options)
+    {
+        if (emitter != system->emitters.end())
+        {
+            system->emitters.erase(emitter);
+        }
+        return true;
+    }
+
+    // Update() turns the rate into a spawn count, so it has to be a finite, non-negative number.
+    if (!std::isfinite(options->rate))
+    {
+        PLOG_ERROR << "Particle emitter '" << name << "' rate must be a finite number";
+        return false;
+    }
+    ParticleEmitterOptions checked = *options;
+    checked.rate = std::max(0.0f, checked.rate);
+
+    if (emitter == system->emitters.end())
+    {
+        system->emitters.push_back({ name, checked });
+        return true;
+    }
+
+    // A burst already queued but not yet spawned is not lost by re-setting the emitter.
+    const int queued_burst = emitter->options.burst;
+    emitter->options = checked;
+    emitter->options.burst += queued_burst;
+    return true;
+}
+
+void ParticleSystemManager::Update(ResourceHandle system_id, float delta_time)
+{
+    ParticleSystem* system = FindSystem(system_id);
+    if (!system)
+    {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    delta_time = std::clamp(delta_time, 0.0f, MAX_UPDATE_STEP);
+
+    for (Emitter& emitter : system->emitters)
+    {
+        emitter.pending += emitter.options.rate * delta_time;
+        const float whole = std::floor(emitter.pending);
+        emitter.pending -= whole;
+        Spawn(*system, emitter.options, (size_t)whole + (size_t)std::max(0, emitter.options.burst));
+        emitter.options.burst = 0;
+    }
+
+    Integrate(*system, delta_time);
+    RemoveExpired(*system);
+
+    system->stats.alive = system->alive;
+    system->stats.update_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ParticleSystemManager::Draw(ResourceHandle system_id, ImDrawList* draw_list, const ImVec2& origin)
+{
+    ParticleSystem* system = FindSystem(system_id);
+    if (!system || !draw_list || system->alive == 0)
+    {
+        return;
+    }
+
+    // DrawBatch takes x, y pairs; interleave four particles per iteration.
+    const size_t padded = (system->alive + 3) & ~(size_t)3;
+    system->draw_positions.resize(padded * 2);
+    float* positions = system->draw_positions.data();
+    for (size_t i = 0; i < padded; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(&system->x[i]);
+        const __m128 y = _mm_loadu_ps(&system->y[i]);
+        _mm_storeu_ps(positions + i * 2, _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(positions + i * 2 + 4, _mm_unpackhi_ps(x, y));
+    }
+
+    system->draw_colors.resize(system->alive);
+    for (size_t i = 0; i < system->alive; ++i)
+    {
+        const ImU32 color = system->color[i];
+        if (system->inverse_lifetime[i] == 0.0f)
+        {
+            system->draw_colors[i] = color;
+            continue;
+        }
+        const float fade = std::clamp(system->life[i] * system->inverse_lifetime[i], 0.0f, 1.0f);
+        const ImU32 alpha = (ImU32)((float)(color >> IM_COL32_A_SHIFT) * fade);
+        system->draw_colors[i] = (color & ~IM_COL32_A_MASK) | (alpha << IM_COL32_A_SHIFT);
+    }
+
+    DrawBatchCircles circles;
+    circles.count       = system->alive;
+    circles.positions   = system->draw_positions.data();
+    circles.radii       = system->radius.data();
+    circles.colors      = system->draw_colors.data();
+    circles.segments    = system->options.segments;
+    DrawBatch::Circles(draw_list, circles, origin);
+}
+
+void ParticleSystemManager::Clear(ResourceHandle system_id)
+{
+    if (ParticleSystem* system = FindSystem(system_id))
+    {
+        system->alive = 0;
+        system->stats.alive = 0;
+    }
+}
+
+ParticleSystemStats ParticleSystemManager::GetStats(ResourceHandle system_id)
+{
+    const ParticleSystem* system = FindSystem(system_id);
+    return system ? system->stats : ParticleSystemStats();
+}
+
+void ParticleSystemManager::Release(ResourceHandle system_id)
+{
+    systems.Remove(system_id);
+}
+
+void ParticleSystemManager::ReleaseAll()
+{
+    systems.Clear();
+}
+
+void ParticleSystemManager::ReleaseOwnedBy(uint32_t owner)
+{
+    for (ResourceHandle system_id : systems.HandlesOwnedBy(owner))
+    {
+        Release(system_id);
+    }
+}
+
+bool ParticleSystemManager::Keep(ResourceHandle system_id)
+{
+    return systems.SetOwner(system_id, 0);
+}
+
+ResourceUsage ParticleSystemManager::GetUsage(uint32_t owner)
+{
+    ResourceUsage usage;
+    systems.ForEach([&](ResourceHandle, std::unique_ptr<ParticleSystem>& system, uint32_t system_owner)
+    {
+        if (system_owner == owner)
+        {
+            usage.count++;
+            usage.bytes += system->x.size() * BYTES_PER_PARTICLE;
+        }
+    });
+    return usage;
+}
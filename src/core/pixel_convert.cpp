@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <intrin.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <immintrin.h>
+
+#include "core\pixel_convert.h"
+
+namespace
+{
+    // Converts one row of width pixels. Source and destination may be the same row for the
+    // in-place kernels (unpremultiply), never partially overlapping.
+    using RowKernel = void (*)(const uint8_t* source, uint8_t* destination, int width);
+
+    struct RowKernels
+    {
+        RowKernel   bgra_to_rgba;
+        RowKernel   rgb_to_rgba;
+        RowKernel   gray_to_rgba;
+        RowKernel   unpremultiply;
+        const char* name;
+    };
+
+    // Scalar reference kernels.
+
+    void BgraToRgbaScalar(const uint8_t* source, uint8_t* destination, int width)
+    {
+        for (int x = 0; x < width; ++x, source += 4, destination += 4)
+        {
+            const uint8_t blue = source[0];
+            destination[0] = source[2];
+            destination[1] = source[1];
+            destination[2] = blue;
+            destination[3] = source[3];
+        }
+    }
+
+    void RgbToRgbaScalar(const uint8_t* source, uint8_t* destination, int width)
+    {
+        for (int x = 0; x < width; ++x, source += 3, destination += 4)
+        {
+            destination[0] = source[0];
+            destination[1] = source[1];
+            destination[2] = source[2];
+            destination[3] = 0xFF;
+        }
+    }
+
+    void GrayToRgbaScalar(const uint8_t* source, uint8_t* destination, int width)
+    {
+        for (int x = 0; x < width; ++x, destination += 4)
+        {
+            destination[0] = source[x];
+            destination[1] = source[x];
+            destination[2] = source[x];
+            destination[3] = 0xFF;
+        }
+    }
+
+    void UnpremultiplyScalar(const uint8_t* source, uint8_t* destination, int width)
+    {
+        for (int x = 0; x < width; ++x, source += 4, destination += 4)
+        {
+            const uint32_t alpha = source[3];
+            if (alpha == 0xFF)
+            {
+                if (source != destination)
+                {
+                    std::memcpy(destination, source, 4);
+                }
+                continue;
+            }
+
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                const uint32_t value = alpha ? (source[channel] * 255u + alpha / 2) / alpha : 0;
+                destination[channel] = (uint8_t)std::min<uint32_t>(value, 255u);
+            }
+            destination[3] = (uint8_t)alpha;
+        }
+    }
+
+    // The scalar kernels on their own, for ConvertToRgbaScalar.
+    const RowKernels SCALAR_KERNELS = { BgraToRgbaScalar, RgbToRgbaScalar, GrayToRgbaScalar, UnpremultiplyScalar, "scalar" };
+
+    // SSE2 kernels.
+
+    void BgraToRgbaSse2(const uint8_t* source, uint8_t* destination, int width)
+    {
+        // As little endian words a BGRA pixel is 0xAARRGGBB. Green and alpha stay put; red and
+        // blue are the low bytes of the two 16-bit halves, so swapping the halves swaps them.
+        const __m128i green_alpha_mask = _mm_set1_epi32((int)0xFF00FF00);
+
+        int x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            const __m128i pixels     = _mm_loadu_si128((const __m128i*)(source + (size_t)x * 4));
+            const __m128i green_alpha = _mm_and_si128(pixels, green_alpha_mask);
+            __m128i red_blue         = _mm_andnot_si128(green_alpha_mask, pixels);
+            red_blue = _mm_shufflelo_epi16(red_blue, _MM_SHUFFLE(2, 3, 0, 1));
+            red_blue = _mm_shufflehi_epi16(red_blue, _MM_SHUFFLE(2, 3, 0, 1));
+            _mm_storeu_si128((__m128i*)(destination + (size_t)x * 4), _mm_or_si128(green_alpha, red_blue));
+        }
+
+        BgraToRgbaScalar(source + (size_t)x * 4, destination + (size_t)x * 4, width - x);
+    }
+
+    void GrayToRgbaSse2(const uint8_t* source, uint8_t* destination, int width)
+    {
+        const __m128i opaque = _mm_set1_epi8((char)0xFF);
+
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            const __m128i gray = _mm_loadu_si128((const __m128i*)(source + x));
+
+            // Interleave (g, g) and (g, 0xFF) byte pairs, then interleave those words to get
+            // g g g 0xFF per pixel.
+            const __m128i gray_gray_low   = _mm_unpacklo_epi8(gray, gray);
+            const __m128i gray_alpha_low  = _mm_unpacklo_epi8(gray, opaque);
+            const __m128i gray_gray_high  = _mm_unpackhi_epi8(gray, gray);
+            const __m128i gray_alpha_high = _mm_unpackhi_epi8(gray, opaque);
+
+            __m128i* out = (__m128i*)(destination + (size_t)x * 4);
+            _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(gray_gray_low, gray_alpha_low));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(gray_gray_low, gray_alpha_low));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(gray_gray_high, gray_alpha_high));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(gray_gray_high, gray_alpha_high));
+        }
+
+        GrayToRgbaScalar(source + x, destination + (size_t)x * 4, width - x);
+    }
+
+    // Divides the colour channels of one pixel (r, g, b, a as floats) by alpha. Alpha itself is
+    // passed through, and a fully transparent pixel comes out as all zeros.
+    inline __m128 UnpremultiplyPixelSse2(__m128 pixel)
+    {
+        const __m128 alpha      = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128 alpha_lane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+        const __m128 visible    = _mm_cmpneq_ps(alpha, _mm_setzero_ps());
+
+        __m128 colour = _mm_mul_ps(pixel, _mm_div_ps(_mm_set1_ps(255.0f), alpha));
+        colour = _mm_and_ps(_mm_min_ps(colour, _mm_set1_ps(255.0f)), visible);
+        return _mm_or_ps(_mm_andnot_ps(alpha_lane, colour), _mm_and_ps(alpha_lane, pixel));
+    }
+
+    void UnpremultiplySse2(const uint8_t* source, uint8_t* destination, int width)
+    {
+        const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000);
+        const __m128i zero       = _mm_setzero_si128();
+
+        int x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            const __m128i pixels = _mm_loadu_si128((const __m128i*)(source + (size_t)x * 4));
+            __m128i* out = (__m128i*)(destination + (size_t)x * 4);
+
+            // Opaque runs are by far the common case and need no math.
+            const __m128i opaque = _mm_cmpeq_epi32(_mm_and_si128(pixels, alpha_mask), alpha_mask);
+            if (_mm_movemask_epi8(opaque) == 0xFFFF)
+            {
+                _mm_storeu_si128(out, pixels);
+                continue;
+            }
+
+            const __m128i low  = _mm_unpacklo_epi8(pixels, zero);
+            const __m128i high = _mm_unpackhi_epi8(pixels, zero);
+
+            const __m128i p0 = _mm_cvtps_epi32(UnpremultiplyPixelSse2(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero))));
+            const __m128i p1 = _mm_cvtps_epi32(UnpremultiplyPixelSse2(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero))));
+            const __m128i p2 = _mm_cvtps_epi32(UnpremultiplyPixelSse2(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero))));
+            const __m128i p3 = _mm_cvtps_epi32(UnpremultiplyPixelSse2(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero))));
+
+            _mm_storeu_si128(out, _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+        }
+
+        UnpremultiplyScalar(source + (size_t)x * 4, destination + (size_t)x * 4, width - x);
+    }
+
+    // SSSE3 and AVX2 kernels.
+
+    void RgbToRgbaSsse3(const uint8_t* source, uint8_t* destination, int width)
+    {
+        const __m128i expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+
+        // Each step consumes 12 source bytes but loads 16, so stop while two more pixels of
+        // source remain to keep the load inside the row.
+        int x = 0;
+        for (; x + 6 <= width; x += 4)
+        {
+            const __m128i pixels = _mm_loadu_si128((const __m128i*)(source + (size_t)x * 3));
+            _mm_storeu_si128((__m128i*)(destination + (size_t)x * 4), _mm_or_si128(_mm_shuffle_epi8(pixels, expand), opaque));
+        }
+
+        RgbToRgbaScalar(source + (size_t)x * 3, destination + (size_t)x * 4, width - x);
+    }
+
+    void BgraToRgbaAvx2(const uint8_t* source, uint8_t* destination, int width)
+    {
+        const __m256i swizzle = _mm256_setr_epi8(
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            const __m256i pixels = _mm256_loadu_si256((const __m256i*)(source + (size_t)x * 4));
+            _mm256_storeu_si256((__m256i*)(destination + (size_t)x * 4), _mm256_shuffle_epi8(pixels, swizzle));
+        }
+
+        BgraToRgbaSse2(source + (size_t)x * 4, destination + (size_t)x * 4, width - x);
+    }
+
+    // Runtime dispatch.
+
+    struct CpuFeatures
+    {
+        bool ssse3 = false;
+        bool avx2  = false;
+    };
+
+    CpuFeatures DetectCpuFeatures()
+    {
+        CpuFeatures features;
+
+        int info[4] = {};
+        __cpuid(info, 0);
+        const int max_leaf = info[0];
+
+        __cpuid(info, 1);
+        features.ssse3 = (info[2] & (1 << 9)) != 0;
+        const bool os_saves_ymm = (info[2] & (1 << 27)) != 0;
+        const bool avx          = (info[2] & (1 << 28)) != 0;
+
+        // AVX2 also needs the OS to preserve the upper YMM halves across context switches.
+        if (max_leaf >= 7 && os_saves_ymm && avx && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            features.avx2 = (info[1] & (1 << 5)) != 0;
+        }
+
+        return features;
+    }
+
+    RowKernels SelectKernels()
+    {
+        // x64 guarantees SSE2, so that is the floor. Scalar kernels remain as the tail handlers
+        // and the reference the vector paths are checked against.
+        RowKernels kernels = { BgraToRgbaSse2, RgbToRgbaScalar, GrayToRgbaSse2, UnpremultiplySse2, "sse2" };
+
+        const CpuFeatures features = DetectCpuFeatures();
+        if (features.ssse3)
+        {
+            kernels.rgb_to_rgba = RgbToRgbaSsse3;
+        }
+        if (features.avx2)
+        {
+            kernels.bgra_to_rgba = BgraToRgbaAvx2;
+            kernels.name         = "avx2";
+        }
+
+        return kernels;
+    }
+
+    const RowKernels& GetKernels()
+    {
+        static const RowKernels kernels = SelectKernels();
+        return kernels;
+    }
+
+    void ConvertRows(const RowKernels& kernels, const void* source, const PixelLayout& layout, int width, int height, void* destination, size_t destination_pitch)
+    {
+        if (!source || !destination || width <= 0 || height <= 0)
+        {
+            return;
+        }
+
+        const size_t source_pitch = PixelConvert::SourceRowPitch(layout, width);
+        const bool has_alpha      = layout.format == PixelFormat::RGBA8 || layout.format == PixelFormat::BGRA8;
+
+        for (int row = 0; row < height; ++row)
+        {
+            const uint8_t* source_row  = (const uint8_t*)source + (size_t)row * source_pitch;
+            uint8_t* destination_row   = (uint8_t*)destination + (size_t)row * destination_pitch;
+
+            switch (layout.format)
+            {
+                case PixelFormat::RGBA8:    std::memcpy(destination_row, source_row, (size_t)width * 4); break;
+                case PixelFormat::BGRA8:    kernels.bgra_to_rgba(source_row, destination_row, width); break;
+                case PixelFormat::RGB8:     kernels.rgb_to_rgba(source_row, destination_row, width); break;
+                case PixelFormat::Gray8:    kernels.gray_to_rgba(source_row, destination_row, width); break;
+            }
+
+            // Undo premultiplication while the row is still in cache. Formats without alpha are
+            // opaque, where premultiplied and straight are the same thing.
+            if (layout.premultiplied && has_alpha)
+            {
+                kernels.unpremultiply(destination_row, destination_row, width);
+            }
+        }
+    }
+}
+
+size_t PixelConvert::BytesPerPixel(PixelFormat format)
+{
+    switch (format)
+    {
+        case PixelFormat::RGBA8:
+        case PixelFormat::BGRA8:    return 4;
+        case PixelFormat::RGB8:     return 3;
+        case PixelFormat::Gray8:    return 1;
+    }
+    return 4;
+}
+
+size_t PixelConvert::SourceRowPitch(const PixelLayout& layout, int width)
+{
+    return layout.row_pitch ? layout.row_pitch : BytesPerPixel(layout.format) * (size_t)width;
+}
+
+size_t PixelConvert::RequiredSourceSize(const PixelLayout& layout, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return 0;
+    }
+
+    const size_t row_bytes = BytesPerPixel(layout.format) * (size_t)width;
+    const size_t pitch     = SourceRowPitch(layout, width);
+    if (pitch < row_bytes)
+    {
+        return 0;
+    }
+
+    // row_pitch comes from scripts, so a huge one must not wrap around into a small size.
+    const size_t full_rows = (size_t)(height - 1);
+    if (full_rows && pitch > (SIZE_MAX - row_bytes) / full_rows)
+    {
+        return 0;
+    }
+
+    return pitch * full_rows + row_bytes;
+}
+
+bool PixelConvert::IsPassthrough(const PixelLayout& layout)
+{
+    return layout.format == PixelFormat::RGBA8 && !layout.premultiplied;
+}
+
+void PixelConvert::ConvertToRgba(const void* source, const PixelLayout& layout, int width, int height, void* destination, size_t destination_pitch)
+{
+    ConvertRows(GetKernels(), source, layout, width, height, destination, destination_pitch);
+}
+
+void PixelConvert::ConvertToRgbaScalar(const void* source, const PixelLayout& layout, int width, int height, void* destination, size_t destination_pitch)
+{
+    ConvertRows(SCALAR_KERNELS, source, layout, width, height, destination, destination_pitch);
+}
+
+bool PixelConvert::ParseFormat(const std::string& name, PixelFormat& out_format)
+{
+    if (name == "rgba")                     { out_format = PixelFormat::RGBA8; return true; }
+    if (name == "bgra")                     { out_format = PixelFormat::BGRA8; return true; }
+    if (name == "rgb")                      { out_format = PixelFormat::RGB8;  return true; }
+    if (name == "gray" || name == "grey")   { out_format = PixelFormat::Gray8; return true; }
+    return false;
+}
+
+const char* PixelConvert::GetSimdLevelName()
+{
+    return GetKernels().name;
+}
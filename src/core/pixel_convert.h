@@ -0,0 +1,103 @@
+/**
+ * @file pixel_convert.h
+ * @brief Conversion of common CPU pixel layouts into the 32-bit RGBA textures UiForge uploads.
+ *
+ * Every texture UiForge creates is DXGI_FORMAT_R8G8B8A8_UNORM with straight alpha, which is
+ * what the ImGui backends blend with. Callers hand over whatever layout they have (BGRA from
+ * a screen grab, RGB24 from a decoder, 8-bit masks, premultiplied output from another
+ * renderer, padded rows) and the conversion is done while writing into the staging memory,
+ * so there is no intermediate RGBA copy.
+ *
+ * Row kernels are picked once at first use: AVX2 (with SSSE3 shuffles) when the CPU and OS
+ * support it, SSE2 otherwise. Plain scalar code handles the row tails and is the reference the
+ * vector kernels are checked against (src/test/test_pixel_convert.cpp).
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Byte order of a source pixel.
+ */
+enum class PixelFormat
+{
+    RGBA8,      // 4 bytes, R G B A
+    BGRA8,      // 4 bytes, B G R A (GDI, DXGI desktop duplication)
+    RGB8,       // 3 bytes, R G B, opaque
+    Gray8       // 1 byte, expanded to opaque grey
+};
+
+/**
+ * @brief Describes how source pixels are laid out in memory.
+ */
+struct PixelLayout
+{
+    PixelFormat format          = PixelFormat::RGBA8;
+    size_t      row_pitch       = 0;        // Bytes from one source row to the next, 0 for tightly packed
+    bool        premultiplied   = false;    // Colour channels are already multiplied by alpha
+};
+
+namespace PixelConvert
+{
+    /**
+     * @brief Returns the size of one source pixel in bytes.
+     */
+    size_t BytesPerPixel(PixelFormat format);
+
+    /**
+     * @brief Returns the effective source row pitch, resolving a row_pitch of 0 to tightly packed.
+     */
+    size_t SourceRowPitch(const PixelLayout& layout, int width);
+
+    /**
+     * @brief Returns the minimum number of bytes a source buffer must hold for the given size.
+     *
+     * The last row only needs its pixels, not a full pitch, matching how padded images are
+     * usually allocated.
+     *
+     * @return The required byte count, or 0 when the layout is invalid for the width (a row
+     * pitch smaller than one row of pixels) or the size does not fit in a size_t.
+     */
+    size_t RequiredSourceSize(const PixelLayout& layout, int width, int height);
+
+    /**
+     * @brief Reports whether the source can be copied into an RGBA texture unchanged.
+     */
+    bool IsPassthrough(const PixelLayout& layout);
+
+    /**
+     * @brief Converts a source image into straight-alpha 32-bit RGBA.
+     *
+     * Source and destination must not overlap. The destination may be padded (for example a
+     * D3D12 upload buffer with 256-byte aligned rows); only width * 4 bytes of each destination
+     * row are written.
+     *
+     * @param source Pointer to the first source row.
+     * @param layout Format, row pitch and alpha mode of the source.
+     * @param width Image width in pixels.
+     * @param height Image height in pixels.
+     * @param destination Pointer to the first destination row.
+     * @param destination_pitch Bytes from one destination row to the next.
+     */
+    void ConvertToRgba(const void* source, const PixelLayout& layout, int width, int height, void* destination, size_t destination_pitch);
+
+    /**
+     * @brief ConvertToRgba with the scalar kernels only, whatever the CPU supports. The tests
+     * and the benchmark compare the SIMD kernels against it.
+     */
+    void ConvertToRgbaScalar(const void* source, const PixelLayout& layout, int width, int height, void* destination, size_t destination_pitch);
+
+    /**
+     * @brief Parses a format name as used by the Lua API ("rgba", "bgra", "rgb", "gray").
+     *
+     * @return True when the name is recognized and out_format was written.
+     */
+    bool ParseFormat(const std::string& name, PixelFormat& out_format);
+
+    /**
+     * @brief Returns the name of the row kernel set in use: "avx2" or "sse2".
+     */
+    const char* GetSimdLevelName();
+}
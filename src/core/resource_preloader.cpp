@@ -0,0 +1,266 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <algorithm>
+#include <condition_variable>
+#include <cwctype>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <plog/Log.h>
+
+#include "core\package_archive.h"
+#include "core\resource_preloader.h"
+
+namespace
+{
+    constexpr unsigned MAX_WORKERS = 4;
+
+    struct PreloadJob
+    {
+        bool                    is_texture = false;
+        std::filesystem::path   file_path;
+        std::wstring            file_key;       // See FileKey
+        std::wstring            package_key;
+        TextureLoadOptions      options;
+    };
+
+    std::mutex preload_mutex;
+    std::condition_variable jobs_changed;       // Signalled when a job is queued or stopping is set
+    std::condition_variable job_finished;
+    std::deque<PreloadJob> queued_jobs;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    std::unordered_set<std::wstring> started_packages;
+    std::unordered_map<std::wstring, PreloadProgress> progress_by_package;
+    std::unordered_map<std::wstring, int> running_by_file;     // Jobs a worker is on, by file
+    std::unordered_map<std::wstring, std::unique_ptr<PreparedTexture>> prepared_textures;  // By TextureKey
+
+    // Manifest paths and script paths can differ in case and separators, so both are compared
+    // in this normalized form.
+    std::wstring FileKey(const std::filesystem::path& file_path)
+    {
+        std::wstring key = file_path.lexically_normal().wstring();
+        std::transform(key.begin(), key.end(), key.begin(), [](wchar_t c) { return (wchar_t)towlower(c); });
+        return key;
+    }
+
+    std::wstring TextureKey(const std::wstring& file_key, const TextureLoadOptions& options)
+    {
+        return file_key + L"|" + std::to_wstring((int)options.compression) + L"|" + std::to_wstring(options.max_width)
+             + L"x" + std::to_wstring(options.max_height) + L"|" + std::to_wstring((int)options.filter)
+             + (options.generate_mips ? L"|mips" : L"");
+    }
+
+    bool HasQueuedJob(const std::wstring& file_key)
+    {
+        return std::any_of(queued_jobs.begin(), queued_jobs.end(), [&](const PreloadJob& job) { return job.file_key == file_key; });
+    }
+
+    // Reads a sound file through once so MCI's open finds it in the OS file cache. Archived
+    // sounds are extracted first, which is most of the work for them.
+    bool WarmSoundFile(const std::filesystem::path& file_path)
+    {
+        const std::filesystem::path sound_path = PackageArchive::ExtractToCache(file_path);
+        std::ifstream in(sound_path, std::ios::binary);
+        if (sound_path.empty() || !in)
+        {
+            PLOG_WARNING << "Could not preload sound \"" << file_path.string() << "\"";
+            return false;
+        }
+
+        char buffer[64 * 1024];
+        while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+        {
+        }
+        return true;
+    }
+
+    void RunWorker()
+    {
+        std::unique_lock<std::mutex> lock(preload_mutex);
+        for (;;)
+        {
+            jobs_changed.wait(lock, [] { return stopping || !queued_jobs.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+
+            PreloadJob job = std::move(queued_jobs.front());
+            queued_jobs.pop_front();
+            running_by_file[job.file_key]++;
+            lock.unlock();
+
+            std::unique_ptr<PreparedTexture> prepared;
+            bool succeeded = false;
+            if (job.is_texture)
+            {
+                prepared = std::make_unique<PreparedTexture>();
+                succeeded = TextureLoader::Prepare(job.file_path, job.options, *prepared);
+            }
+            else
+            {
+                succeeded = WarmSoundFile(job.file_path);
+            }
+
+            lock.lock();
+            if (job.is_texture && succeeded)
+            {
+                prepared_textures[TextureKey(job.file_key, job.options)] = std::move(prepared);
+            }
+
+            PreloadProgress& progress = progress_by_package[job.package_key];
+            progress.finished++;
+            progress.failed += succeeded ? 0 : 1;
+            if (--running_by_file[job.file_key] == 0)
+            {
+                running_by_file.erase(job.file_key);
+            }
+            job_finished.notify_all();
+        }
+    }
+
+    // Drops a file's queued jobs (counting them as finished) and waits out its running ones.
+    void ClaimFile(std::unique_lock<std::mutex>& lock, const std::wstring& file_key)
+    {
+        for (auto job = queued_jobs.begin(); job != queued_jobs.end();)
+        {
+            if (job->file_key == file_key)
+            {
+                progress_by_package[job->package_key].finished++;
+                job = queued_jobs.erase(job);
+            }
+            else
+            {
+                ++job;
+            }
+        }
+        job_finished.wait(lock, [&] { return running_by_file.find(file_key) == running_by_file.end(); });
+    }
+}
+
+void ResourcePreloader::Start(const std::filesystem::path& package_dir, const PackageManifest& manifest)
+{
+    const size_t job_count = manifest.textures.size() + manifest.sounds.size();
+    std::lock_guard<std::mutex> lock(preload_mutex);
+    const std::wstring package_key = FileKey(package_dir);
+    if (stopping || job_count == 0 || !started_packages.insert(package_key).second)
+    {
+        return;
+    }
+
+    for (const ManifestTexture& texture : manifest.textures)
+    {
+        queued_jobs.push_back({ true, texture.path, FileKey(texture.path), package_key, texture.options });
+    }
+    for (const std::filesystem::path& sound : manifest.sounds)
+    {
+        queued_jobs.push_back({ false, sound, FileKey(sound), package_key, TextureLoadOptions() });
+    }
+    progress_by_package[package_key].total += job_count;
+
+    // Leave most cores to the game; the texture encoder parallelizes within a job anyway.
+    const unsigned worker_count = std::max(1u, std::min(MAX_WORKERS, std::thread::hardware_concurrency() / 2));
+    while (workers.size() < worker_count)
+    {
+        workers.emplace_back(RunWorker);
+    }
+    jobs_changed.notify_all();
+
+    PLOG_INFO << "Preloading " << job_count << " resources for " << package_dir.string();
+}
+
+bool ResourcePreloader::IsReady(const std::filesystem::path& file_path)
+{
+    const std::wstring file_key = FileKey(file_path);
+    std::lock_guard<std::mutex> lock(preload_mutex);
+    return running_by_file.find(file_key) == running_by_file.end() && !HasQueuedJob(file_key);
+}
+
+PreloadProgress ResourcePreloader::GetProgress(const std::filesystem::path& package_dir)
+{
+    std::lock_guard<std::mutex> lock(preload_mutex);
+    auto progress = progress_by_package.find(FileKey(package_dir));
+    return progress == progress_by_package.end() ? PreloadProgress() : progress->second;
+}
+
+std::unique_ptr<PreparedTexture> ResourcePreloader::TakeTexture(const std::filesystem::path& file_path, const TextureLoadOptions& options)
+{
+    const std::wstring file_key = FileKey(file_path);
+    std::unique_lock<std::mutex> lock(preload_mutex);
+    if (prepared_textures.empty() && queued_jobs.empty() && running_by_file.empty())
+    {
+        return nullptr;
+    }
+
+    ClaimFile(lock, file_key);
+    std::unique_ptr<PreparedTexture> texture;
+    auto prepared = prepared_textures.find(TextureKey(file_key, options));
+    if (prepared != prepared_textures.end())
+    {
+        texture = std::move(prepared->second);
+        prepared_textures.erase(prepared);
+    }
+
+    // Whatever else was prepared for this file used options the script did not load it with.
+    // Nothing would ever take it, so it would hold its memory until shutdown.
+    const std::wstring file_prefix = file_key + L"|";
+    size_t dropped = 0;
+    for (auto entry = prepared_textures.begin(); entry != prepared_textures.end();)
+    {
+        if (entry->first.compare(0, file_prefix.size(), file_prefix) == 0)
+        {
+            entry = prepared_textures.erase(entry);
+            dropped++;
+        }
+        else
+        {
+            ++entry;
+        }
+    }
+    if (dropped)
+    {
+        PLOG_WARNING << "Dropped " << dropped << " preloaded version(s) of \"" << file_path.string()
+                     << "\" whose manifest options differ from the ones it was loaded with.";
+    }
+
+    return texture;
+}
+
+void ResourcePreloader::WaitFor(const std::filesystem::path& file_path)
+{
+    const std::wstring file_key = FileKey(file_path);
+    std::unique_lock<std::mutex> lock(preload_mutex);
+    ClaimFile(lock, file_key);
+}
+
+void ResourcePreloader::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex);
+        stopping = true;
+        queued_jobs.clear();
+    }
+    jobs_changed.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(preload_mutex);
+    workers.clear();
+    running_by_file.clear();
+    prepared_textures.clear();
+    started_packages.clear();
+    progress_by_package.clear();
+    stopping = false;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file resource_preloader.h
+ * @brief Loads the textures and sounds a package declares in its manifest.lua on worker threads.
+ *
+ * Without a manifest a package loads everything the first time its main chunk asks, so enabling
+ * a large package (or applying a profile that enables several) decodes a burst of images in one
+ * frame. Packages are started here as soon as they are discovered, long before they are enabled:
+ * a small pool of workers decodes, resizes and compresses each declared texture (see
+ * TextureLoader::Prepare) and reads each declared sound file through the OS cache (extracting it
+ * first when it lives in a .ufpak archive). Only the GPU upload is left for LoadTexture.
+ *
+ * Scripts can poll IsReady before loading. A load that does not wait takes over the work: a
+ * preload that has not started yet is dropped and the load runs as usual, and one that is already
+ * running is waited for rather than repeated.
+ */
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+#include "core\package_manifest.h"
+#include "core\texture_loader.h"
+
+/**
+ * @brief Preload counts for one package.
+ */
+struct PreloadProgress
+{
+    size_t total    = 0;    // Textures and sounds declared
+    size_t finished = 0;    // Done, failed or taken over by a load, failures included
+    size_t failed   = 0;
+};
+
+class ResourcePreloader
+{
+    public:
+        /**
+         * @brief Queues a package's declared textures and sounds. Later calls for the same
+         * package do nothing. Fonts are not handled here; they must be added on the render
+         * thread (see FontManager::Preload).
+         */
+        static void Start(const std::filesystem::path& package_dir, const PackageManifest& manifest);
+
+        /**
+         * @brief Reports whether a file has no preload queued or running, so loading it will not
+         * wait on a worker. Files no manifest declares are always ready.
+         */
+        static bool IsReady(const std::filesystem::path& file_path);
+
+        /**
+         * @brief Returns a package's preload counts (all zero for packages without a manifest).
+         */
+        static PreloadProgress GetProgress(const std::filesystem::path& package_dir);
+
+        /**
+         * @brief Hands over a preloaded texture, waiting for it when its preload is running.
+         *
+         * Versions of the file preloaded with other options are released (and logged), since a
+         * manifest entry that does not match the script's load would otherwise never be taken.
+         *
+         * @return The prepared image, or nullptr when none was preloaded with these options (or
+         * the preload failed); the caller then loads the texture itself.
+         */
+        static std::unique_ptr<PreparedTexture> TakeTexture(const std::filesystem::path& file_path, const TextureLoadOptions& options);
+
+        /**
+         * @brief Makes sure no worker is touching a file: drops its queued preloads and waits
+         * for running ones.
+         */
+        static void WaitFor(const std::filesystem::path& file_path);
+
+        /**
+         * @brief Stops the workers and frees every preloaded image nobody took. Called during
+         * core cleanup.
+         */
+        static void Shutdown();
+};
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <Windows.h>
+
+#include <plog/Log.h>
+
+#include "core\package_archive.h"
+#include "core\resource_vfs.h"
+#include "core\ufpak_format.h"
+
+namespace
+{
+    // One indexed resources folder. Keys are relative paths, lowercased with backslash
+    // separators, since Windows paths are case-insensitive.
+    struct IndexedRoot
+    {
+        std::filesystem::path directory;
+        std::unordered_map<std::string, std::filesystem::path> files;
+        HANDLE change_notification = INVALID_HANDLE_VALUE;
+        bool indexed = false;
+
+        ~IndexedRoot()
+        {
+            if (change_notification != INVALID_HANDLE_VALUE)
+            {
+                FindCloseChangeNotification(change_notification);
+            }
+        }
+    };
+
+    std::mutex vfs_mutex;
+    std::filesystem::path shared_directory;
+    std::unordered_map<std::wstring, std::unique_ptr<IndexedRoot>> roots;
+    ResourceVfsStats stats;
+
+    void BuildIndex(IndexedRoot& root)
+    {
+        root.files.clear();
+        root.indexed = true;
+        stats.index_builds++;
+
+        // Folders inside a mounted archive are indexed from its entry names. Archives do not
+        // change while mounted, so they need no change notification.
+        std::string archive_key;
+        if (const PackageArchive* archive = PackageArchive::Locate(root.directory, archive_key))
+        {
+            for (const std::string& key : archive->ListDirectory(archive_key))
+            {
+                root.files.emplace(key, root.directory / key);
+            }
+            stats.indexed_files += root.files.size();
+            PLOG_DEBUG << "Indexed " << root.files.size() << " archived resources in " << root.directory.string();
+            return;
+        }
+
+        std::error_code ec;
+        if (!std::filesystem::is_directory(root.directory, ec))
+        {
+            return;
+        }
+
+        // Arm the notification before walking, so a change made during the walk still
+        // triggers a rebuild.
+        if (root.change_notification == INVALID_HANDLE_VALUE)
+        {
+            root.change_notification = FindFirstChangeNotificationW(root.directory.wstring().c_str(), TRUE,
+                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME);
+        }
+        else
+        {
+            FindNextChangeNotification(root.change_notification);
+        }
+
+        auto iterator = std::filesystem::recursive_directory_iterator(root.directory,
+            std::filesystem::directory_options::skip_permission_denied, ec);
+        for (; !ec && iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(ec))
+        {
+            if (!iterator->is_regular_file(ec))
+            {
+                continue;
+            }
+
+            std::string key;
+            if (Ufpak::NormalizeKey(iterator->path().lexically_relative(root.directory).string(), key))
+            {
+                root.files.emplace(std::move(key), iterator->path());
+            }
+        }
+
+        stats.indexed_files += root.files.size();
+        PLOG_DEBUG << "Indexed " << root.files.size() << " resources in " << root.directory.string();
+    }
+
+    IndexedRoot& GetRoot(const std::filesystem::path& directory)
+    {
+        std::unique_ptr<IndexedRoot>& root = roots[directory.wstring()];
+        if (!root)
+        {
+            root = std::make_unique<IndexedRoot>();
+            root->directory = directory;
+        }
+
+        // A signalled notification means files were added, removed or renamed under the root.
+        const bool changed = root->change_notification != INVALID_HANDLE_VALUE
+            && WaitForSingleObject(root->change_notification, 0) == WAIT_OBJECT_0;
+        if (!root->indexed || changed)
+        {
+            stats.indexed_files -= root->files.size();
+            BuildIndex(*root);
+        }
+        return *root;
+    }
+
+    const std::filesystem::path* FindInRoot(const std::filesystem::path& directory, const std::string& key)
+    {
+        IndexedRoot& root = GetRoot(directory);
+        auto file = root.files.find(key);
+        return (file == root.files.end()) ? nullptr : &file->second;
+    }
+}
+
+void ResourceVfs::SetSharedDirectory(const std::filesystem::path& directory_path)
+{
+    std::lock_guard<std::mutex> lock(vfs_mutex);
+    shared_directory = directory_path;
+}
+
+std::filesystem::path ResourceVfs::Resolve(const std::string& path, const std::string& package_resources_dir)
+{
+    std::filesystem::path resource_path(path);
+    if (!resource_path.is_relative())
+    {
+        return resource_path;
+    }
+
+    std::lock_guard<std::mutex> lock(vfs_mutex);
+    const auto start_time = std::chrono::steady_clock::now();
+    stats.lookups++;
+
+    std::filesystem::path resolved;
+    std::string key;
+    if (Ufpak::NormalizeKey(path, key))
+    {
+        const std::filesystem::path* found = nullptr;
+        if (!package_resources_dir.empty() && (found = FindInRoot(package_resources_dir, key)) != nullptr)
+        {
+            stats.package_hits++;
+        }
+        else if ((found = FindInRoot(shared_directory, key)) != nullptr)
+        {
+            stats.shared_hits++;
+        }
+        else
+        {
+            // Archives may carry shared resources too, under the same folder name.
+            for (const std::filesystem::path& archive_path : PackageArchive::GetMountedPaths())
+            {
+                if ((found = FindInRoot(archive_path / shared_directory.filename(), key)) != nullptr)
+                {
+                    break;
+                }
+            }
+            (found ? stats.shared_hits : stats.misses)++;
+        }
+        resolved = found ? *found : shared_directory / resource_path;
+    }
+    else
+    {
+        stats.disk_probes++;
+        std::error_code ec;
+        const std::filesystem::path local_path = std::filesystem::path(package_resources_dir) / resource_path;
+        resolved = (!package_resources_dir.empty() && std::filesystem::exists(local_path, ec)) ? local_path : shared_directory / resource_path;
+    }
+
+    stats.total_lookup_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+    return resolved;
+}
+
+void ResourceVfs::Invalidate()
+{
+    std::lock_guard<std::mutex> lock(vfs_mutex);
+    for (auto& [directory, root] : roots)
+    {
+        root->indexed = false;
+    }
+}
+
+ResourceVfsStats ResourceVfs::GetStats()
+{
+    std::lock_guard<std::mutex> lock(vfs_mutex);
+    return stats;
+}
+
+void ResourceVfs::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(vfs_mutex);
+    roots.clear();
+    stats.indexed_files = 0;
+}
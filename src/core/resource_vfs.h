@@ -0,0 +1,76 @@
+/**
+ * @file resource_vfs.h
+ * @brief Resolves the relative resource paths scripts pass to UiForge.LoadTexture and friends.
+ *
+ * A relative path is looked up in the calling package's resources folder first, then in the
+ * shared resources folder. Instead of probing the disk on every call, each folder is indexed
+ * once, the first time it is searched, into a hash map of lowercased relative paths, so a lookup
+ * is a string normalization and a map find. Each indexed folder carries a change notification
+ * handle; when files under it are added, removed or renamed, its index is rebuilt on the next
+ * lookup.
+ *
+ * Folders inside a mounted .ufpak archive (see package_archive.h) are indexed from the archive's
+ * entry names, and a resource missing from the shared folder is also looked for in the shared
+ * folder of each mounted archive.
+ *
+ * Lookups that the index cannot answer (paths with ".." in them) fall back to probing the disk.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Lookup counters, for the Lua API and logging.
+ */
+struct ResourceVfsStats
+{
+    uint64_t lookups            = 0;
+    uint64_t package_hits       = 0;    // Found in the calling package's resources folder
+    uint64_t shared_hits        = 0;    // Found in the shared resources folder
+    uint64_t misses             = 0;    // Found nowhere; the shared path is returned anyway
+    uint64_t disk_probes        = 0;    // Lookups the index could not answer
+    uint64_t index_builds       = 0;    // Folders indexed, including rebuilds after changes
+    uint64_t indexed_files      = 0;    // Files in every live index
+    uint64_t total_lookup_us    = 0;    // Time spent in Resolve, index builds included
+};
+
+class ResourceVfs
+{
+    public:
+        /**
+         * @brief Sets the shared resources folder searched after a package's own.
+         */
+        static void SetSharedDirectory(const std::filesystem::path& directory_path);
+
+        /**
+         * @brief Resolves a resource path the way scripts expect.
+         *
+         * Absolute paths are returned unchanged. Relative paths resolve against the package's
+         * resources folder when the file exists there, otherwise against the shared folder. A
+         * path found in neither still resolves against the shared folder, so the caller's own
+         * "file not found" handling names the expected location.
+         *
+         * @param path The path as the script gave it.
+         * @param package_resources_dir The calling package's resources folder, or "" for none.
+         * @return The full path.
+         */
+        static std::filesystem::path Resolve(const std::string& path, const std::string& package_resources_dir);
+
+        /**
+         * @brief Drops every index, so the next lookup in each folder rebuilds it.
+         */
+        static void Invalidate();
+
+        /**
+         * @brief Returns the lookup counters since the core started.
+         */
+        static ResourceVfsStats GetStats();
+
+        /**
+         * @brief Drops every index and closes the change notification handles. Called during core cleanup.
+         */
+        static void Shutdown();
+};
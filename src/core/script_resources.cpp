@@ -0,0 +1,44 @@
+#include <plog/Log.h>
+
+#include "core\animation_manager.h"
+#include "core\audio_manager.h"
+#include "core\font_manager.h"
+#include "core\graphics_api.h"
+#include "core\particle_system.h"
+#include "core\script_resources.h"
+#include "core\sdf_font.h"
+
+void ScriptResources::ReleaseOwnedBy(uint32_t owner)
+{
+    if (owner == 0)
+    {
+        return;
+    }
+
+    const ScriptResourceUsage usage = GetUsage(owner);
+    const size_t count = usage.textures.count + usage.sounds.count + usage.animations.count + usage.sdf_fonts.count
+                       + usage.particle_systems.count;
+    if (count > 0)
+    {
+        PLOG_DEBUG << "Reclaiming " << count << " resources (" << usage.TotalBytes() << " bytes) from script owner " << owner;
+    }
+
+    IGraphicsApi::ReleaseScriptTexturesOwnedBy(owner);
+    AudioManager::ReleaseOwnedBy(owner);
+    AnimationManager::ReleaseOwnedBy(owner);
+    SdfFontManager::ReleaseOwnedBy(owner);
+    ParticleSystemManager::ReleaseOwnedBy(owner);
+    FontManager::ForgetOwner(owner);
+}
+
+ScriptResourceUsage ScriptResources::GetUsage(uint32_t owner)
+{
+    ScriptResourceUsage usage;
+    usage.textures   = IGraphicsApi::GetScriptTextureUsage(owner);
+    usage.sounds     = AudioManager::GetUsage(owner);
+    usage.animations = AnimationManager::GetUsage(owner);
+    usage.sdf_fonts  = SdfFontManager::GetUsage(owner);
+    usage.particle_systems = ParticleSystemManager::GetUsage(owner);
+    usage.fonts      = FontManager::GetUsage(owner);
+    return usage;
+}
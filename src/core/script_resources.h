@@ -0,0 +1,49 @@
+/**
+ * @file script_resources.h
+ * @brief Per-script accounting of the resources scripts create through the UiForge table.
+ *
+ * Every texture, sound, animation, SDF font and particle system a script creates is tagged with
+ * the script's owner id (ForgeScript::GetResourceOwner). When the script is disabled or reloaded,
+ * whatever it still owns is released, so a script that forgets to clean up does not leak video
+ * memory on every hot reload. Scripts hand a resource over to the core with the UiForge.Keep*
+ * functions when it must outlive them; kept resources are released explicitly or on eject.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "core\handle_table.h"
+
+/**
+ * @brief The live resources one script owns, by kind.
+ */
+struct ScriptResourceUsage
+{
+    ResourceUsage textures;
+    ResourceUsage sounds;
+    ResourceUsage animations;
+    ResourceUsage sdf_fonts;
+    ResourceUsage particle_systems;
+    ResourceUsage fonts;
+
+    size_t TotalBytes() const
+    {
+        return textures.bytes + sounds.bytes + animations.bytes + sdf_fonts.bytes + particle_systems.bytes + fonts.bytes;
+    }
+};
+
+namespace ScriptResources
+{
+    /**
+     * @brief Releases every resource owned by a script. Owner 0 (the core) is ignored.
+     *
+     * Textures are invalidated at once and released once the GPU is done with them; fonts stay
+     * in the shared atlas and only stop being counted against the script.
+     */
+    void ReleaseOwnedBy(uint32_t owner);
+
+    /**
+     * @brief Counts the live resources owned by a script, with estimated memory use.
+     */
+    ScriptResourceUsage GetUsage(uint32_t owner);
+}
@@ -0,0 +1,599 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <plog/Log.h>
+
+// ImGui ships stb_truetype for its own atlas, compiled static into imgui_draw.cpp; this is a
+// separate static copy for the SDF glyph worker.
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <imstb_truetype.h>
+
+#include "core\font_manager.h"
+#include "core\graphics_api.h"
+#include "core\mapped_file.h"
+#include "core\sdf_font.h"
+#include "core\sdf_generator.h"
+
+namespace
+{
+    // Glyphs are rasterized at FIELD_PIXEL_HEIGHT, OVERSAMPLE times finer than the field they are
+    // reduced to. FIELD_SPREAD texels on each side of the outline are enough for the shader's
+    // antialiasing at any size down to a few pixels.
+    constexpr float FIELD_PIXEL_HEIGHT  = 40.0f;
+    constexpr int   OVERSAMPLE          = 4;
+    constexpr float FIELD_SPREAD        = 4.0f;
+
+    // The atlas is ATLAS_WIDTH texels wide and grows in height as it fills.
+    constexpr int ATLAS_WIDTH           = 1024;
+    constexpr int INITIAL_ATLAS_HEIGHT  = 256;
+    constexpr int MAX_ATLAS_HEIGHT      = 4096;
+
+    struct GeneratedGlyph
+    {
+        unsigned int codepoint;
+        int width;                  // Field size in texels, 0 for glyphs with no outline
+        int height;
+        float offset_x;             // Top-left of the field relative to the pen, in field texels
+        float offset_y;
+        std::vector<uint8_t> field;
+    };
+
+    // A rectangle of the atlas that changed since it was last uploaded.
+    struct AtlasRect
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    struct Glyph
+    {
+        float advance   = 0.0f;     // In field texels
+        bool ready      = false;
+        bool visible    = false;    // False for whitespace and glyphs that did not fit the atlas
+        int atlas_x     = 0;
+        int atlas_y     = 0;
+        int width       = 0;
+        int height      = 0;
+        float offset_x  = 0.0f;
+        float offset_y  = 0.0f;
+    };
+
+    struct SdfFace
+    {
+        std::filesystem::path file_path;
+        MappedFile file;
+        stbtt_fontinfo info = {};   // Read-only once loaded; shared with the worker
+        float field_scale   = 0.0f; // Font units to field texels
+        float ascent        = 0.0f; // In field texels
+        float line_height   = 0.0f;
+
+        // Render thread only.
+        std::unordered_map<unsigned int, Glyph> glyphs;
+        std::vector<uint8_t> atlas_pixels;      // One byte per texel, the distance field
+        int atlas_height    = 0;
+        int shelf_x         = 0;
+        int shelf_y         = 0;
+        int shelf_height    = 0;
+        std::vector<AtlasRect> dirty_rects;     // Not yet copied to atlas_texture
+        bool atlas_full     = false;
+        void* atlas_texture = nullptr;          // Dynamic, single channel
+        int texture_height  = 0;                // Height atlas_texture was created with
+        int last_update_frame = -1;
+
+        // Shared with the worker, under mutex.
+        std::mutex mutex;
+        std::condition_variable requests_changed;
+        std::deque<unsigned int> requests;
+        std::vector<GeneratedGlyph> generated;
+
+        std::atomic<bool> stop { false };
+        std::thread worker;
+    };
+
+    HandleTable<std::unique_ptr<SdfFace>> faces;
+
+    SdfFace* FindFace(ResourceHandle font_id)
+    {
+        std::unique_ptr<SdfFace>* face = faces.Find(font_id);
+        return face ? face->get() : nullptr;
+    }
+
+    GeneratedGlyph GenerateGlyph(const SdfFace* face, unsigned int codepoint)
+    {
+        GeneratedGlyph glyph = { codepoint, 0, 0, 0.0f, 0.0f, {} };
+
+        const float scale = face->field_scale * OVERSAMPLE;
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        stbtt_GetCodepointBitmapBox(&face->info, (int)codepoint, scale, scale, &x0, &y0, &x1, &y1);
+        if (x1 <= x0 || y1 <= y0)
+        {
+            return glyph;
+        }
+
+        // Leave room for the field to fall off around the outline, and round up to whole texels.
+        const int padding = (int)FIELD_SPREAD * OVERSAMPLE;
+        const int width   = ((x1 - x0 + 2 * padding + OVERSAMPLE - 1) / OVERSAMPLE) * OVERSAMPLE;
+        const int height  = ((y1 - y0 + 2 * padding + OVERSAMPLE - 1) / OVERSAMPLE) * OVERSAMPLE;
+
+        std::vector<uint8_t> coverage((size_t)width * height, 0);
+        stbtt_MakeCodepointBitmap(&face->info, coverage.data() + (size_t)padding * width + padding,
+                                  x1 - x0, y1 - y0, width, scale, scale, (int)codepoint);
+
+        if (!SdfGenerator::FromCoverage(coverage.data(), width, height, (size_t)width, OVERSAMPLE, FIELD_SPREAD,
+                                        glyph.field, glyph.width, glyph.height))
+        {
+            glyph.width = glyph.height = 0;
+            return glyph;
+        }
+
+        glyph.offset_x = (float)(x0 - padding) / OVERSAMPLE;
+        glyph.offset_y = (float)(y0 - padding) / OVERSAMPLE;
+        return glyph;
+    }
+
+    void GenerateGlyphs(SdfFace* face)
+    {
+        while (true)
+        {
+            unsigned int codepoint = 0;
+            {
+                std::unique_lock<std::mutex> lock(face->mutex);
+                face->requests_changed.wait(lock, [face] { return face->stop || !face->requests.empty(); });
+                if (face->stop)
+                {
+                    return;
+                }
+                codepoint = face->requests.front();
+                face->requests.pop_front();
+            }
+
+            GeneratedGlyph glyph = GenerateGlyph(face, codepoint);
+
+            std::lock_guard<std::mutex> lock(face->mutex);
+            face->generated.push_back(std::move(glyph));
+        }
+    }
+
+    // Finds room for a width x height block on the current shelf or a new one, growing the atlas
+    // when it runs out of shelves. Blocks are kept a texel apart so filtering never reads a
+    // neighbour.
+    bool PackGlyph(SdfFace* face, int width, int height, int& out_x, int& out_y)
+    {
+        if (width + 1 > ATLAS_WIDTH)
+        {
+            return false;
+        }
+
+        if (face->shelf_x + width + 1 > ATLAS_WIDTH)
+        {
+            face->shelf_y       += face->shelf_height;
+            face->shelf_x        = 0;
+            face->shelf_height   = 0;
+        }
+
+        const int needed_height = face->shelf_y + height + 1;
+        if (needed_height > face->atlas_height)
+        {
+            int new_height = std::max(face->atlas_height, INITIAL_ATLAS_HEIGHT);
+            while (new_height < needed_height)
+            {
+                new_height *= 2;
+            }
+            if (new_height > MAX_ATLAS_HEIGHT)
+            {
+                return false;
+            }
+
+            // New rows are empty field; existing rows keep their place, so only V changes.
+            face->atlas_pixels.resize((size_t)ATLAS_WIDTH * new_height, 0);
+            face->atlas_height = new_height;
+        }
+
+        out_x = face->shelf_x;
+        out_y = face->shelf_y;
+        face->shelf_x      += width + 1;
+        face->shelf_height  = std::max(face->shelf_height, height + 1);
+        return true;
+    }
+
+    // Records a glyph's block as changed. Glyphs on one shelf merge into one rectangle, so a frame
+    // usually uploads a strip or two rather than the atlas.
+    void MarkDirty(SdfFace* face, int x, int y, int width, int height)
+    {
+        if (!face->dirty_rects.empty())
+        {
+            AtlasRect& last = face->dirty_rects.back();
+            if (last.y == y)
+            {
+                const int right = std::max(last.x + last.width, x + width);
+                last.x      = std::min(last.x, x);
+                last.width  = right - last.x;
+                last.height = std::max(last.height, height);
+                return;
+            }
+        }
+        face->dirty_rects.push_back({ x, y, width, height });
+    }
+
+    // Copies the changed parts of the atlas to its texture. Growing the atlas needs a taller
+    // texture, which starts from the whole atlas; the old one goes through the deferred release
+    // queue for the frames still in flight.
+    void UploadAtlas(SdfFace* face)
+    {
+        if (face->atlas_height == 0 || !IGraphicsApi::CreateDynamicTexture || !IGraphicsApi::UpdateTexture)
+        {
+            return;
+        }
+
+        if (!face->atlas_texture || face->texture_height != face->atlas_height)
+        {
+            void* texture = IGraphicsApi::CreateDynamicTexture(ATLAS_WIDTH, face->atlas_height, PixelFormat::Gray8);
+            if (!texture)
+            {
+                return;
+            }
+            IGraphicsApi::QueueTextureRelease(face->atlas_texture);
+            face->atlas_texture  = texture;
+            face->texture_height = face->atlas_height;
+            face->dirty_rects.assign(1, { 0, 0, ATLAS_WIDTH, face->atlas_height });
+        }
+
+        for (const AtlasRect& rect : face->dirty_rects)
+        {
+            const uint8_t* pixels = face->atlas_pixels.data() + (size_t)rect.y * ATLAS_WIDTH + rect.x;
+            if (!IGraphicsApi::UpdateTexture(face->atlas_texture, rect.x, rect.y, rect.width, rect.height, pixels, ATLAS_WIDTH))
+            {
+                // Start over from the whole atlas next frame.
+                IGraphicsApi::QueueTextureRelease(face->atlas_texture);
+                face->atlas_texture  = nullptr;
+                face->texture_height = 0;
+                break;
+            }
+        }
+        face->dirty_rects.clear();
+    }
+
+    // Moves glyphs the worker finished into the atlas and uploads what changed. Runs once per
+    // frame per face, before the face is first drawn in that frame.
+    void UpdateAtlas(SdfFace* face)
+    {
+        const int frame_number = ImGui::GetFrameCount();
+        if (frame_number == face->last_update_frame)
+        {
+            return;
+        }
+        face->last_update_frame = frame_number;
+
+        std::vector<GeneratedGlyph> generated;
+        {
+            std::lock_guard<std::mutex> lock(face->mutex);
+            generated.swap(face->generated);
+        }
+
+        for (const GeneratedGlyph& generated_glyph : generated)
+        {
+            Glyph& glyph = face->glyphs[generated_glyph.codepoint];
+            glyph.ready = true;
+            if (generated_glyph.width == 0)
+            {
+                continue;
+            }
+
+            int x = 0;
+            int y = 0;
+            if (!PackGlyph(face, generated_glyph.width, generated_glyph.height, x, y))
+            {
+                if (!face->atlas_full)
+                {
+                    PLOG_WARNING << "SDF atlas for " << face->file_path.string() << " is full; further glyphs are skipped.";
+                    face->atlas_full = true;
+                }
+                continue;
+            }
+
+            for (int row = 0; row < generated_glyph.height; ++row)
+            {
+                memcpy(face->atlas_pixels.data() + (size_t)(y + row) * ATLAS_WIDTH + x,
+                       generated_glyph.field.data() + (size_t)row * generated_glyph.width, generated_glyph.width);
+            }
+            MarkDirty(face, x, y, generated_glyph.width, generated_glyph.height);
+
+            glyph.visible   = true;
+            glyph.atlas_x   = x;
+            glyph.atlas_y   = y;
+            glyph.width     = generated_glyph.width;
+            glyph.height    = generated_glyph.height;
+            glyph.offset_x  = generated_glyph.offset_x;
+            glyph.offset_y  = generated_glyph.offset_y;
+        }
+
+        if (!face->dirty_rects.empty() || (face->atlas_height && !face->atlas_texture))
+        {
+            UploadAtlas(face);
+        }
+    }
+
+    // Returns the glyph for a codepoint, queueing it for the worker the first time it is seen.
+    // The advance is known straight away, so text lays out correctly before the glyph is ready.
+    const Glyph& RequestGlyph(SdfFace* face, unsigned int codepoint)
+    {
+        auto existing = face->glyphs.find(codepoint);
+        if (existing != face->glyphs.end())
+        {
+            return existing->second;
+        }
+
+        int advance = 0;
+        int left_side_bearing = 0;
+        stbtt_GetCodepointHMetrics(&face->info, (int)codepoint, &advance, &left_side_bearing);
+
+        Glyph& glyph = face->glyphs[codepoint];
+        glyph.advance = advance * face->field_scale;
+        {
+            std::lock_guard<std::mutex> lock(face->mutex);
+            face->requests.push_back(codepoint);
+        }
+        face->requests_changed.notify_one();
+        return glyph;
+    }
+
+    // Decodes one UTF-8 sequence, advancing text. Malformed bytes decode as U+FFFD.
+    unsigned int DecodeUtf8(const char*& text, const char* end)
+    {
+        const unsigned char lead = (unsigned char)*text++;
+        int length = 0;
+        unsigned int codepoint = 0;
+        if      (lead < 0x80)           { return lead; }
+        else if ((lead & 0xE0) == 0xC0) { length = 1; codepoint = lead & 0x1F; }
+        else if ((lead & 0xF0) == 0xE0) { length = 2; codepoint = lead & 0x0F; }
+        else if ((lead & 0xF8) == 0xF0) { length = 3; codepoint = lead & 0x07; }
+        else                            { return 0xFFFD; }
+
+        for (int i = 0; i < length; ++i)
+        {
+            if (text >= end || ((unsigned char)*text & 0xC0) != 0x80)
+            {
+                return 0xFFFD;
+            }
+            codepoint = (codepoint << 6) | ((unsigned char)*text++ & 0x3F);
+        }
+        return codepoint;
+    }
+
+    // Walks the text, calling on_glyph(glyph, x, baseline_y) with positions relative to the top
+    // left of the text at the given size, and returns the size of the laid-out block.
+    template <typename GlyphCallback>
+    ImVec2 LayoutText(SdfFace* face, const std::string& text, float size, GlyphCallback&& on_glyph)
+    {
+        const float scale       = size / FIELD_PIXEL_HEIGHT;
+        const float line_height = face->line_height * scale;
+
+        float pen_x     = 0.0f;
+        float widest    = 0.0f;
+        int lines       = 1;
+        unsigned int previous = 0;
+
+        const char* cursor = text.data();
+        const char* end    = text.data() + text.size();
+        while (cursor < end)
+        {
+            const unsigned int codepoint = DecodeUtf8(cursor, end);
+            if (codepoint == '\n')
+            {
+                widest   = std::max(widest, pen_x);
+                pen_x    = 0.0f;
+                previous = 0;
+                lines++;
+                continue;
+            }
+            if (codepoint == '\r')
+            {
+                continue;
+            }
+
+            if (previous)
+            {
+                pen_x += stbtt_GetCodepointKernAdvance(&face->info, (int)previous, (int)codepoint) * face->field_scale * scale;
+            }
+
+            const Glyph& glyph = RequestGlyph(face, codepoint);
+            on_glyph(glyph, pen_x, (lines - 1) * line_height + face->ascent * scale);
+            pen_x   += glyph.advance * scale;
+            previous = codepoint;
+        }
+
+        return ImVec2(std::max(widest, pen_x), lines * line_height);
+    }
+}
+
+ResourceHandle SdfFontManager::Load(const std::filesystem::path& file_path, uint32_t owner)
+{
+    auto face = std::make_unique<SdfFace>();
+    face->file_path = file_path;
+
+    if (!face->file.Open(file_path))
+    {
+        PLOG_WARNING << "LoadSdfFont could not open \"" << file_path.string() << "\".";
+        return 0;
+    }
+
+    const unsigned char* data = face->file.Data();
+    const int offset = stbtt_GetFontOffsetForIndex(data, 0);
+    if (offset < 0 || !stbtt_InitFont(&face->info, data, offset))
+    {
+        PLOG_WARNING << "LoadSdfFont could not read \"" << file_path.string() << "\" as a font.";
+        return 0;
+    }
+
+    int ascent = 0, descent = 0, line_gap = 0;
+    stbtt_GetFontVMetrics(&face->info, &ascent, &descent, &line_gap);
+    face->field_scale = stbtt_ScaleForPixelHeight(&face->info, FIELD_PIXEL_HEIGHT);
+    face->ascent      = ascent * face->field_scale;
+    face->line_height = (ascent - descent) * face->field_scale;
+
+    SdfFace* raw_face = face.get();
+    const ResourceHandle font_id = faces.Insert(std::move(face), owner);
+    if (font_id == 0)
+    {
+        PLOG_ERROR << "Out of SDF font handles.";
+        return 0;
+    }
+
+    try
+    {
+        raw_face->worker = std::thread(GenerateGlyphs, raw_face);
+    }
+    catch (const std::system_error& err)
+    {
+        PLOG_ERROR << "Failed to start SDF glyph worker: " << err.what();
+        faces.Remove(font_id);
+        return 0;
+    }
+
+    PLOG_DEBUG << "Loaded SDF font \"" << file_path.string() << "\"";
+    return font_id;
+}
+
+bool SdfFontManager::Text(ResourceHandle font_id, const std::string& text, float size, ImU32 color)
+{
+    SdfFace* face = FindFace(font_id);
+    if (!face)
+    {
+        return false;
+    }
+
+    if (!IGraphicsApi::SdfTextCallback)
+    {
+        // No SDF shader on this backend: ImGui's own dynamic font renders the same file.
+        ImFont* font = FontManager::Load(face->file_path, 0.0f);
+        ImGui::PushFont(font, size);
+        ImGui::PushStyleColor(ImGuiCol_Text, color);
+        ImGui::TextUnformatted(text.c_str(), text.c_str() + text.size());
+        ImGui::PopStyleColor();
+        ImGui::PopFont();
+        return true;
+    }
+
+    UpdateAtlas(face);
+
+    const float scale       = size / FIELD_PIXEL_HEIGHT;
+    const ImVec2 origin     = ImGui::GetCursorScreenPos();
+    ImDrawList* draw_list   = ImGui::GetWindowDrawList();
+    bool shader_bound       = false;
+
+    const ImVec2 text_size = LayoutText(face, text, size, [&](const Glyph& glyph, float x, float baseline_y)
+    {
+        // A glyph packed into rows the texture does not have yet (it failed to grow) waits.
+        if (!glyph.ready || !glyph.visible || !face->atlas_texture || glyph.atlas_y + glyph.height > face->texture_height)
+        {
+            return;
+        }
+
+        if (!shader_bound)
+        {
+            draw_list->AddCallback(IGraphicsApi::SdfTextCallback, nullptr);
+            shader_bound = true;
+        }
+
+        const ImVec2 p_min(origin.x + x + glyph.offset_x * scale, origin.y + baseline_y + glyph.offset_y * scale);
+        const ImVec2 p_max(p_min.x + glyph.width * scale, p_min.y + glyph.height * scale);
+        const ImVec2 uv_min((float)glyph.atlas_x / ATLAS_WIDTH, (float)glyph.atlas_y / face->texture_height);
+        const ImVec2 uv_max((float)(glyph.atlas_x + glyph.width) / ATLAS_WIDTH, (float)(glyph.atlas_y + glyph.height) / face->texture_height);
+        draw_list->AddImage(ImTextureRef(face->atlas_texture), p_min, p_max, uv_min, uv_max, color);
+    });
+
+    if (shader_bound)
+    {
+        draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+    }
+
+    ImGui::Dummy(text_size);
+    return true;
+}
+
+ImVec2 SdfFontManager::CalcTextSize(ResourceHandle font_id, const std::string& text, float size)
+{
+    SdfFace* face = FindFace(font_id);
+    if (!face)
+    {
+        return ImVec2(0.0f, 0.0f);
+    }
+
+    if (!IGraphicsApi::SdfTextCallback)
+    {
+        ImGui::PushFont(FontManager::Load(face->file_path, 0.0f), size);
+        const ImVec2 text_size = ImGui::CalcTextSize(text.c_str(), text.c_str() + text.size());
+        ImGui::PopFont();
+        return text_size;
+    }
+
+    return LayoutText(face, text, size, [](const Glyph&, float, float) {});
+}
+
+void SdfFontManager::Release(ResourceHandle font_id)
+{
+    SdfFace* face = FindFace(font_id);
+    if (!face)
+    {
+        return;
+    }
+
+    face->stop = true;
+    {
+        std::lock_guard<std::mutex> lock(face->mutex);
+        face->requests_changed.notify_all();
+    }
+    if (face->worker.joinable())
+    {
+        face->worker.join();
+    }
+
+    IGraphicsApi::QueueTextureRelease(face->atlas_texture);
+    faces.Remove(font_id);
+}
+
+void SdfFontManager::ReleaseAll()
+{
+    for (ResourceHandle font_id : faces.Handles())
+    {
+        Release(font_id);
+    }
+}
+
+void SdfFontManager::ReleaseOwnedBy(uint32_t owner)
+{
+    for (ResourceHandle font_id : faces.HandlesOwnedBy(owner))
+    {
+        Release(font_id);
+    }
+}
+
+bool SdfFontManager::Keep(ResourceHandle font_id)
+{
+    return faces.SetOwner(font_id, 0);
+}
+
+ResourceUsage SdfFontManager::GetUsage(uint32_t owner)
+{
+    ResourceUsage usage;
+    faces.ForEach([&](ResourceHandle, std::unique_ptr<SdfFace>& face, uint32_t face_owner)
+    {
+        if (face_owner == owner)
+        {
+            usage.count++;
+            usage.bytes += IGraphicsApi::GetTextureBytes(face->atlas_texture);
+        }
+    });
+    return usage;
+}
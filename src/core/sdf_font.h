@@ -0,0 +1,84 @@
+/**
+ * @file sdf_font.h
+ * @brief Scalable text drawn from one signed-distance-field atlas per font face.
+ *
+ * Regular ImGui fonts rasterize every glyph again for every size they are drawn at. An SDF font
+ * rasterizes each glyph once, at a fixed field resolution, as a signed distance field (see
+ * sdf_generator.h), and the graphics backend's SDF text shader rebuilds a sharp edge from it at
+ * whatever size the text is drawn. Changing the size is free: nothing is rasterized or uploaded.
+ *
+ * Glyphs are generated on a worker thread per face the first time they are drawn; a glyph that
+ * is not ready yet keeps its advance, so the layout does not shift when it appears. Finished
+ * glyphs are packed into the face's single-channel atlas on the render thread, and at most once
+ * per frame the rectangles they landed in are copied into its dynamic texture (see
+ * IGraphicsApi::UpdateTexture). Only growing the atlas creates a new texture.
+ *
+ * Backends without an SDF text shader (see IGraphicsApi::SdfTextCallback) fall back to drawing
+ * through a regular ImGui font of the same file, so scripts never need to check.
+ */
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include <imgui.h>
+
+#include "core\handle_table.h"
+
+class SdfFontManager
+{
+    public:
+        /**
+         * @brief Opens a TTF/OTF file as an SDF font and starts its glyph worker.
+         *
+         * @param file_path Full path to the font file.
+         * @param owner Owner tag recorded with the handle (see ReleaseOwnedBy).
+         * @return A positive font handle, or 0 on failure (logged).
+         */
+        static ResourceHandle Load(const std::filesystem::path& file_path, uint32_t owner = 0);
+
+        /**
+         * @brief Draws UTF-8 text at the cursor as one ImGui item.
+         *
+         * Must be called between ImGui::NewFrame and ImGui::Render. Newlines start a new line.
+         *
+         * @param font_id Handle returned by Load().
+         * @param text The text.
+         * @param size Line height in pixels, like the size given to ImGui.PushFont.
+         * @param color Text colour.
+         * @return False for a bad handle.
+         */
+        static bool Text(ResourceHandle font_id, const std::string& text, float size, ImU32 color);
+
+        /**
+         * @brief Measures UTF-8 text as Text() would lay it out. A bad handle measures 0x0.
+         */
+        static ImVec2 CalcTextSize(ResourceHandle font_id, const std::string& text, float size);
+
+        /**
+         * @brief Stops a font's worker and releases its atlas. The handle becomes invalid.
+         */
+        static void Release(ResourceHandle font_id);
+
+        /**
+         * @brief Releases every SDF font loaded with the given owner tag.
+         */
+        static void ReleaseOwnedBy(uint32_t owner);
+
+        /**
+         * @brief Hands a font over to the core (owner 0) so ReleaseOwnedBy leaves it alone.
+         *
+         * @return True when the handle was valid.
+         */
+        static bool Keep(ResourceHandle font_id);
+
+        /**
+         * @brief Counts the SDF fonts loaded with an owner tag and the GPU memory of their atlases.
+         */
+        static ResourceUsage GetUsage(uint32_t owner);
+
+        /**
+         * @brief Releases every SDF font. Called during core cleanup.
+         */
+        static void ReleaseAll();
+};
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cmath>
+
+#include "core\sdf_generator.h"
+
+namespace
+{
+    constexpr float INF = 1e20f;
+
+    // One-dimensional squared distance transform of a sampled function (Felzenszwalb and
+    // Huttenlocher): out[q] = min over p of (q - p)^2 + f[p]. The lower envelope of the parabolas
+    // rooted at every sample is built in one pass and read back in a second.
+    void DistanceTransform1D(const float* f, float* out, int n, int* envelope, float* boundaries)
+    {
+        int k = 0;
+        envelope[0]   = 0;
+        boundaries[0] = -INF;
+        boundaries[1] = INF;
+
+        for (int q = 1; q < n; ++q)
+        {
+            if (f[q] >= INF)
+            {
+                continue;
+            }
+
+            float s;
+            while (true)
+            {
+                const int p = envelope[k];
+                s = ((f[q] + (float)q * q) - (f[p] + (float)p * p)) / (2.0f * q - 2.0f * p);
+                if (s > boundaries[k] || k == 0)
+                {
+                    break;
+                }
+                k--;
+            }
+
+            if (f[envelope[k]] >= INF)
+            {
+                // Every earlier sample was at infinity; this one starts the envelope afresh.
+                envelope[k] = q;
+                continue;
+            }
+
+            k++;
+            envelope[k]       = q;
+            boundaries[k]     = s;
+            boundaries[k + 1] = INF;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q)
+        {
+            while (boundaries[k + 1] < q)
+            {
+                k++;
+            }
+            const int p = envelope[k];
+            out[q] = f[p] >= INF ? INF : (float)(q - p) * (q - p) + f[p];
+        }
+    }
+
+    // Squared distance from every pixel to the nearest pixel whose mask value is set.
+    void DistanceTransform2D(const std::vector<uint8_t>& mask, int width, int height, std::vector<float>& out)
+    {
+        const int longest = std::max(width, height);
+        std::vector<float> line_in(longest), line_out(longest), boundaries(longest + 1);
+        std::vector<int> envelope(longest);
+
+        out.resize((size_t)width * height);
+        for (size_t i = 0; i < out.size(); ++i)
+        {
+            out[i] = mask[i] ? 0.0f : INF;
+        }
+
+        for (int x = 0; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y) line_in[y] = out[(size_t)y * width + x];
+            DistanceTransform1D(line_in.data(), line_out.data(), height, envelope.data(), boundaries.data());
+            for (int y = 0; y < height; ++y) out[(size_t)y * width + x] = line_out[y];
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            float* row = out.data() + (size_t)y * width;
+            std::copy(row, row + width, line_in.begin());
+            DistanceTransform1D(line_in.data(), row, width, envelope.data(), boundaries.data());
+        }
+    }
+}
+
+bool SdfGenerator::FromCoverage(const uint8_t* coverage, int width, int height, size_t pitch, int downscale, float spread,
+                                std::vector<uint8_t>& out_field, int& out_width, int& out_height)
+{
+    if (!coverage || width <= 0 || height <= 0 || pitch < (size_t)width || downscale <= 0 || spread <= 0.0f)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> inside((size_t)width * height);
+    std::vector<uint8_t> outside((size_t)width * height);
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* row = coverage + (size_t)y * pitch;
+        for (int x = 0; x < width; ++x)
+        {
+            inside[(size_t)y * width + x]  = row[x] >= 128;
+            outside[(size_t)y * width + x] = row[x] < 128;
+        }
+    }
+
+    std::vector<float> to_inside, to_outside;
+    DistanceTransform2D(inside, width, height, to_inside);
+    DistanceTransform2D(outside, width, height, to_outside);
+
+    out_width  = (width + downscale - 1) / downscale;
+    out_height = (height + downscale - 1) / downscale;
+    out_field.assign((size_t)out_width * out_height, 0);
+
+    // Distances run between pixel centres, so the outline sits half a pixel short of either
+    // neighbour. Each field texel averages the signed distance over the pixels it covers.
+    const float texel_scale = 1.0f / (downscale * spread * 2.0f);
+    for (int field_y = 0; field_y < out_height; ++field_y)
+    {
+        for (int field_x = 0; field_x < out_width; ++field_x)
+        {
+            float sum   = 0.0f;
+            int samples = 0;
+            for (int y = field_y * downscale; y < std::min(height, (field_y + 1) * downscale); ++y)
+            {
+                for (int x = field_x * downscale; x < std::min(width, (field_x + 1) * downscale); ++x)
+                {
+                    const size_t i = (size_t)y * width + x;
+                    sum += inside[i] ? -(std::sqrt(to_outside[i]) - 0.5f) : (std::sqrt(to_inside[i]) - 0.5f);
+                    samples++;
+                }
+            }
+
+            // Without any inside (or outside) pixels the distances stay huge and clamp below.
+            const float distance = sum / samples;
+            const float value    = std::min(1.0f, std::max(0.0f, 0.5f - distance * texel_scale));
+            out_field[(size_t)field_y * out_width + field_x] = (uint8_t)std::lround(value * 255.0f);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file sdf_generator.h
+ * @brief Builds signed distance fields from rasterized glyph coverage.
+ *
+ * A glyph rasterized once at a few times its field resolution is thresholded and run through an
+ * exact Euclidean distance transform (Felzenszwalb and Huttenlocher), inside and outside, then
+ * reduced to the field resolution. The result stores, per texel, how far the texel centre is
+ * from the glyph outline, which a shader turns back into a crisp edge at any scale.
+ *
+ * The module has no platform or graphics dependencies, so it can be exercised on its own.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SdfGenerator
+{
+    /**
+     * @brief Converts an 8-bit coverage bitmap into an 8-bit signed distance field.
+     *
+     * Field values are 255 deep inside the glyph, 128 on the outline and 0 at spread texels or
+     * further outside it. The coverage bitmap should leave at least spread * downscale pixels of
+     * empty border around the glyph so the field can fall off to 0 before the edge.
+     *
+     * @param coverage First row of the coverage bitmap; 128 or more counts as inside.
+     * @param width Coverage width in pixels.
+     * @param height Coverage height in pixels.
+     * @param pitch Bytes from one coverage row to the next.
+     * @param downscale How many coverage pixels make up one field texel in each direction.
+     * @param spread Distance, in field texels, covered by the 0-255 range on each side of the outline.
+     * @param out_field Receives the tightly packed field.
+     * @param out_width Receives the field width, width / downscale rounded up.
+     * @param out_height Receives the field height, height / downscale rounded up.
+     * @return False when any argument is invalid.
+     */
+    bool FromCoverage(const uint8_t* coverage, int width, int height, size_t pitch, int downscale, float spread,
+                      std::vector<uint8_t>& out_field, int& out_width, int& out_height);
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include <imgui.h>
+#include <plog/Log.h>
+
+#include "core\lua_helpers.h"
+#include "core\string_list.h"
+
+namespace
+{
+    const char* GetItem(void* user_data, int index)
+    {
+        return static_cast<const StringList*>(user_data)->Get((size_t)index);
+    }
+
+    // The item count argument of the table overloads stays accepted, so a script switches to a
+    // StringList by changing only the table it passes; it can only shorten the list.
+    int ItemCount(lua_State* L, int index, const StringList* list)
+    {
+        const lua_Integer count = luaL_optinteger(L, index, (lua_Integer)list->Size());
+        return (int)std::clamp<lua_Integer>(count, 0, (lua_Integer)list->Size());
+    }
+
+    // ImGui.Combo(label, current_item, list[, items_count[, popup_max_height_in_items]])
+    //   -> current_item, changed
+    int Combo(lua_State* L)
+    {
+        const StringList* list = StringList::Test(L, 3);
+        if (!list)
+        {
+            return LuaHelpers::CallOriginal(L);
+        }
+
+        const char* label = luaL_checkstring(L, 1);
+        int current_item = (int)luaL_checkinteger(L, 2);
+        const int items_count = ItemCount(L, 4, list);
+        const int popup_max_height = (int)luaL_optinteger(L, 5, -1);
+
+        const bool changed = ImGui::Combo(label, &current_item, GetItem, (void*)list, items_count, popup_max_height);
+        lua_pushinteger(L, current_item);
+        lua_pushboolean(L, changed);
+        return 2;
+    }
+
+    // ImGui.ListBox(label, current_item, list[, items_count[, height_in_items]])
+    //   -> current_item, changed
+    int ListBox(lua_State* L)
+    {
+        const StringList* list = StringList::Test(L, 3);
+        if (!list)
+        {
+            return LuaHelpers::CallOriginal(L);
+        }
+
+        const char* label = luaL_checkstring(L, 1);
+        int current_item = (int)luaL_checkinteger(L, 2);
+        const int items_count = ItemCount(L, 4, list);
+        const int height_in_items = (int)luaL_optinteger(L, 5, -1);
+
+        const bool changed = ImGui::ListBox(label, &current_item, GetItem, (void*)list, items_count, height_in_items);
+        lua_pushinteger(L, current_item);
+        lua_pushboolean(L, changed);
+        return 2;
+    }
+
+    StringList* CheckList(lua_State* L)
+    {
+        StringList* list = StringList::Test(L, 1);
+        if (!list)
+        {
+            luaL_typerror(L, 1, StringList::METATABLE_NAME);
+        }
+        return list;
+    }
+
+    // list:Get(index) -> the entry, or nil when index is out of range
+    int ListGet(lua_State* L)
+    {
+        const StringList* list = CheckList(L);
+        const lua_Integer index = luaL_checkinteger(L, 2);
+        if (index < 0 || (size_t)index >= list->Size())
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+        lua_pushstring(L, list->Get((size_t)index));
+        return 1;
+    }
+
+    // list:Find(value) -> index of the first equal entry, or -1
+    int ListFind(lua_State* L)
+    {
+        const StringList* list = CheckList(L);
+        size_t length = 0;
+        const char* value = luaL_checklstring(L, 2, &length);
+        lua_pushinteger(L, list->Find(std::string_view(value, length)));
+        return 1;
+    }
+
+    int ListLength(lua_State* L)
+    {
+        lua_pushinteger(L, (lua_Integer)CheckList(L)->Size());
+        return 1;
+    }
+
+    int ListGc(lua_State* L)
+    {
+        if (StringList* list = StringList::Test(L, 1))
+        {
+            list->~StringList();
+        }
+        return 0;
+    }
+
+    // Pushes the shared metatable, creating it on first use.
+    void PushMetatable(lua_State* L)
+    {
+        if (luaL_newmetatable(L, StringList::METATABLE_NAME) == 0)
+        {
+            return;
+        }
+
+        lua_pushcfunction(L, ListGc);
+        lua_setfield(L, -2, "__gc");
+        lua_pushcfunction(L, ListLength);
+        lua_setfield(L, -2, "__len");
+
+        lua_newtable(L);
+        lua_pushcfunction(L, ListGet);
+        lua_setfield(L, -2, "Get");
+        lua_pushcfunction(L, ListFind);
+        lua_setfield(L, -2, "Find");
+        lua_pushcfunction(L, ListLength);
+        lua_setfield(L, -2, "Size");
+        lua_setfield(L, -2, "__index");
+    }
+}
+
+int StringList::Find(std::string_view value) const
+{
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        const uint32_t end = i + 1 < offsets.size() ? offsets[i + 1] - 1 : (uint32_t)text.size() - 1;
+        if (std::string_view(text.data() + offsets[i], end - offsets[i]) == value)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+StringList* StringList::Test(lua_State* L, int index)
+{
+    return static_cast<StringList*>(LuaHelpers::TestUserdata(L, index, METATABLE_NAME));
+}
+
+int StringList::LuaCreate(lua_State* L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    StringList list;
+    const size_t count = lua_objlen(L, 1);
+    list.offsets.reserve(count);
+    for (size_t i = 1; i <= count; ++i)
+    {
+        lua_rawgeti(L, 1, (int)i);
+        const int type = lua_type(L, -1);
+        if (type != LUA_TSTRING && type != LUA_TNUMBER)
+        {
+            return luaL_error(L, "StringList: item %d is a %s, not a string", (int)i, lua_typename(L, type));
+        }
+
+        size_t length = 0;
+        const char* item = lua_tolstring(L, -1, &length);
+        list.offsets.push_back((uint32_t)list.text.size());
+        list.text.insert(list.text.end(), item, item + length);
+        list.text.push_back('\0');
+        lua_pop(L, 1);
+    }
+
+    void* memory = lua_newuserdata(L, sizeof(StringList));
+    new (memory) StringList(std::move(list));
+    PushMetatable(L);
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+void StringList::InstallWidgetOverloads(lua_State* L)
+{
+    lua_getglobal(L, "ImGui");
+    if (!lua_istable(L, -1))
+    {
+        PLOG_WARNING << "ImGui bindings not found; Combo and ListBox will not accept StringLists";
+        lua_pop(L, 1);
+        return;
+    }
+
+    LuaHelpers::WrapFunction(L, "Combo", Combo);
+    LuaHelpers::WrapFunction(L, "ListBox", ListBox);
+    lua_pop(L, 1);
+}
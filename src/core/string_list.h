@@ -0,0 +1,57 @@
+/**
+ * @file string_list.h
+ * @brief Immutable native string lists for the Combo and ListBox widgets.
+ *
+ * The sol2 bindings for ImGui.Combo and ImGui.ListBox take a Lua table of items and copy every
+ * entry into a fresh vector of strings on every call, so a list of a few thousand names costs
+ * milliseconds a frame even while the combo is closed. UiForge.StringList(items) copies the
+ * table once into one contiguous, NUL-terminated buffer. ImGui.Combo and ImGui.ListBox also
+ * accept such a list in place of the table (with the same arguments otherwise) and hand ImGui a
+ * getter over it, so ImGui's list clipper only touches the entries that are visible.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <lua.hpp>
+
+class StringList
+{
+    public:
+        /** @brief Registry name of the userdata metatable. */
+        static constexpr const char* METATABLE_NAME = "UiForge.StringList";
+
+        size_t Size() const { return offsets.size(); }
+
+        /** @brief Returns the entry at index, which is 0-based like the widgets' current item. */
+        const char* Get(size_t index) const { return text.data() + offsets[index]; }
+
+        /** @brief Returns the index of the first entry equal to value, or -1. */
+        int Find(std::string_view value) const;
+
+        /**
+         * @brief Returns the StringList at a stack index, or nullptr when the value is anything
+         * else. Never raises.
+         */
+        static StringList* Test(lua_State* L, int index);
+
+        /**
+         * @brief UiForge.StringList(items). Copies an array of strings (numbers are converted)
+         * into a new list. Raises a Lua error for any other item.
+         */
+        static int LuaCreate(lua_State* L);
+
+        /**
+         * @brief Wraps ImGui.Combo and ImGui.ListBox so they accept a StringList as their items.
+         * Every other call goes to the original binding unchanged. Call once the sol2 ImGui
+         * bindings are registered.
+         */
+        static void InstallWidgetOverloads(lua_State* L);
+
+    private:
+        std::vector<char>       text;       // Every entry, each followed by a NUL
+        std::vector<uint32_t>   offsets;    // Start of each entry in text
+};
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <new>
+
+#include <imgui.h>
+#include <imgui_stdlib.h>
+#include <plog/Log.h>
+
+#include "core\lua_helpers.h"
+#include "core\text_buffer.h"
+
+namespace
+{
+    // Returns the buffer and whether the widget changed it, so the overloads stay drop-in for
+    // scripts written as `text, changed = ImGui.InputText(...)`.
+    int PushResult(lua_State* L, int buffer_index, bool changed)
+    {
+        lua_pushvalue(L, buffer_index);
+        lua_pushboolean(L, changed);
+        return 2;
+    }
+
+    // ImGui.InputText(label, buffer[, flags]) -> buffer, changed
+    int InputText(lua_State* L)
+    {
+        TextBuffer* buffer = TextBuffer::Test(L, 2);
+        if (!buffer)
+        {
+            return LuaHelpers::CallOriginal(L);
+        }
+
+        const char* label = luaL_checkstring(L, 1);
+        const ImGuiInputTextFlags flags = (ImGuiInputTextFlags)luaL_optinteger(L, 3, 0);
+        return PushResult(L, 2, ImGui::InputText(label, &buffer->text, flags));
+    }
+
+    // ImGui.InputTextWithHint(label, hint, buffer[, flags]) -> buffer, changed
+    int InputTextWithHint(lua_State* L)
+    {
+        TextBuffer* buffer = TextBuffer::Test(L, 3);
+        if (!buffer)
+        {
+            return LuaHelpers::CallOriginal(L);
+        }
+
+        const char* label = luaL_checkstring(L, 1);
+        const char* hint = luaL_checkstring(L, 2);
+        const ImGuiInputTextFlags flags = (ImGuiInputTextFlags)luaL_optinteger(L, 4, 0);
+        return PushResult(L, 3, ImGui::InputTextWithHint(label, hint, &buffer->text, flags));
+    }
+
+    // ImGui.InputTextMultiline(label, buffer[, width[, height[, flags]]]) -> buffer, changed
+    int InputTextMultiline(lua_State* L)
+    {
+        TextBuffer* buffer = TextBuffer::Test(L, 2);
+        if (!buffer)
+        {
+            return LuaHelpers::CallOriginal(L);
+        }
+
+        const char* label = luaL_checkstring(L, 1);
+        const ImVec2 size((float)luaL_optnumber(L, 3, 0.0), (float)luaL_optnumber(L, 4, 0.0));
+        const ImGuiInputTextFlags flags = (ImGuiInputTextFlags)luaL_optinteger(L, 5, 0);
+        return PushResult(L, 2, ImGui::InputTextMultiline(label, &buffer->text, size, flags));
+    }
+
+    TextBuffer* CheckBuffer(lua_State* L)
+    {
+        TextBuffer* buffer = TextBuffer::Test(L, 1);
+        if (!buffer)
+        {
+            luaL_typerror(L, 1, TextBuffer::METATABLE_NAME);
+        }
+        return buffer;
+    }
+
+    // buffer:Get() -> the text as a Lua string. The only call that creates one.
+    int BufferGet(lua_State* L)
+    {
+        const TextBuffer* buffer = CheckBuffer(L);
+        lua_pushlstring(L, buffer->text.data(), buffer->text.size());
+        return 1;
+    }
+
+    // buffer:Set(text)
+    int BufferSet(lua_State* L)
+    {
+        TextBuffer* buffer = CheckBuffer(L);
+        size_t length = 0;
+        const char* text = luaL_checklstring(L, 2, &length);
+        buffer->text.assign(text, length);
+        return 0;
+    }
+
+    // buffer:Append(text), for logs and consoles that only ever add to the end
+    int BufferAppend(lua_State* L)
+    {
+        TextBuffer* buffer = CheckBuffer(L);
+        size_t length = 0;
+        const char* text = luaL_checklstring(L, 2, &length);
+        buffer->text.append(text, length);
+        return 0;
+    }
+
+    // buffer:Clear() keeps the capacity
+    int BufferClear(lua_State* L)
+    {
+        CheckBuffer(L)->text.clear();
+        return 0;
+    }
+
+    int BufferLength(lua_State* L)
+    {
+        lua_pushinteger(L, (lua_Integer)CheckBuffer(L)->text.size());
+        return 1;
+    }
+
+    int BufferCapacity(lua_State* L)
+    {
+        lua_pushinteger(L, (lua_Integer)CheckBuffer(L)->text.capacity());
+        return 1;
+    }
+
+    // buffer:Reserve(capacity) grows the buffer ahead of time; it never shrinks
+    int BufferReserve(lua_State* L)
+    {
+        TextBuffer* buffer = CheckBuffer(L);
+        const lua_Integer capacity = luaL_checkinteger(L, 2);
+        luaL_argcheck(L, capacity >= 0, 2, "capacity must not be negative");
+        buffer->text.reserve((size_t)capacity);
+        return 0;
+    }
+
+    int BufferGc(lua_State* L)
+    {
+        if (TextBuffer* buffer = TextBuffer::Test(L, 1))
+        {
+            buffer->~TextBuffer();
+        }
+        return 0;
+    }
+
+    // Pushes the shared metatable, creating it on first use.
+    void PushMetatable(lua_State* L)
+    {
+        if (luaL_newmetatable(L, TextBuffer::METATABLE_NAME) == 0)
+        {
+            return;
+        }
+
+        lua_pushcfunction(L, BufferGc);
+        lua_setfield(L, -2, "__gc");
+        lua_pushcfunction(L, BufferLength);
+        lua_setfield(L, -2, "__len");
+        lua_pushcfunction(L, BufferGet);
+        lua_setfield(L, -2, "__tostring");
+
+        lua_newtable(L);
+        lua_pushcfunction(L, BufferGet);
+        lua_setfield(L, -2, "Get");
+        lua_pushcfunction(L, BufferSet);
+        lua_setfield(L, -2, "Set");
+        lua_pushcfunction(L, BufferAppend);
+        lua_setfield(L, -2, "Append");
+        lua_pushcfunction(L, BufferClear);
+        lua_setfield(L, -2, "Clear");
+        lua_pushcfunction(L, BufferLength);
+        lua_setfield(L, -2, "Length");
+        lua_pushcfunction(L, BufferCapacity);
+        lua_setfield(L, -2, "Capacity");
+        lua_pushcfunction(L, BufferReserve);
+        lua_setfield(L, -2, "Reserve");
+        lua_setfield(L, -2, "__index");
+    }
+}
+
+TextBuffer* TextBuffer::Test(lua_State* L, int index)
+{
+    return static_cast<TextBuffer*>(LuaHelpers::TestUserdata(L, index, METATABLE_NAME));
+}
+
+int TextBuffer::LuaCreate(lua_State* L)
+{
+    const lua_Integer capacity = luaL_optinteger(L, 1, 256);
+    luaL_argcheck(L, capacity >= 0, 1, "capacity must not be negative");
+    size_t length = 0;
+    const char* text = luaL_optlstring(L, 2, "", &length);
+
+    TextBuffer* buffer = new (lua_newuserdata(L, sizeof(TextBuffer))) TextBuffer();
+    PushMetatable(L);
+    lua_setmetatable(L, -2);
+
+    buffer->text.reserve(std::max((size_t)capacity, length));
+    buffer->text.assign(text, length);
+    return 1;
+}
+
+void TextBuffer::InstallWidgetOverloads(lua_State* L)
+{
+    lua_getglobal(L, "ImGui");
+    if (!lua_istable(L, -1))
+    {
+        PLOG_WARNING << "ImGui bindings not found; InputText will not accept TextBuffers";
+        lua_pop(L, 1);
+        return;
+    }
+
+    LuaHelpers::WrapFunction(L, "InputText", InputText);
+    LuaHelpers::WrapFunction(L, "InputTextWithHint", InputTextWithHint);
+    LuaHelpers::WrapFunction(L, "InputTextMultiline", InputTextMultiline);
+    lua_pop(L, 1);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file text_buffer.h
+ * @brief Persistent native text buffers that InputText widgets edit in place.
+ *
+ * The sol2 bindings for ImGui.InputText copy the script's string into a buffer on every call
+ * and return a new Lua string every frame, so a text field produces garbage proportional to
+ * its contents times the frame rate, and a multiline editor holding a large document slows
+ * down. UiForge.TextBuffer(capacity) holds the text natively instead. ImGui.InputText,
+ * ImGui.InputTextWithHint and ImGui.InputTextMultiline accept such a buffer in place of the
+ * string and edit it where it is, growing it when the text outgrows its capacity. The script
+ * reads the text back as a Lua string only when it asks for it, typically when the widget
+ * reports a change.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <lua.hpp>
+
+class TextBuffer
+{
+    public:
+        /** @brief Registry name of the userdata metatable. */
+        static constexpr const char* METATABLE_NAME = "UiForge.TextBuffer";
+
+        std::string text;   // Reserved to at least the requested capacity
+
+        /**
+         * @brief Returns the TextBuffer at a stack index, or nullptr when the value is anything
+         * else. Never raises.
+         */
+        static TextBuffer* Test(lua_State* L, int index);
+
+        /**
+         * @brief UiForge.TextBuffer([capacity[, text]]). Creates a buffer with room for capacity
+         * bytes before it has to grow, holding text.
+         */
+        static int LuaCreate(lua_State* L);
+
+        /**
+         * @brief Wraps ImGui.InputText, ImGui.InputTextWithHint and ImGui.InputTextMultiline so
+         * they accept a TextBuffer in place of the text. Every other call goes to the original
+         * binding unchanged. Call once the sol2 ImGui bindings are registered.
+         */
+        static void InstallWidgetOverloads(lua_State* L);
+};
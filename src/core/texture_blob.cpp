@@ -0,0 +1,137 @@
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#include "core\texture_blob.h"
+
+namespace
+{
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+bool TextureBlob::Write(const std::filesystem::path& file_path, const TextureImage& image, uint64_t source_hash, uint64_t source_size)
+{
+    if (image.mips.empty())
+    {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(file_path.parent_path(), ec);
+
+    BlobHeader header = {};
+    header.magic        = BLOB_MAGIC;
+    header.version      = BLOB_VERSION;
+    header.format       = (uint32_t)image.format;
+    header.mip_count    = (uint32_t)image.mips.size();
+    header.source_hash  = source_hash;
+    header.source_size  = source_size;
+
+    std::vector<BlobLevel> levels(image.mips.size());
+    uint64_t offset = AlignUp(sizeof(BlobHeader) + sizeof(BlobLevel) * levels.size(), BLOB_DATA_ALIGNMENT);
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        levels[i].offset = offset;
+        levels[i].size   = TextureFormats::LevelSize(image.format, image.mips[i].width, image.mips[i].height);
+        levels[i].width  = (uint32_t)image.mips[i].width;
+        levels[i].height = (uint32_t)image.mips[i].height;
+        offset = AlignUp(offset + levels[i].size, BLOB_DATA_ALIGNMENT);
+    }
+
+    // Written to a temp file and renamed into place, so a crash or a second process can never
+    // observe a half-written blob.
+    std::filesystem::path temp_path = file_path;
+    temp_path += ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)levels.data(), sizeof(BlobLevel) * levels.size());
+
+        const char padding[BLOB_DATA_ALIGNMENT] = {};
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            const uint64_t position = (uint64_t)out.tellp();
+            out.write(padding, (std::streamsize)(levels[i].offset - position));
+
+            const TextureMip& mip  = image.mips[i];
+            const size_t row_bytes = TextureFormats::RowPitch(image.format, mip.width);
+            const int row_count    = TextureFormats::RowCount(image.format, mip.height);
+            if (mip.row_pitch == row_bytes)
+            {
+                out.write((const char*)mip.data, (std::streamsize)levels[i].size);
+            }
+            else
+            {
+                for (int row = 0; row < row_count; ++row)
+                {
+                    out.write((const char*)mip.data + (size_t)row * mip.row_pitch, (std::streamsize)row_bytes);
+                }
+            }
+        }
+
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, file_path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+bool TextureBlob::Parse(const uint8_t* data, size_t size, uint64_t source_hash, TextureImage& out_image)
+{
+    if (!data || size < sizeof(BlobHeader))
+    {
+        return false;
+    }
+
+    BlobHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != BLOB_MAGIC || header.version != BLOB_VERSION || header.source_hash != source_hash
+        || header.format > (uint32_t)TextureFormat::BC7 || header.mip_count == 0 || header.mip_count > 16
+        || sizeof(BlobHeader) + sizeof(BlobLevel) * header.mip_count > size)
+    {
+        return false;
+    }
+
+    TextureImage image;
+    image.format = (TextureFormat)header.format;
+    for (uint32_t i = 0; i < header.mip_count; ++i)
+    {
+        BlobLevel level;
+        std::memcpy(&level, data + sizeof(BlobHeader) + sizeof(BlobLevel) * i, sizeof(level));
+
+        if (level.width == 0 || level.height == 0 || level.offset > size || level.size > size - level.offset
+            || level.size != TextureFormats::LevelSize(image.format, (int)level.width, (int)level.height))
+        {
+            return false;
+        }
+
+        TextureMip mip;
+        mip.data      = data + level.offset;
+        mip.width     = (int)level.width;
+        mip.height    = (int)level.height;
+        mip.row_pitch = TextureFormats::RowPitch(image.format, mip.width);
+        image.mips.push_back(mip);
+    }
+
+    out_image = std::move(image);
+    return true;
+}
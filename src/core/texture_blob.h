@@ -0,0 +1,68 @@
+/**
+ * @file texture_blob.h
+ * @brief The .uftex file format: a GPU-ready texture (any TextureFormat, with mips) on disk.
+ *
+ * Layout, all integers little endian:
+ *
+ *     BlobHeader                          fixed size, see below
+ *     BlobLevel[header.mip_count]         one entry per mip level, largest first
+ *     level data                          each level starts on a BLOB_DATA_ALIGNMENT boundary
+ *
+ * Level data is stored tightly packed (row pitch = TextureFormats::RowPitch), so it can be
+ * handed to the graphics API without any processing. The header records the hash and size of
+ * the source file it was produced from, which lets a loader reject a stale blob.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "core\texture_image.h"
+
+namespace TextureBlob
+{
+    constexpr uint32_t BLOB_MAGIC           = 0x58544655;  // "UFTX"
+    constexpr uint32_t BLOB_VERSION         = 1;
+    constexpr uint64_t BLOB_DATA_ALIGNMENT  = 64;
+
+    struct BlobHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;        // TextureFormat
+        uint32_t mip_count;
+        uint64_t source_hash;
+        uint64_t source_size;
+    };
+
+    struct BlobLevel
+    {
+        uint64_t offset;        // From the start of the file
+        uint64_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    /**
+     * @brief Writes an image to a blob file, replacing any existing file atomically.
+     *
+     * @param file_path Destination path. Parent directories are created.
+     * @param image The image to store. Rows are repacked tightly if they are padded.
+     * @param source_hash Hash of the file the image was produced from.
+     * @param source_size Size of that file in bytes.
+     * @return True when the file was written.
+     */
+    bool Write(const std::filesystem::path& file_path, const TextureImage& image, uint64_t source_hash, uint64_t source_size);
+
+    /**
+     * @brief Validates blob bytes already in memory and describes them as a TextureImage.
+     *
+     * @param data Start of the blob.
+     * @param size Size of the blob in bytes.
+     * @param source_hash Expected source hash.
+     * @param out_image Receives the image description, pointing into data.
+     * @return True when the blob is consistent.
+     */
+    bool Parse(const uint8_t* data, size_t size, uint64_t source_hash, TextureImage& out_image);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file texture_image.h
+ * @brief CPU-side description of a texture that is ready for upload, in any supported GPU format.
+ *
+ * A TextureImage does not own its pixels; it points at memory owned by the caller (a decoded
+ * image, an encoder's output, a cache file). The graphics API copies everything it needs
+ * during creation, so the memory only has to outlive the create call.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief GPU texture formats UiForge can create.
+ *
+ * The block-compressed formats store 4x4 pixel blocks: 8 bytes per block for BC1, 16 bytes per
+ * block for BC3 and BC7.
+ */
+enum class TextureFormat : uint32_t
+{
+    RGBA8   = 0,
+    BC1     = 1,    // RGB with 1-bit alpha, 4 bits per pixel
+    BC3     = 2,    // RGB with interpolated alpha, 8 bits per pixel
+    BC7     = 3     // High quality RGBA, 8 bits per pixel
+};
+
+/**
+ * @brief One mip level of a TextureImage.
+ */
+struct TextureMip
+{
+    const void* data        = nullptr;
+    int         width       = 0;        // In pixels
+    int         height      = 0;        // In pixels
+    size_t      row_pitch   = 0;        // Bytes from one row to the next; a row of 4x4 blocks for BC formats
+};
+
+/**
+ * @brief A texture with one or more mip levels, largest first.
+ */
+struct TextureImage
+{
+    TextureFormat           format = TextureFormat::RGBA8;
+    std::vector<TextureMip> mips;
+};
+
+namespace TextureFormats
+{
+    /**
+     * @brief Reports whether the format stores 4x4 compressed blocks.
+     */
+    inline bool IsBlockCompressed(TextureFormat format)
+    {
+        return format != TextureFormat::RGBA8;
+    }
+
+    /**
+     * @brief Returns the size of one 4x4 block, or of one pixel for RGBA8.
+     */
+    inline size_t BytesPerBlock(TextureFormat format)
+    {
+        switch (format)
+        {
+            case TextureFormat::BC1:    return 8;
+            case TextureFormat::BC3:
+            case TextureFormat::BC7:    return 16;
+            default:                    return 4;
+        }
+    }
+
+    /**
+     * @brief Returns the tightly packed row pitch of a level (a row of blocks for BC formats).
+     */
+    inline size_t RowPitch(TextureFormat format, int width)
+    {
+        if (IsBlockCompressed(format))
+        {
+            return (size_t)((width + 3) / 4) * BytesPerBlock(format);
+        }
+        return (size_t)width * 4;
+    }
+
+    /**
+     * @brief Returns the number of rows (rows of blocks for BC formats) in a level.
+     */
+    inline int RowCount(TextureFormat format, int height)
+    {
+        return IsBlockCompressed(format) ? (height + 3) / 4 : height;
+    }
+
+    /**
+     * @brief Returns the tightly packed size of a level in bytes.
+     */
+    inline size_t LevelSize(TextureFormat format, int width, int height)
+    {
+        return RowPitch(format, width) * (size_t)RowCount(format, height);
+    }
+
+    /**
+     * @brief Returns the GPU memory taken by every level of an image, tightly packed.
+     */
+    inline size_t ImageSize(const TextureImage& image)
+    {
+        size_t total = 0;
+        for (const TextureMip& mip : image.mips)
+        {
+            total += LevelSize(image.format, mip.width, mip.height);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns a short lowercase name for logs and cache file names ("rgba8", "bc1", ...).
+     */
+    inline const char* GetName(TextureFormat format)
+    {
+        switch (format)
+        {
+            case TextureFormat::BC1:    return "bc1";
+            case TextureFormat::BC3:    return "bc3";
+            case TextureFormat::BC7:    return "bc7";
+            default:                    return "rgba8";
+        }
+    }
+}
@@ -0,0 +1,505 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+
+#include <wincodec.h>
+
+#include <plog/Log.h>
+
+#include "core\bc_encoder.h"
+#include "core\graphics_api.h"
+#include "core\image_resample.h"
+#include "core\mapped_file.h"
+#include "core\package_archive.h"
+#include "core\texture_blob.h"
+#include "core\texture_loader.h"
+#include "core\util.h"
+
+namespace
+{
+    bool ReadFileBytes(const std::filesystem::path& file_path, std::vector<uint8_t>& out_bytes)
+    {
+        ArchiveFile archived;
+        if (PackageArchive::ReadFile(file_path, archived))
+        {
+            out_bytes.assign((const uint8_t*)archived.data, (const uint8_t*)archived.data + archived.size);
+            return !out_bytes.empty();
+        }
+
+        std::ifstream in(file_path, std::ios::binary | std::ios::ate);
+        if (!in)
+        {
+            return false;
+        }
+
+        const std::streamsize size = in.tellg();
+        if (size <= 0)
+        {
+            return false;
+        }
+
+        out_bytes.resize((size_t)size);
+        in.seekg(0);
+        return (bool)in.read((char*)out_bytes.data(), size);
+    }
+
+    std::mutex cache_mutex;
+
+    // Touches a cache file so the least recently used files are the ones evicted.
+    void TouchCacheFile(const std::filesystem::path& cache_path)
+    {
+        std::error_code ec;
+        std::filesystem::last_write_time(cache_path, std::filesystem::file_time_type::clock::now(), ec);
+    }
+}
+
+std::filesystem::path TextureLoader::cache_directory;
+uint64_t TextureLoader::cache_max_bytes = 0;
+
+bool TextureLoader::ParseCompression(const std::string& name, TextureFormat& out_format)
+{
+    std::string lower;
+    for (char c : name)
+    {
+        lower += (char)tolower((unsigned char)c);
+    }
+
+    if (lower == "none" || lower == "rgba8") { out_format = TextureFormat::RGBA8;  return true; }
+    if (lower == "bc1")                      { out_format = TextureFormat::BC1;    return true; }
+    if (lower == "bc3")                      { out_format = TextureFormat::BC3;    return true; }
+    if (lower == "bc7")                      { out_format = TextureFormat::BC7;    return true; }
+    return false;
+}
+
+bool TextureLoader::DecodeImage(const void* data, size_t size, PixelFormat format, std::vector<uint8_t>& out_pixels, int& out_width, int& out_height)
+{
+    if (!data || size == 0 || size > MAXDWORD || (format != PixelFormat::RGBA8 && format != PixelFormat::BGRA8))
+    {
+        PLOG_WARNING << "DecodeImage called with invalid arguments (data=" << data << ", size=" << size << ").";
+        return false;
+    }
+
+    const HRESULT co_init = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    const bool co_initialized = SUCCEEDED(co_init);    // RPC_E_CHANGED_MODE means COM was already up in another mode; keep going.
+
+    bool decoded = false;
+    IWICImagingFactory* wic_factory = nullptr;
+    IWICStream* stream = nullptr;
+    IWICBitmapDecoder* decoder = nullptr;
+    IWICBitmapFrameDecode* frame = nullptr;
+    IWICFormatConverter* converter = nullptr;
+
+    do
+    {
+        HRESULT result = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic_factory));
+        if (FAILED(result)) { PLOG_ERROR << "Failed to create WIC imaging factory. HRESULT: " << result; break; }
+
+        result = wic_factory->CreateStream(&stream);
+        if (FAILED(result)) { PLOG_ERROR << "Failed to create WIC stream. HRESULT: " << result; break; }
+
+        result = stream->InitializeFromMemory((BYTE*)data, (DWORD)size);
+        if (FAILED(result)) { PLOG_ERROR << "Failed to initialize WIC stream. HRESULT: " << result; break; }
+
+        result = wic_factory->CreateDecoderFromStream(stream, nullptr, WICDecodeMetadataCacheOnDemand, &decoder);
+        if (FAILED(result)) { PLOG_ERROR << "Failed to decode image. HRESULT: " << result; break; }
+
+        result = decoder->GetFrame(0, &frame);
+        if (FAILED(result)) { PLOG_ERROR << "Failed to get image frame. HRESULT: " << result; break; }
+
+        result = wic_factory->CreateFormatConverter(&converter);
+        if (FAILED(result)) { PLOG_ERROR << "Failed to create WIC format converter. HRESULT: " << result; break; }
+
+        const WICPixelFormatGUID& target_format = format == PixelFormat::BGRA8 ? GUID_WICPixelFormat32bppBGRA : GUID_WICPixelFormat32bppRGBA;
+        result = converter->Initialize(frame, target_format, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+        if (FAILED(result)) { PLOG_ERROR << "Failed to convert image to 32bpp. HRESULT: " << result; break; }
+
+        UINT width = 0;
+        UINT height = 0;
+        result = converter->GetSize(&width, &height);
+        if (FAILED(result) || !width || !height) { PLOG_ERROR << "Failed to get image size. HRESULT: " << result; break; }
+
+        out_pixels.resize((size_t)width * height * 4);
+        result = converter->CopyPixels(nullptr, width * 4, (UINT)out_pixels.size(), out_pixels.data());
+        if (FAILED(result)) { PLOG_ERROR << "Failed to copy decoded pixels. HRESULT: " << result; break; }
+
+        out_width  = (int)width;
+        out_height = (int)height;
+        decoded = true;
+    } while (false);
+
+    if (converter)   converter->Release();
+    if (frame)       frame->Release();
+    if (decoder)     decoder->Release();
+    if (stream)      stream->Release();
+    if (wic_factory) wic_factory->Release();
+    if (co_initialized) CoUninitialize();
+
+    return decoded;
+}
+
+bool TextureLoader::DecodeImageFile(const std::filesystem::path& file_path, PixelFormat format, std::vector<uint8_t>& out_pixels, int& out_width, int& out_height)
+{
+    std::vector<uint8_t> file_bytes;
+    if (!ReadFileBytes(file_path, file_bytes))
+    {
+        PLOG_ERROR << "Failed to read image file: " << file_path.string();
+        return false;
+    }
+
+    return DecodeImage(file_bytes.data(), file_bytes.size(), format, out_pixels, out_width, out_height);
+}
+
+void TextureLoader::ConfigureCache(const std::filesystem::path& directory, uint64_t max_bytes)
+{
+    cache_directory = directory;
+    cache_max_bytes = max_bytes;
+    if (!IsCacheEnabled())
+    {
+        PLOG_INFO << "Texture cache disabled";
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(cache_directory, ec);
+    if (ec)
+    {
+        PLOG_WARNING << "Failed to create texture cache directory " << cache_directory.string() << ": " << ec.message()
+                     << ". Texture cache disabled.";
+        cache_directory.clear();
+        return;
+    }
+
+    EnforceCacheLimit();
+}
+
+bool TextureLoader::IsCacheEnabled()
+{
+    return !cache_directory.empty() && cache_max_bytes > 0;
+}
+
+void* TextureLoader::LoadFromFile(const std::filesystem::path& file_path, const TextureLoadOptions& options)
+{
+    if (!IGraphicsApi::CreateTextureFromFile)
+    {
+        return nullptr;
+    }
+
+    const bool needs_processing = options.compression != TextureFormat::RGBA8 || options.max_width > 0
+                               || options.max_height > 0 || options.generate_mips;
+    if (!IGraphicsApi::CreateTextureFromImage)
+    {
+        if (needs_processing)
+        {
+            PLOG_WARNING << "Texture compression and resizing are not supported by the active graphics API; loading as is: " << file_path.string();
+        }
+        // The backend's loader opens files by name, so an archived image is extracted first.
+        return IGraphicsApi::CreateTextureFromFile(PackageArchive::ExtractToCache(file_path).wstring());
+    }
+
+    // Without a cache a plain load gains nothing from going through here. Archived images
+    // still do: decoding from the entry beats extracting it to disk.
+    if (!IsCacheEnabled() && !needs_processing && !PackageArchive::ContainsFile(file_path))
+    {
+        return IGraphicsApi::CreateTextureFromFile(file_path.wstring());
+    }
+
+    // A cache blob the backend rejects is rebuilt from the source image.
+    PreparedTexture prepared;
+    if (!PrepareImage(file_path, options, true, prepared))
+    {
+        return nullptr;
+    }
+
+    void* texture = Upload(prepared);
+    if (!texture && prepared.from_cache && PrepareImage(file_path, options, false, prepared))
+    {
+        texture = Upload(prepared);
+    }
+    return texture;
+}
+
+bool TextureLoader::Prepare(const std::filesystem::path& file_path, const TextureLoadOptions& options, PreparedTexture& out_prepared)
+{
+    return PrepareImage(file_path, options, true, out_prepared);
+}
+
+bool TextureLoader::PrepareImage(const std::filesystem::path& file_path, const TextureLoadOptions& options, bool read_cache,
+                                 PreparedTexture& out_prepared)
+{
+    out_prepared = PreparedTexture();
+    out_prepared.file_path = file_path;
+
+    std::vector<uint8_t> file_bytes;
+    if (!ReadFileBytes(file_path, file_bytes))
+    {
+        PLOG_ERROR << "Failed to read image file: " << file_path.string();
+        return false;
+    }
+
+    const uint64_t source_hash = CoreUtils::HashBytes(file_bytes.data(), file_bytes.size());
+
+    // Cache hit: the blob is GPU-ready, so the upload reads straight from the mapped pages and
+    // the image is never decoded.
+    std::filesystem::path cache_path;
+    if (IsCacheEnabled())
+    {
+        cache_path = GetCachePath(source_hash, file_bytes.size(), options);
+        if (read_cache && out_prepared.blob.Open(cache_path)
+            && TextureBlob::Parse(out_prepared.blob.Data(), out_prepared.blob.Size(), source_hash, out_prepared.image))
+        {
+            TouchCacheFile(cache_path);
+            out_prepared.from_cache = true;
+            return true;
+        }
+        out_prepared.blob.Close();
+    }
+
+    int width = 0;
+    int height = 0;
+    if (!DecodeImage(file_bytes.data(), file_bytes.size(), PixelFormat::RGBA8, out_prepared.pixels, width, height))
+    {
+        return false;
+    }
+
+    BuildImage(file_path, out_prepared.pixels, width, height, options, out_prepared.storage, out_prepared.image);
+
+    if (IsCacheEnabled())
+    {
+        // Preload workers and the render thread may both be writing blobs and evicting.
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (TextureBlob::Write(cache_path, out_prepared.image, source_hash, file_bytes.size()))
+        {
+            EnforceCacheLimit();
+        }
+        else
+        {
+            PLOG_WARNING << "Failed to write texture cache file: " << cache_path.string();
+        }
+    }
+    return true;
+}
+
+void* TextureLoader::Upload(const PreparedTexture& prepared)
+{
+    if (!IGraphicsApi::CreateTextureFromImage)
+    {
+        return nullptr;
+    }
+
+    const size_t resident_before = IGraphicsApi::GetResidentTextureBytes();
+    void* texture = IGraphicsApi::CreateTextureFromImage(prepared.image);
+    if (texture)
+    {
+        PLOG_DEBUG << "Loaded " << prepared.file_path.filename().string() << (prepared.from_cache ? " from texture cache" : "") << " as "
+                   << TextureFormats::GetName(prepared.image.format) << ": " << TextureFormats::ImageSize(prepared.image)
+                   << " bytes, resident texture memory " << resident_before << " -> " << IGraphicsApi::GetResidentTextureBytes() << " bytes";
+    }
+    return texture;
+}
+
+std::filesystem::path TextureLoader::GetCachePath(uint64_t source_hash, size_t source_size, const TextureLoadOptions& options)
+{
+    // "<content hash>-<source size>[.fit<w>x<h>[.box]][.mips].<format>.uftex". The variant
+    // records the requested bounds rather than the resulting size, which is not known until the
+    // image has been decoded.
+    std::string variant;
+    if (options.max_width > 0 || options.max_height > 0)
+    {
+        variant += ".fit" + std::to_string(options.max_width) + "x" + std::to_string(options.max_height);
+        if (options.filter == ResampleFilter::Box)
+        {
+            variant += ".box";
+        }
+    }
+    if (options.generate_mips)
+    {
+        variant += ".mips";
+    }
+
+    char file_name[160];
+    snprintf(file_name, sizeof(file_name), "%016llx-%llu%s.%s.uftex", (unsigned long long)source_hash,
+             (unsigned long long)source_size, variant.c_str(), TextureFormats::GetName(options.compression));
+    return cache_directory / file_name;
+}
+
+void TextureLoader::BuildImage(const std::filesystem::path& file_path, const std::vector<uint8_t>& pixels, int width, int height,
+                               const TextureLoadOptions& options, std::vector<std::vector<uint8_t>>& out_storage, TextureImage& out_image)
+{
+    const std::string file_name = file_path.filename().string();
+    TextureFormat format = options.compression;
+    const char* format_name = TextureFormats::GetName(format);
+
+    // Only the resolution the image is drawn at is kept; the source stays untouched on disk.
+    int level_width = width;
+    int level_height = height;
+    ImageResample::FitWithin(width, height, options.max_width, options.max_height, level_width, level_height);
+    const bool resized = level_width != width || level_height != height;
+    if (resized && format != TextureFormat::RGBA8)
+    {
+        // Round up to whole blocks so a downscaled image can always be compressed.
+        level_width  = std::min(width, (level_width + 3) & ~3);
+        level_height = std::min(height, (level_height + 3) & ~3);
+    }
+
+    // Block-compressed textures must be a multiple of the block size in both directions at the
+    // top level; anything else is kept as RGBA8 rather than padded or stretched behind the
+    // script's back.
+    if (format != TextureFormat::RGBA8 && (level_width % 4 != 0 || level_height % 4 != 0))
+    {
+        PLOG_WARNING << "Cannot compress " << file_path.string() << " to " << format_name << ": " << level_width << "x" << level_height
+                     << " is not a multiple of 4. Loading uncompressed.";
+        format = TextureFormat::RGBA8;
+    }
+
+    const uint8_t* level_pixels = pixels.data();
+    if (resized)
+    {
+        const auto resize_start = std::chrono::steady_clock::now();
+        std::vector<uint8_t> level((size_t)level_width * level_height * 4);
+        ImageResample::Resize(pixels.data(), width, height, (size_t)width * 4, level.data(), level_width, level_height, (size_t)level_width * 4, options.filter);
+        const auto resize_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - resize_start).count();
+
+        PLOG_DEBUG << "Downscaled " << file_name << " from " << width << "x" << height << " to " << level_width << "x" << level_height
+                   << " (" << (options.filter == ResampleFilter::Box ? "box" : "lanczos") << ") in " << resize_us << " us";
+        out_storage.push_back(std::move(level));
+        level_pixels = out_storage.back().data();
+    }
+
+    // Every level as RGBA8 first; compression (if any) works level by level afterwards.
+    struct Level
+    {
+        const uint8_t* rgba;
+        int width;
+        int height;
+    };
+    std::vector<Level> levels = { Level{ level_pixels, level_width, level_height } };
+    if (options.generate_mips)
+    {
+        std::vector<std::vector<uint8_t>> mip_chain = ImageResample::BuildMipChain(level_pixels, level_width, level_height);
+        int mip_width = level_width;
+        int mip_height = level_height;
+        for (std::vector<uint8_t>& mip : mip_chain)
+        {
+            mip_width  = std::max(1, mip_width / 2);
+            mip_height = std::max(1, mip_height / 2);
+            out_storage.push_back(std::move(mip));
+            levels.push_back(Level{ out_storage.back().data(), mip_width, mip_height });
+        }
+    }
+
+    out_image.format = TextureFormat::RGBA8;
+    out_image.mips.clear();
+    for (const Level& level : levels)
+    {
+        TextureMip mip;
+        mip.data      = level.rgba;
+        mip.width     = level.width;
+        mip.height    = level.height;
+        mip.row_pitch = (size_t)level.width * 4;
+        out_image.mips.push_back(mip);
+    }
+
+    if (format == TextureFormat::RGBA8)
+    {
+        return;
+    }
+
+    const auto encode_start = std::chrono::steady_clock::now();
+    std::vector<std::vector<uint8_t>> encoded_levels;
+    for (const Level& level : levels)
+    {
+        encoded_levels.push_back(BcEncoder::Encode(level.rgba, level.width, level.height, (size_t)level.width * 4, format));
+        if (encoded_levels.back().empty())
+        {
+            PLOG_ERROR << "Failed to encode " << file_path.string() << " as " << format_name << ". Loading uncompressed.";
+            return;
+        }
+    }
+    const auto encode_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - encode_start).count();
+
+    PLOG_DEBUG << "Encoded " << file_name << " (" << level_width << "x" << level_height << ", " << levels.size() << " mips) as "
+               << format_name << " in " << encode_ms << " ms";
+    if (plog::get()->checkSeverity(plog::debug))
+    {
+        const std::vector<uint8_t> decoded = BcEncoder::Decode(encoded_levels[0].data(), level_width, level_height, format);
+        PLOG_DEBUG << format_name << " PSNR: " << BcEncoder::ComputePsnr(level_pixels, (size_t)level_width * 4, decoded.data(), (size_t)level_width * 4, level_width, level_height) << " dB";
+    }
+
+    out_image.format = format;
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        out_storage.push_back(std::move(encoded_levels[i]));
+        out_image.mips[i].data      = out_storage.back().data();
+        out_image.mips[i].row_pitch = TextureFormats::RowPitch(format, levels[i].width);
+    }
+}
+
+void TextureLoader::EnforceCacheLimit()
+{
+    struct CacheEntry
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type last_used;
+        uint64_t size;
+    };
+
+    std::vector<CacheEntry> entries;
+    uint64_t total_bytes = 0;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_directory, ec))
+    {
+        std::error_code entry_ec;
+        if (!entry.is_regular_file(entry_ec) || entry.path().extension() != ".uftex")
+        {
+            continue;
+        }
+
+        CacheEntry cache_entry;
+        cache_entry.path      = entry.path();
+        cache_entry.last_used = entry.last_write_time(entry_ec);
+        cache_entry.size      = entry.file_size(entry_ec);
+        if (entry_ec)
+        {
+            continue;
+        }
+
+        total_bytes += cache_entry.size;
+        entries.push_back(std::move(cache_entry));
+    }
+
+    if (total_bytes <= cache_max_bytes)
+    {
+        return;
+    }
+
+    // Least recently used first. Loads touch the files they hit, so the write time is the last use.
+    std::sort(entries.begin(), entries.end(),
+              [](const CacheEntry& a, const CacheEntry& b) { return a.last_used < b.last_used; });
+
+    size_t evicted = 0;
+    for (const CacheEntry& entry : entries)
+    {
+        if (total_bytes <= cache_max_bytes)
+        {
+            break;
+        }
+
+        std::error_code remove_ec;
+        if (std::filesystem::remove(entry.path, remove_ec))
+        {
+            total_bytes -= entry.size;
+            evicted++;
+        }
+    }
+
+    PLOG_DEBUG << "Texture cache evicted " << evicted << " files, " << total_bytes << " of " << cache_max_bytes << " bytes used";
+}
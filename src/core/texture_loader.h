@@ -0,0 +1,152 @@
+/**
+ * @file texture_loader.h
+ * @brief Loads image files into textures through the active IGraphicsApi.
+ *
+ * Images are decoded with WIC and, when asked for, block-compressed on the CPU (see
+ * bc_encoder.h). The GPU-ready result is written to a cache directory as a .uftex blob (see
+ * texture_blob.h) named after the content hash and size of the source file, so later loads of
+ * the same image, including after the next injection, memory-map the blob and upload straight
+ * from the mapped pages without decoding or encoding anything. The cache is capped in size and
+ * evicts the least recently used blobs first.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core\image_resample.h"
+#include "core\mapped_file.h"
+#include "core\pixel_convert.h"
+#include "core\texture_image.h"
+
+/**
+ * @brief Per-load options for TextureLoader::LoadFromFile.
+ */
+struct TextureLoadOptions
+{
+    TextureFormat   compression     = TextureFormat::RGBA8;         // RGBA8 uploads uncompressed
+    int             max_width       = 0;                            // Largest size the image is drawn at, 0 for unbounded
+    int             max_height      = 0;
+    ResampleFilter  filter          = ResampleFilter::Lanczos3;     // Used when the image is shrunk to fit
+    bool            generate_mips   = false;                        // Build a full mip chain below the top level
+};
+
+/**
+ * @brief An image decoded and processed on the CPU, ready to be uploaded by TextureLoader::Upload.
+ *
+ * image points into pixels, storage or the mapped cache blob, so a PreparedTexture must be kept
+ * alive (and not copied) until it is uploaded.
+ */
+struct PreparedTexture
+{
+    std::filesystem::path               file_path;
+    TextureImage                        image;
+    std::vector<uint8_t>                pixels;         // The decoded image
+    std::vector<std::vector<uint8_t>>   storage;        // Levels generated from it
+    MappedFile                          blob;           // The cache file, on a cache hit
+    bool                                from_cache = false;
+};
+
+class TextureLoader
+{
+    public:
+        /**
+         * @brief Sets where decoded textures are cached and how large the cache may grow.
+         *
+         * Creates the directory and evicts blobs beyond the limit. Until this is called, or when
+         * max_bytes is 0, nothing is cached.
+         *
+         * @param directory The cache directory.
+         * @param max_bytes Total size the cache files may use.
+         */
+        static void ConfigureCache(const std::filesystem::path& directory, uint64_t max_bytes);
+
+        /**
+         * @brief Loads an image file into a texture.
+         *
+         * Images larger than options.max_width x options.max_height are shrunk to fit (keeping
+         * their aspect ratio) before upload. When compression is requested but cannot be applied
+         * (the graphics API has no image upload, or the image is not a multiple of 4 pixels in
+         * each direction) the image is loaded uncompressed instead, with a warning.
+         *
+         * @param file_path Full path to the image.
+         * @param options Load options.
+         * @return A texture handle usable with ImGui.Image, or nullptr on failure (logged).
+         */
+        static void* LoadFromFile(const std::filesystem::path& file_path, const TextureLoadOptions& options);
+
+        /**
+         * @brief Does the CPU side of LoadFromFile: reads the image, then either maps its cache
+         * blob or decodes, resizes and compresses it (writing the blob). Touches no graphics API
+         * state, so it may run on a worker thread.
+         *
+         * @return True when out_prepared is ready for Upload; failures are logged.
+         */
+        static bool Prepare(const std::filesystem::path& file_path, const TextureLoadOptions& options, PreparedTexture& out_prepared);
+
+        /**
+         * @brief Creates the texture for a prepared image. Render thread only.
+         *
+         * @return A texture handle usable with ImGui.Image, or nullptr on failure.
+         */
+        static void* Upload(const PreparedTexture& prepared);
+
+        /**
+         * @brief Decodes an encoded image (PNG, JPEG, BMP, ...) held in memory with WIC.
+         *
+         * @param data The encoded image bytes.
+         * @param size Number of bytes.
+         * @param format PixelFormat::RGBA8 or PixelFormat::BGRA8.
+         * @param out_pixels Receives tightly packed 32-bit pixels.
+         * @param out_width Receives the width in pixels.
+         * @param out_height Receives the height in pixels.
+         * @return True on success; failures are logged.
+         */
+        static bool DecodeImage(const void* data, size_t size, PixelFormat format, std::vector<uint8_t>& out_pixels, int& out_width, int& out_height);
+
+        /**
+         * @brief Reads and decodes an image file with WIC. See DecodeImage.
+         */
+        static bool DecodeImageFile(const std::filesystem::path& file_path, PixelFormat format, std::vector<uint8_t>& out_pixels, int& out_width, int& out_height);
+
+        /**
+         * @brief Parses a compression name as used by the Lua API ("none", "bc1", "bc3", "bc7").
+         *
+         * @return True when the name is recognized and out_format was written.
+         */
+        static bool ParseCompression(const std::string& name, TextureFormat& out_format);
+
+    private:
+        static std::filesystem::path cache_directory;
+        static uint64_t cache_max_bytes;
+
+        static bool IsCacheEnabled();
+
+        /**
+         * @brief Prepare, optionally skipping the cache lookup (when the cached blob was rejected).
+         */
+        static bool PrepareImage(const std::filesystem::path& file_path, const TextureLoadOptions& options, bool read_cache,
+                                 PreparedTexture& out_prepared);
+
+        /**
+         * @brief Builds the cache file path for a source file and the options it is loaded with.
+         */
+        static std::filesystem::path GetCachePath(uint64_t source_hash, size_t source_size, const TextureLoadOptions& options);
+
+        /**
+         * @brief Turns decoded RGBA8 pixels into the image to upload: shrinks it to the requested
+         * bounds, builds mips and compresses it, as asked.
+         *
+         * @param out_storage Receives buffers for any levels that were generated; out_image points
+         * into them or into pixels.
+         */
+        static void BuildImage(const std::filesystem::path& file_path, const std::vector<uint8_t>& pixels, int width, int height,
+                               const TextureLoadOptions& options, std::vector<std::vector<uint8_t>>& out_storage, TextureImage& out_image);
+
+        /**
+         * @brief Deletes the least recently used cache files until the cache fits in cache_max_bytes.
+         */
+        static void EnforceCacheLimit();
+};
@@ -0,0 +1,108 @@
+/**
+ * @file ufpak_format.h
+ * @brief On-disk layout of .ufpak script package archives, shared by the core and the packer.
+ *
+ * A .ufpak file bundles a scripts folder (packages, modules and resources) into one file that
+ * the core memory-maps, so loading a pack of scripts costs one file open instead of thousands.
+ *
+ *   Header                 fixed size, at offset 0
+ *   entry data             each entry starts on a DATA_ALIGNMENT boundary
+ *   Entry[entry_count]     the index, sorted by name so lookups are a binary search
+ *   names                  entry names, not null-terminated, referenced by the index
+ *
+ * Entry names are paths relative to the packed folder, normalized by NormalizeKey: lowercased,
+ * with single backslash separators. An archive named "tools.ufpak" in the scripts folder holding
+ * "tools\tools.lua" is found by the core as "<scripts>\tools.ufpak\tools\tools.lua", the same way
+ * a loose package at "<scripts>\tools\tools.lua" is.
+ *
+ * Entries are stored raw, compressed with the Windows XPRESS Huffman codec (ENTRY_COMPRESSED), or,
+ * for Lua sources, precompiled to LuaJIT bytecode (ENTRY_BYTECODE), which luaL_loadbuffer accepts
+ * in place of source. All integers are little-endian.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+
+namespace Ufpak
+{
+    constexpr char      MAGIC[4]        = { 'U', 'F', 'P', 'K' };
+    constexpr uint32_t  VERSION         = 1;
+    constexpr uint64_t  DATA_ALIGNMENT  = 16;
+
+    enum EntryFlags : uint32_t
+    {
+        ENTRY_COMPRESSED    = 1u << 0,  // Data is XPRESS Huffman compressed; size is the decompressed size
+        ENTRY_BYTECODE      = 1u << 1,  // A .lua entry stored as LuaJIT bytecode
+    };
+
+#pragma pack(push, 1)
+    struct Header
+    {
+        char        magic[4];
+        uint32_t    version;
+        uint32_t    entry_count;
+        uint32_t    reserved;
+        uint64_t    index_offset;       // First Entry
+        uint64_t    names_offset;       // First byte of the name block
+        uint64_t    names_size;
+    };
+
+    struct Entry
+    {
+        uint64_t    data_offset;
+        uint64_t    stored_size;        // Bytes in the archive
+        uint64_t    size;               // Bytes once decompressed; equals stored_size when uncompressed
+        uint32_t    name_offset;        // Relative to Header::names_offset
+        uint32_t    name_length;
+        uint32_t    flags;              // EntryFlags
+        uint32_t    reserved;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(Header) == 40, "ufpak header layout changed");
+    static_assert(sizeof(Entry) == 40, "ufpak entry layout changed");
+
+    /**
+     * @brief Normalizes a relative path into an entry name: lowercased, backslash separated, with
+     * empty and "." components dropped.
+     *
+     * @return False for paths that cannot name an entry (empty, or containing "..").
+     */
+    inline bool NormalizeKey(const std::string& path, std::string& out_key)
+    {
+        out_key.clear();
+        out_key.reserve(path.size());
+
+        size_t segment_start = 0;
+        for (size_t i = 0; i <= path.size(); ++i)
+        {
+            const char c = (i < path.size()) ? path[i] : '\\';
+            if (c != '/' && c != '\\')
+            {
+                continue;
+            }
+
+            const std::string segment = path.substr(segment_start, i - segment_start);
+            segment_start = i + 1;
+            if (segment.empty() || segment == ".")
+            {
+                continue;
+            }
+            if (segment == "..")
+            {
+                return false;
+            }
+            if (!out_key.empty())
+            {
+                out_key += '\\';
+            }
+            out_key += segment;
+        }
+
+        std::transform(out_key.begin(), out_key.end(), out_key.begin(), [](unsigned char ch) { return (char)std::tolower(ch); });
+        return !out_key.empty();
+    }
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cfloat>
 #include <cstddef>
 #include <cstdio>
@@ -6,6 +7,7 @@
 #include <vector>
 #include <filesystem>
 #include <mutex>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -14,7 +16,9 @@
 #include <plog/Log.h>
 
 #include "core\ui_manager.h"
+#include "core\font_manager.h"
 #include "core\graphics_api.h"
+#include "core\script_resources.h"
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 extern std::atomic<bool> needs_cleanup; // From core.cpp
@@ -197,6 +201,39 @@ void UiManager::RenderSettingsIcon(void* settings_icon)
     ImGui::End();
 }
 
+// Draws a module as a tree node holding the modules it requires. module_path holds the modules
+// above it, so a require cycle is shown once instead of recursing forever.
+static void DrawModuleDependencies(ForgeScriptManager& script_manager, const std::string& module_name, std::vector<std::string>& module_path)
+{
+    const std::set<std::string> required_modules = script_manager.GetRequiredModules(module_name);
+    const size_t dependent_count = script_manager.GetModuleDependents(module_name).size();
+    if (std::find(module_path.begin(), module_path.end(), module_name) != module_path.end())
+    {
+        ImGui::BulletText("%s (cycle)", module_name.c_str());
+        return;
+    }
+
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanAvailWidth;
+    if (required_modules.empty())
+    {
+        flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_Bullet;
+    }
+
+    const bool open = ImGui::TreeNodeEx(module_name.c_str(), flags, "%s  (required by %llu)", module_name.c_str(), (unsigned long long)dependent_count);
+    if (required_modules.empty() || !open)
+    {
+        return;
+    }
+
+    module_path.push_back(module_name);
+    for (const std::string& required_module : required_modules)
+    {
+        DrawModuleDependencies(script_manager, required_module, module_path);
+    }
+    module_path.pop_back();
+    ImGui::TreePop();
+}
+
 void UiManager::RenderSettingsWindow(ForgeScriptManager& script_manager)
 {
     static ForgeScript* selected_script;    // Static so the selected script stays selected
@@ -447,14 +484,43 @@ void UiManager::RenderSettingsWindow(ForgeScriptManager& script_manager)
                          size_t avg_time_loading     = (selected_script->stats.times_executed) ? selected_script->stats.total_time_loading_from_mem / selected_script->stats.times_executed : 0;
                          size_t avg_time_executing   = (selected_script->stats.times_executed) ? selected_script->stats.total_time_executing / selected_script->stats.times_executed : 0;
                          ImGui::Text("File Name                                  : %s", selected_script->GetFileName().c_str());
+                         if (!selected_script->IsLoaded())
+                         {
+                             ImGui::TextDisabled("Not read yet; scripts are read when first enabled.");
+                         }
                          ImGui::Text("Last Write Time                            : %s", selected_script->GetLastWriteTimeString().c_str());
                          ImGui::Text("Last Reload Time                           : %s", selected_script->GetLastReloadTimeString().c_str());
                          ImGui::Text("File Contents Size                         : %llu bytes", selected_script->stats.script_size);
                          ImGui::Text("Time to Read File                          : %llu microseconds", selected_script->stats.time_to_read_file_contents);
                          ImGui::Text("Time to Hash File                          : %llu microseconds", selected_script->stats.time_to_hash_file_contents);
+                         ImGui::Text("Time to Compile                            : %llu microseconds", selected_script->stats.time_to_compile);
                          ImGui::Text("Avg Time Loading Script From Memory        : %llu microseconds", avg_time_loading);
                           ImGui::Text("Avg Time Executing                         : %llu microseconds", avg_time_executing);
                           ImGui::Text("Number of Times Script Executed            : %llu", selected_script->stats.times_executed);
+
+                          // Live resources the script owns; all of them are released when it is disabled or reloaded.
+                          const ScriptResourceUsage usage = ScriptResources::GetUsage(selected_script->GetResourceOwner());
+                          ImGui::SeparatorText("Owned Resources");
+                          ImGui::Text("Textures                                   : %llu (%llu KB)", usage.textures.count, usage.textures.bytes / 1024);
+                          ImGui::Text("Sounds                                     : %llu (%llu KB on disk)", usage.sounds.count, usage.sounds.bytes / 1024);
+                          ImGui::Text("Animations                                 : %llu (%llu KB)", usage.animations.count, usage.animations.bytes / 1024);
+                          ImGui::Text("SDF Fonts                                  : %llu (%llu KB)", usage.sdf_fonts.count, usage.sdf_fonts.bytes / 1024);
+                          ImGui::Text("Particle Systems                           : %llu (%llu KB)", usage.particle_systems.count, usage.particle_systems.bytes / 1024);
+                          ImGui::Text("Fonts (shared atlas)                       : %llu", usage.fonts.count);
+                          ImGui::Text("Estimated Total                            : %llu KB", usage.TotalBytes() / 1024);
+
+                          // Modules the script requires, recorded as it runs; each node lists what that module requires in turn.
+                          ImGui::SeparatorText("Module Dependencies");
+                          const std::set<std::string> required_modules = script_manager.GetRequiredModules(selected_script->GetFileName());
+                          if (required_modules.empty())
+                          {
+                              ImGui::TextDisabled("No modules required.");
+                          }
+                          std::vector<std::string> module_path;
+                          for (const std::string& module_name : required_modules)
+                          {
+                              DrawModuleDependencies(script_manager, module_name, module_path);
+                          }
                      }
                       else
                       {
@@ -516,6 +582,10 @@ void UiManager::RenderUiElements(ForgeScriptManager& script_manager, void* setti
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
 
+    // Fonts declared by packages are rasterized here on the first frame, before any script
+    // gets a chance to draw with them.
+    FontManager::BakePending();
+
     // Execute all UI Mods
     // CreateTestWindow();
     RenderSettingsIcon(settings_icon);
@@ -1,5 +1,6 @@
 #pragma once
 #include <Windows.h>
+#include <cstdint>
 #include <string>
 
 namespace CoreUtils
@@ -29,4 +30,27 @@ namespace CoreUtils
      * This function monitors specific keyboard input to trigger custom actions, such as cleanup operations.
      */
     void ProcessCustomInputs(HWND target_window);
+
+    /**
+     * @brief Computes a 64-bit FNV-1a hash of a byte range.
+     *
+     * Unlike std::hash the result is the same across builds and runs, so it can be used to key
+     * files on disk. Defined here so tools built without util.cpp (the ufpak packer compiles
+     * package_archive.cpp) can use it too.
+     *
+     * @param data The bytes to hash.
+     * @param size Number of bytes.
+     * @return The hash.
+     */
+    inline uint64_t HashBytes(const void* data, size_t size)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
 }
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <vector>
+
+#include <imgui.h>
+
+#include "core\data_table.h"
+#include "core\string_list.h"
+#include "core\virtual_widgets.h"
+
+namespace
+{
+    constexpr ImGuiTableFlags DEFAULT_TABLE_FLAGS = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter
+                                                  | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+
+    // A DataTable sorts itself, so its headers are clickable by default.
+    constexpr ImGuiTableFlags DEFAULT_DATA_TABLE_FLAGS = DEFAULT_TABLE_FLAGS | ImGuiTableFlags_Sortable;
+
+    // BeginTable asserts on anything wider (IMGUI_TABLE_MAX_COLUMNS, in imgui_internal.h).
+    constexpr size_t MAX_TABLE_COLUMNS = 511;
+
+    // Options shared by the list and table forms; read from an optional options table.
+    struct ViewOptions
+    {
+        ImGuiTableFlags flags       = DEFAULT_TABLE_FLAGS;
+        ImVec2          size        = ImVec2(0.0f, 0.0f);   // Table only: outer size, 0 fills
+        float           item_height = -1.0f;                // -1 lets the clipper measure a row
+        bool            headers     = true;                 // Table only
+        bool            selectable  = false;                // Set when options.selected is given
+        long long       selected    = -1;                   // Highlighted row, in the source's numbering
+    };
+
+    ViewOptions ReadOptions(lua_State* L, int index, ImGuiTableFlags default_flags = DEFAULT_TABLE_FLAGS)
+    {
+        ViewOptions options;
+        options.flags = default_flags;
+        if (!lua_istable(L, index))
+        {
+            return options;
+        }
+
+        lua_getfield(L, index, "flags");
+        options.flags = lua_isnumber(L, -1) ? (ImGuiTableFlags)lua_tointeger(L, -1) : options.flags;
+        lua_getfield(L, index, "width");
+        options.size.x = (float)lua_tonumber(L, -1);
+        lua_getfield(L, index, "height");
+        options.size.y = (float)lua_tonumber(L, -1);
+        lua_getfield(L, index, "item_height");
+        options.item_height = lua_isnumber(L, -1) ? (float)lua_tonumber(L, -1) : options.item_height;
+        lua_getfield(L, index, "headers");
+        options.headers = lua_isnil(L, -1) || lua_toboolean(L, -1);
+        lua_getfield(L, index, "selected");
+        options.selectable = !lua_isnil(L, -1);
+        options.selected = lua_isnumber(L, -1) ? (long long)lua_tointeger(L, -1) : -1;
+        lua_pop(L, 6);
+        return options;
+    }
+
+    // Calls the row function at fn_index with row, leaving nresults results (LUA_MULTRET for
+    // all) on the stack. On an error the caller's open ImGui scopes are closed by on_error and
+    // the error is raised again, so a failing row function does not leave a table open.
+    template <typename OnError>
+    int CallRow(lua_State* L, int fn_index, long long row, int nresults, OnError on_error)
+    {
+        const int top = lua_gettop(L);
+        lua_pushvalue(L, fn_index);
+        lua_pushinteger(L, (lua_Integer)row);
+        if (lua_pcall(L, 1, nresults, 0) != 0)
+        {
+            on_error();
+            lua_error(L);
+        }
+        return lua_gettop(L) - top;
+    }
+
+    // Draws a row's first cell (or a list entry) as a selectable when the view has a selection.
+    // Returns true when it was clicked.
+    bool DrawEntry(const char* text, long long row, const ViewOptions& options, ImGuiSelectableFlags flags)
+    {
+        if (!options.selectable)
+        {
+            ImGui::TextUnformatted(text);
+            return false;
+        }
+
+        ImGui::PushID((int)row);
+        const bool clicked = ImGui::Selectable(text, row == options.selected, flags);
+        ImGui::PopID();
+        return clicked;
+    }
+
+    // Pushes the clicked row, or nil.
+    int PushClicked(lua_State* L, long long clicked)
+    {
+        if (clicked < 0)
+        {
+            lua_pushnil(L);
+        }
+        else
+        {
+            lua_pushinteger(L, (lua_Integer)clicked);
+        }
+        return 1;
+    }
+
+    int DrawStringList(lua_State* L, const StringList* list)
+    {
+        const ViewOptions options = ReadOptions(L, 2);
+        long long clicked = -1;
+
+        ImGuiListClipper clipper;
+        clipper.Begin((int)list->Size(), options.item_height);
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                if (DrawEntry(list->Get((size_t)i), i, options, ImGuiSelectableFlags_None))
+                {
+                    clicked = i;
+                }
+            }
+        }
+        return PushClicked(L, clicked);
+    }
+
+    // Sets up the columns and the frozen header row of a table that BeginTable just opened.
+    void SetupColumns(const char* const* names, int column_count, const ViewOptions& options)
+    {
+        if (options.headers)
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+        }
+        for (int column = 0; column < column_count; ++column)
+        {
+            ImGui::TableSetupColumn(names[column]);
+        }
+        if (options.headers)
+        {
+            ImGui::TableHeadersRow();
+        }
+    }
+
+    // Passes a change of the table's sort specs (a header click) on to the DataTable. Only the
+    // primary sort column is used; rows that tie keep their order.
+    void ApplySortSpecs(DataTable* table)
+    {
+        ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs();
+        if (!sort_specs || !sort_specs->SpecsDirty)
+        {
+            return;
+        }
+
+        if (sort_specs->SpecsCount > 0)
+        {
+            const ImGuiTableColumnSortSpecs& spec = sort_specs->Specs[0];
+            table->SetSort(spec.ColumnIndex, spec.SortDirection == ImGuiSortDirection_Descending);
+        }
+        else
+        {
+            table->SetSort(-1, false);
+        }
+        sort_specs->SpecsDirty = false;
+    }
+
+    int DrawDataTable(lua_State* L, const char* id, DataTable* table)
+    {
+        const ViewOptions options = ReadOptions(L, 3, DEFAULT_DATA_TABLE_FLAGS);
+        const int column_count = (int)std::min<size_t>(table->ColumnCount(), MAX_TABLE_COLUMNS);
+        if (!ImGui::BeginTable(id, column_count, options.flags, options.size))
+        {
+            return PushClicked(L, -1);
+        }
+
+        std::vector<const char*> names(column_count);
+        for (int column = 0; column < column_count; ++column)
+        {
+            names[column] = table->ColumnName(column).c_str();
+        }
+        SetupColumns(names.data(), column_count, options);
+        ApplySortSpecs(table);
+        table->UpdateView();
+
+        // Rows are drawn in the order of the table's sorted and filtered view. selected and the
+        // result are rows, not positions, so a selection survives sorting; they are 1-based.
+        long long clicked = -1;
+        ImGuiListClipper clipper;
+        clipper.Begin((int)table->VisibleCount(), options.item_height);
+        while (clipper.Step())
+        {
+            for (int position = clipper.DisplayStart; position < clipper.DisplayEnd; ++position)
+            {
+                const size_t row = table->VisibleRow((size_t)position);
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                if (DrawEntry(table->GetText(row, 0), (long long)row + 1, options, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap))
+                {
+                    clicked = (long long)row + 1;
+                }
+                for (int column = 1; column < column_count; ++column)
+                {
+                    ImGui::TableSetColumnIndex(column);
+                    ImGui::TextUnformatted(table->GetText(row, column));
+                }
+            }
+        }
+        ImGui::EndTable();
+        return PushClicked(L, clicked);
+    }
+
+    int DrawCallbackTable(lua_State* L, const char* id)
+    {
+        luaL_checktype(L, 2, LUA_TTABLE);
+        const lua_Integer row_count = luaL_checkinteger(L, 3);
+        luaL_checktype(L, 4, LUA_TFUNCTION);
+        const ViewOptions options = ReadOptions(L, 5);
+
+        const int column_count = (int)std::min<size_t>(lua_objlen(L, 2), MAX_TABLE_COLUMNS);
+        luaL_argcheck(L, column_count > 0, 2, "a VirtualTable needs at least one column");
+
+        // The names stay referenced by the column_names table for the whole call.
+        std::vector<const char*> names(column_count);
+        for (int column = 0; column < column_count; ++column)
+        {
+            lua_rawgeti(L, 2, column + 1);
+            names[column] = lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : "";
+            lua_pop(L, 1);
+        }
+
+        if (!ImGui::BeginTable(id, column_count, options.flags, options.size))
+        {
+            return 0;
+        }
+        SetupColumns(names.data(), column_count, options);
+
+        ImGuiListClipper clipper;
+        clipper.Begin((int)std::max<lua_Integer>(0, row_count), options.item_height);
+        while (clipper.Step())
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+            {
+                ImGui::TableNextRow();
+
+                // fn(row) either draws the row's cells itself and returns nothing, or returns
+                // one value per column to be drawn as text.
+                const int results = CallRow(L, 4, row + 1, LUA_MULTRET, [&]()
+                {
+                    clipper.End();
+                    ImGui::EndTable();
+                });
+                const int first = lua_gettop(L) - results + 1;
+                for (int column = 0; column < std::min(results, column_count); ++column)
+                {
+                    ImGui::TableSetColumnIndex(column);
+                    const char* text = lua_tostring(L, first + column);
+                    if (!text)
+                    {
+                        text = lua_type(L, first + column) == LUA_TBOOLEAN ? (lua_toboolean(L, first + column) ? "true" : "false") : "";
+                    }
+                    ImGui::TextUnformatted(text);
+                }
+                lua_pop(L, results);
+            }
+        }
+        ImGui::EndTable();
+        return 0;
+    }
+}
+
+int VirtualWidgets::LuaVirtualList(lua_State* L)
+{
+    if (const StringList* list = StringList::Test(L, 1))
+    {
+        return DrawStringList(L, list);
+    }
+
+    const lua_Integer count = luaL_checkinteger(L, 1);
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    const float item_height = (float)luaL_optnumber(L, 3, -1.0);
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)std::max<lua_Integer>(0, count), item_height);
+    while (clipper.Step())
+    {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+        {
+            CallRow(L, 2, row + 1, 0, [&]() { clipper.End(); });
+        }
+    }
+    return 0;
+}
+
+int VirtualWidgets::LuaVirtualTable(lua_State* L)
+{
+    const char* id = luaL_checkstring(L, 1);
+    if (DataTable* table = DataTable::Test(L, 2))
+    {
+        return DrawDataTable(L, id, table);
+    }
+    return DrawCallbackTable(L, id);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file virtual_widgets.h
+ * @brief Lists and tables that only touch their visible rows, for scripts with very long data.
+ *
+ * A script that draws a 100k-row table by looping over its rows calls into ImGui (and walks its
+ * Lua tables) for every row, although only a few dozen are on screen. UiForge.VirtualList and
+ * UiForge.VirtualTable run an ImGuiListClipper natively and only do work for the rows it asks
+ * for: they either call a Lua function for each visible row or, given a native source (a
+ * StringList or a DataTable), draw the rows themselves without calling Lua at all. Either way
+ * the cost of a frame depends on the window's height, not on the row count.
+ */
+#pragma once
+
+#include <lua.hpp>
+
+class VirtualWidgets
+{
+    public:
+        /**
+         * @brief UiForge.VirtualList(count, fn[, item_height]) calls fn(row) for each visible
+         * row (1-based) in the current window. UiForge.VirtualList(list[, options]) draws a
+         * StringList's visible entries itself.
+         */
+        static int LuaVirtualList(lua_State* L);
+
+        /**
+         * @brief UiForge.VirtualTable(id, data_table[, options]) draws the visible rows of a
+         * DataTable's sorted and filtered view; its headers sort it. UiForge.VirtualTable(id,
+         * column_names, count, fn[, options]) calls fn(row) for each visible row instead.
+         */
+        static int LuaVirtualTable(lua_State* L);
+};
@@ -0,0 +1,248 @@
+/**
+ * @file test_handle_table.cpp
+ * @brief Checks HandleTable's handle validation and slot reuse, then times lookups against a map.
+ *
+ * @example test_handle_table.exe
+ *          test_handle_table.exe --benchmark
+ *
+ * Covers what scripts rely on: a removed resource's handle stays rejected even after its slot
+ * is reused, however many times, removing from the middle keeps every other handle valid,
+ * Clear makes every handle stale at once, and owner tags follow their values. Returns nonzero
+ * when a check fails.
+ *
+ * Options:
+ *   --benchmark    Also time random lookups against std::unordered_map<int, T>, which the
+ *                  managers used before the handle table.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core\handle_table.h"
+
+namespace
+{
+    int failures = 0;
+
+    void Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAIL: " << what << "\n";
+            ++failures;
+        }
+    }
+
+    uint32_t SlotOf(ResourceHandle handle)
+    {
+        return (uint32_t)(handle & (HandleTable<int>::MAX_SLOTS - 1));
+    }
+
+    void CheckInsertAndFind()
+    {
+        HandleTable<std::string> table;
+        const ResourceHandle a = table.Insert("a");
+        const ResourceHandle b = table.Insert("b", 7);
+
+        Check(a != 0 && b != 0 && a != b, "handles are nonzero and distinct");
+        Check(a < (1ull << 44) && b < (1ull << 44), "handles fit in 44 bits");
+        Check(table.Find(a) && *table.Find(a) == "a", "a is found");
+        Check(table.Find(b) && *table.Find(b) == "b", "b is found");
+        Check(table.GetOwner(b) == 7 && table.GetOwner(a) == 0, "owners are kept");
+        Check(!table.Find(0) && !table.Contains(0), "0 is never valid");
+        Check(!table.Find(b + 1) && !table.Find(b | (1ull << 43)), "made-up handles are rejected");
+        Check(table.Size() == 2, "size counts live values");
+    }
+
+    void CheckStaleGeneration()
+    {
+        HandleTable<std::string> table;
+        const ResourceHandle old_handle = table.Insert("old");
+
+        std::string removed;
+        Check(table.Remove(old_handle, &removed) && removed == "old", "remove moves the value out");
+        Check(!table.Find(old_handle) && !table.Contains(old_handle), "a removed handle is rejected");
+        Check(!table.Remove(old_handle), "a removed handle cannot be removed twice");
+        Check(!table.SetOwner(old_handle, 3) && table.GetOwner(old_handle) == 0, "a removed handle has no owner");
+
+        // The new value reuses the slot, but the old handle must not alias it.
+        const ResourceHandle new_handle = table.Insert("new");
+        Check(SlotOf(new_handle) == SlotOf(old_handle), "the freed slot is reused");
+        Check(new_handle != old_handle, "a reused slot gets a new generation");
+        Check(!table.Find(old_handle), "the old handle does not find the slot's new value");
+        Check(table.Find(new_handle) && *table.Find(new_handle) == "new", "the new handle finds the new value");
+    }
+
+    void CheckSlotReuse()
+    {
+        HandleTable<int> table;
+        std::vector<ResourceHandle> handles;
+        for (int i = 0; i < 100; ++i)
+        {
+            handles.push_back(table.Insert(i));
+        }
+
+        // Remove every other value: the swaps that keep storage dense must not disturb the rest.
+        for (size_t i = 0; i < handles.size(); i += 2)
+        {
+            Check(table.Remove(handles[i]), "remove " + std::to_string(i));
+        }
+        bool others_intact = true;
+        for (size_t i = 1; i < handles.size(); i += 2)
+        {
+            others_intact = others_intact && table.Find(handles[i]) && *table.Find(handles[i]) == (int)i;
+        }
+        Check(others_intact, "values survive removals around them");
+        Check(table.Size() == 50, "half the values are left");
+
+        // Refilling uses the 50 freed slots and no new ones.
+        uint32_t highest_slot = 0;
+        for (int i = 0; i < 50; ++i)
+        {
+            highest_slot = std::max(highest_slot, SlotOf(table.Insert(1000 + i)));
+        }
+        Check(highest_slot < 100, "freed slots are reused before new ones are added");
+
+        // A slot cycled through every 16-bit generation is retired instead of wrapping, so no
+        // handle it issued can ever match again; the next insert takes a fresh slot.
+        HandleTable<int> cycled;
+        const ResourceHandle first = cycled.Insert(0);
+        ResourceHandle handle = first;
+        std::unordered_set<ResourceHandle> issued = { first };
+        bool never_zero = true;
+        bool never_reissued = true;
+        for (int i = 0; i < 70000; ++i)
+        {
+            cycled.Remove(handle);
+            handle = cycled.Insert(i);
+            never_zero = never_zero && handle != 0;
+            never_reissued = issued.insert(handle).second && never_reissued;
+        }
+        Check(never_zero, "cycled handles are never 0");
+        Check(never_reissued, "a cycled slot never issues the same handle twice");
+        Check(!cycled.Find(first), "the first handle stays stale after its slot's generations run out");
+        Check(cycled.Size() == 1 && SlotOf(handle) == SlotOf(first) + 1, "a slot out of generations is retired for a fresh one");
+    }
+
+    void CheckReleaseAll()
+    {
+        HandleTable<std::unique_ptr<int>> table;
+        std::vector<ResourceHandle> handles;
+        for (int i = 0; i < 10; ++i)
+        {
+            handles.push_back(table.Insert(std::make_unique<int>(i), i % 2 ? 5 : 6));
+        }
+
+        std::vector<ResourceHandle> owned = table.HandlesOwnedBy(5);
+        Check(owned.size() == 5, "HandlesOwnedBy finds one owner's values");
+        for (ResourceHandle handle : owned)
+        {
+            table.Remove(handle);
+        }
+        Check(table.Size() == 5 && table.HandlesOwnedBy(5).empty(), "removing one owner's values leaves the others");
+
+        int visited = 0;
+        table.ForEach([&](ResourceHandle handle, std::unique_ptr<int>& value, uint32_t owner)
+        {
+            visited += table.Contains(handle) && value && owner == 6;
+        });
+        Check(visited == 5, "ForEach visits every live value with its handle and owner");
+        Check(table.Handles().size() == 5, "Handles lists every live value");
+
+        table.Clear();
+        Check(table.Empty(), "Clear removes every value");
+        bool all_stale = true;
+        for (ResourceHandle handle : handles)
+        {
+            all_stale = all_stale && !table.Find(handle);
+        }
+        Check(all_stale, "Clear makes every handle stale");
+
+        uint32_t highest_slot = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            highest_slot = std::max(highest_slot, SlotOf(table.Insert(std::make_unique<int>(i))));
+        }
+        Check(highest_slot < 10, "slots freed by Clear are reused");
+    }
+
+    // Looks up random live resources, the access pattern of scripts drawing textures each frame.
+    void RunBenchmark()
+    {
+        using Clock = std::chrono::steady_clock;
+        const int counts[] = { 100, 10000, 1000000 };
+        const int lookups  = 10000000;
+
+        std::cout << "Benchmark (" << lookups << " random lookups):\n";
+        for (int count : counts)
+        {
+            HandleTable<int> table;
+            std::unordered_map<int, int> map;
+            std::vector<ResourceHandle> handles;
+            std::vector<int> ids;
+            for (int i = 0; i < count; ++i)
+            {
+                handles.push_back(table.Insert(i));
+                ids.push_back(i + 1);
+                map.emplace(i + 1, i);
+            }
+
+            std::mt19937 random(1);
+            std::vector<uint32_t> order(lookups);
+            for (uint32_t& position : order)
+            {
+                position = random() % count;
+            }
+
+            long long sum = 0;
+            auto start = Clock::now();
+            for (uint32_t position : order)
+            {
+                sum += *table.Find(handles[position]);
+            }
+            const long long table_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+            start = Clock::now();
+            for (uint32_t position : order)
+            {
+                sum -= map.find(ids[position])->second;
+            }
+            const long long map_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+            Check(sum == 0, "both containers found the same values");
+            std::cout << "  " << count << " resources: HandleTable " << table_us << " us, unordered_map " << map_us << " us ("
+                      << (double)map_us / (double)std::max(table_us, 1LL) << "x)\n";
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const bool benchmark = argc > 1 && std::string(argv[1]) == "--benchmark";
+
+    CheckInsertAndFind();
+    CheckStaleGeneration();
+    CheckSlotReuse();
+    CheckReleaseAll();
+
+    if (failures)
+    {
+        std::cerr << failures << " handle table check(s) failed\n";
+        return 1;
+    }
+    std::cout << "Handle table checks passed\n";
+
+    if (benchmark)
+    {
+        RunBenchmark();
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * @file test_sdf_generator.cpp
+ * @brief Checks the signed distance fields SdfGenerator builds from small generated glyphs.
+ *
+ * @example test_sdf_generator.exe
+ *
+ * The glyphs are generated, so the test needs no font: a filled square, sampled at the field
+ * resolution and at four times it, and a disc. Every field texel must be on the right side of 128
+ * for its side of the outline, saturate to 0 and 255 past the spread, and sit within a small
+ * tolerance of the true signed distance scaled into the 0-255 range. Interpolating between the
+ * texels either side of an edge must put the 0.5 level on the glyph's edge. Padded row pitches,
+ * rounded up field sizes and invalid arguments are checked as well. Returns nonzero when a check
+ * fails.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core\sdf_generator.h"
+
+namespace
+{
+    int failures = 0;
+
+    void Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAIL: " << what << "\n";
+            ++failures;
+        }
+    }
+
+    struct Glyph
+    {
+        int                     width  = 0;
+        int                     height = 0;
+        std::vector<uint8_t>    coverage;
+    };
+
+    struct Field
+    {
+        int                     width  = 0;
+        int                     height = 0;
+        std::vector<uint8_t>    values;
+
+        float At(int x, int y) const { return values[(size_t)y * width + x] / 255.0f; }
+    };
+
+    // A size x size coverage bitmap with the square [begin, end) in both directions filled.
+    Glyph MakeSquare(int size, int begin, int end)
+    {
+        Glyph glyph;
+        glyph.width  = size;
+        glyph.height = size;
+        glyph.coverage.assign((size_t)size * size, 0);
+        for (int y = begin; y < end; ++y)
+        {
+            for (int x = begin; x < end; ++x)
+            {
+                glyph.coverage[(size_t)y * size + x] = 255;
+            }
+        }
+        return glyph;
+    }
+
+    // A size x size coverage bitmap with every pixel whose centre lies within radius of the
+    // bitmap's centre filled.
+    Glyph MakeDisc(int size, float radius)
+    {
+        Glyph glyph;
+        glyph.width  = size;
+        glyph.height = size;
+        glyph.coverage.assign((size_t)size * size, 0);
+        const float centre = size * 0.5f;
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                if (std::hypot(x + 0.5f - centre, y + 0.5f - centre) <= radius)
+                {
+                    glyph.coverage[(size_t)y * size + x] = 255;
+                }
+            }
+        }
+        return glyph;
+    }
+
+    Field Generate(const Glyph& glyph, int downscale, float spread)
+    {
+        Field field;
+        const bool generated = SdfGenerator::FromCoverage(glyph.coverage.data(), glyph.width, glyph.height, glyph.width,
+                                                          downscale, spread, field.values, field.width, field.height);
+        Check(generated, "a valid glyph generates a field");
+        return field;
+    }
+
+    // The value a field texel should hold for a texel centre at signed distance (in texels,
+    // negative inside) from the outline.
+    float ExpectedValue(float distance, float spread)
+    {
+        return std::clamp(0.5f - distance / (2.0f * spread), 0.0f, 1.0f);
+    }
+
+    // Checks the texels of rows [first_row, last_row] against the signed distance from their
+    // centres to the outline.
+    template <typename SignedDistance>
+    void CheckDistances(const std::string& name, const Field& field, int first_row, int last_row, float spread, float tolerance,
+                        SignedDistance signed_distance)
+    {
+        float worst = 0.0f;
+        bool signs_match = true;
+        for (int y = first_row; y <= last_row; ++y)
+        {
+            for (int x = 0; x < field.width; ++x)
+            {
+                const float distance = signed_distance(x + 0.5f, y + 0.5f);
+                const float value    = field.At(x, y);
+                worst = std::max(worst, std::abs(value - ExpectedValue(distance, spread)));
+
+                // Texels right on the outline can round either way.
+                if ((distance <= -0.25f && value <= 0.5f) || (distance >= 0.25f && value >= 0.5f))
+                {
+                    signs_match = false;
+                }
+            }
+        }
+
+        std::cout << "  " << name << ": largest error " << worst * 255.0f << " of 255\n";
+        Check(signs_match, name + " texels are above 0.5 inside the outline and below it outside");
+        Check(worst <= tolerance, name + " values follow the distance to the outline");
+    }
+
+    // Where the 0.5 level falls between texel centres x and x + 1 of row y, by linear interpolation.
+    float EdgeBetween(const Field& field, int x, int y)
+    {
+        const float before = field.At(x, y);
+        const float after  = field.At(x + 1, y);
+        return x + 0.5f + (0.5f - before) / (after - before);
+    }
+
+    // Signed distance to the square [begin, end) in both directions.
+    float SquareDistance(float x, float y, float begin, float end)
+    {
+        const float dx = std::max(begin - x, x - end);
+        const float dy = std::max(begin - y, y - end);
+        if (dx <= 0.0f && dy <= 0.0f)
+        {
+            return std::max(dx, dy);
+        }
+        return std::hypot(std::max(dx, 0.0f), std::max(dy, 0.0f));
+    }
+
+    // Distances are measured between pixel centres, which is exact along an axis but overshoots
+    // by up to a third of a pixel diagonally past a corner, and a texel near a corner averages
+    // pixels closest to different sides. Rows further than the spread from a square's top and
+    // bottom see only its left and right edges, so those must be exact up to rounding to 8 bits.
+    const float EXACT_TOLERANCE  = 0.5f / 255.0f + 1e-4f;
+    const float CORNER_TOLERANCE = 6.0f / 255.0f;
+
+    // A square sampled at the field resolution.
+    void CheckSquare()
+    {
+        const float spread = 8.0f;
+        const Field field = Generate(MakeSquare(64, 16, 48), 1, spread);
+        Check(field.width == 64 && field.height == 64, "square field is the coverage size at downscale 1");
+        if (field.width != 64 || field.height != 64)
+        {
+            return;
+        }
+
+        auto distance = [](float x, float y) { return SquareDistance(x, y, 16.0f, 48.0f); };
+        CheckDistances("square", field, 0, 63, spread, CORNER_TOLERANCE, distance);
+        CheckDistances("square middle rows", field, 24, 39, spread, EXACT_TOLERANCE, distance);
+
+        Check(field.At(32, 32) == 1.0f, "square centre, further than the spread inside, is 255");
+        Check(field.At(0, 0) == 0.0f, "square corner, further than the spread outside, is 0");
+        Check(std::abs(EdgeBetween(field, 15, 32) - 16.0f) < 0.01f, "square left edge lands at 16");
+        Check(std::abs(EdgeBetween(field, 47, 32) - 48.0f) < 0.01f, "square right edge lands at 48");
+    }
+
+    // The same square rasterized at four times the field resolution, as SdfFont does.
+    void CheckOversampledSquare()
+    {
+        const float spread = 4.0f;
+        const Field field = Generate(MakeSquare(128, 32, 96), 4, spread);
+        Check(field.width == 32 && field.height == 32, "oversampled field is a quarter of the coverage size");
+        if (field.width != 32 || field.height != 32)
+        {
+            return;
+        }
+
+        // Each texel averages the distances of the 4x4 pixels it covers, which along a straight
+        // edge is the distance at the texel centre.
+        auto distance = [](float x, float y) { return SquareDistance(x, y, 8.0f, 24.0f); };
+        CheckDistances("oversampled square", field, 0, 31, spread, CORNER_TOLERANCE, distance);
+        CheckDistances("oversampled square middle rows", field, 12, 19, spread, EXACT_TOLERANCE, distance);
+
+        Check(std::abs(EdgeBetween(field, 7, 16) - 8.0f) < 0.01f, "oversampled square left edge lands at 8");
+        Check(std::abs(EdgeBetween(field, 23, 16) - 24.0f) < 0.01f, "oversampled square right edge lands at 24");
+    }
+
+    // A disc has no axis-aligned edges, so pixel staircasing limits how close the field gets.
+    void CheckDisc()
+    {
+        const float spread = 4.0f;
+        const float radius = 40.0f;
+        const Field field = Generate(MakeDisc(128, radius), 4, spread);
+        if (field.width != 32 || field.height != 32)
+        {
+            Check(false, "disc field is a quarter of the coverage size");
+            return;
+        }
+
+        CheckDistances("disc", field, 0, 31, spread, CORNER_TOLERANCE, [&](float x, float y)
+        {
+            return std::hypot(x - 16.0f, y - 16.0f) - radius / 4.0f;
+        });
+
+        const float edge = EdgeBetween(field, 25, 16);
+        Check(std::abs(edge - (16.0f + radius / 4.0f)) < 0.1f, "disc edge lands on its radius");
+    }
+
+    // A padded row pitch reads the same pixels, and sizes round up to whole texels.
+    void CheckLayout()
+    {
+        const Glyph glyph = MakeSquare(30, 10, 20);
+        const Field tight = Generate(glyph, 4, 2.0f);
+        Check(tight.width == 8 && tight.height == 8, "a 30 pixel glyph at downscale 4 rounds up to 8 texels");
+
+        const size_t pitch = 48;
+        std::vector<uint8_t> padded(pitch * glyph.height, 255);
+        for (int y = 0; y < glyph.height; ++y)
+        {
+            std::copy_n(glyph.coverage.data() + (size_t)y * glyph.width, glyph.width, padded.data() + y * pitch);
+        }
+
+        Field from_padded;
+        const bool generated = SdfGenerator::FromCoverage(padded.data(), glyph.width, glyph.height, pitch, 4, 2.0f,
+                                                          from_padded.values, from_padded.width, from_padded.height);
+        Check(generated && from_padded.values == tight.values, "a padded row pitch gives the same field");
+    }
+
+    void CheckInvalidArguments()
+    {
+        const Glyph glyph = MakeSquare(16, 4, 12);
+        std::vector<uint8_t> field;
+        int width = 0, height = 0;
+        Check(!SdfGenerator::FromCoverage(nullptr, 16, 16, 16, 1, 4.0f, field, width, height), "null coverage is rejected");
+        Check(!SdfGenerator::FromCoverage(glyph.coverage.data(), 0, 16, 16, 1, 4.0f, field, width, height), "zero width is rejected");
+        Check(!SdfGenerator::FromCoverage(glyph.coverage.data(), 16, 16, 8, 1, 4.0f, field, width, height), "a row pitch smaller than a row is rejected");
+        Check(!SdfGenerator::FromCoverage(glyph.coverage.data(), 16, 16, 16, 0, 4.0f, field, width, height), "zero downscale is rejected");
+        Check(!SdfGenerator::FromCoverage(glyph.coverage.data(), 16, 16, 16, 1, 0.0f, field, width, height), "zero spread is rejected");
+    }
+}
+
+int main()
+{
+    std::cout << "Distance error:\n";
+    CheckSquare();
+    CheckOversampledSquare();
+    CheckDisc();
+    CheckLayout();
+    CheckInvalidArguments();
+
+    if (failures)
+    {
+        std::cerr << failures << " SDF generator check(s) failed\n";
+        return 1;
+    }
+    std::cout << "SDF generator checks passed\n";
+    return 0;
+}
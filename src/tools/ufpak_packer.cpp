@@ -0,0 +1,399 @@
+/**
+ * @file ufpak_packer.cpp
+ * @brief Packs a scripts folder into a .ufpak archive (see core\ufpak_format.h).
+ *
+ * @example ufpak_packer.exe scripts\tools scripts\tools.ufpak
+ *          ufpak_packer.exe build\scripts scripts\mods.ufpak --bytecode --strip --compress
+ *          ufpak_packer.exe build\scripts scripts\mods.ufpak --benchmark
+ *
+ * The input folder is laid out the way the scripts folder is: loose .lua files at the top,
+ * package folders ("tools\tools.lua", "tools\modules", "tools\resources"), and optionally the
+ * shared "modules" and "resources" folders. Drop the archive into the scripts folder and the core
+ * mounts it on the next script refresh.
+ *
+ * Options:
+ *   --bytecode     Precompile .lua files to LuaJIT bytecode. The archive then only runs on the
+ *                  LuaJIT build it was packed with.
+ *   --strip        With --bytecode, drop debug info (smaller, but errors lose line numbers).
+ *   --compress     XPRESS Huffman compress entries that shrink by at least an eighth. Already
+ *                  compressed formats (png, jpg, gif, mp3, ogg) are stored as is.
+ *   --benchmark    After packing, time reading every file loose versus from the archive.
+ */
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <compressapi.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <lua.hpp>
+
+#include "core\package_archive.h"
+#include "core\ufpak_format.h"
+
+namespace
+{
+    struct PackOptions
+    {
+        bool bytecode   = false;
+        bool strip      = false;
+        bool compress   = false;
+        bool benchmark  = false;
+    };
+
+    struct PackedEntry
+    {
+        std::string             key;
+        std::filesystem::path   source;
+        std::vector<char>       data;       // As stored in the archive
+        uint64_t                size  = 0;  // Once decompressed
+        uint32_t                flags = 0;
+    };
+
+    bool ReadWholeFile(const std::filesystem::path& file_path, std::vector<char>& out_data)
+    {
+        std::ifstream in(file_path, std::ios::binary | std::ios::ate);
+        if (!in)
+        {
+            return false;
+        }
+
+        const std::streamsize size = in.tellg();
+        out_data.resize((size_t)std::max<std::streamsize>(size, 0));
+        in.seekg(0);
+        return size <= 0 || (bool)in.read(out_data.data(), size);
+    }
+
+    std::string LowerExtension(const std::filesystem::path& file_path)
+    {
+        std::string extension = file_path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return extension;
+    }
+
+    int WriteBytecode(lua_State* L, const void* chunk, size_t size, void* user_data)
+    {
+        std::vector<char>* out_data = (std::vector<char>*)user_data;
+        out_data->insert(out_data->end(), (const char*)chunk, (const char*)chunk + size);
+        return 0;
+    }
+
+    // Compiles a Lua source to bytecode through string.dump, which (unlike lua_dump) can strip
+    // debug info on LuaJIT.
+    bool CompileToBytecode(lua_State* L, const std::string& chunk_name, bool strip, std::vector<char>& in_out_data)
+    {
+        if (luaL_loadbuffer(L, in_out_data.data(), in_out_data.size(), chunk_name.c_str()) != 0)
+        {
+            std::cerr << "  " << lua_tostring(L, -1) << "\n";
+            lua_pop(L, 1);
+            return false;
+        }
+
+        std::vector<char> bytecode;
+        if (strip)
+        {
+            lua_getglobal(L, "string");
+            lua_getfield(L, -1, "dump");
+            lua_pushvalue(L, -3);
+            lua_pushboolean(L, 1);
+            if (lua_pcall(L, 2, 1, 0) != 0)
+            {
+                std::cerr << "  " << lua_tostring(L, -1) << "\n";
+                lua_pop(L, 3);
+                return false;
+            }
+
+            size_t length = 0;
+            const char* dumped = lua_tolstring(L, -1, &length);
+            bytecode.assign(dumped, dumped + length);
+            lua_pop(L, 3);
+        }
+        else
+        {
+            lua_dump(L, WriteBytecode, &bytecode);
+            lua_pop(L, 1);
+        }
+
+        in_out_data.swap(bytecode);
+        return true;
+    }
+
+    // Compresses in place when it saves at least an eighth; returns whether it did.
+    bool TryCompress(COMPRESSOR_HANDLE compressor, std::vector<char>& in_out_data)
+    {
+        if (in_out_data.size() < 64)
+        {
+            return false;
+        }
+
+        std::vector<char> compressed(in_out_data.size());
+        SIZE_T compressed_size = 0;
+        if (!Compress(compressor, in_out_data.data(), in_out_data.size(), compressed.data(), compressed.size(), &compressed_size)
+            || compressed_size > in_out_data.size() - in_out_data.size() / 8)
+        {
+            return false;
+        }
+
+        compressed.resize(compressed_size);
+        in_out_data.swap(compressed);
+        return true;
+    }
+
+    bool CollectEntries(const std::filesystem::path& input_dir, const std::filesystem::path& output_path,
+                        const PackOptions& options, std::vector<PackedEntry>& out_entries)
+    {
+        lua_State* L = options.bytecode ? luaL_newstate() : nullptr;
+        if (L)
+        {
+            luaL_openlibs(L);
+        }
+
+        COMPRESSOR_HANDLE compressor = nullptr;
+        if (options.compress && !CreateCompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &compressor))
+        {
+            std::cerr << "Could not create the XPRESS Huffman compressor (" << GetLastError() << ")\n";
+            return false;
+        }
+
+        const char* precompressed[] = { ".png", ".jpg", ".jpeg", ".gif", ".mp3", ".ogg" };
+        bool succeeded = true;
+
+        std::error_code ec;
+        for (auto iterator = std::filesystem::recursive_directory_iterator(input_dir, ec);
+             !ec && iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(ec))
+        {
+            std::error_code entry_ec;
+            if (!iterator->is_regular_file(entry_ec) || std::filesystem::equivalent(iterator->path(), output_path, entry_ec))
+            {
+                continue;
+            }
+
+            PackedEntry entry;
+            entry.source = iterator->path();
+            if (!Ufpak::NormalizeKey(entry.source.lexically_relative(input_dir).string(), entry.key))
+            {
+                continue;
+            }
+            if (!ReadWholeFile(entry.source, entry.data))
+            {
+                std::cerr << "Could not read " << entry.source.string() << "\n";
+                succeeded = false;
+                break;
+            }
+
+            const std::string extension = LowerExtension(entry.source);
+            if (L && extension == ".lua")
+            {
+                if (!CompileToBytecode(L, "@" + entry.key, options.strip, entry.data))
+                {
+                    std::cerr << "Could not compile " << entry.source.string() << "\n";
+                    succeeded = false;
+                    break;
+                }
+                entry.flags |= Ufpak::ENTRY_BYTECODE;
+            }
+
+            entry.size = entry.data.size();
+            const bool skip_compression = std::find(std::begin(precompressed), std::end(precompressed), extension) != std::end(precompressed);
+            if (compressor && !skip_compression && TryCompress(compressor, entry.data))
+            {
+                entry.flags |= Ufpak::ENTRY_COMPRESSED;
+            }
+
+            out_entries.push_back(std::move(entry));
+        }
+
+        if (compressor)
+        {
+            CloseCompressor(compressor);
+        }
+        if (L)
+        {
+            lua_close(L);
+        }
+        if (ec)
+        {
+            std::cerr << "Could not list " << input_dir.string() << ": " << ec.message() << "\n";
+            return false;
+        }
+        if (!succeeded)
+        {
+            return false;
+        }
+
+        // The core binary searches the index, so it must be in byte order of the names.
+        std::sort(out_entries.begin(), out_entries.end(), [](const PackedEntry& a, const PackedEntry& b) { return a.key < b.key; });
+        for (size_t i = 1; i < out_entries.size(); ++i)
+        {
+            if (out_entries[i].key == out_entries[i - 1].key)
+            {
+                std::cerr << out_entries[i - 1].source.string() << " and " << out_entries[i].source.string()
+                          << " differ only by case\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool WriteArchive(const std::filesystem::path& output_path, const std::vector<PackedEntry>& entries)
+    {
+        std::vector<Ufpak::Entry> index(entries.size());
+        std::string names;
+
+        std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "Could not create " << output_path.string() << "\n";
+            return false;
+        }
+
+        Ufpak::Header header = {};
+        out.write((const char*)&header, sizeof(header));
+
+        uint64_t offset = sizeof(header);
+        const char padding[Ufpak::DATA_ALIGNMENT] = {};
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const uint64_t aligned = (offset + Ufpak::DATA_ALIGNMENT - 1) & ~(Ufpak::DATA_ALIGNMENT - 1);
+            out.write(padding, (std::streamsize)(aligned - offset));
+            out.write(entries[i].data.data(), (std::streamsize)entries[i].data.size());
+
+            index[i].data_offset = aligned;
+            index[i].stored_size = entries[i].data.size();
+            index[i].size        = entries[i].size;
+            index[i].name_offset = (uint32_t)names.size();
+            index[i].name_length = (uint32_t)entries[i].key.size();
+            index[i].flags       = entries[i].flags;
+            names += entries[i].key;
+            offset = aligned + entries[i].data.size();
+        }
+
+        std::memcpy(header.magic, Ufpak::MAGIC, sizeof(header.magic));
+        header.version      = Ufpak::VERSION;
+        header.entry_count  = (uint32_t)entries.size();
+        header.index_offset = offset;
+        header.names_offset = offset + index.size() * sizeof(Ufpak::Entry);
+        header.names_size   = names.size();
+
+        out.write((const char*)index.data(), (std::streamsize)(index.size() * sizeof(Ufpak::Entry)));
+        out.write(names.data(), (std::streamsize)names.size());
+        out.seekp(0);
+        out.write((const char*)&header, sizeof(header));
+        return (bool)out;
+    }
+
+    // Reads every packed file once loose and once through the archive, the way the core would.
+    void RunBenchmark(const std::filesystem::path& output_path, const std::vector<PackedEntry>& entries)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        auto loose_start = Clock::now();
+        size_t loose_bytes = 0;
+        std::vector<char> buffer;
+        for (const PackedEntry& entry : entries)
+        {
+            if (ReadWholeFile(entry.source, buffer))
+            {
+                loose_bytes += buffer.size();
+            }
+        }
+        const auto loose_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - loose_start).count();
+
+        auto archive_start = Clock::now();
+        size_t archive_bytes = 0;
+        if (PackageArchive::Mount(output_path))
+        {
+            for (const PackedEntry& entry : entries)
+            {
+                // Touch every page, so a zero-copy read is charged for faulting the data in.
+                ArchiveFile file;
+                if (PackageArchive::ReadFile(output_path / entry.key, file))
+                {
+                    volatile char sink = 0;
+                    for (size_t i = 0; i < file.size; i += 4096)
+                    {
+                        sink ^= file.data[i];
+                    }
+                    archive_bytes += file.size;
+                }
+            }
+        }
+        const auto archive_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - archive_start).count();
+        PackageArchive::UnmountAll();
+
+        std::cout << "Benchmark (" << entries.size() << " files, warm file cache):\n"
+                  << "  loose:   " << loose_us << " us, " << loose_bytes << " bytes\n"
+                  << "  archive: " << archive_us << " us, " << archive_bytes << " bytes (mount included)\n";
+    }
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: ufpak_packer <input_dir> <output.ufpak> [--bytecode [--strip]] [--compress] [--benchmark]\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const std::filesystem::path input_dir = argv[1];
+    const std::filesystem::path output_path = argv[2];
+    PackOptions options;
+    for (int i = 3; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+        if      (option == "--bytecode")  options.bytecode = true;
+        else if (option == "--strip")     options.strip = true;
+        else if (option == "--compress")  options.compress = true;
+        else if (option == "--benchmark") options.benchmark = true;
+        else
+        {
+            std::cerr << "Unknown option " << option << "\n";
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(input_dir, ec))
+    {
+        std::cerr << input_dir.string() << " is not a directory\n";
+        return 1;
+    }
+
+    std::vector<PackedEntry> entries;
+    if (!CollectEntries(input_dir, output_path, options, entries) || !WriteArchive(output_path, entries))
+    {
+        return 1;
+    }
+
+    uint64_t source_bytes = 0;
+    uint64_t stored_bytes = 0;
+    for (const PackedEntry& entry : entries)
+    {
+        source_bytes += std::filesystem::file_size(entry.source, ec);
+        stored_bytes += entry.data.size();
+    }
+    std::cout << "Packed " << entries.size() << " files (" << source_bytes << " bytes, " << stored_bytes << " stored) into "
+              << output_path.string() << " (" << std::filesystem::file_size(output_path, ec) << " bytes)\n";
+
+    if (options.benchmark)
+    {
+        RunBenchmark(output_path, entries);
+    }
+    return 0;
+}